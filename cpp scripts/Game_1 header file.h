@@ -10,13 +10,23 @@
 #include <Label.hpp>
 #include <Panel.hpp>
 #include <Button.hpp>
-#include <Timer.hpp>
-#include <Tween.hpp>
 #include <SceneTree.hpp>
+#include <Tween.hpp>
+#include <Camera2D.hpp>
+#include <Time.hpp>
+
+#include "gameplay_timers.h"
+#include "health_system.h"
+#include "match_sequencer.h"
+#include "match_events.h"
+#include "match_hud.h"
+
+#include <algorithm>
+#include <vector>
 
 namespace godot {
 
-    class MatchManager : public Node2D {
+    class MatchManager : public Node2D, public MatchEventListener {
         GODOT_CLASS(MatchManager, Node2D)
 
     public:
@@ -28,6 +38,7 @@ namespace godot {
         void _init() override;
         void _ready() override;
         void _process(double delta) override;
+        void _physics_process(double delta) override;
 
         // ============================================================
         // NODES
@@ -42,11 +53,11 @@ namespace godot {
         Label* round_counter_label;
         Label* match_state_msgs;
 
-        Timer* round_timer;
-
         Panel* victory_screen;
         Button* restart_button;
 
+        Camera2D* camera_2d;
+
         // ============================================================
         // GAME STATE
         // ============================================================
@@ -57,7 +68,66 @@ namespace godot {
         int rounds_won_p2;
         const int MAX_ROUNDS = 3;
 
+        int fighter_health[2];                  // mirrored from EVENT_HEALTH_CHANGED
+
         float speed;
+        int round_seconds;                      // round clock, run as a sequence
+
+        // Owned here so fighters and health systems can schedule into it from _ready
+        GameplayTimers gameplay_timers;
+        MatchEventBus match_events;
+
+        // Match flow and events write here; widgets are touched once per render frame
+        MatchHud hud;
+
+        // Round timer and counter are drawn from pre-rasterised digits
+        GlyphStrip hud_digits;
+        GlyphCounter round_timer_digits;
+        GlyphCounter round_counter_digits;
+
+        // ============================================================
+        // MATCH FLOW
+        // Intro, fight text, round clock, round end and victory run as
+        // sequences on physics frames. No Tween, Timer or SceneTreeTimer is
+        // created per round.
+        // ============================================================
+        enum Sequence : uint8_t { SEQUENCE_INTRO, SEQUENCE_FIGHT_TEXT, SEQUENCE_ROUND_END, SEQUENCE_VICTORY, SEQUENCE_ROUND_CLOCK };
+
+        MatchSequencer sequencer;
+        NodePath position_x_path;
+        NodePath modulate_a_path;
+
+        static SequenceTask run_sequence(MatchSequencer& sequencer, void* owner, uint8_t script, int32_t arg);
+
+        // Engine Tweens for the match (HUD flourishes and the like) go
+        // through create_match_tween() so rematch kills those and nothing else
+        std::vector<Ref<Tween>> match_tweens;
+        Ref<Tween> create_match_tween();
+
+        // ============================================================
+        // REMATCH
+        // Captured once after load and restored in place, instead of
+        // reload_current_scene().
+        // ============================================================
+        struct MatchSnapshot {
+            Vector2 player_positions[2];
+            Vector2 player_facing[2];
+            double health_bar_values[2];
+
+            String round_timer_text;
+            String round_counter_text;
+            String match_state_text;
+            bool match_state_visible;
+
+            bool victory_visible;
+            Color victory_modulate;
+
+            Vector2 camera_position;
+            Vector2 camera_zoom;
+        };
+
+        MatchSnapshot initial_snapshot;
+        int64_t last_restart_usec;              // reset cost of the last rematch, before start_match
 
         // ============================================================
         // FUNCTIONS
@@ -68,11 +138,16 @@ namespace godot {
         void reset_round();
         void end_match();
 
-        void on_player_health_changed(int new_health, String character_id);
-        void on_character_died(String character_id);
+        void on_match_events(const MatchEvent* events, int count) override;
         void on_restart_button_pressed();
-
-        void _on_round_timer_timeout();
+        Dictionary get_event_stats();
+        Dictionary get_hud_stats();
+
+        MatchSnapshot capture_snapshot();
+        void apply_snapshot(const MatchSnapshot& snapshot);
+        int64_t hash_match_state();
+        void rematch();
+        int64_t get_last_restart_usec();
     };
 
 } // namespace godot
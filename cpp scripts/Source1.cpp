@@ -8,11 +8,14 @@
 #include <AnimatedSprite2D.hpp>
 #include <Hurtbox.hpp>
 #include <Hitbox.hpp>
-#include <Timer.hpp>
+
+#include "gameplay_timers.h"
+#include "match_events.h"
+#include "anim_timeline.h"
 
 namespace godot {
 
-    class Player2 : public CharacterBody2D {
+    class Player2 : public CharacterBody2D, public TimerListener {
         GODOT_CLASS(Player2, CharacterBody2D)
 
     public:
@@ -24,6 +27,7 @@ namespace godot {
         void _init() override;
         void _ready() override;
         void _physics_process(float delta) override;
+        void _process(float delta) override;
 
         // Signals
         static void _register_methods();
@@ -48,12 +52,13 @@ namespace godot {
         Hitbox* hitbox_punch_area;
         Hitbox* hitbox_kick_area;
 
-        Timer* counter_window_timer;
+        TimerHandle counter_timer;
 
 
         // EXPORT VARIABLES
 
         String character_name;
+        int fighter_slot;
         int max_health;
         float hitstun_duration;
         float knockdown_duration;
@@ -71,10 +76,10 @@ namespace godot {
         String crouch_state;
 
         bool is_stunned;
-        float stun_timer;
+        TimerHandle stun_timer;
 
         bool is_knocked_down;
-        float knockdown_time;
+        TimerHandle knockdown_timer;
 
         bool is_blocking;
         bool is_blocking_hit;
@@ -83,6 +88,16 @@ namespace godot {
         Array<String> input_buffer;
         float buffer_timer;
 
+        // Which animation and how long in it; the sprite only samples this
+        AnimState anim;
+
+
+        // ANIMATION
+
+        AnimTimeline anim_timeline;
+        PackedStringArray anim_names;       // timeline id -> SpriteFrames name
+        Dictionary anim_ids;
+
 
         // COMBOS
 
@@ -99,16 +114,27 @@ namespace godot {
         void _handle_movement(float delta);
         void _handle_attack_input();
         void _handle_animation();
-        void _on_animation_finished();
+        void _end_attack();
+        void build_anim_timeline();
+        void play_anim(const String& name, bool restart = false);
+        void sync_sprite();
         void _start_attack(String type);
         void take_damage(int amount, Vector2 hit_position);
         void die();
+        void push_event(MatchEventType type, int value = 0, int delta = 0);
         void _handle_block();
         void _handle_input_buffer(float delta);
         void add_input_to_buffer(String action);
         void check_for_combos();
         void perform_combo(String combo_name);
         void reset_stats();
+        void reset_counter();
+
+        int get_health() const;
+        int get_fighter_state() const;
+
+        void schedule_timer(TimerHandle& handle, float seconds, GameplayTimerKind kind);
+        void on_gameplay_timer(const TimerEvent& event) override;
 
         void _on_hurtbox_standing_area_entered(Area2D* area);
         void _on_hurtbox_crouching_area_entered(Area2D* area);
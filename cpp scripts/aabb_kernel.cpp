@@ -0,0 +1,267 @@
+#include "aabb_kernel.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <new>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define AABB_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+// MSVC emits any intrinsic anywhere; GCC/Clang need the function tagged
+#if defined(AABB_X86) && (defined(__GNUC__) || defined(__clang__))
+#define AABB_TARGET(isa) __attribute__((target(isa)))
+#else
+#define AABB_TARGET(isa)
+#endif
+
+using namespace godot;
+
+static const size_t ALIGNMENT = 32;
+static const int FIELD_COUNT = 4;
+
+// ------------------ RECT BUFFER --------------------
+RectBuffer::RectBuffer() :
+		capacity(0),
+		count(0),
+		block(nullptr),
+		min_x(nullptr),
+		min_y(nullptr),
+		max_x(nullptr),
+		max_y(nullptr) {}
+
+RectBuffer::RectBuffer(int capacity) :
+		RectBuffer() {
+	reserve(capacity);
+}
+
+RectBuffer::~RectBuffer() {
+	if (block) ::operator delete(block, std::align_val_t(ALIGNMENT));
+}
+
+void RectBuffer::reserve(int wanted) {
+	wanted = (wanted + LANES - 1) / LANES * LANES;
+	if (wanted <= capacity) return;
+
+	size_t field_bytes = (size_t)wanted * sizeof(float);
+	void* grown = ::operator new(field_bytes * FIELD_COUNT, std::align_val_t(ALIGNMENT));
+	float* base = static_cast<float*>(grown);
+
+	float* fields[FIELD_COUNT] = { base, base + wanted, base + wanted * 2, base + wanted * 3 };
+	if (block) {
+		memcpy(fields[0], min_x, count * sizeof(float));
+		memcpy(fields[1], min_y, count * sizeof(float));
+		memcpy(fields[2], max_x, count * sizeof(float));
+		memcpy(fields[3], max_y, count * sizeof(float));
+		::operator delete(block, std::align_val_t(ALIGNMENT));
+	}
+
+	block = grown;
+	min_x = fields[0];
+	min_y = fields[1];
+	max_x = fields[2];
+	max_y = fields[3];
+	capacity = wanted;
+	pad_tail();
+}
+
+void RectBuffer::clear() {
+	count = 0;
+	pad_tail();
+}
+
+int RectBuffer::add(float x0, float y0, float x1, float y1) {
+	if (count + 1 > capacity) reserve(std::max(capacity * 2, LANES));
+
+	int i = count++;
+	min_x[i] = x0;
+	min_y[i] = y0;
+	max_x[i] = x1;
+	max_y[i] = y1;
+
+	// Opened a new block of LANES: fill the rest of it with empty rects
+	if (count % LANES == 1) pad_tail();
+	return i;
+}
+
+void RectBuffer::pad_tail() {
+	const float inf = std::numeric_limits<float>::infinity();
+	for (int i = count; i < get_padded_count(); i++) {
+		min_x[i] = min_y[i] = inf;
+		max_x[i] = max_y[i] = -inf;
+	}
+}
+
+// ------------------ KERNELS --------------------
+typedef int (*OverlapFn)(int, float, float, float, float, const RectBuffer&, std::vector<HitPair>&);
+
+static int overlap_scalar(int q, float x0, float y0, float x1, float y1, const RectBuffer& targets, std::vector<HitPair>& out) {
+	const float* min_x = targets.get_min_x();
+	const float* min_y = targets.get_min_y();
+	const float* max_x = targets.get_max_x();
+	const float* max_y = targets.get_max_y();
+	const int count = targets.get_count();
+	const size_t before = out.size();
+
+	for (int i = 0; i < count; i++) {
+		if (x0 < max_x[i] && min_x[i] < x1 && y0 < max_y[i] && min_y[i] < y1) {
+			out.push_back(HitPair{ q, i });
+		}
+	}
+	return (int)(out.size() - before);
+}
+
+#ifdef AABB_X86
+
+static inline int lowest_bit(unsigned mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return (int)index;
+#else
+	return __builtin_ctz(mask);
+#endif
+}
+
+AABB_TARGET("sse2")
+static int overlap_sse2(int q, float x0, float y0, float x1, float y1, const RectBuffer& targets, std::vector<HitPair>& out) {
+	const float* min_x = targets.get_min_x();
+	const float* min_y = targets.get_min_y();
+	const float* max_x = targets.get_max_x();
+	const float* max_y = targets.get_max_y();
+	const int padded = targets.get_padded_count();
+	const size_t before = out.size();
+
+	const __m128 qx0 = _mm_set1_ps(x0);
+	const __m128 qy0 = _mm_set1_ps(y0);
+	const __m128 qx1 = _mm_set1_ps(x1);
+	const __m128 qy1 = _mm_set1_ps(y1);
+
+	for (int i = 0; i < padded; i += 4) {
+		__m128 hit = _mm_and_ps(_mm_cmplt_ps(qx0, _mm_load_ps(max_x + i)), _mm_cmplt_ps(_mm_load_ps(min_x + i), qx1));
+		hit = _mm_and_ps(hit, _mm_cmplt_ps(qy0, _mm_load_ps(max_y + i)));
+		hit = _mm_and_ps(hit, _mm_cmplt_ps(_mm_load_ps(min_y + i), qy1));
+
+		unsigned mask = (unsigned)_mm_movemask_ps(hit);
+		while (mask) {
+			out.push_back(HitPair{ q, i + lowest_bit(mask) });
+			mask &= mask - 1;
+		}
+	}
+	return (int)(out.size() - before);
+}
+
+AABB_TARGET("avx2")
+static int overlap_avx2(int q, float x0, float y0, float x1, float y1, const RectBuffer& targets, std::vector<HitPair>& out) {
+	const float* min_x = targets.get_min_x();
+	const float* min_y = targets.get_min_y();
+	const float* max_x = targets.get_max_x();
+	const float* max_y = targets.get_max_y();
+	const int padded = targets.get_padded_count();
+	const size_t before = out.size();
+
+	const __m256 qx0 = _mm256_set1_ps(x0);
+	const __m256 qy0 = _mm256_set1_ps(y0);
+	const __m256 qx1 = _mm256_set1_ps(x1);
+	const __m256 qy1 = _mm256_set1_ps(y1);
+
+	for (int i = 0; i < padded; i += 8) {
+		__m256 hit = _mm256_and_ps(_mm256_cmp_ps(qx0, _mm256_load_ps(max_x + i), _CMP_LT_OQ), _mm256_cmp_ps(_mm256_load_ps(min_x + i), qx1, _CMP_LT_OQ));
+		hit = _mm256_and_ps(hit, _mm256_cmp_ps(qy0, _mm256_load_ps(max_y + i), _CMP_LT_OQ));
+		hit = _mm256_and_ps(hit, _mm256_cmp_ps(_mm256_load_ps(min_y + i), qy1, _CMP_LT_OQ));
+
+		unsigned mask = (unsigned)_mm256_movemask_ps(hit);
+		while (mask) {
+			out.push_back(HitPair{ q, i + lowest_bit(mask) });
+			mask &= mask - 1;
+		}
+	}
+	return (int)(out.size() - before);
+}
+
+static bool cpu_has(AabbIsa isa) {
+	if (isa == AABB_SCALAR) return true;
+#if defined(_MSC_VER) && !defined(__clang__)
+	int info[4];
+	__cpuid(info, 1);
+	bool sse2 = (info[3] >> 26) & 1;
+	bool osxsave = (info[2] >> 27) & 1;
+	bool avx = (info[2] >> 28) & 1;
+	if (isa == AABB_SSE2) return sse2;
+	if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) return false;
+	__cpuidex(info, 7, 0);
+	return (info[1] >> 5) & 1;
+#else
+	__builtin_cpu_init();
+	if (isa == AABB_SSE2) return __builtin_cpu_supports("sse2");
+	return __builtin_cpu_supports("avx2");
+#endif
+}
+
+static const OverlapFn KERNELS[AABB_ISA_COUNT] = { overlap_scalar, overlap_sse2, overlap_avx2 };
+
+#else
+
+static bool cpu_has(AabbIsa isa) {
+	return isa == AABB_SCALAR;
+}
+
+static const OverlapFn KERNELS[AABB_ISA_COUNT] = { overlap_scalar, overlap_scalar, overlap_scalar };
+
+#endif
+
+// ------------------ DISPATCH --------------------
+static AabbIsa detect_best() {
+	for (int isa = AABB_ISA_COUNT - 1; isa > AABB_SCALAR; isa--) {
+		if (cpu_has((AabbIsa)isa)) return (AabbIsa)isa;
+	}
+	return AABB_SCALAR;
+}
+
+static AabbIsa& active_isa() {
+	static AabbIsa isa = detect_best();
+	return isa;
+}
+
+AabbIsa AabbKernel::get_best_isa() {
+	static const AabbIsa best = detect_best();
+	return best;
+}
+
+AabbIsa AabbKernel::get_isa() {
+	return active_isa();
+}
+
+bool AabbKernel::set_isa(AabbIsa isa) {
+	if (isa >= AABB_ISA_COUNT || isa > get_best_isa()) return false;
+	active_isa() = isa;
+	return true;
+}
+
+const char* AabbKernel::get_isa_name(AabbIsa isa) {
+	static const char* NAMES[AABB_ISA_COUNT] = { "scalar", "sse2", "avx2" };
+	return isa < AABB_ISA_COUNT ? NAMES[isa] : "unknown";
+}
+
+int AabbKernel::overlap(int query_index, float min_x, float min_y, float max_x, float max_y, const RectBuffer& targets, std::vector<HitPair>& out) {
+	return KERNELS[active_isa()](query_index, min_x, min_y, max_x, max_y, targets, out);
+}
+
+int AabbKernel::overlap_all(const RectBuffer& queries, const RectBuffer& targets, std::vector<HitPair>& out) {
+	const OverlapFn kernel = KERNELS[active_isa()];
+	const float* min_x = queries.get_min_x();
+	const float* min_y = queries.get_min_y();
+	const float* max_x = queries.get_max_x();
+	const float* max_y = queries.get_max_y();
+
+	int found = 0;
+	for (int q = 0; q < queries.get_count(); q++) {
+		found += kernel(q, min_x[q], min_y[q], max_x[q], max_y[q], targets, out);
+	}
+	return found;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#ifndef AABB_KERNEL_H
+#define AABB_KERNEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace godot {
+
+    // ============================================================
+    // RECT BUFFER
+    // Axis-aligned rectangles as structure-of-arrays, 32-byte aligned
+    // and padded to LANES with empty rects (min > max) so the kernels
+    // always run whole vectors and padding can never overlap anything.
+    // ============================================================
+    class RectBuffer {
+    public:
+        static const int LANES = 8;
+
+        RectBuffer();
+        explicit RectBuffer(int capacity);
+        ~RectBuffer();
+
+        RectBuffer(const RectBuffer&) = delete;
+        RectBuffer& operator=(const RectBuffer&) = delete;
+
+        void reserve(int capacity);
+        void clear();
+        int add(float min_x, float min_y, float max_x, float max_y);
+
+        int get_count() const { return count; }
+        int get_padded_count() const { return (count + LANES - 1) / LANES * LANES; }
+
+        const float* get_min_x() const { return min_x; }
+        const float* get_min_y() const { return min_y; }
+        const float* get_max_x() const { return max_x; }
+        const float* get_max_y() const { return max_y; }
+
+    private:
+        int capacity;
+        int count;
+
+        void* block;
+        float* min_x;
+        float* min_y;
+        float* max_x;
+        float* max_y;
+
+        void pad_tail();
+    };
+
+    struct HitPair {
+        int32_t query;      // index into the query rects
+        int32_t target;     // index into the target buffer
+    };
+
+    // ============================================================
+    // OVERLAP KERNEL
+    // Tests query rects against a RectBuffer and appends every
+    // overlapping (query, target) pair, in query then target order,
+    // whatever the ISA. Strict inequalities: touching edges don't count.
+    // The best ISA the CPU supports is picked on first use; set_isa()
+    // forces a lower one (benchmarks, debugging).
+    // ============================================================
+    enum AabbIsa : uint8_t {
+        AABB_SCALAR,
+        AABB_SSE2,
+        AABB_AVX2,
+        AABB_ISA_COUNT
+    };
+
+    class AabbKernel {
+    public:
+        static AabbIsa get_best_isa();
+        static AabbIsa get_isa();
+        static bool set_isa(AabbIsa isa);       // false if the CPU can't run it
+        static const char* get_isa_name(AabbIsa isa);
+
+        // One query rect against every target; returns pairs appended
+        static int overlap(int query_index, float min_x, float min_y, float max_x, float max_y, const RectBuffer& targets, std::vector<HitPair>& out);
+
+        // Every query against every target
+        static int overlap_all(const RectBuffer& queries, const RectBuffer& targets, std::vector<HitPair>& out);
+    };
+
+} // namespace godot
+
+#endif
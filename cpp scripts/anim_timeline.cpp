@@ -0,0 +1,87 @@
+#include "anim_timeline.h"
+#include "frame_table.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace godot;
+
+AnimTimeline::AnimTimeline(int tick_rate) :
+		tick_rate(tick_rate) {}
+
+void AnimTimeline::clear() {
+	animations.clear();
+	frame_ends.clear();
+}
+
+int AnimTimeline::add_animation(float speed, bool loop, const float* durations, int count) {
+	Animation animation = {};
+	animation.first = (uint32_t)frame_ends.size();
+	animation.count = (uint16_t)count;
+	animation.loop = loop ? 1 : 0;
+
+	// speed 0 is a paused animation: hold each frame one tick so it still samples
+	double seconds_per_unit = speed > 0.0f ? 1.0 / speed : 1.0 / tick_rate;
+	uint32_t end = 0;
+	for (int f = 0; f < count; f++) {
+		long ticks = std::lround(durations[f] * seconds_per_unit * tick_rate);
+		end += (uint32_t)std::max(ticks, 1L);
+		frame_ends.push_back(end);
+	}
+	animation.length = end;
+
+	animations.push_back(animation);
+	return (int)animations.size() - 1;
+}
+
+int AnimTimeline::add_clip(float seconds, bool loop) {
+	float duration = seconds;
+	return add_animation(1.0f, loop, &duration, 1);
+}
+
+void AnimTimeline::build(const FrameTable& table) {
+	clear();
+
+	std::vector<float> durations;
+	for (int a = 0; a < table.get_animation_count(); a++) {
+		const FrameAnimationRecord& record = table.get_animation(a);
+
+		durations.resize(record.frame_count);
+		for (int f = 0; f < record.frame_count; f++) {
+			durations[f] = table.get_frame(a, f).duration;
+		}
+		add_animation(record.speed, record.loop != 0, durations.data(), record.frame_count);
+	}
+}
+
+int AnimTimeline::sample(const AnimState& state) const {
+	if (state.animation < 0 || state.animation >= (int)animations.size()) return 0;
+
+	const Animation& animation = animations[state.animation];
+	if (animation.count == 0) return 0;
+
+	uint32_t t = state.frame;
+	if (t >= animation.length) {
+		if (!animation.loop) return animation.count - 1;
+		t %= animation.length;
+	}
+
+	// Fighter animations are a dozen frames or so; upper_bound either way
+	const uint32_t* ends = frame_ends.data() + animation.first;
+	return (int)(std::upper_bound(ends, ends + animation.count, t) - ends);
+}
+
+bool AnimTimeline::is_finished(const AnimState& state) const {
+	if (state.animation < 0 || state.animation >= (int)animations.size()) return true;
+
+	const Animation& animation = animations[state.animation];
+	return !animation.loop && state.frame >= animation.length;
+}
+
+uint32_t AnimTimeline::get_pass_frame(const AnimState& state) const {
+	if (state.animation < 0 || state.animation >= (int)animations.size()) return 0;
+
+	const Animation& animation = animations[state.animation];
+	if (state.frame < animation.length) return state.frame;
+	return animation.loop ? state.frame % animation.length : animation.length;
+}
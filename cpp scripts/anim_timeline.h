@@ -0,0 +1,88 @@
+#pragma once
+
+#ifndef ANIM_TIMELINE_H
+#define ANIM_TIMELINE_H
+
+#include <cstdint>
+#include <vector>
+
+namespace godot {
+
+    class FrameTable;
+
+    // ============================================================
+    // ANIMATION STATE
+    // All a fighter stores about its animation: which one, and how
+    // many sim frames since it was entered. Two ints, copied with the
+    // rest of the sim state, so a rollback restores it for free and
+    // nothing render-side has to be rewound.
+    // ============================================================
+    struct AnimState {
+        int16_t animation = -1;
+        uint16_t reserved = 0;
+        uint32_t frame = 0;         // sim frames since entry
+
+        // Switch animation; re-entering the current one keeps counting
+        // (AnimatedSprite2D::play semantics)
+        void enter(int id) {
+            if (id == animation) return;
+            animation = (int16_t)id;
+            frame = 0;
+        }
+        void restart(int id) {
+            animation = (int16_t)id;
+            frame = 0;
+        }
+        void step() { frame++; }
+    };
+
+    // ============================================================
+    // ANIM TIMELINE
+    // Per-character frame timing, baked once into whole sim frames:
+    // each animation frame lasts round(duration / speed * tick_rate),
+    // at least one. Sampling is a pure function of AnimState, so the
+    // renderer asks "which frame now" instead of advancing its own
+    // clock, and "is the attack over" is a sim-side frame count rather
+    // than an animation_finished signal.
+    // ============================================================
+    class AnimTimeline {
+    public:
+        explicit AnimTimeline(int tick_rate = 60);
+
+        void clear();
+
+        // durations relative, as SpriteFrames; returns the animation id
+        int add_animation(float speed, bool loop, const float* durations, int count);
+        // Whole-clip animation (AnimationPlayer): one frame of `seconds`
+        int add_clip(float seconds, bool loop);
+        void build(const FrameTable& table);
+
+        int get_animation_count() const { return (int)animations.size(); }
+        int get_tick_rate() const { return tick_rate; }
+        uint32_t get_length(int id) const { return animations[id].length; }
+        bool is_looping(int id) const { return animations[id].loop != 0; }
+
+        // Frame index to show; non-looping animations hold their last frame
+        int sample(const AnimState& state) const;
+        // Non-looping and played through; never true for loops
+        bool is_finished(const AnimState& state) const;
+        // Sim frames into the current pass: wrapped for loops, clamped otherwise
+        uint32_t get_pass_frame(const AnimState& state) const;
+
+    private:
+        struct Animation {
+            uint32_t first;         // into frame_ends
+            uint16_t count;
+            uint8_t loop;
+            uint8_t reserved;
+            uint32_t length;        // sim frames for one pass
+        };
+
+        int tick_rate;
+        std::vector<Animation> animations;
+        std::vector<uint32_t> frame_ends;     // cumulative, per animation
+    };
+
+} // namespace godot
+
+#endif
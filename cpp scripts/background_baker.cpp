@@ -0,0 +1,503 @@
+// Offline baker for static stage tile layers.
+// Drop a BackgroundBaker node into an empty scene and run it once. It
+// instantiates `stage_scene`, groups its TileMapLayers into depth bands
+// (same parent, and no other canvas item whose z falls between them),
+// composites each band into chunk_size x chunk_size textures at the
+// band's finest texel size and writes:
+//   <output_dir>/<stage>_<band>_<cx>_<cy>.res   ImageTexture per chunk
+//   <output_scene>                              the stage with each band's
+//                                               layers replaced by one
+//                                               Sprite2D per chunk and
+//                                               their tile collision by
+//                                               one merged StaticBody2D
+//                                               per physics layer
+// Then it loads both scenes a few times and shows each for a few frames,
+// and prints load time, node count and canvas items / draw calls per
+// frame before and after.
+
+#include <Godot.hpp>
+#include <Node.hpp>
+#include <Node2D.hpp>
+#include <CanvasItem.hpp>
+#include <CanvasLayer.hpp>
+#include <PackedScene.hpp>
+#include <ResourceLoader.hpp>
+#include <ResourceSaver.hpp>
+#include <DirAccess.hpp>
+#include <TileMapLayer.hpp>
+#include <TileSet.hpp>
+#include <TileSetAtlasSource.hpp>
+#include <TileData.hpp>
+#include <Texture2D.hpp>
+#include <ImageTexture.hpp>
+#include <Image.hpp>
+#include <Sprite2D.hpp>
+#include <StaticBody2D.hpp>
+#include <CollisionPolygon2D.hpp>
+#include <Performance.hpp>
+#include <Time.hpp>
+
+#include "tile_collision.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace godot {
+
+    class BackgroundBaker : public Node {
+        GODOT_CLASS(BackgroundBaker, Node)
+
+    public:
+        static void _register_methods();
+
+        void _init() override;
+        void _ready() override;
+        void _process(double delta) override;
+
+        String stage_scene;
+        String output_scene;
+        String output_dir;
+        int chunk_size;
+        int measure_frames;
+        float collision_tolerance;
+
+    private:
+        struct Band {
+            Node* parent;
+            std::vector<TileMapLayer*> layers;     // back to front
+            int z_min;
+            int z_max;
+            float texel;                           // world units per baked texel
+            Rect2 bounds;
+        };
+
+        struct Chunk {
+            Vector2i coords;
+            Ref<Image> image;
+        };
+
+        struct Measure {
+            double load_msec = 0.0;
+            int nodes = 0;
+            int canvas_items = 0;
+            double objects = 0.0;
+            double draw_calls = 0.0;
+        };
+
+        // Measurement runs across frames: load, show, read the monitors
+        int phase;
+        int wait;
+        Node* shown;
+        Measure before;
+        Measure after;
+
+        std::unordered_map<int64_t, Ref<Image>> sheets;
+
+        bool bake();
+        void find_bands(Node* stage, std::vector<Band>& bands);
+        void composite(const Band& band, std::vector<Chunk>& chunks);
+        void add_collision(Node* root, TileMapLayer* layer);
+
+        Ref<Image> tile_image(TileMapLayer* layer, Vector2i cell, Rect2& world_rect);
+        Measure measure_load(const String& path);
+        void show_scene(const String& path);
+        void report();
+    };
+
+} // namespace godot
+
+using namespace godot;
+
+enum BakerPhase {
+	PHASE_DONE,
+	PHASE_SHOW_BEFORE,
+	PHASE_SHOW_AFTER,
+};
+
+static const int LOAD_REPEATS = 5;
+
+static int count_nodes(Node* node) {
+	int count = 1;
+	for (int i = 0; i < node->get_child_count(); i++) {
+		count += count_nodes(node->get_child(i));
+	}
+	return count;
+}
+
+// Canvas items the renderer walks: visible CanvasItem nodes, plus one per
+// TileMapLayer rendering quadrant (the layer draws through those, not itself)
+static int count_canvas_items(Node* node) {
+	int count = 0;
+	if (CanvasItem* item = Object::cast_to<CanvasItem>(node)) {
+		if (!item->is_visible()) return 0;
+
+		if (TileMapLayer* layer = Object::cast_to<TileMapLayer>(node)) {
+			int quadrant = std::max(layer->get_rendering_quadrant_size(), 1);
+			std::unordered_set<int64_t> quadrants;
+			TypedArray<Vector2i> cells = layer->get_used_cells();
+			for (int i = 0; i < cells.size(); i++) {
+				Vector2i cell = cells[i];
+				int64_t qx = (int64_t)std::floor((double)cell.x / quadrant);
+				int64_t qy = (int64_t)std::floor((double)cell.y / quadrant);
+				quadrants.insert(qx << 32 ^ (qy & 0xFFFFFFFF));
+			}
+			count += (int)quadrants.size();
+		} else {
+			count++;
+		}
+	}
+
+	for (int i = 0; i < node->get_child_count(); i++) {
+		count += count_canvas_items(node->get_child(i));
+	}
+	return count;
+}
+
+static void collect(Node* node, std::vector<TileMapLayer*>& layers, std::vector<CanvasItem*>& others) {
+	// UI on its own canvas layer can't sit between two world layers
+	if (Object::cast_to<CanvasLayer>(node)) return;
+
+	if (TileMapLayer* layer = Object::cast_to<TileMapLayer>(node)) {
+		if (layer->is_enabled() && layer->is_visible() && layer->get_tile_set().is_valid()) layers.push_back(layer);
+	} else if (CanvasItem* item = Object::cast_to<CanvasItem>(node)) {
+		others.push_back(item);
+	}
+
+	for (int i = 0; i < node->get_child_count(); i++) {
+		collect(node->get_child(i), layers, others);
+	}
+}
+
+void BackgroundBaker::_register_methods() {
+	register_method("_ready", &BackgroundBaker::_ready);
+	register_method("_process", &BackgroundBaker::_process);
+
+	register_property<BackgroundBaker, String>("stage_scene", &BackgroundBaker::stage_scene, "res://scenes/game_1.tscn");
+	register_property<BackgroundBaker, String>("output_scene", &BackgroundBaker::output_scene, "res://scenes/game_1_baked.tscn");
+	register_property<BackgroundBaker, String>("output_dir", &BackgroundBaker::output_dir, "res://assets/TILE SETS/baked");
+	register_property<BackgroundBaker, int>("chunk_size", &BackgroundBaker::chunk_size, 2048);
+	register_property<BackgroundBaker, int>("measure_frames", &BackgroundBaker::measure_frames, 10);
+	register_property<BackgroundBaker, float>("collision_tolerance", &BackgroundBaker::collision_tolerance, 0.5f);
+}
+
+void BackgroundBaker::_init() {
+	stage_scene = "res://scenes/game_1.tscn";
+	output_scene = "res://scenes/game_1_baked.tscn";
+	output_dir = "res://assets/TILE SETS/baked";
+	chunk_size = 2048;
+	measure_frames = 10;
+	collision_tolerance = 0.5f;
+
+	phase = PHASE_DONE;
+	wait = 0;
+	shown = nullptr;
+}
+
+void BackgroundBaker::_ready() {
+	if (!bake()) return;
+
+	before = measure_load(stage_scene);
+	after = measure_load(output_scene);
+
+	show_scene(stage_scene);
+	phase = PHASE_SHOW_BEFORE;
+}
+
+// ------------------ BANDS --------------------
+void BackgroundBaker::find_bands(Node* stage, std::vector<Band>& bands) {
+	std::vector<TileMapLayer*> layers;
+	std::vector<CanvasItem*> others;
+	for (int i = 0; i < stage->get_child_count(); i++) {
+		collect(stage->get_child(i), layers, others);
+	}
+
+	// Back to front; stable so equal z keeps tree order, as the renderer does
+	std::stable_sort(layers.begin(), layers.end(), [](TileMapLayer* a, TileMapLayer* b) {
+		return a->get_z_index() < b->get_z_index();
+	});
+
+	for (TileMapLayer* layer : layers) {
+		int z = layer->get_z_index();
+
+		bool joins = false;
+		if (!bands.empty() && bands.back().parent == layer->get_parent()) {
+			joins = true;
+			for (CanvasItem* item : others) {
+				if (item->get_z_index() >= bands.back().z_min && item->get_z_index() <= z) {
+					joins = false;
+					break;
+				}
+			}
+		}
+
+		if (!joins) {
+			Band band;
+			band.parent = layer->get_parent();
+			band.z_min = z;
+			band.texel = 0.0f;
+			bands.push_back(band);
+		}
+
+		Band& band = bands.back();
+		band.layers.push_back(layer);
+		band.z_max = z;
+
+		float scale = Math::abs(root_transform(layer).get_scale().x);
+		band.texel = band.texel > 0.0f ? std::min(band.texel, scale) : scale;
+	}
+}
+
+// ------------------ COMPOSITE --------------------
+Ref<Image> BackgroundBaker::tile_image(TileMapLayer* layer, Vector2i cell, Rect2& world_rect) {
+	Ref<TileSet> tile_set = layer->get_tile_set();
+	Ref<TileSetAtlasSource> atlas = tile_set->get_source(layer->get_cell_source_id(cell));
+	TileData* data = layer->get_cell_tile_data(cell);
+	if (atlas.is_null() || atlas->get_texture().is_null() || !data) return Ref<Image>();
+
+	Ref<Texture2D> texture = atlas->get_texture();
+	int64_t sheet_id = texture->get_instance_id();
+	if (sheets.find(sheet_id) == sheets.end()) {
+		Ref<Image> image = texture->get_image();
+		if (image->is_compressed()) image->decompress();
+		image->convert(Image::FORMAT_RGBA8);
+		sheets[sheet_id] = image;
+	}
+
+	Rect2i region = atlas->get_tile_texture_region(layer->get_cell_atlas_coords(cell));
+	Ref<Image> image = sheets[sheet_id]->get_region(region);
+	if (data->get_flip_h()) image->flip_x();
+	if (data->get_flip_v()) image->flip_y();
+	if (data->get_transpose()) {
+		WARN_PRINT("BackgroundBaker: transposed tiles are baked untransposed");
+	}
+
+	// Same placement as the tile renderer: centred on the cell, minus texture_origin
+	Vector2 size = region.size;
+	Vector2 local = layer->map_to_local(cell) - size * 0.5f - Vector2(data->get_texture_origin());
+	Transform2D transform = root_transform(layer);
+	world_rect = Rect2(transform.xform(local), size * transform.get_scale().abs());
+	return image;
+}
+
+void BackgroundBaker::composite(const Band& band, std::vector<Chunk>& chunks) {
+	std::unordered_map<int64_t, int> by_coords;
+	float chunk_world = chunk_size * band.texel;
+
+	for (TileMapLayer* layer : band.layers) {
+		TypedArray<Vector2i> cells = layer->get_used_cells();
+		float factor = Math::abs(root_transform(layer).get_scale().x) / band.texel;
+
+		for (int i = 0; i < cells.size(); i++) {
+			Rect2 world_rect;
+			Ref<Image> image = tile_image(layer, cells[i], world_rect);
+			if (image.is_null()) continue;
+
+			if (factor != 1.0f) {
+				image->resize((int)Math::round(image->get_width() * factor), (int)Math::round(image->get_height() * factor), Image::INTERPOLATE_NEAREST);
+			}
+
+			Vector2 offset = (world_rect.position - band.bounds.position) / band.texel;
+			Vector2i position((int)Math::round(offset.x), (int)Math::round(offset.y));
+			Rect2i source(Vector2i(), image->get_size());
+
+			int cx0 = (int)std::floor((world_rect.position.x - band.bounds.position.x) / chunk_world);
+			int cy0 = (int)std::floor((world_rect.position.y - band.bounds.position.y) / chunk_world);
+			int cx1 = (int)std::floor((world_rect.get_end().x - band.bounds.position.x - 0.001f) / chunk_world);
+			int cy1 = (int)std::floor((world_rect.get_end().y - band.bounds.position.y - 0.001f) / chunk_world);
+
+			for (int cy = std::max(cy0, 0); cy <= cy1; cy++) {
+				for (int cx = std::max(cx0, 0); cx <= cx1; cx++) {
+					int64_t key = (int64_t)cx << 32 | (uint32_t)cy;
+					auto found = by_coords.find(key);
+					if (found == by_coords.end()) {
+						Chunk chunk;
+						chunk.coords = Vector2i(cx, cy);
+						chunk.image = Image::create_empty(chunk_size, chunk_size, false, Image::FORMAT_RGBA8);
+						found = by_coords.emplace(key, (int)chunks.size()).first;
+						chunks.push_back(chunk);
+					}
+
+					// blend_rect clips to the chunk; layers go back to front
+					Vector2i origin = Vector2i(cx, cy) * chunk_size;
+					chunks[found->second].image->blend_rect(image, source, position - origin);
+				}
+			}
+		}
+	}
+}
+
+// ------------------ COLLISION --------------------
+// Tile collision, kept apart from the flattened visuals: one StaticBody2D
+// per physics layer holding every tile polygon in world space
+void BackgroundBaker::add_collision(Node* root, TileMapLayer* layer) {
+	if (!layer->is_collision_enabled()) return;
+
+	Ref<TileSet> tile_set = layer->get_tile_set();
+	Transform2D transform = root_transform(layer);
+
+	for (int physics = 0; physics < tile_set->get_physics_layers_count(); physics++) {
+		MergedCollision merged;
+		merge_tile_collision(layer, physics, transform, collision_tolerance, merged);
+
+		StaticBody2D* body = build_merged_body(merged,
+				tile_set->get_physics_layer_collision_layer(physics), tile_set->get_physics_layer_collision_mask(physics));
+		if (!body) continue;
+
+		body->set_name(String(layer->get_name()) + "_collision_" + String::num_int64(physics));
+		root->add_child(body);
+		body->set_owner(root);
+		for (int i = 0; i < body->get_child_count(); i++) {
+			body->get_child(i)->set_owner(root);
+		}
+	}
+}
+
+// ------------------ BAKE --------------------
+bool BackgroundBaker::bake() {
+	Ref<PackedScene> scene = ResourceLoader::get_singleton()->load(stage_scene);
+	ERR_FAIL_COND_V_MSG(scene.is_null(), false, "BackgroundBaker: cannot load " + stage_scene);
+
+	// Instanced outside the tree so none of the stage's scripts run
+	Node* root = scene->instantiate();
+	ERR_FAIL_COND_V(!root, false);
+	DirAccess::make_dir_recursive_absolute(output_dir);
+
+	std::vector<Band> bands;
+	find_bands(root, bands);
+	String stage_name = stage_scene.get_file().get_basename();
+
+	for (size_t b = 0; b < bands.size(); b++) {
+		Band& band = bands[b];
+
+		bool first = true;
+		for (TileMapLayer* layer : band.layers) {
+			TypedArray<Vector2i> cells = layer->get_used_cells();
+			for (int i = 0; i < cells.size(); i++) {
+				Rect2 world_rect;
+				if (tile_image(layer, cells[i], world_rect).is_null()) continue;
+				band.bounds = first ? world_rect : band.bounds.merge(world_rect);
+				first = false;
+			}
+		}
+		if (first) continue;
+
+		std::vector<Chunk> chunks;
+		composite(band, chunks);
+
+		Node2D* holder = memnew(Node2D);
+		holder->set_name("baked_band_" + String::num_int64(b));
+		holder->set_z_index(band.z_min);
+		band.parent->add_child(holder);
+		band.parent->move_child(holder, band.layers.front()->get_index());
+		holder->set_owner(root);
+		Transform2D to_holder = root_transform(holder).affine_inverse();
+
+		for (const Chunk& chunk : chunks) {
+			if (!chunk.image->get_used_rect().has_area()) continue;
+
+			String path = output_dir.path_join(stage_name + "_" + String::num_int64(b) + "_"
+					+ String::num_int64(chunk.coords.x) + "_" + String::num_int64(chunk.coords.y) + ".res");
+			Ref<ImageTexture> texture = ImageTexture::create_from_image(chunk.image);
+			ERR_CONTINUE_MSG(ResourceSaver::get_singleton()->save(texture, path) != OK, "BackgroundBaker: cannot write " + path);
+
+			Sprite2D* sprite = memnew(Sprite2D);
+			sprite->set_name("chunk_" + String::num_int64(chunk.coords.x) + "_" + String::num_int64(chunk.coords.y));
+			sprite->set_texture(ResourceLoader::get_singleton()->load(path));
+			sprite->set_centered(false);
+			sprite->set_texture_filter(band.layers.front()->get_texture_filter());
+			Vector2 world_position = band.bounds.position + Vector2(chunk.coords) * (chunk_size * band.texel);
+			sprite->set_transform(to_holder * Transform2D(0.0, Vector2(band.texel, band.texel), 0.0, world_position));
+			holder->add_child(sprite);
+			sprite->set_owner(root);
+		}
+
+		for (TileMapLayer* layer : band.layers) {
+			add_collision(root, layer);
+			layer->get_parent()->remove_child(layer);
+			memdelete(layer);
+		}
+
+		Godot::print("BackgroundBaker band " + String::num_int64(b) + ": z " + String::num_int64(band.z_min) + ".."
+				+ String::num_int64(band.z_max) + ", " + String::num_int64(holder->get_child_count()) + " chunk(s) at "
+				+ String::num(band.texel, 2) + " world units per texel");
+	}
+
+	// Saved as a scene of its own, not as an inherited one that can't drop the layers
+	root->set_scene_file_path("");
+	Ref<PackedScene> baked;
+	baked.instantiate();
+	Error packed = baked->pack(root);
+	root->free();
+	ERR_FAIL_COND_V_MSG(packed != OK, false, "BackgroundBaker: cannot pack the baked stage");
+	ERR_FAIL_COND_V_MSG(ResourceSaver::get_singleton()->save(baked, output_scene) != OK, false, "BackgroundBaker: cannot write " + output_scene);
+	return true;
+}
+
+// ------------------ MEASURE --------------------
+BackgroundBaker::Measure BackgroundBaker::measure_load(const String& path) {
+	Measure result;
+	std::vector<double> msec;
+
+	for (int r = 0; r < LOAD_REPEATS; r++) {
+		uint64_t start = Time::get_singleton()->get_ticks_usec();
+		Ref<PackedScene> scene = ResourceLoader::get_singleton()->load(path, "", ResourceLoader::CACHE_MODE_IGNORE_DEEP);
+		ERR_FAIL_COND_V(scene.is_null(), result);
+		Node* root = scene->instantiate();
+		msec.push_back(double(Time::get_singleton()->get_ticks_usec() - start) / 1000.0);
+
+		result.nodes = count_nodes(root);
+		result.canvas_items = count_canvas_items(root);
+		root->free();
+	}
+
+	std::sort(msec.begin(), msec.end());
+	result.load_msec = msec[msec.size() / 2];
+	return result;
+}
+
+void BackgroundBaker::show_scene(const String& path) {
+	if (shown) {
+		shown->queue_free();
+		shown = nullptr;
+	}
+
+	Ref<PackedScene> scene = ResourceLoader::get_singleton()->load(path);
+	ERR_FAIL_COND(scene.is_null());
+	shown = scene->instantiate();
+	add_child(shown);
+	wait = 0;
+}
+
+void BackgroundBaker::_process(double) {
+	if (phase == PHASE_DONE) return;
+	if (++wait < measure_frames) return;
+
+	Performance* performance = Performance::get_singleton();
+	Measure& target = phase == PHASE_SHOW_BEFORE ? before : after;
+	target.objects = performance->get_monitor(Performance::RENDER_TOTAL_OBJECTS_IN_FRAME);
+	target.draw_calls = performance->get_monitor(Performance::RENDER_TOTAL_DRAW_CALLS_IN_FRAME);
+
+	if (phase == PHASE_SHOW_BEFORE) {
+		show_scene(output_scene);
+		phase = PHASE_SHOW_AFTER;
+		return;
+	}
+
+	shown->queue_free();
+	shown = nullptr;
+	phase = PHASE_DONE;
+	report();
+}
+
+void BackgroundBaker::report() {
+	Godot::print("BackgroundBaker " + stage_scene.get_file() + " -> " + output_scene.get_file());
+	Godot::print("  load + instantiate " + String::num(before.load_msec, 2) + " ms -> " + String::num(after.load_msec, 2)
+			+ " ms (median of " + String::num_int64(LOAD_REPEATS) + ")");
+	Godot::print("  nodes " + String::num_int64(before.nodes) + " -> " + String::num_int64(after.nodes));
+	Godot::print("  canvas items " + String::num_int64(before.canvas_items) + " -> " + String::num_int64(after.canvas_items));
+	Godot::print("  per frame: objects " + String::num(before.objects, 0) + " -> " + String::num(after.objects, 0)
+			+ ", draw calls " + String::num(before.draw_calls, 0) + " -> " + String::num(after.draw_calls, 0));
+}
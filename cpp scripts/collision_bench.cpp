@@ -0,0 +1,258 @@
+// Physics step cost of per-tile collision vs merged tile collision.
+// Add a CollisionBench node to an empty scene and run it. It builds a
+// level of width_cells x height_cells 16 px tiles (solid ground, end walls
+// and scattered platforms, fixed seed), drops body_count bouncing
+// RigidBody2Ds onto it, and averages the physics process time over
+// measure_frames physics frames with the layer's own per-tile collision.
+// Then a TileCollisionMerger replaces it with merged rects, the same
+// bodies keep bouncing, and the average is taken again. Prints collider
+// counts, broadphase pairs and ms/step for both.
+
+#include <Godot.hpp>
+#include <Node2D.hpp>
+#include <TileMapLayer.hpp>
+#include <TileSet.hpp>
+#include <TileSetAtlasSource.hpp>
+#include <TileData.hpp>
+#include <Image.hpp>
+#include <ImageTexture.hpp>
+#include <RigidBody2D.hpp>
+#include <CollisionShape2D.hpp>
+#include <CircleShape2D.hpp>
+#include <PhysicsMaterial.hpp>
+#include <Performance.hpp>
+
+#include "tile_collision.h"
+
+#include <algorithm>
+
+namespace godot {
+
+    class CollisionBench : public Node2D {
+        GODOT_CLASS(CollisionBench, Node2D)
+
+    public:
+        static void _register_methods();
+
+        void _init() override;
+        void _ready() override;
+        void _physics_process(double delta) override;
+
+        int width_cells;
+        int height_cells;
+        int body_count;
+        int measure_frames;
+
+    private:
+        struct Measure {
+            double step_msec = 0.0;
+            double pairs = 0.0;
+            int colliders = 0;
+        };
+
+        int phase;
+        int frames;
+        uint32_t rng;
+        TileMapLayer* layer;
+        TileCollisionMerger* merger;
+        Measure tiles;
+        Measure merged;
+
+        float random_unit();
+        void build_level();
+        void spawn_bodies();
+        void sample(Measure& measure);
+        void report();
+    };
+
+} // namespace godot
+
+using namespace godot;
+
+enum CollisionBenchPhase {
+	PHASE_SETTLE_TILES,
+	PHASE_MEASURE_TILES,
+	PHASE_SETTLE_MERGED,
+	PHASE_MEASURE_MERGED,
+	PHASE_DONE,
+};
+
+static const int TILE_SIZE = 16;
+static const int SETTLE_FRAMES = 30;
+
+void CollisionBench::_register_methods() {
+	register_method("_ready", &CollisionBench::_ready);
+	register_method("_physics_process", &CollisionBench::_physics_process);
+
+	register_property<CollisionBench, int>("width_cells", &CollisionBench::width_cells, 2000);
+	register_property<CollisionBench, int>("height_cells", &CollisionBench::height_cells, 60);
+	register_property<CollisionBench, int>("body_count", &CollisionBench::body_count, 300);
+	register_property<CollisionBench, int>("measure_frames", &CollisionBench::measure_frames, 300);
+}
+
+void CollisionBench::_init() {
+	width_cells = 2000;
+	height_cells = 60;
+	body_count = 300;
+	measure_frames = 300;
+
+	phase = PHASE_DONE;
+	frames = 0;
+	rng = 0x9E3779B9u;
+	layer = nullptr;
+	merger = nullptr;
+}
+
+float CollisionBench::random_unit() {
+	rng ^= rng << 13;
+	rng ^= rng >> 17;
+	rng ^= rng << 5;
+	return (float)(rng & 0xFFFFFF) / (float)0x1000000;
+}
+
+// ------------------ SETUP --------------------
+void CollisionBench::build_level() {
+	Ref<Image> image = Image::create_empty(TILE_SIZE, TILE_SIZE, false, Image::FORMAT_RGBA8);
+	image->fill(Color(0.35f, 0.3f, 0.25f));
+
+	Ref<TileSetAtlasSource> atlas;
+	atlas.instantiate();
+	atlas->set_texture(ImageTexture::create_from_image(image));
+	atlas->set_texture_region_size(Vector2i(TILE_SIZE, TILE_SIZE));
+	atlas->create_tile(Vector2i(0, 0));
+
+	Ref<TileSet> tile_set;
+	tile_set.instantiate();
+	tile_set->set_tile_size(Vector2i(TILE_SIZE, TILE_SIZE));
+	tile_set->add_physics_layer();
+	tile_set->set_physics_layer_collision_layer(0, 1);
+	tile_set->add_source(atlas, 0);
+
+	// Full-square polygon, as the stage tilesets paint their solid tiles
+	float half = TILE_SIZE * 0.5f;
+	PackedVector2Array square;
+	square.push_back(Vector2(-half, -half));
+	square.push_back(Vector2(half, -half));
+	square.push_back(Vector2(half, half));
+	square.push_back(Vector2(-half, half));
+
+	TileData* data = atlas->get_tile_data(Vector2i(0, 0), 0);
+	data->add_collision_polygon(0);
+	data->set_collision_polygon_points(0, 0, square);
+
+	layer = memnew(TileMapLayer);
+	layer->set_name("Level");
+	layer->set_tile_set(tile_set);
+	add_child(layer);
+
+	int ground = height_cells - 4;
+	for (int x = 0; x < width_cells; x++) {
+		for (int y = ground; y < height_cells; y++) {
+			layer->set_cell(Vector2i(x, y), 0, Vector2i(0, 0));
+		}
+	}
+	for (int y = 0; y < ground; y++) {
+		layer->set_cell(Vector2i(0, y), 0, Vector2i(0, 0));
+		layer->set_cell(Vector2i(width_cells - 1, y), 0, Vector2i(0, 0));
+	}
+
+	int platforms = width_cells / 8;
+	for (int i = 0; i < platforms; i++) {
+		int length = 4 + (int)(random_unit() * 20.0f);
+		int x0 = 1 + (int)(random_unit() * (width_cells - length - 2));
+		int y = 8 + (int)(random_unit() * (ground - 12));
+		for (int x = x0; x < x0 + length; x++) {
+			layer->set_cell(Vector2i(x, y), 0, Vector2i(0, 0));
+		}
+	}
+}
+
+void CollisionBench::spawn_bodies() {
+	Ref<PhysicsMaterial> material;
+	material.instantiate();
+	material->set_bounce(1.0f);
+	material->set_friction(0.0f);
+
+	Ref<CircleShape2D> circle;
+	circle.instantiate();
+	circle->set_radius(6.0f);
+
+	float span_x = (width_cells - 2) * (float)TILE_SIZE;
+	float span_y = (height_cells - 8) * (float)TILE_SIZE;
+
+	for (int i = 0; i < body_count; i++) {
+		RigidBody2D* body = memnew(RigidBody2D);
+		body->set_physics_material_override(material);
+		body->set_can_sleep(false);
+
+		CollisionShape2D* shape = memnew(CollisionShape2D);
+		shape->set_shape(circle);
+		body->add_child(shape);
+
+		body->set_position(Vector2(TILE_SIZE + random_unit() * span_x, TILE_SIZE + random_unit() * span_y));
+		body->set_linear_velocity(Vector2(random_unit() * 400.0f - 200.0f, random_unit() * -200.0f));
+		add_child(body);
+	}
+}
+
+void CollisionBench::_ready() {
+	build_level();
+	spawn_bodies();
+
+	tiles.colliders = layer->get_used_cells().size();
+	phase = PHASE_SETTLE_TILES;
+	Godot::print("CollisionBench: " + String::num_int64(width_cells) + "x" + String::num_int64(height_cells)
+			+ " cells, " + String::num_int64(body_count) + " bodies");
+}
+
+// ------------------ MEASURE --------------------
+void CollisionBench::sample(Measure& measure) {
+	Performance* performance = Performance::get_singleton();
+	measure.step_msec += performance->get_monitor(Performance::TIME_PHYSICS_PROCESS) * 1000.0;
+	measure.pairs += performance->get_monitor(Performance::PHYSICS_2D_COLLISION_PAIRS);
+}
+
+void CollisionBench::_physics_process(double delta) {
+	switch (phase) {
+		case PHASE_SETTLE_TILES:
+		case PHASE_SETTLE_MERGED:
+			if (++frames < SETTLE_FRAMES) return;
+			frames = 0;
+			phase++;
+			return;
+
+		case PHASE_MEASURE_TILES:
+			sample(tiles);
+			if (++frames < measure_frames) return;
+
+			// Merger resolves ".." to us and swaps the layer's collision
+			merger = TileCollisionMerger::_new();
+			add_child(merger);
+			merged.colliders = merger->get_merged_shapes();
+
+			frames = 0;
+			phase = PHASE_SETTLE_MERGED;
+			return;
+
+		case PHASE_MEASURE_MERGED:
+			sample(merged);
+			if (++frames < measure_frames) return;
+
+			phase = PHASE_DONE;
+			report();
+			return;
+
+		default:
+			return;
+	}
+}
+
+void CollisionBench::report() {
+	double n = (double)std::max(measure_frames, 1);
+
+	Godot::print("  colliders " + String::num_int64(tiles.colliders) + " (per tile) -> "
+			+ String::num_int64(merged.colliders) + " (merged), " + String::num_int64(merger->get_bodies()) + " static bodies");
+	Godot::print("  pairs/step " + String::num(tiles.pairs / n, 1) + " -> " + String::num(merged.pairs / n, 1));
+	Godot::print("  physics step " + String::num(tiles.step_msec / n, 3) + " ms -> "
+			+ String::num(merged.step_msec / n, 3) + " ms, mean of " + String::num_int64(measure_frames) + " frames");
+}
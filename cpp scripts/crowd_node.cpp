@@ -0,0 +1,452 @@
+#include "crowd_node.h"
+
+#include <CollisionShape2D.hpp>
+#include <Shape2D.hpp>
+
+using namespace godot;
+
+// enemy.tscn "walk" frames in Milan Flare.png
+static const Rect2 WALK_REGIONS[CrowdSim::WALK_FRAMES] = {
+	Rect2(0, 187, 66, 129),
+	Rect2(81, 187, 68, 129),
+	Rect2(164, 187, 72, 129),
+	Rect2(249, 187, 72, 129),
+	Rect2(331, 187, 72, 129),
+	Rect2(403, 187, 72, 129),
+};
+
+// enemy.tscn RayCastRight / RayCastLeft target_position
+static const float PROBE_RIGHT = 26.0f;
+static const float PROBE_LEFT = -10.0f;
+
+// enemy.tscn "attack hitbox" capsule (r 24, h 114 at (9, 7)) as a rect
+static const Rect2 ENEMY_HURTBOX(-15.0f, -50.0f, 48.0f, 114.0f);
+
+// enemy.tscn "killzone" rect (43 x 102 at (7.5, 7))
+static const Rect2 ENEMY_KILLZONE(-14.0f, -44.0f, 43.0f, 102.0f);
+
+// Fighter body when a target has no CollisionShape2D to read
+static const Rect2 DEFAULT_BODY(-30.0f, -60.0f, 60.0f, 120.0f);
+
+CrowdNode::CrowdNode() {}
+CrowdNode::~CrowdNode() {}
+
+void CrowdNode::_register_methods() {
+	register_method("_ready", &CrowdNode::_ready);
+	register_method("_physics_process", &CrowdNode::_physics_process);
+	register_method("_process", &CrowdNode::_process);
+
+	register_method("spawn_enemy", &CrowdNode::spawn_enemy);
+	register_method("damage_enemy", &CrowdNode::damage_enemy);
+	register_method("despawn_enemy", &CrowdNode::despawn_enemy);
+	register_method("get_enemy_count", &CrowdNode::get_enemy_count);
+	register_method("queue_hit", &CrowdNode::queue_hit);
+	register_method("get_last_hit_count", &CrowdNode::get_last_hit_count);
+
+	register_property<CrowdNode, Ref<Texture2D>>("texture", &CrowdNode::texture, Ref<Texture2D>());
+	register_property<CrowdNode, int>("capacity", &CrowdNode::capacity, 10000);
+	register_property<CrowdNode, int>("bench_enemies", &CrowdNode::bench_enemies, 0);
+	register_property<CrowdNode, NodePath>("stage_path", &CrowdNode::stage_path, NodePath());
+	register_property<CrowdNode, int>("ray_collision_mask", &CrowdNode::ray_collision_mask, 4);
+	register_property<CrowdNode, float>("ray_cell_size", &CrowdNode::ray_cell_size, 4.0f);
+	register_property<CrowdNode, Array>("chase_targets", &CrowdNode::chase_targets, Array());
+	register_property<CrowdNode, float>("flow_cell_size", &CrowdNode::flow_cell_size, 16.0f);
+	register_property<CrowdNode, int>("flow_rebuild_ticks", &CrowdNode::flow_rebuild_ticks, 10);
+	register_property<CrowdNode, int>("flow_repair_radius", &CrowdNode::flow_repair_radius, 16);
+	register_property<CrowdNode, int>("contact_damage", &CrowdNode::contact_damage, 10);
+
+	register_signal<CrowdNode>("enemy_contact", "target", GODOT_VARIANT_TYPE_OBJECT, "enemy", GODOT_VARIANT_TYPE_INT);
+}
+
+void CrowdNode::_init() {
+	capacity = 10000;
+	bench_enemies = 0;
+	ray_collision_mask = 4;
+	ray_cell_size = 4.0f;
+	flow_cell_size = 16.0f;
+	flow_rebuild_ticks = 10;
+	flow_repair_radius = 16;
+	contact_damage = 10;
+	stage_baked = false;
+	flow_tick = 0;
+	last_hit_count = 0;
+	contact_tick = 0;
+	drawn = 0;
+
+	tick_usec = 0;
+	draw_usec = 0;
+	flow_usec = 0;
+	ticks = 0;
+	frames = 0;
+	window = 0.0;
+}
+
+void CrowdNode::_ready() {
+	sim.reset(new CrowdSim(MAX(capacity, bench_enemies)));
+	hurtboxes.reserve(sim->get_capacity());
+
+	bool flow_baked = false;
+	if (!stage_path.is_empty()) {
+		Node* stage = get_node_or_null(stage_path);
+		if (stage) {
+			// CrowdSim positions are local to this node, so bake the grids in local space too
+			Transform2D to_local = get_global_transform().affine_inverse();
+			stage_baked = bake_stage_collision(stage, ray_collision_mask, ray_cell_size, raycasts, to_local);
+			if (stage_baked && !chase_targets.is_empty()) {
+				flow_baked = bake_stage_collision(stage, ray_collision_mask, flow_cell_size, flow_service, to_local);
+			}
+		} else {
+			ERR_PRINT("CrowdNode: stage_path does not resolve, patrol rays disabled");
+		}
+	}
+
+	// Contacts need only the targets, the chase needs the flow grid as well
+	if (!chase_targets.is_empty()) {
+		bind_targets(flow_baked);
+	}
+
+	if (bench_enemies > 0) {
+		fill_bench();
+	}
+}
+
+// ------------------ ENEMIES --------------------
+int CrowdNode::spawn_enemy(Vector2 position, float min_x, float max_x, int health) {
+	ERR_FAIL_COND_V(!sim, CrowdSim::INVALID_ID);
+	return sim->spawn(position.x, position.y, min_x, max_x, health);
+}
+
+bool CrowdNode::damage_enemy(int id, int amount) {
+	ERR_FAIL_COND_V(!sim, false);
+	return sim->damage_id(id, amount);
+}
+
+void CrowdNode::despawn_enemy(int id) {
+	ERR_FAIL_COND(!sim);
+	sim->despawn_id(id);
+}
+
+int CrowdNode::get_enemy_count() const {
+	return sim ? sim->get_count() : 0;
+}
+
+void CrowdNode::queue_hit(Rect2 box, int damage) {
+	pending_hits.add(box.position.x, box.position.y, box.position.x + box.size.x, box.position.y + box.size.y);
+	pending_damage.push_back(damage);
+}
+
+void CrowdNode::fill_bench() {
+	// Rows of 900 px platforms, a few hundred enemies each
+	const float width = 900.0f;
+	const int per_platform = 250;
+
+	for (int i = 0; i < bench_enemies; i++) {
+		int platform = i / per_platform;
+		float left = (platform % 8) * (width + 200.0f);
+		float y = (platform / 8) * 160.0f;
+		float x = left + (float)((i * 37) % (int)width);
+		sim->spawn(x, y, left, left + width, 3, (i & 1) ? 1.0f : -1.0f);
+	}
+}
+
+// ------------------ TICK --------------------
+void CrowdNode::_physics_process(double delta) {
+	if (!sim) return;
+
+	uint64_t start = Time::get_singleton()->get_ticks_usec();
+	resolve_hits();
+	if (stage_baked) {
+		probe_patrol();
+	}
+	if (!fields.empty()) {
+		update_flow();
+	}
+	sim->tick((float)delta);
+	if (!targets.empty()) {
+		update_contacts();
+	}
+	tick_usec += Time::get_singleton()->get_ticks_usec() - start;
+	ticks++;
+}
+
+void CrowdNode::resolve_hits() {
+	last_hit_count = 0;
+	if (pending_hits.get_count() == 0) return;
+
+	const int count = sim->get_count();
+	const float* x = sim->get_x();
+	const float* y = sim->get_y();
+
+	hurtboxes.clear();
+	for (int i = 0; i < count; i++) {
+		float left = x[i] + ENEMY_HURTBOX.position.x;
+		float top = y[i] + ENEMY_HURTBOX.position.y;
+		hurtboxes.add(left, top, left + ENEMY_HURTBOX.size.x, top + ENEMY_HURTBOX.size.y);
+	}
+
+	// Pairs come out in (hit, enemy) order, so damage lands the same way every run
+	hit_pairs.clear();
+	last_hit_count = AabbKernel::overlap_all(pending_hits, hurtboxes, hit_pairs);
+
+	const int32_t* ids = sim->get_ids();
+	for (const HitPair& pair : hit_pairs) {
+		sim->damage_id(ids[pair.target], pending_damage[pair.query]);
+	}
+
+	pending_hits.clear();
+	pending_damage.clear();
+}
+
+void CrowdNode::probe_patrol() {
+	const int count = sim->get_count();
+	const float* x = sim->get_x();
+	const float* y = sim->get_y();
+	const float* direction = sim->get_direction();
+
+	// Only the ray in the facing direction can turn an enemy around
+	raycasts.begin(count);
+	for (int i = 0; i < count; i++) {
+		raycasts.add_ray(x[i], y[i], direction[i] > 0.0f ? PROBE_RIGHT : PROBE_LEFT, 0.0f);
+	}
+	raycasts.resolve();
+
+	sim->apply_blocked(raycasts.get_hits());
+}
+
+// ------------------ CHASE --------------------
+void CrowdNode::bind_targets(bool chase) {
+	for (int i = 0; i < chase_targets.size(); i++) {
+		Node2D* target = Object::cast_to<Node2D>(get_node_or_null(NodePath(chase_targets[i])));
+		if (!target) {
+			WARN_PRINT("CrowdNode: chase target " + String(chase_targets[i]) + " is not a Node2D, skipped");
+			continue;
+		}
+		targets.push_back(target->get_instance_id());
+
+		// The fighter's own body shape, as the killzone Area2D saw it
+		Rect2 body = DEFAULT_BODY;
+		CollisionShape2D* shape_node = Object::cast_to<CollisionShape2D>(target->get_node_or_null("CollisionShape2D"));
+		if (shape_node && shape_node->get_shape().is_valid()) {
+			body = shape_node->get_shape()->get_rect();
+			body.position += shape_node->get_position();
+		}
+		target_bodies.push_back(body);
+
+		// Owners past the last enemy id, so a body never shares one with an enemy
+		int owner = sim->get_capacity() + (int)target_volumes.size();
+		target_volumes.push_back(contacts.add(VOLUME_BODY, owner, 0.0f, 0.0f, 0.0f, 0.0f));
+	}
+
+	enemy_volumes.assign(sim->get_capacity(), -1);
+	enemy_seen.assign(sim->get_capacity(), 0);
+	if (chase) {
+		fields.resize(targets.size());
+	}
+}
+
+void CrowdNode::update_flow() {
+	uint64_t start = Time::get_singleton()->get_ticks_usec();
+	const OccupancyGrid& grid = flow_service.get_grid();
+	bool rebuild = flow_tick % MAX(flow_rebuild_ticks, 1) == 0;
+	flow_tick++;
+
+	// Fighters that were freed drop out of the chase
+	Transform2D to_local = get_global_transform().affine_inverse();
+	field_views.clear();
+	for (size_t t = 0; t < targets.size(); t++) {
+		Node2D* target = Object::cast_to<Node2D>(ObjectDB::get_instance(targets[t]));
+		if (!target) continue;
+
+		Vector2 position = to_local.xform(target->get_global_position());
+		int cx = grid.cell_x(position.x);
+		int cy = grid.cell_y(position.y);
+
+		// A fighter's origin can sit on the floor line; use the first free cell above
+		for (int up = 0; up < 4 && cy > 0 && grid.is_solid(cx, cy); up++) {
+			cy--;
+		}
+
+		if (rebuild) {
+			fields[t].build(grid, cx, cy);
+		} else {
+			fields[t].move_target(grid, cx, cy, flow_repair_radius);
+		}
+		field_views.push_back(&fields[t]);
+	}
+
+	sim->apply_flow(field_views.data(), (int)field_views.size());
+	flow_usec += Time::get_singleton()->get_ticks_usec() - start;
+}
+
+// ------------------ CONTACT --------------------
+void CrowdNode::update_contacts() {
+	const int count = sim->get_count();
+	const float* x = sim->get_x();
+	const float* y = sim->get_y();
+	const int32_t* ids = sim->get_ids();
+	contact_tick++;
+
+	for (int i = 0; i < count; i++) {
+		int id = ids[i];
+		float left = x[i] + ENEMY_KILLZONE.position.x;
+		float top = y[i] + ENEMY_KILLZONE.position.y;
+		float right = left + ENEMY_KILLZONE.size.x;
+		float bottom = top + ENEMY_KILLZONE.size.y;
+
+		if (enemy_volumes[id] < 0) {
+			enemy_volumes[id] = contacts.add(VOLUME_KILLZONE, id, left, top, right, bottom);
+			contact_enemies.push_back(id);
+		} else {
+			contacts.move(enemy_volumes[id], left, top, right, bottom);
+		}
+		enemy_seen[id] = contact_tick;
+	}
+
+	// Killed or despawned since the last tick
+	for (size_t k = 0; k < contact_enemies.size();) {
+		int id = contact_enemies[k];
+		if (enemy_seen[id] == contact_tick) {
+			k++;
+			continue;
+		}
+		contacts.remove(enemy_volumes[id]);
+		enemy_volumes[id] = -1;
+		contact_enemies[k] = contact_enemies.back();
+		contact_enemies.pop_back();
+	}
+
+	Transform2D to_local = get_global_transform().affine_inverse();
+	for (size_t t = 0; t < targets.size(); t++) {
+		Node2D* target = Object::cast_to<Node2D>(ObjectDB::get_instance(targets[t]));
+		bool alive = target && target->is_visible_in_tree();
+		contacts.set_enabled(target_volumes[t], alive);
+		if (!alive) continue;
+
+		Vector2 position = to_local.xform(target->get_global_position()) + target_bodies[t].position;
+		contacts.move(target_volumes[t], position.x, position.y,
+				position.x + target_bodies[t].size.x, position.y + target_bodies[t].size.y);
+	}
+
+	contacts.update();
+
+	// Events are sorted, so contact damage lands in the same order every run
+	for (const OverlapEvent& event : contacts.get_events()) {
+		if (!event.entered || event.type != OVERLAP_KILL) continue;
+
+		int enemy = contacts.get_owner(event.source);
+		int t = contacts.get_owner(event.target) - sim->get_capacity();
+		Node2D* target = Object::cast_to<Node2D>(ObjectDB::get_instance(targets[t]));
+		if (!target) continue;
+
+		emit_signal("enemy_contact", target, enemy);
+		if (contact_damage > 0 && target->has_method("take_damage")) {
+			int index = sim->index_of(enemy);
+			Vector2 from = index >= 0 ? to_global(Vector2(sim->get_x()[index], sim->get_y()[index])) : get_global_position();
+			target->call("take_damage", contact_damage, from);
+		}
+	}
+}
+
+void CrowdNode::_process(double delta) {
+	if (!sim) return;
+
+	uint64_t start = Time::get_singleton()->get_ticks_usec();
+	build_mesh();
+	draw_usec += Time::get_singleton()->get_ticks_usec() - start;
+	frames++;
+
+	if (bench_enemies <= 0) return;
+
+	window += delta;
+	if (window >= 1.0) {
+		Godot::print("CrowdNode: " + String::num_int64(sim->get_count()) + " enemies, "
+				+ String::num_int64(drawn) + " drawn, tick "
+				+ String::num(ticks ? double(tick_usec) / ticks : 0.0, 1) + " us, draw "
+				+ String::num(frames ? double(draw_usec) / frames : 0.0, 1) + " us, flow "
+				+ String::num(ticks ? double(flow_usec) / ticks : 0.0, 1) + " us, "
+				+ String::num_int64(frames) + " fps");
+		tick_usec = draw_usec = flow_usec = 0;
+		ticks = frames = 0;
+		window -= 1.0;
+	}
+}
+
+// ------------------ DRAW --------------------
+void CrowdNode::build_mesh() {
+	RenderingServer* rs = RenderingServer::get_singleton();
+	RID canvas_item = get_canvas_item();
+	rs->canvas_item_clear(canvas_item);
+
+	if (texture.is_null()) return;
+
+	const int count = sim->get_count();
+	const float* x = sim->get_x();
+	const float* y = sim->get_y();
+	const float* direction = sim->get_direction();
+
+	// Only what the camera sees, in this node's local space
+	Rect2 view = get_viewport_rect();
+	Transform2D to_local = (get_canvas_transform() * get_global_transform()).affine_inverse();
+	Rect2 visible = (to_local.xform(view)).grow(80.0f);
+
+	Vector2 texture_size = texture->get_size();
+	Vector2 uv_scale(1.0f / texture_size.x, 1.0f / texture_size.y);
+
+	points.resize(count * 4);
+	uvs.resize(count * 4);
+	colors.resize(count * 4);
+	Vector2* p = points.ptrw();
+	Vector2* uv = uvs.ptrw();
+	Color* c = colors.ptrw();
+
+	int quads = 0;
+	for (int i = 0; i < count; i++) {
+		if (!visible.has_point(Vector2(x[i], y[i]))) continue;
+
+		const Rect2& region = WALK_REGIONS[sim->get_walk_frame(i)];
+		Vector2 half = region.size * 0.5f;
+
+		// AnimatedSprite2D is centred; flip_h when walking left
+		float u0 = region.position.x * uv_scale.x;
+		float u1 = (region.position.x + region.size.x) * uv_scale.x;
+		if (direction[i] < 0.0f) {
+			float swap = u0;
+			u0 = u1;
+			u1 = swap;
+		}
+		float v0 = region.position.y * uv_scale.y;
+		float v1 = (region.position.y + region.size.y) * uv_scale.y;
+
+		int v = quads * 4;
+		p[v + 0] = Vector2(x[i] - half.x, y[i] - half.y);
+		p[v + 1] = Vector2(x[i] + half.x, y[i] - half.y);
+		p[v + 2] = Vector2(x[i] + half.x, y[i] + half.y);
+		p[v + 3] = Vector2(x[i] - half.x, y[i] + half.y);
+		uv[v + 0] = Vector2(u0, v0);
+		uv[v + 1] = Vector2(u1, v0);
+		uv[v + 2] = Vector2(u1, v1);
+		uv[v + 3] = Vector2(u0, v1);
+		c[v + 0] = c[v + 1] = c[v + 2] = c[v + 3] = Color(1, 1, 1, 1);
+		quads++;
+	}
+
+	drawn = quads;
+	if (quads == 0) return;
+
+	points.resize(quads * 4);
+	uvs.resize(quads * 4);
+	colors.resize(quads * 4);
+
+	// The index pattern is fixed; only quads beyond last frame need filling in
+	int old_quads = MIN(indices.size() / 6, quads);
+	indices.resize(quads * 6);
+	int32_t* out = indices.ptrw();
+	for (int q = old_quads; q < quads; q++) {
+		int32_t base = q * 4;
+		int32_t* tri = out + q * 6;
+		tri[0] = base; tri[1] = base + 1; tri[2] = base + 2;
+		tri[3] = base; tri[4] = base + 2; tri[5] = base + 3;
+	}
+
+	rs->canvas_item_add_triangle_array(canvas_item, indices, points, colors, uvs, PackedInt32Array(), PackedFloat32Array(), texture->get_rid());
+}
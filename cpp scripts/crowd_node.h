@@ -0,0 +1,140 @@
+#pragma once
+
+#ifndef CROWD_NODE_H
+#define CROWD_NODE_H
+
+#include <Godot.hpp>
+#include <Node2D.hpp>
+#include <Texture2D.hpp>
+#include <RenderingServer.hpp>
+#include <Time.hpp>
+
+#include "crowd_sim.h"
+#include "raycast_service.h"
+#include "aabb_kernel.h"
+#include "stage_collision.h"
+#include "flow_field.h"
+#include "spatial_hash.h"
+
+#include <memory>
+#include <vector>
+
+namespace godot {
+
+    // ============================================================
+    // CROWD NODE
+    // Owns a CrowdSim, ticks it on physics frames and draws every
+    // visible enemy as one textured triangle array using the enemy.tscn
+    // "walk" frames. Stands in for one enemy.tscn per PvE enemy.
+    // With bench_enemies > 0 it fills itself on _ready and prints tick
+    // and draw cost once a second.
+    // With stage_path set, the stage's tile collision and world
+    // boundaries are baked on _ready and every enemy's patrol ray is
+    // answered by one RaycastService pass per tick.
+    // Fighter hitboxes queued with queue_hit() are resolved against
+    // every enemy hurtbox in one AabbKernel pass before the tick.
+    // With chase_targets set as well, every enemy walks toward the
+    // nearest target along one shared FlowField per target, baked on a
+    // flow_cell_size grid: repaired around the target each tick it
+    // changes cell, rebuilt every flow_rebuild_ticks.
+    // Chase targets are also bodies in a SpatialHash against every
+    // enemy's killzone. An enemy that starts touching one emits
+    // "enemy_contact" and deals contact_damage through the target's
+    // take_damage(), as enemy.tscn's killzone Area2D did.
+    // ============================================================
+    class CrowdNode : public Node2D {
+        GODOT_CLASS(CrowdNode, Node2D)
+
+    public:
+        CrowdNode();
+        ~CrowdNode();
+
+        static void _register_methods();
+
+        void _init() override;
+        void _ready() override;
+        void _physics_process(double delta) override;
+        void _process(double delta) override;
+
+        // ============================================================
+        // SETTINGS
+        // ============================================================
+        Ref<Texture2D> texture;     // Milan Flare.png
+        int capacity;
+        int bench_enemies;
+        NodePath stage_path;
+        int ray_collision_mask;     // enemy.tscn RayCastRight/Left
+        float ray_cell_size;
+        Array chase_targets;        // NodePaths of Node2Ds (fighters)
+        float flow_cell_size;
+        int flow_rebuild_ticks;
+        int flow_repair_radius;     // in flow cells
+        int contact_damage;         // 0: only emit enemy_contact
+
+        // ============================================================
+        // ENEMIES
+        // ============================================================
+        int spawn_enemy(Vector2 position, float min_x, float max_x, int health);
+        bool damage_enemy(int id, int amount);
+        void despawn_enemy(int id);
+        int get_enemy_count() const;
+
+        // Box in this node's space; applied on the next physics tick
+        void queue_hit(Rect2 box, int damage);
+        int get_last_hit_count() const { return last_hit_count; }
+
+        CrowdSim* get_sim() const { return sim.get(); }
+        RaycastService& get_raycasts() { return raycasts; }
+        const FlowField* get_flow_field(int target) const { return &fields[target]; }
+
+    private:
+        std::unique_ptr<CrowdSim> sim;
+        RaycastService raycasts;
+        bool stage_baked;
+
+        RaycastService flow_service;        // only its grid is used
+        std::vector<uint64_t> targets;      // ObjectID
+        std::vector<FlowField> fields;      // per target
+        std::vector<const FlowField*> field_views;      // live targets only
+        int flow_tick;
+
+        RectBuffer hurtboxes;
+        RectBuffer pending_hits;
+        std::vector<int> pending_damage;
+        std::vector<HitPair> hit_pairs;
+        int last_hit_count;
+
+        SpatialHash contacts;               // enemy killzones vs target bodies
+        std::vector<int> enemy_volumes;     // enemy id -> volume, -1 when none
+        std::vector<uint32_t> enemy_seen;   // enemy id -> last contact tick it was alive
+        std::vector<int> contact_enemies;   // ids that have a volume
+        std::vector<int> target_volumes;    // per target
+        std::vector<Rect2> target_bodies;   // per target, around its origin
+        uint32_t contact_tick;
+
+        PackedVector2Array points;
+        PackedVector2Array uvs;
+        PackedColorArray colors;
+        PackedInt32Array indices;
+        int drawn;
+
+        // Bench counters, reset every second
+        uint64_t tick_usec;
+        uint64_t draw_usec;
+        uint64_t flow_usec;
+        int ticks;
+        int frames;
+        double window;
+
+        void fill_bench();
+        void probe_patrol();
+        void bind_targets(bool chase);
+        void update_flow();
+        void update_contacts();
+        void resolve_hits();
+        void build_mesh();
+    };
+
+} // namespace godot
+
+#endif
@@ -0,0 +1,177 @@
+#include "crowd_sim.h"
+#include "flow_field.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+using namespace godot;
+
+static const size_t ALIGNMENT = 32;
+static const int FIELD_COUNT = 8;
+
+static const float WALK_PERIOD = CrowdSim::WALK_FRAMES / CrowdSim::WALK_FPS;
+
+CrowdSim::CrowdSim(int capacity) :
+		count(0) {
+	// Padded so every loop can run whole LANES-wide blocks
+	this->capacity = (capacity + LANES - 1) / LANES * LANES;
+	size_t field_bytes = (size_t)this->capacity * 4;
+
+	block = ::operator new(field_bytes * FIELD_COUNT, std::align_val_t(ALIGNMENT));
+	memset(block, 0, field_bytes * FIELD_COUNT);
+
+	unsigned char* base = static_cast<unsigned char*>(block);
+	x = reinterpret_cast<float*>(base + field_bytes * 0);
+	y = reinterpret_cast<float*>(base + field_bytes * 1);
+	direction = reinterpret_cast<float*>(base + field_bytes * 2);
+	min_x = reinterpret_cast<float*>(base + field_bytes * 3);
+	max_x = reinterpret_cast<float*>(base + field_bytes * 4);
+	anim_time = reinterpret_cast<float*>(base + field_bytes * 5);
+	health = reinterpret_cast<int32_t*>(base + field_bytes * 6);
+	ids = reinterpret_cast<int32_t*>(base + field_bytes * 7);
+
+	id_slots.reserve(this->capacity);
+	free_ids.reserve(this->capacity);
+}
+
+CrowdSim::~CrowdSim() {
+	::operator delete(block, std::align_val_t(ALIGNMENT));
+}
+
+// ------------------ SPAWN --------------------
+int CrowdSim::spawn(float spawn_x, float spawn_y, float limit_min, float limit_max, int hp, float dir) {
+	if (count >= capacity) return INVALID_ID;
+
+	int id;
+	if (!free_ids.empty()) {
+		id = free_ids.back();
+		free_ids.pop_back();
+	} else {
+		id = (int)id_slots.size();
+		id_slots.push_back(-1);
+	}
+
+	int i = count++;
+	x[i] = spawn_x;
+	y[i] = spawn_y;
+	direction[i] = dir < 0.0f ? -1.0f : 1.0f;
+	min_x[i] = limit_min;
+	max_x[i] = limit_max;
+	// Spread the walk cycles so a wave doesn't step in lockstep
+	anim_time[i] = WALK_PERIOD * (float)(id % 17) / 17.0f;
+	health[i] = hp;
+	ids[i] = id;
+
+	id_slots[id] = i;
+	return id;
+}
+
+int CrowdSim::index_of(int id) const {
+	if (id < 0 || id >= (int)id_slots.size()) return -1;
+	return id_slots[id];
+}
+
+void CrowdSim::despawn_id(int id) {
+	int index = index_of(id);
+	if (index >= 0) remove_index(index);
+}
+
+void CrowdSim::remove_index(int index) {
+	int last = count - 1;
+	int id = ids[index];
+
+	if (index != last) {
+		x[index] = x[last];
+		y[index] = y[last];
+		direction[index] = direction[last];
+		min_x[index] = min_x[last];
+		max_x[index] = max_x[last];
+		anim_time[index] = anim_time[last];
+		health[index] = health[last];
+		ids[index] = ids[last];
+		id_slots[ids[index]] = index;
+	}
+
+	count--;
+	id_slots[id] = -1;
+	free_ids.push_back(id);
+}
+
+void CrowdSim::clear() {
+	count = 0;
+	id_slots.clear();
+	free_ids.clear();
+}
+
+void CrowdSim::set_patrol_limits(int index, float limit_min, float limit_max) {
+	min_x[index] = limit_min;
+	max_x[index] = limit_max;
+}
+
+void CrowdSim::apply_blocked(const uint8_t* blocked) {
+	float* __restrict pdir = direction;
+	for (int i = 0; i < count; i++) {
+		pdir[i] = blocked[i] ? -pdir[i] : pdir[i];
+	}
+}
+
+void CrowdSim::apply_flow(const FlowField* const* fields, int field_count) {
+	float* __restrict pdir = direction;
+	for (int i = 0; i < count; i++) {
+		const FlowField* best = nullptr;
+		uint32_t best_cost = FlowField::UNREACHABLE;
+		for (int f = 0; f < field_count; f++) {
+			uint32_t cost = fields[f]->get_cost_at(x[i], y[i]);
+			if (cost < best_cost) {
+				best_cost = cost;
+				best = fields[f];
+			}
+		}
+		if (!best) continue;
+
+		float dx, dy;
+		best->sample(x[i], y[i], dx, dy);
+		pdir[i] = dx > 0.0f ? 1.0f : (dx < 0.0f ? -1.0f : pdir[i]);
+	}
+}
+
+bool CrowdSim::damage_id(int id, int amount) {
+	int index = index_of(id);
+	if (index < 0 || health[index] <= 0) return false;
+
+	health[index] = std::max(health[index] - amount, 0);
+	return health[index] == 0;
+}
+
+// ------------------ TICK --------------------
+void CrowdSim::tick(float delta) {
+	const float step = SPEED * delta;
+
+	// Whole blocks: the padding past count is never read back
+	const int blocks = (count + LANES - 1) / LANES * LANES;
+
+	float* __restrict px = x;
+	float* __restrict pdir = direction;
+	float* __restrict panim = anim_time;
+	const float* __restrict plo = min_x;
+	const float* __restrict phi = max_x;
+
+	for (int i = 0; i < blocks; i++) {
+		float next = px[i] + pdir[i] * step;
+
+		// Turn around at either limit, same as a RayCast hit in enemy.gd
+		float dir = next > phi[i] ? -1.0f : pdir[i];
+		dir = next < plo[i] ? 1.0f : dir;
+		pdir[i] = dir;
+		px[i] = std::min(std::max(next, plo[i]), phi[i]);
+
+		float t = panim[i] + delta;
+		panim[i] = t >= WALK_PERIOD ? t - WALK_PERIOD : t;
+	}
+
+	// Dead enemies leave after their last tick; walk backwards so swaps stay valid
+	for (int i = count - 1; i >= 0; i--) {
+		if (health[i] <= 0) remove_index(i);
+	}
+}
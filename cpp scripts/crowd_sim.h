@@ -0,0 +1,94 @@
+#pragma once
+
+#ifndef CROWD_SIM_H
+#define CROWD_SIM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace godot {
+
+    class FlowField;
+
+    // ============================================================
+    // CROWD SIMULATION
+    // PvE enemies as structure-of-arrays: one packed float array per
+    // field, 32-byte aligned and padded to a multiple of LANES so the
+    // patrol loop compiles to straight vector code. Same behaviour as
+    // enemy.gd: walk at 45 px/s, turn around at the patrol limits (what
+    // RayCastLeft/RayCastRight detect), loop the 7 fps walk cycle.
+    // No engine calls; CrowdNode renders it.
+    // Indices are dense and change on despawn; ids are stable.
+    // ============================================================
+    class CrowdSim {
+    public:
+        static const int LANES = 8;
+        static const int INVALID_ID = -1;
+
+        static constexpr float SPEED = 45.0f;               // enemy.gd SPEED
+        static constexpr float WALK_FPS = 7.0f;             // "walk" animation speed
+        static const int WALK_FRAMES = 6;
+
+        explicit CrowdSim(int capacity);
+        ~CrowdSim();
+
+        CrowdSim(const CrowdSim&) = delete;
+        CrowdSim& operator=(const CrowdSim&) = delete;
+
+        int spawn(float x, float y, float min_x, float max_x, int health, float direction = 1.0f);
+        void despawn_id(int id);
+        void clear();
+
+        // Returns true when this hit killed it; dead enemies leave at the end of the next tick
+        bool damage_id(int id, int amount);
+
+        void tick(float delta);
+
+        int get_count() const { return count; }
+        int get_capacity() const { return capacity; }
+        int index_of(int id) const;
+
+        // Packed views, valid for get_count() entries until the next spawn/despawn/tick
+        const float* get_x() const { return x; }
+        const float* get_y() const { return y; }
+        const float* get_direction() const { return direction; }
+        const float* get_anim_time() const { return anim_time; }
+        const int32_t* get_health() const { return health; }
+        const int32_t* get_ids() const { return ids; }
+
+        int get_walk_frame(int index) const { return (int)(anim_time[index] * WALK_FPS) % WALK_FRAMES; }
+
+        void set_patrol_limits(int index, float min_x, float max_x);
+
+        // One patrol probe result per enemy, by index (RaycastService order); blocked ones turn around
+        void apply_blocked(const uint8_t* blocked);
+        // Chase: face along whichever field is cheapest from each enemy's
+        // cell. Only the x of the step is used (enemies walk, they don't
+        // climb); enemies on a vertical step, the target cell or off every
+        // field keep their direction. Patrol limits still apply in tick().
+        void apply_flow(const FlowField* const* fields, int field_count);
+
+    private:
+        int capacity;
+        int count;
+
+        void* block;
+        float* x;
+        float* y;
+        float* direction;
+        float* min_x;
+        float* max_x;
+        float* anim_time;
+        int32_t* health;
+        int32_t* ids;
+
+        std::vector<int> id_slots;      // id -> index, -1 when free
+        std::vector<int> free_ids;
+
+        void remove_index(int index);
+    };
+
+} // namespace godot
+
+#endif
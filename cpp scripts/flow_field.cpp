@@ -0,0 +1,178 @@
+#include "flow_field.h"
+#include "raycast_service.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+
+using namespace godot;
+
+// E, SE, S, SW, W, NW, N, NE; opposite of k is k ^ 4
+static const int DIR_X[8] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+static const int DIR_Y[8] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+static const float DIAGONAL = 0.70710678f;
+static const float STEP_X[10] = { 1.0f, DIAGONAL, 0.0f, -DIAGONAL, -1.0f, -DIAGONAL, 0.0f, DIAGONAL, 0.0f, 0.0f };
+static const float STEP_Y[10] = { 0.0f, DIAGONAL, 1.0f, DIAGONAL, 0.0f, -DIAGONAL, -1.0f, -DIAGONAL, 0.0f, 0.0f };
+
+static const int32_t NO_COST = INT32_MAX;
+static const int64_t MAX_BIAS = (int64_t)1 << 30;      // rebuild before stored costs get near int32 limits
+
+FlowField::FlowField() :
+		width(0),
+		height(0),
+		stride(2),
+		origin_x(0.0f),
+		origin_y(0.0f),
+		inv_cell_size(1.0f),
+		target_x(-1),
+		target_y(-1),
+		bias(0),
+		last_visited(0),
+		last_full(false) {}
+
+// ------------------ BUILD --------------------
+void FlowField::build(const OccupancyGrid& grid, int new_target_x, int new_target_y) {
+	width = grid.get_width();
+	height = grid.get_height();
+	stride = width + 2;
+	origin_x = grid.get_origin_x();
+	origin_y = grid.get_origin_y();
+	inv_cell_size = 1.0f / grid.get_cell_size();
+
+	size_t cells = (size_t)stride * (height + 2);
+	open.assign(cells, 0);
+	for (int cy = 0; cy < height; cy++) {
+		uint8_t* row = open.data() + padded(0, cy);
+		for (int cx = 0; cx < width; cx++) {
+			row[cx] = !grid.is_solid(cx, cy);
+		}
+	}
+	cost.assign(cells, NO_COST);
+	dirs.assign(cells, DIR_NONE);
+	bias = 0;
+	target_x = new_target_x;
+	target_y = new_target_y;
+	last_visited = 0;
+	last_full = true;
+
+	if (target_x < 0 || target_y < 0 || target_x >= width || target_y >= height) return;
+	if (!open[padded(target_x, target_y)]) return;
+
+	propagate(target_x, target_y, -1);
+}
+
+void FlowField::move_target(const OccupancyGrid& grid, int new_target_x, int new_target_y, int radius) {
+	last_visited = 0;
+	last_full = false;
+	if (new_target_x == target_x && new_target_y == target_y) return;
+
+	bool stale = !is_built() || width != grid.get_width() || height != grid.get_height();
+	bool outside = new_target_x < 0 || new_target_y < 0 || new_target_x >= width || new_target_y >= height;
+	bool far = std::max(std::abs(new_target_x - target_x), std::abs(new_target_y - target_y)) > radius;
+	if (stale || outside || far || cost[padded(new_target_x, new_target_y)] == NO_COST || bias > MAX_BIAS) {
+		build(grid, new_target_x, new_target_y);
+		return;
+	}
+
+	size_t old_index = padded(target_x, target_y);
+
+	// Raise everything by the old cost of the new cell: costs stay upper
+	// bounds on the new distances. The old target has no parent to
+	// follow, so it is cleared and must be reached again
+	bias += (int64_t)cost[padded(new_target_x, new_target_y)] + bias;
+	cost[old_index] = NO_COST;
+	dirs[old_index] = DIR_NONE;
+	target_x = new_target_x;
+	target_y = new_target_y;
+	propagate(target_x, target_y, radius);
+
+	// Walled off within the radius: chasers would stop on it
+	if (cost[old_index] == NO_COST) build(grid, target_x, target_y);
+}
+
+// Dial's algorithm: edge costs are 2 and 3, so buckets d, d+2 and d+3
+// never collide in a ring of four
+void FlowField::propagate(int seed_x, int seed_y, int radius) {
+	const int offset[8] = {
+		1, stride + 1, stride, stride - 1, -1, -stride - 1, -stride, -stride + 1,
+	};
+	const uint8_t* pass = open.data();
+	int32_t* pcost = cost.data();
+	uint8_t* pdir = dirs.data();
+
+	int seed = (int)padded(seed_x, seed_y);
+	pcost[seed] = (int32_t)(0 - bias);
+	pdir[seed] = DIR_TARGET;
+
+	for (std::vector<int>& bucket : buckets) {
+		bucket.clear();
+	}
+	buckets[0].push_back(seed);
+	size_t pending = 1;
+	int visited = 0;
+
+	for (int64_t d = 0; pending > 0; d++) {
+		std::vector<int>& bucket = buckets[d & 3];
+
+		for (size_t i = 0; i < bucket.size(); i++) {
+			int c = bucket[i];
+			pending--;
+			if ((int64_t)pcost[c] + bias != d) continue;      // settled cheaper already
+			visited++;
+
+			int cx = 0;
+			int cy = 0;
+			if (radius >= 0) {
+				cx = c % stride - 1;
+				cy = c / stride - 1;
+			}
+
+			for (int k = 0; k < 8; k++) {
+				int n = c + offset[k];
+				if (!pass[n]) continue;
+
+				bool diagonal = (k & 1) != 0;
+				if (diagonal && (!pass[c + DIR_X[k]] || !pass[c + DIR_Y[k] * stride])) continue;
+				if (radius >= 0 && std::max(std::abs(cx + DIR_X[k] - seed_x), std::abs(cy + DIR_Y[k] - seed_y)) > radius) continue;
+
+				int64_t next = d + (diagonal ? 3 : 2);
+				if (pcost[n] != NO_COST && (int64_t)pcost[n] + bias <= next) continue;
+
+				pcost[n] = (int32_t)(next - bias);
+				pdir[n] = (uint8_t)(k ^ 4);
+				buckets[next & 3].push_back(n);
+				pending++;
+			}
+		}
+		bucket.clear();
+	}
+
+	last_visited = visited;
+}
+
+// ------------------ SAMPLE --------------------
+int FlowField::cell_index(float x, float y) const {
+	int cx = (int)std::floor((x - origin_x) * inv_cell_size);
+	int cy = (int)std::floor((y - origin_y) * inv_cell_size);
+	if (cx < 0 || cy < 0 || cx >= width || cy >= height) return -1;
+	return (int)padded(cx, cy);
+}
+
+uint32_t FlowField::get_cost(int cell_x, int cell_y) const {
+	int32_t stored = cost[padded(cell_x, cell_y)];
+	return stored == NO_COST ? UNREACHABLE : (uint32_t)((int64_t)stored + bias);
+}
+
+void FlowField::sample(float x, float y, float& dx, float& dy) const {
+	int index = cell_index(x, y);
+	uint8_t dir = index < 0 ? DIR_NONE : dirs[index];
+	dx = STEP_X[dir];
+	dy = STEP_Y[dir];
+}
+
+uint32_t FlowField::get_cost_at(float x, float y) const {
+	int index = cell_index(x, y);
+	if (index < 0 || cost[index] == NO_COST) return UNREACHABLE;
+	return (uint32_t)((int64_t)cost[index] + bias);
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#ifndef FLOW_FIELD_H
+#define FLOW_FIELD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace godot {
+
+    class OccupancyGrid;
+
+    // ============================================================
+    // FLOW FIELD
+    // Shortest-path directions from every free cell of an OccupancyGrid
+    // to one target cell, so any number of chasers steer with one byte
+    // read each instead of a path search each.
+    // build() is a Dijkstra over 8-connected free cells (straight step
+    // 2, diagonal 3, no corner cutting) using a four-bucket queue, so it
+    // is linear in the cells reached. Each cell keeps the direction of
+    // the neighbour it was reached from. The grid is copied to one byte
+    // per cell with a solid border on build(), so the inner loop has no
+    // bounds checks; move_target() keeps using that copy.
+    // move_target() is the cheap per-tick update for a target that moved
+    // a cell or two: every cost goes up by the old cost of the new
+    // target cell (one add to `bias`, not a pass over the grid), then
+    // costs are lowered outward from the new cell, up to `radius` cells
+    // away. Following directions still strictly lowers the cost at
+    // every step, so chasers always arrive. Cells past the radius may
+    // take a detour via the old target until the next build().
+    // ============================================================
+    class FlowField {
+    public:
+        static constexpr uint8_t DIR_NONE = 8;          // solid, unreachable or outside
+        static constexpr uint8_t DIR_TARGET = 9;
+        static constexpr uint32_t UNREACHABLE = 0xFFFFFFFFu;
+
+        FlowField();
+
+        void build(const OccupancyGrid& grid, int target_x, int target_y);
+        // Falls back to build() when the repair can't reach (target was
+        // unreachable, or moved further than `radius`)
+        void move_target(const OccupancyGrid& grid, int target_x, int target_y, int radius);
+
+        bool is_built() const { return !dirs.empty(); }
+        int get_target_x() const { return target_x; }
+        int get_target_y() const { return target_y; }
+        int get_width() const { return width; }
+        int get_height() const { return height; }
+
+        uint8_t get_dir(int cell_x, int cell_y) const { return dirs[padded(cell_x, cell_y)]; }
+        uint32_t get_cost(int cell_x, int cell_y) const;
+
+        // O(1): unit step toward the target from a point in grid space,
+        // (0, 0) on the target cell, solid / unreachable cells and outside
+        void sample(float x, float y, float& dx, float& dy) const;
+        uint32_t get_cost_at(float x, float y) const;
+
+        int get_last_visited() const { return last_visited; }   // cells settled by the last update
+        bool was_rebuilt() const { return last_full; }          // last update was (or fell back to) build()
+
+    private:
+        int width;
+        int height;
+        int stride;                         // width + 2
+        float origin_x;
+        float origin_y;
+        float inv_cell_size;
+
+        int target_x;
+        int target_y;
+        int64_t bias;                       // added to every stored cost
+        std::vector<uint8_t> open;          // padded, 0 on the border
+        std::vector<int32_t> cost;          // padded, INT32_MAX: unreachable
+        std::vector<uint8_t> dirs;
+        std::vector<int> buckets[4];
+        int last_visited;
+        bool last_full;
+
+        size_t padded(int cell_x, int cell_y) const { return (size_t)(cell_y + 1) * stride + cell_x + 1; }
+        int cell_index(float x, float y) const;
+        void propagate(int seed_x, int seed_y, int radius);
+    };
+
+} // namespace godot
+
+#endif
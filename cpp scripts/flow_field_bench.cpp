@@ -0,0 +1,225 @@
+// Cost of chasing with shared flow fields instead of per-enemy paths.
+// Add a FlowFieldBench node to any scene and run it. Without stage_path
+// it lays out a synthetic level (level_cells_x * level_cells_y cells of
+// cell_size, scattered platforms and pillars); with stage_path it bakes
+// that stage's tile collision instead. It drops `enemies` CrowdSim
+// enemies on free cells, runs `ticks` physics ticks of `targets`
+// fighters walking the level, and prints the full rebuild time, the
+// per-tick repair time and cells touched, and the steering cost per
+// enemy per tick.
+
+#include <Godot.hpp>
+#include <Node.hpp>
+#include <Time.hpp>
+
+#include "crowd_sim.h"
+#include "flow_field.h"
+#include "raycast_service.h"
+#include "stage_collision.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace godot {
+
+    class FlowFieldBench : public Node {
+        GODOT_CLASS(FlowFieldBench, Node)
+
+    public:
+        static void _register_methods();
+
+        void _init() override;
+        void _ready() override;
+
+        NodePath stage_path;
+        int collision_mask;
+        float cell_size;
+        int level_cells_x;
+        int level_cells_y;
+        int enemies;
+        int targets;
+        int ticks;
+        int rebuild_ticks;
+        int repair_radius;
+        float target_speed;
+
+    private:
+        uint32_t rng;
+
+        RaycastService service;
+
+        float random_unit();
+        void lay_out(OccupancyGrid& grid);
+        void run();
+    };
+
+} // namespace godot
+
+using namespace godot;
+
+void FlowFieldBench::_register_methods() {
+	register_method("_ready", &FlowFieldBench::_ready);
+
+	register_property<FlowFieldBench, NodePath>("stage_path", &FlowFieldBench::stage_path, NodePath());
+	register_property<FlowFieldBench, int>("collision_mask", &FlowFieldBench::collision_mask, 4);
+	register_property<FlowFieldBench, float>("cell_size", &FlowFieldBench::cell_size, 16.0f);
+	register_property<FlowFieldBench, int>("level_cells_x", &FlowFieldBench::level_cells_x, 2000);
+	register_property<FlowFieldBench, int>("level_cells_y", &FlowFieldBench::level_cells_y, 200);
+	register_property<FlowFieldBench, int>("enemies", &FlowFieldBench::enemies, 5000);
+	register_property<FlowFieldBench, int>("targets", &FlowFieldBench::targets, 2);
+	register_property<FlowFieldBench, int>("ticks", &FlowFieldBench::ticks, 600);
+	register_property<FlowFieldBench, int>("rebuild_ticks", &FlowFieldBench::rebuild_ticks, 10);
+	register_property<FlowFieldBench, int>("repair_radius", &FlowFieldBench::repair_radius, 16);
+	register_property<FlowFieldBench, float>("target_speed", &FlowFieldBench::target_speed, 300.0f);
+}
+
+void FlowFieldBench::_init() {
+	collision_mask = 4;
+	cell_size = 16.0f;
+	level_cells_x = 2000;
+	level_cells_y = 200;
+	enemies = 5000;
+	targets = 2;
+	ticks = 600;
+	rebuild_ticks = 10;
+	repair_radius = 16;
+	target_speed = 300.0f;
+
+	rng = 0x9E3779B9u;
+}
+
+float FlowFieldBench::random_unit() {
+	rng ^= rng << 13;
+	rng ^= rng >> 17;
+	rng ^= rng << 5;
+	return (float)(rng & 0xFFFFFF) / (float)0x1000000;
+}
+
+// ------------------ SETUP --------------------
+void FlowFieldBench::lay_out(OccupancyGrid& grid) {
+	grid.reset(0.0f, 0.0f, cell_size, level_cells_x, level_cells_y);
+	float width = level_cells_x * cell_size;
+	float height = level_cells_y * cell_size;
+
+	// Floor, then one platform or pillar per ~40 cells of area
+	grid.fill_rect(0.0f, height - cell_size, width, height);
+	int pieces = level_cells_x * level_cells_y / 40;
+	for (int i = 0; i < pieces; i++) {
+		float x = random_unit() * width;
+		float y = random_unit() * (height - cell_size);
+		if (i % 5 == 0) {
+			grid.fill_rect(x, y, x + cell_size, y + cell_size * (2 + (int)(random_unit() * 6)));
+		} else {
+			grid.fill_rect(x, y, x + cell_size * (3 + (int)(random_unit() * 12)), y + cell_size);
+		}
+	}
+}
+
+void FlowFieldBench::_ready() {
+	if (!stage_path.is_empty()) {
+		Node* stage = get_node_or_null(stage_path);
+		ERR_FAIL_COND_MSG(!stage, "FlowFieldBench: stage_path does not resolve");
+		if (!bake_stage_collision(stage, collision_mask, cell_size, service)) return;
+	} else {
+		lay_out(service.get_grid());
+	}
+
+	const OccupancyGrid& grid = service.get_grid();
+	ERR_FAIL_COND_MSG(grid.get_width() == 0, "FlowFieldBench: empty grid");
+	Godot::print("FlowFieldBench: " + String::num_int64(grid.get_width()) + "x" + String::num_int64(grid.get_height())
+			+ " cells, " + String::num_int64(enemies) + " enemies, " + String::num_int64(targets) + " targets");
+	run();
+}
+
+// ------------------ RUN --------------------
+void FlowFieldBench::run() {
+	Time* time = Time::get_singleton();
+	const OccupancyGrid& grid = service.get_grid();
+	const float span_x = grid.get_width() * grid.get_cell_size();
+	const float span_y = grid.get_height() * grid.get_cell_size();
+	const float delta = 1.0f / 60.0f;
+
+	CrowdSim sim(enemies);
+	for (int placed = 0, tries = 0; placed < enemies && tries < enemies * 20; tries++) {
+		float x = grid.get_origin_x() + random_unit() * span_x;
+		float y = grid.get_origin_y() + random_unit() * span_y;
+		if (grid.is_solid_at(x, y)) continue;
+		sim.spawn(x, y, grid.get_origin_x(), grid.get_origin_x() + span_x, 3);
+		placed++;
+	}
+
+	// Fighters walk the level back and forth, climbing over whatever is in the way and dropping off edges
+	std::vector<FlowField> fields(MAX(targets, 1));
+	std::vector<const FlowField*> views;
+	std::vector<float> target_x;
+	std::vector<float> direction;
+	std::vector<int> target_row;
+	for (size_t t = 0; t < fields.size(); t++) {
+		views.push_back(&fields[t]);
+		target_x.push_back(grid.get_origin_x() + span_x * (t + 1) / (fields.size() + 1));
+		direction.push_back((t & 1) ? -1.0f : 1.0f);
+		target_row.push_back(grid.get_height() / 2);
+	}
+
+	uint64_t build_usec = 0;
+	uint64_t worst_build_usec = 0;
+	int builds = 0;
+	uint64_t repair_usec = 0;
+	uint64_t worst_repair_usec = 0;
+	int64_t repair_cells = 0;
+	int repairs = 0;
+	uint64_t steer_usec = 0;
+	int64_t steered = 0;
+
+	for (int tick = 0; tick < ticks; tick++) {
+		bool rebuild = tick % MAX(rebuild_ticks, 1) == 0;
+
+		for (size_t t = 0; t < fields.size(); t++) {
+			target_x[t] += direction[t] * target_speed * delta;
+			if (target_x[t] < grid.get_origin_x() || target_x[t] >= grid.get_origin_x() + span_x) {
+				direction[t] = -direction[t];
+				target_x[t] = std::min(std::max(target_x[t], grid.get_origin_x()), grid.get_origin_x() + span_x - 1.0f);
+			}
+			int cx = grid.cell_x(target_x[t]);
+			int cy = target_row[t];
+			while (cy > 0 && grid.is_solid(cx, cy)) cy--;
+			while (cy + 1 < grid.get_height() && !grid.is_solid(cx, cy + 1)) cy++;
+			target_row[t] = cy;
+
+			uint64_t start = time->get_ticks_usec();
+			if (rebuild) {
+				fields[t].build(grid, cx, cy);
+			} else {
+				fields[t].move_target(grid, cx, cy, repair_radius);
+			}
+			uint64_t usec = time->get_ticks_usec() - start;
+
+			if (fields[t].was_rebuilt()) {
+				build_usec += usec;
+				worst_build_usec = std::max(worst_build_usec, usec);
+				builds++;
+			} else {
+				repair_usec += usec;
+				worst_repair_usec = std::max(worst_repair_usec, usec);
+				repair_cells += fields[t].get_last_visited();
+				repairs++;
+			}
+		}
+
+		uint64_t start = time->get_ticks_usec();
+		sim.apply_flow(views.data(), (int)views.size());
+		steer_usec += time->get_ticks_usec() - start;
+		steered += sim.get_count();
+
+		sim.tick(delta);
+	}
+
+	Godot::print("  full rebuild " + String::num(builds ? build_usec / 1000.0 / builds : 0.0, 3) + " ms mean, "
+			+ String::num(worst_build_usec / 1000.0, 3) + " ms worst (" + String::num_int64(builds) + ")");
+	Godot::print("  repair " + String::num(repairs ? (double)repair_usec / repairs : 0.0, 1) + " us mean, "
+			+ String::num((double)worst_repair_usec, 1) + " us worst, "
+			+ String::num(repairs ? (double)repair_cells / repairs : 0.0, 0) + " cells (" + String::num_int64(repairs) + ")");
+	Godot::print("  steering " + String::num(steered ? steer_usec * 1000.0 / steered : 0.0, 1) + " ns/enemy, "
+			+ String::num(ticks ? (double)steer_usec / ticks : 0.0, 1) + " us/tick for "
+			+ String::num_int64(sim.get_count()) + " enemies");
+}
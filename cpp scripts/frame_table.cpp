@@ -0,0 +1,153 @@
+#include "frame_table.h"
+
+#include <cstring>
+
+using namespace godot;
+
+static size_t align4(size_t value) {
+	return (value + 3) & ~(size_t)3;
+}
+
+// ------------------ TABLE --------------------
+FrameTable::FrameTable() :
+		header(nullptr),
+		page_paths(nullptr),
+		animations(nullptr),
+		frames(nullptr),
+		boxes(nullptr),
+		strings(nullptr) {}
+
+FrameTable::~FrameTable() {
+	close();
+}
+
+bool FrameTable::open(const char* path) {
+	close();
+	if (!file.open(path)) return false;
+
+	if (!bind()) {
+		close();
+		return false;
+	}
+	return true;
+}
+
+void FrameTable::close() {
+	file.close();
+	header = nullptr;
+}
+
+bool FrameTable::bind() {
+	const uint8_t* data = file.get_data();
+	size_t size = file.get_size();
+	if (size < sizeof(FrameTableHeader)) return false;
+
+	const FrameTableHeader* h = reinterpret_cast<const FrameTableHeader*>(data);
+	if (h->magic != FRAME_TABLE_MAGIC || h->version != FRAME_TABLE_VERSION || h->lod_count == 0) return false;
+
+	size_t path_count = (size_t)h->page_count * h->lod_count;
+
+	size_t offset = sizeof(FrameTableHeader);
+	size_t pages_at = offset;
+	offset = align4(offset + path_count * sizeof(uint32_t));
+	size_t animations_at = offset;
+	offset += (size_t)h->animation_count * sizeof(FrameAnimationRecord);
+	size_t frames_at = offset;
+	offset += (size_t)h->frame_count * sizeof(FrameRecord);
+	size_t boxes_at = offset;
+	offset += (size_t)h->box_count * sizeof(FrameBox);
+	size_t strings_at = offset;
+	offset += h->strings_size;
+
+	if (offset > size || h->strings_size == 0 || data[strings_at + h->strings_size - 1] != 0) return false;
+
+	page_paths = reinterpret_cast<const uint32_t*>(data + pages_at);
+	animations = reinterpret_cast<const FrameAnimationRecord*>(data + animations_at);
+	frames = reinterpret_cast<const FrameRecord*>(data + frames_at);
+	boxes = reinterpret_cast<const FrameBox*>(data + boxes_at);
+	strings = reinterpret_cast<const char*>(data + strings_at);
+
+	// Every offset checked here, so lookups later are plain indexing
+	for (size_t p = 0; p < path_count; p++) {
+		if (page_paths[p] >= h->strings_size) return false;
+	}
+	for (uint32_t a = 0; a < h->animation_count; a++) {
+		const FrameAnimationRecord& animation = animations[a];
+		if (animation.name >= h->strings_size) return false;
+		if ((uint64_t)animation.first_frame + animation.frame_count > h->frame_count) return false;
+	}
+	for (uint32_t f = 0; f < h->frame_count; f++) {
+		const FrameRecord& frame = frames[f];
+		if (frame.page < -1 || frame.page >= (int)h->page_count) return false;
+		if ((uint64_t)frame.first_box + frame.box_count > h->box_count) return false;
+	}
+
+	header = h;
+	return true;
+}
+
+int FrameTable::find_animation(const char* name) const {
+	for (uint32_t a = 0; a < header->animation_count; a++) {
+		if (strcmp(strings + animations[a].name, name) == 0) return (int)a;
+	}
+	return -1;
+}
+
+// ------------------ WRITER --------------------
+uint32_t FrameTableWriter::add_string(const std::string& value) {
+	uint32_t offset = (uint32_t)strings.size();
+	strings += value;
+	strings.push_back('\0');
+	return offset;
+}
+
+void FrameTableWriter::add_page(const std::string& path) {
+	pages.push_back(add_string(path));
+}
+
+void FrameTableWriter::begin_animation(const std::string& name, float speed, bool loop) {
+	FrameAnimationRecord animation = {};
+	animation.name = add_string(name);
+	animation.first_frame = (uint32_t)frames.size();
+	animation.loop = loop ? 1 : 0;
+	animation.speed = speed;
+	animations.push_back(animation);
+}
+
+void FrameTableWriter::add_frame(const FrameRecord& frame, const FrameBox* frame_boxes, int count) {
+	FrameRecord record = frame;
+	record.first_box = (uint32_t)boxes.size();
+	record.box_count = (uint16_t)count;
+	frames.push_back(record);
+	boxes.insert(boxes.end(), frame_boxes, frame_boxes + count);
+
+	animations.back().frame_count++;
+}
+
+std::vector<uint8_t> FrameTableWriter::build() const {
+	FrameTableHeader header = {};
+	header.magic = FRAME_TABLE_MAGIC;
+	header.version = FRAME_TABLE_VERSION;
+	header.page_count = (uint16_t)(pages.size() / lod_count);
+	header.lod_count = (uint16_t)lod_count;
+	header.animation_count = (uint32_t)animations.size();
+	header.frame_count = (uint32_t)frames.size();
+	header.box_count = (uint32_t)boxes.size();
+	header.strings_size = (uint32_t)align4(strings.size() + 1);
+
+	std::vector<uint8_t> out;
+	auto append = [&](const void* bytes, size_t count) {
+		const uint8_t* begin = static_cast<const uint8_t*>(bytes);
+		out.insert(out.end(), begin, begin + count);
+	};
+
+	append(&header, sizeof(header));
+	append(pages.data(), pages.size() * sizeof(uint32_t));
+	out.resize(align4(out.size()), 0);
+	append(animations.data(), animations.size() * sizeof(FrameAnimationRecord));
+	append(frames.data(), frames.size() * sizeof(FrameRecord));
+	append(boxes.data(), boxes.size() * sizeof(FrameBox));
+	append(strings.data(), strings.size());
+	out.resize(out.size() + (header.strings_size - strings.size()), 0);
+	return out;
+}
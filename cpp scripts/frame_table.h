@@ -0,0 +1,155 @@
+#pragma once
+
+#ifndef FRAME_TABLE_H
+#define FRAME_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mapped_file.h"
+
+namespace godot {
+
+    // ============================================================
+    // FRAME TABLE FORMAT (.frames.bin)
+    // Little-endian, every section 4-byte aligned, in this order:
+    //   FrameTableHeader
+    //   uint32_t page_paths[lod_count][page_count]  offsets into strings
+    //   FrameAnimationRecord animations[animation_count]
+    //   FrameRecord frames[frame_count]             grouped by animation
+    //   FrameBox boxes[box_count]                   grouped by frame
+    //   char strings[strings_size]                  NUL-terminated
+    // Written by SpriteRepacker, read in place by FrameTable. Rects are
+    // in LOD 0 pixels; LOD n pages are 1/2^n scale and every rect is
+    // aligned so that x >> n etc. is exact on all of them.
+    // ============================================================
+    const uint32_t FRAME_TABLE_MAGIC = 0x4C425446;      // "FTBL"
+    const uint16_t FRAME_TABLE_VERSION = 2;
+
+    enum FrameBoxKind : uint8_t {
+        FRAME_BOX_HURT,
+        FRAME_BOX_HIT,
+    };
+
+    struct FrameTableHeader {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t page_count;
+        uint16_t lod_count;
+        uint16_t reserved;
+        uint32_t animation_count;
+        uint32_t frame_count;
+        uint32_t box_count;
+        uint32_t strings_size;
+    };
+
+    struct FrameAnimationRecord {
+        uint32_t name;              // strings offset
+        uint32_t first_frame;
+        uint16_t frame_count;
+        uint8_t loop;
+        uint8_t reserved;
+        float speed;                // SpriteFrames animation speed (fps)
+    };
+
+    // Packed rect on a page, and where it sits inside the untrimmed frame
+    struct FrameRecord {
+        int16_t page;               // -1: fully transparent frame
+        uint16_t x, y, width, height;
+        int16_t offset_x, offset_y;
+        uint16_t source_width, source_height;
+        uint16_t box_count;
+        uint32_t first_box;
+        float duration;             // relative, as SpriteFrames frame duration
+    };
+
+    // Sprite-local, unflipped, relative to the sprite's origin
+    struct FrameBox {
+        uint8_t kind;
+        uint8_t reserved;
+        int16_t x, y;
+        uint16_t width, height;
+        uint16_t reserved2;
+    };
+
+    static_assert(sizeof(FrameTableHeader) == 28, "FrameTableHeader layout");
+    static_assert(sizeof(FrameAnimationRecord) == 16, "FrameAnimationRecord layout");
+    static_assert(sizeof(FrameRecord) == 28, "FrameRecord layout");
+    static_assert(sizeof(FrameBox) == 12, "FrameBox layout");
+
+    // ============================================================
+    // FRAME TABLE
+    // One character's animations, memory-mapped read-only and used in
+    // place: lookups are pointer arithmetic into the mapping, nothing is
+    // copied or turned into Resources. open() validates every offset
+    // once so accessors don't have to.
+    // ============================================================
+    class FrameTable {
+    public:
+        FrameTable();
+        ~FrameTable();
+
+        FrameTable(const FrameTable&) = delete;
+        FrameTable& operator=(const FrameTable&) = delete;
+
+        // OS path (ProjectSettings::globalize_path for res://)
+        bool open(const char* path);
+        void close();
+        bool is_open() const { return header != nullptr; }
+        size_t get_size() const { return file.get_size(); }
+
+        int get_page_count() const { return header->page_count; }
+        int get_lod_count() const { return header->lod_count; }
+        const char* get_page_path(int page, int lod = 0) const { return strings + page_paths[lod * header->page_count + page]; }
+
+        int get_animation_count() const { return (int)header->animation_count; }
+        const FrameAnimationRecord& get_animation(int id) const { return animations[id]; }
+        const char* get_animation_name(int id) const { return strings + animations[id].name; }
+        int find_animation(const char* name) const;     // -1 if missing
+
+        int get_frame_count(int animation) const { return animations[animation].frame_count; }
+        const FrameRecord& get_frame(int animation, int index) const { return frames[animations[animation].first_frame + index]; }
+        const FrameBox* get_boxes(const FrameRecord& frame) const { return boxes + frame.first_box; }
+
+    private:
+        MappedFile file;
+
+        const FrameTableHeader* header;
+        const uint32_t* page_paths;
+        const FrameAnimationRecord* animations;
+        const FrameRecord* frames;
+        const FrameBox* boxes;
+        const char* strings;
+
+        bool bind();
+    };
+
+    // ============================================================
+    // FRAME TABLE WRITER
+    // ============================================================
+    class FrameTableWriter {
+    public:
+        // All LOD 0 pages first, then LOD 1 in the same order, ...
+        void add_page(const std::string& path);
+        void set_lod_count(int count) { lod_count = count; }
+        void begin_animation(const std::string& name, float speed, bool loop);
+        void add_frame(const FrameRecord& frame, const FrameBox* frame_boxes, int count);
+
+        std::vector<uint8_t> build() const;
+
+    private:
+        std::vector<uint32_t> pages;
+        int lod_count = 1;
+        std::vector<FrameAnimationRecord> animations;
+        std::vector<FrameRecord> frames;
+        std::vector<FrameBox> boxes;
+        std::string strings;
+
+        uint32_t add_string(const std::string& value);
+    };
+
+} // namespace godot
+
+#endif
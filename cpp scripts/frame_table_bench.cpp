@@ -0,0 +1,157 @@
+// Load cost of a fighter's animations: SpriteFrames scene vs frame table.
+// Run SpriteRepacker first, then add a FrameTableBench node to an empty
+// scene and run it. For each character it times loading + instantiating
+// the character scene (every AtlasTexture a SpriteFrames sub-resource)
+// against mapping <name>.frames.bin + loading its page textures, both
+// with the resource cache bypassed, and prints the number of live
+// Resources each leaves behind (the scene side also counts the
+// character's shapes and scripts, a handful next to the frames).
+
+#include <Godot.hpp>
+#include <Node.hpp>
+#include <PackedScene.hpp>
+#include <ResourceLoader.hpp>
+#include <Texture2D.hpp>
+#include <Performance.hpp>
+#include <ProjectSettings.hpp>
+#include <Time.hpp>
+
+#include "frame_table.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace godot {
+
+    class FrameTableBench : public Node {
+        GODOT_CLASS(FrameTableBench, Node)
+
+    public:
+        static void _register_methods();
+
+        void _init() override;
+        void _ready() override;
+
+        PackedStringArray character_scenes;
+        String table_dir;
+        int repeats;
+
+    private:
+        struct Sample {
+            double msec = 0.0;
+            int64_t resources = 0;
+        };
+
+        Sample load_scene(const String& path);
+        Sample load_table(const String& path, size_t& bytes, int& frames);
+    };
+
+} // namespace godot
+
+using namespace godot;
+
+static uint64_t now_usec() {
+	return Time::get_singleton()->get_ticks_usec();
+}
+
+static int64_t resource_count() {
+	return (int64_t)Performance::get_singleton()->get_monitor(Performance::OBJECT_RESOURCE_COUNT);
+}
+
+void FrameTableBench::_register_methods() {
+	register_method("_ready", &FrameTableBench::_ready);
+
+	PackedStringArray defaults;
+	defaults.push_back("res://scenes/player.tscn");
+	defaults.push_back("res://scenes/player_2.tscn");
+
+	register_property<FrameTableBench, PackedStringArray>("character_scenes", &FrameTableBench::character_scenes, defaults);
+	register_property<FrameTableBench, String>("table_dir", &FrameTableBench::table_dir, "res://assets/SPRITES/packed");
+	register_property<FrameTableBench, int>("repeats", &FrameTableBench::repeats, 10);
+}
+
+void FrameTableBench::_init() {
+	character_scenes.push_back("res://scenes/player.tscn");
+	character_scenes.push_back("res://scenes/player_2.tscn");
+	table_dir = "res://assets/SPRITES/packed";
+	repeats = 10;
+}
+
+// ------------------ SAMPLES --------------------
+FrameTableBench::Sample FrameTableBench::load_scene(const String& path) {
+	Sample sample;
+	int64_t before = resource_count();
+	uint64_t start = now_usec();
+
+	Ref<PackedScene> scene = ResourceLoader::get_singleton()->load(path, "", ResourceLoader::CACHE_MODE_IGNORE_DEEP);
+	ERR_FAIL_COND_V(scene.is_null(), sample);
+	Node* root = scene->instantiate();
+
+	sample.msec = double(now_usec() - start) / 1000.0;
+	sample.resources = resource_count() - before;
+
+	root->free();
+	return sample;
+}
+
+FrameTableBench::Sample FrameTableBench::load_table(const String& path, size_t& bytes, int& frames) {
+	Sample sample;
+	int64_t before = resource_count();
+	uint64_t start = now_usec();
+
+	FrameTable table;
+	String os_path = ProjectSettings::get_singleton()->globalize_path(path);
+	ERR_FAIL_COND_V_MSG(!table.open(os_path.utf8().get_data()), sample, "FrameTableBench: cannot open " + path);
+
+	std::vector<Ref<Texture2D>> pages;
+	for (int p = 0; p < table.get_page_count(); p++) {
+		pages.push_back(ResourceLoader::get_singleton()->load(String::utf8(table.get_page_path(p)), "", ResourceLoader::CACHE_MODE_IGNORE_DEEP));
+	}
+
+	sample.msec = double(now_usec() - start) / 1000.0;
+	sample.resources = resource_count() - before;
+
+	bytes = table.get_size();
+	frames = 0;
+	for (int a = 0; a < table.get_animation_count(); a++) {
+		frames += table.get_frame_count(a);
+	}
+	return sample;
+}
+
+// ------------------ RUN --------------------
+static double median(std::vector<double>& values) {
+	std::sort(values.begin(), values.end());
+	return values.empty() ? 0.0 : values[values.size() / 2];
+}
+
+void FrameTableBench::_ready() {
+	int runs = std::max(repeats, 1);
+
+	for (int i = 0; i < character_scenes.size(); i++) {
+		String scene_path = character_scenes[i];
+		String name = scene_path.get_file().get_basename();
+		String table_path = table_dir.path_join(name + ".frames.bin");
+
+		std::vector<double> scene_ms;
+		std::vector<double> table_ms;
+		Sample scene;
+		Sample table;
+		size_t bytes = 0;
+		int frames = 0;
+
+		// Interleaved so disk cache and clock drift hit both sides alike
+		for (int r = 0; r < runs; r++) {
+			scene = load_scene(scene_path);
+			table = load_table(table_path, bytes, frames);
+			scene_ms.push_back(scene.msec);
+			table_ms.push_back(table.msec);
+		}
+
+		Godot::print("FrameTableBench " + name + ": " + String::num_int64(frames) + " frames, table "
+				+ String::num(bytes / 1024.0, 1) + " KB");
+		Godot::print("  load " + String::num(median(scene_ms), 2) + " ms (scene) -> "
+				+ String::num(median(table_ms), 2) + " ms (frame table), median of " + String::num_int64(runs));
+		Godot::print("  resources " + String::num_int64(scene.resources) + " -> " + String::num_int64(table.resources));
+	}
+}
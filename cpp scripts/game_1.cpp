@@ -2,24 +2,42 @@
 
 using namespace godot;
 
-MatchManager::MatchManager() {}
-MatchManager::~MatchManager() {}
+MatchManager::MatchManager() {
+	GameplayTimers::set_singleton(&gameplay_timers);
+	MatchEventBus::set_singleton(&match_events);
+	sequencer.set_factory(&MatchManager::run_sequence, this);
+}
+
+MatchManager::~MatchManager() {
+	match_events.remove_listener(this);
+	if (MatchEventBus::get_singleton() == &match_events) {
+		MatchEventBus::set_singleton(nullptr);
+	}
+	if (GameplayTimers::get_singleton() == &gameplay_timers) {
+		GameplayTimers::set_singleton(nullptr);
+	}
+}
 
 void MatchManager::_register_methods() {
 	register_method("_ready", &MatchManager::_ready);
 	register_method("_process", &MatchManager::_process);
-	register_method("on_player_health_changed", &MatchManager::on_player_health_changed);
-	register_method("on_character_died", &MatchManager::on_character_died);
+	register_method("_physics_process", &MatchManager::_physics_process);
 	register_method("on_restart_button_pressed", &MatchManager::on_restart_button_pressed);
-	register_method("_on_round_timer_timeout", &MatchManager::_on_round_timer_timeout);
 
 	register_method("start_match", &MatchManager::start_match);
 	register_method("start_fight", &MatchManager::start_fight);
 	register_method("end_round", &MatchManager::end_round);
 	register_method("reset_round", &MatchManager::reset_round);
 	register_method("end_match", &MatchManager::end_match);
+	register_method("rematch", &MatchManager::rematch);
+	register_method("create_match_tween", &MatchManager::create_match_tween);
+	register_method("get_event_stats", &MatchManager::get_event_stats);
+	register_method("get_hud_stats", &MatchManager::get_hud_stats);
+	register_method("hash_match_state", &MatchManager::hash_match_state);
+	register_method("get_last_restart_usec", &MatchManager::get_last_restart_usec);
 
 	register_property<MatchManager, float>("speed", &MatchManager::speed, 0.1);
+	register_property<MatchManager, int>("round_seconds", &MatchManager::round_seconds, 60);
 }
 
 void MatchManager::_init() {
@@ -27,6 +45,12 @@ void MatchManager::_init() {
 	rounds_won_p1 = 0;
 	rounds_won_p2 = 0;
 	speed = 0.1;
+	round_seconds = 60;
+
+	last_restart_usec = 0;
+
+	position_x_path = NodePath("position:x");
+	modulate_a_path = NodePath("modulate:a");
 }
 
 void MatchManager::_ready() {
@@ -40,110 +64,228 @@ void MatchManager::_ready() {
 	round_counter_label = cast_to<Label>(get_node("UI/round_counter"));
 	match_state_msgs = cast_to<Label>(get_node("UI/match_state_msgs"));
 
-	round_timer = cast_to<Timer>(get_node("round_timer"));
-
 	victory_screen = cast_to<Panel>(get_node("UI/victory_screen"));
 	restart_button = cast_to<Button>(get_node("UI/victory_screen/restart_button"));
 
-	// Connect signals
-	player_1->get("health_changed").connect("health_changed", Callable(this, "on_player_health_changed"));
-	player_2->get("health_changed").connect("health_changed", Callable(this, "on_player_health_changed"));
+	camera_2d = cast_to<Camera2D>(get_node("camera_controller/Camera2D"));
+
+	hud.bind(health_bar_player_1, health_bar_player_2,
+			cast_to<ProgressBar>(health_bar_player_1->get_node_or_null("damage bar")),
+			cast_to<ProgressBar>(health_bar_player_2->get_node_or_null("damage bar")),
+			round_timer_label, round_counter_label, match_state_msgs);
+
+	// Both labels share the same font and size in game_1.tscn
+	if (hud_digits.build(round_timer_label->get_theme_font("font"), round_timer_label->get_theme_font_size("font_size"))) {
+		round_timer_digits.attach(round_timer_label, &hud_digits);
+		round_counter_digits.attach(round_counter_label, &hud_digits);
+		hud.bind_counters(&round_timer_digits, &round_counter_digits);
+	}
+
+	// Fighters report health and death by slot through the event bus
+	CharacterBody2D* fighters[2] = { player_1, player_2 };
+	for (int slot = 0; slot < 2; slot++) {
+		fighters[slot]->set("fighter_slot", slot);
+		HealthSystem* health = cast_to<HealthSystem>(fighters[slot]->get_node_or_null("health_system"));
+		if (health) {
+			health->set_fighter_slot(slot);
+		}
+	}
+	match_events.add_listener(this);
 
-	player_1->get("character_died").connect("character_died", Callable(this, "on_character_died"));
-	player_2->get("character_died").connect("character_died", Callable(this, "on_character_died"));
+	// Dispatch after the fighters have ticked
+	set_physics_process_priority(100);
 
 	restart_button->connect("pressed", Callable(this, "on_restart_button_pressed"));
 
-	health_bar_player_1->set_value(player_1->get("health"));
-	health_bar_player_2->set_value(player_2->get("health"));
+	fighter_health[0] = player_1->get("health");
+	fighter_health[1] = player_2->get("health");
+	health_bar_player_1->set_value(fighter_health[0]);
+	health_bar_player_2->set_value(fighter_health[1]);
 
 	victory_screen->set_visible(false);
+	hud.reset(fighter_health[0], fighter_health[1], match_state_msgs->is_visible());
+
+	initial_snapshot = capture_snapshot();
 
 	start_match();
 }
 
-void MatchManager::_process(double delta) {
+void MatchManager::_physics_process(double delta) {
+	gameplay_timers.advance();
+	sequencer.tick();
+	match_events.dispatch();
+
 	if (current_state == FIGHT) {
-		round_timer_label->set_text(String::num_int64(int(round_timer->get_time_left())));
+		int64_t elapsed = sequencer.get_elapsed(SEQUENCE_ROUND_CLOCK);
+		int64_t frames_left = elapsed < 0 ? 0 : MAX(int64_t(round_seconds) * 60 - elapsed, int64_t(0));
+		hud.set_round_seconds(int(frames_left / 60));
 	}
+	hud.tick();
+}
+
+void MatchManager::_process(double delta) {
+	hud.flush(delta);
 }
 
-// ------------------ PLAYER HEALTH --------------------
-void MatchManager::on_player_health_changed(int new_health, String character_id) {
-	if (character_id == player_1->get("character_name")) {
-		health_bar_player_1->set_value(new_health);
-	} else if (character_id == player_2->get("character_name")) {
-		health_bar_player_2->set_value(new_health);
+// ------------------ MATCH EVENTS --------------------
+void MatchManager::on_match_events(const MatchEvent* events, int count) {
+	for (int i = 0; i < count; i++) {
+		const MatchEvent& event = events[i];
+
+		switch (event.type) {
+			case EVENT_HEALTH_CHANGED:
+				if (event.slot < 2) {
+					fighter_health[event.slot] = event.value;
+					hud.set_health(event.slot, event.value);
+				}
+				break;
+			case EVENT_FIGHTER_DIED:
+				if (current_state == FIGHT) {
+					end_round();
+				}
+				break;
+			default:
+				break;
+		}
 	}
 }
 
-// ------------------ START MATCH --------------------
-void MatchManager::start_match() {
-	current_state = INTRO;
-	match_state_msgs->set_text("Round 1");
-	match_state_msgs->set_visible(true);
+Dictionary MatchManager::get_event_stats() {
+	const MatchEventStats& stats = match_events.get_stats();
+
+	Dictionary result;
+	result["ticks"] = (int64_t)stats.ticks;
+	result["total_events"] = (int64_t)stats.total_events;
+	result["dropped_events"] = (int64_t)stats.dropped_events;
+	result["last_tick_events"] = (int64_t)stats.last_tick_events;
+	result["max_tick_events"] = (int64_t)stats.max_tick_events;
+	result["last_dispatch_usec"] = (int64_t)stats.last_dispatch_usec;
+	result["max_dispatch_usec"] = (int64_t)stats.max_dispatch_usec;
+	result["avg_dispatch_usec"] = stats.ticks ? double(stats.total_dispatch_usec) / double(stats.ticks) : 0.0;
+	return result;
+}
+
+Dictionary MatchManager::get_hud_stats() {
+	const HudStats& stats = hud.get_stats();
 
-	Tween* tween = Tween::_new();
-	add_child(tween);
+	Dictionary result;
+	result["flushes"] = (int64_t)stats.flushes;
+	result["idle_flushes"] = (int64_t)stats.idle_flushes;
+	result["widget_updates"] = (int64_t)stats.widget_updates;
+	result["updates_per_second"] = (int64_t)stats.updates_per_second;
+	return result;
+}
 
-	tween->tween_property(player_1, "position:x", 1701.0, 1.0).from(1701.0);
-	tween->tween_property(player_2, "position:x", 2127.0, 1.0).from(2127.0);
+// ------------------ MATCH FLOW --------------------
+static SequenceTask intro_sequence(MatchSequencer& seq, MatchManager* match) {
+	match->hud.show_message(HUD_MESSAGE_ROUND, 1);
 
-	tween->tween_callback(Callable(this, "start_fight"));
+	co_await seq.tween(match->player_1, match->position_x_path, 1701.0, 1701.0, 60);
+	co_await seq.tween(match->player_2, match->position_x_path, 2127.0, 2127.0, 60);
+
+	match->start_fight();
 }
 
-// ------------------ ROUND TIMER --------------------
-void MatchManager::_on_round_timer_timeout() {
-	if (current_state == FIGHT) {
-		end_round();
+static SequenceTask fight_text_sequence(MatchSequencer& seq, MatchManager* match) {
+	match->hud.show_message(HUD_MESSAGE_FIGHT);
+
+	// Hide "Fight!" after 1 second
+	co_await seq.wait(60);
+	match->hud.hide_message();
+}
+
+static SequenceTask round_end_sequence(MatchSequencer& seq, MatchManager* match) {
+	co_await seq.wait(180);
+	match->reset_round();
+}
+
+// Ends a round nobody won by knockout; the clock stops itself by ending it
+static SequenceTask round_clock_sequence(MatchSequencer& seq, MatchManager* match) {
+	co_await seq.wait(uint32_t(match->round_seconds) * 60);
+
+	if (match->current_state == MatchManager::FIGHT) {
+		match->end_round();
+	}
+}
+
+static SequenceTask victory_sequence(MatchSequencer& seq, MatchManager* match) {
+	match->victory_screen->set_visible(true);
+	match->restart_button->set_visible(true);
+
+	co_await seq.tween(match->victory_screen, match->modulate_a_path, 0.0, 1.0, 48);
+}
+
+SequenceTask MatchManager::run_sequence(MatchSequencer& sequencer, void* owner, uint8_t script, int32_t arg) {
+	MatchManager* match = static_cast<MatchManager*>(owner);
+
+	switch (script) {
+		case SEQUENCE_INTRO:
+			return intro_sequence(sequencer, match);
+		case SEQUENCE_FIGHT_TEXT:
+			return fight_text_sequence(sequencer, match);
+		case SEQUENCE_ROUND_END:
+			return round_end_sequence(sequencer, match);
+		case SEQUENCE_ROUND_CLOCK:
+			return round_clock_sequence(sequencer, match);
+		case SEQUENCE_VICTORY:
+			return victory_sequence(sequencer, match);
 	}
+	return SequenceTask();
+}
+
+// ------------------ START MATCH --------------------
+void MatchManager::start_match() {
+	current_state = INTRO;
+	sequencer.start(SEQUENCE_INTRO);
 }
 
 // ------------------ START FIGHT --------------------
 void MatchManager::start_fight() {
 	current_state = FIGHT;
-	match_state_msgs->set_text("Fight!");
-
-	// Hide "Fight!" after 1 second
-	get_tree()->create_timer(1.0)->timeout.connect([this](){ match_state_msgs->set_visible(false); });
+	match_events.push(EVENT_ROUND_STARTED, MatchEvent::NO_SLOT, rounds_won_p1 + rounds_won_p2 + 1);
 
-	round_timer->start();
-}
+	// A restored sequence replaying its way here finds both in the snapshot already
+	if (!sequencer.is_catching_up()) {
+		sequencer.stop(SEQUENCE_FIGHT_TEXT);
+		sequencer.start(SEQUENCE_FIGHT_TEXT);
 
-// ------------------ CHARACTER DIED --------------------
-void MatchManager::on_character_died(String character_id) {
-	if (current_state == FIGHT) {
-		end_round();
+		sequencer.stop(SEQUENCE_ROUND_CLOCK);
+		sequencer.start(SEQUENCE_ROUND_CLOCK);
 	}
 }
 
 // ------------------ END ROUND --------------------
 void MatchManager::end_round() {
 	current_state = ROUND_END;
-	round_timer->stop();
+	sequencer.stop(SEQUENCE_ROUND_CLOCK);
 
-	if (player_1->get("health") > player_2->get("health")) {
+	int winner = MatchEvent::NO_SLOT;
+	if (fighter_health[0] > fighter_health[1]) {
+		winner = 0;
 		rounds_won_p1++;
-		match_state_msgs->set_text("Geralt Wins Round!");
-	} else if (player_2->get("health") > player_1->get("health")) {
+		hud.show_message(HUD_MESSAGE_ROUND_WINNER, 0);
+	} else if (fighter_health[1] > fighter_health[0]) {
+		winner = 1;
 		rounds_won_p2++;
-		match_state_msgs->set_text("Ciri Wins Round!");
+		hud.show_message(HUD_MESSAGE_ROUND_WINNER, 1);
 	} else {
-		match_state_msgs->set_text("Draw!");
+		hud.show_message(HUD_MESSAGE_DRAW);
 	}
+	match_events.push(EVENT_ROUND_ENDED, winner);
 
-	match_state_msgs->set_visible(true);
-	round_counter_label->set_text(String::num_int64(rounds_won_p1) + " - " + String::num_int64(rounds_won_p2));
+	hud.set_rounds_won(rounds_won_p1, rounds_won_p2);
 
 	if (rounds_won_p1 >= 2 || rounds_won_p2 >= 2) {
 		end_match();
 	} else {
-		get_tree()->create_timer(3.0)->timeout.connect(Callable(this, "reset_round"));
+		sequencer.start(SEQUENCE_ROUND_END);
 	}
 }
 
 // ------------------ RESET ROUND --------------------
 void MatchManager::reset_round() {
+	if (current_state != ROUND_END) return;
+
 	player_1->call("reset_stats");
 	player_2->call("reset_stats");
 
@@ -159,16 +301,161 @@ void MatchManager::reset_round() {
 // ------------------ END MATCH --------------------
 void MatchManager::end_match() {
 	current_state = MATCH_END;
-	victory_screen->set_visible(true);
-	restart_button->set_visible(true);
-
-	Tween* tween = Tween::_new();
-	add_child(tween);
-	victory_screen->set_modulate(Color(1,1,1,0));
-	tween->tween_property(victory_screen, "modulate:a", 1.0, 0.8);
+	match_events.push(EVENT_MATCH_ENDED, rounds_won_p1 > rounds_won_p2 ? 0 : 1);
+	sequencer.start(SEQUENCE_VICTORY);
 }
 
 // ------------------ RESTART BUTTON --------------------
 void MatchManager::on_restart_button_pressed() {
-	get_tree()->reload_current_scene();
+	rematch();
+}
+
+// ------------------ REMATCH --------------------
+Ref<Tween> MatchManager::create_match_tween() {
+	// Drop the ones that already finished so the list stays short
+	match_tweens.erase(std::remove_if(match_tweens.begin(), match_tweens.end(),
+			[](const Ref<Tween>& tween) { return !tween->is_valid(); }), match_tweens.end());
+
+	Ref<Tween> tween = create_tween();
+	match_tweens.push_back(tween);
+	return tween;
+}
+
+MatchManager::MatchSnapshot MatchManager::capture_snapshot() {
+	MatchSnapshot snapshot;
+
+	CharacterBody2D* players[2] = { player_1, player_2 };
+	for (int i = 0; i < 2; i++) {
+		snapshot.player_positions[i] = players[i]->get_position();
+		snapshot.player_facing[i] = cast_to<Node2D>(players[i]->get_node("facing_container"))->get_scale();
+	}
+	snapshot.health_bar_values[0] = health_bar_player_1->get_value();
+	snapshot.health_bar_values[1] = health_bar_player_2->get_value();
+
+	snapshot.round_timer_text = round_timer_label->get_text();
+	snapshot.round_counter_text = round_counter_label->get_text();
+	snapshot.match_state_text = match_state_msgs->get_text();
+	snapshot.match_state_visible = match_state_msgs->is_visible();
+
+	snapshot.victory_visible = victory_screen->is_visible();
+	snapshot.victory_modulate = victory_screen->get_modulate();
+
+	snapshot.camera_position = camera_2d->get_position();
+	snapshot.camera_zoom = camera_2d->get_zoom();
+
+	return snapshot;
+}
+
+void MatchManager::apply_snapshot(const MatchSnapshot& snapshot) {
+	CharacterBody2D* players[2] = { player_1, player_2 };
+	for (int i = 0; i < 2; i++) {
+		players[i]->set_position(snapshot.player_positions[i]);
+		cast_to<Node2D>(players[i]->get_node("facing_container"))->set_scale(snapshot.player_facing[i]);
+	}
+	health_bar_player_1->set_value(snapshot.health_bar_values[0]);
+	health_bar_player_2->set_value(snapshot.health_bar_values[1]);
+
+	round_timer_label->set_text(snapshot.round_timer_text);
+	round_counter_label->set_text(snapshot.round_counter_text);
+	match_state_msgs->set_text(snapshot.match_state_text);
+	match_state_msgs->set_visible(snapshot.match_state_visible);
+
+	victory_screen->set_visible(snapshot.victory_visible);
+	victory_screen->set_modulate(snapshot.victory_modulate);
+
+	camera_2d->set_position(snapshot.camera_position);
+	camera_2d->set_zoom(snapshot.camera_zoom);
+}
+
+// Fighters and health systems may be scripts or native classes, so read them through calls
+static int fighter_health_of(Node* fighter) {
+	if (fighter->has_method("get_health")) return fighter->call("get_health");
+	return fighter->get("health");
+}
+
+static int fighter_state_of(Node* fighter) {
+	if (fighter->has_method("get_fighter_state")) return fighter->call("get_fighter_state");
+	return resolve_fighter_state(fighter_health_of(fighter) <= 0, fighter->get("is_knocked_down"), fighter->get("is_stunned"),
+			fighter->get("is_attacking"), fighter->get("is_blocking"), fighter->get("is_crouching"));
+}
+
+int64_t MatchManager::hash_match_state() {
+	MatchSnapshot snapshot = capture_snapshot();
+
+	Array state;
+	state.append(current_state);
+	state.append(rounds_won_p1);
+	state.append(rounds_won_p2);
+	state.append(sequencer.is_running(SEQUENCE_ROUND_CLOCK));
+
+	CharacterBody2D* players[2] = { player_1, player_2 };
+	for (int i = 0; i < 2; i++) {
+		state.append(snapshot.player_positions[i]);
+		state.append(snapshot.player_facing[i]);
+		state.append(snapshot.health_bar_values[i]);
+		state.append(fighter_health_of(players[i]));
+		state.append(fighter_state_of(players[i]));
+		state.append(fighter_health[i]);
+		Node* health = players[i]->get_node_or_null("health_system");
+		state.append(health ? health->call("get_health") : Variant());
+		state.append(players[i]->get_velocity());
+		state.append(players[i]->is_visible());
+	}
+
+	state.append(snapshot.round_timer_text);
+	state.append(snapshot.round_counter_text);
+	state.append(snapshot.match_state_text);
+	state.append(snapshot.match_state_visible);
+	state.append(snapshot.victory_visible);
+	state.append(snapshot.victory_modulate);
+	state.append(snapshot.camera_position);
+	state.append(snapshot.camera_zoom);
+	state.append((int64_t)gameplay_timers.save_state().hash(0));
+	state.append(sequencer.get_running_count());
+
+	return state.hash();
+}
+
+void MatchManager::rematch() {
+	uint64_t start_usec = Time::get_singleton()->get_ticks_usec();
+
+	sequencer.stop_all();
+	match_events.clear();
+
+	// Sequence tweens stop with the sequencer, engine ones made for the match here
+	for (Ref<Tween>& tween : match_tweens) {
+		if (tween->is_valid()) {
+			tween->kill();
+		}
+	}
+	match_tweens.clear();
+
+	current_state = IDLE;
+	rounds_won_p1 = 0;
+	rounds_won_p2 = 0;
+
+	// Immortality still pending from the last match must not end in this one
+	CharacterBody2D* players[2] = { player_1, player_2 };
+	for (CharacterBody2D* player : players) {
+		Node* health = player->get_node_or_null("health_system");
+		if (health && health->has_method("cancel_temporary_immortality")) {
+			health->call("cancel_temporary_immortality");
+		}
+	}
+
+	player_1->call("reset_stats");
+	player_2->call("reset_stats");
+	player_1->show();
+	player_2->show();
+
+	apply_snapshot(initial_snapshot);
+	hud.reset((int)initial_snapshot.health_bar_values[0], (int)initial_snapshot.health_bar_values[1], initial_snapshot.match_state_visible);
+
+	last_restart_usec = Time::get_singleton()->get_ticks_usec() - start_usec;
+
+	start_match();
+}
+
+int64_t MatchManager::get_last_restart_usec() {
+	return last_restart_usec;
 }
@@ -0,0 +1,82 @@
+#include "gameplay_timers.h"
+
+using namespace godot;
+
+GameplayTimers* GameplayTimers::singleton = nullptr;
+
+TimerListener::~TimerListener() {
+	if (GameplayTimers* timers = GameplayTimers::get_singleton()) {
+		timers->remove_listener(this);
+	}
+}
+
+GameplayTimers::GameplayTimers() {
+	for (int i = 0; i < MAX_LISTENERS; i++) {
+		listeners[i] = nullptr;
+		listener_generations[i] = 0;
+	}
+}
+
+GameplayTimers* GameplayTimers::get_singleton() {
+	return singleton;
+}
+
+void GameplayTimers::set_singleton(GameplayTimers* timers) {
+	singleton = timers;
+}
+
+// ------------------ LISTENERS --------------------
+uint16_t GameplayTimers::add_listener(TimerListener* listener) {
+	for (int i = 0; i < MAX_LISTENERS; i++) {
+		if (!listeners[i]) {
+			listeners[i] = listener;
+			listener->timer_listener_id = (uint16_t)i;
+			return (uint16_t)i;
+		}
+	}
+
+	ERR_PRINT("GameplayTimers: out of listener slots");
+	return 0xFFFF;
+}
+
+void GameplayTimers::remove_listener(TimerListener* listener) {
+	uint16_t id = listener->timer_listener_id;
+	if (id < MAX_LISTENERS && listeners[id] == listener) {
+		listeners[id] = nullptr;
+		listener_generations[id]++;
+	}
+	listener->timer_listener_id = 0xFFFF;
+}
+
+// ------------------ SCHEDULE --------------------
+TimerHandle GameplayTimers::schedule(TimerListener* listener, float seconds, GameplayTimerKind kind, int32_t arg) {
+	if (listener->timer_listener_id >= MAX_LISTENERS) {
+		if (add_listener(listener) >= MAX_LISTENERS) return TimerHandle();
+	}
+
+	TimerEvent event;
+	event.kind = kind;
+	uint16_t id = listener->timer_listener_id;
+	event.target = (uint16_t)(id | ((listener_generations[id] & 0x3FF) << LISTENER_BITS));
+	event.arg = arg;
+
+	int64_t ticks_per_second = Engine::get_singleton()->get_physics_ticks_per_second();
+	uint32_t frames = (uint32_t)Math::round(seconds * ticks_per_second);
+
+	return wheel.schedule(frames, event);
+}
+
+bool GameplayTimers::cancel(TimerHandle& handle) {
+	return wheel.cancel(handle);
+}
+
+void GameplayTimers::advance() {
+	wheel.advance([this](const TimerEvent& event) {
+		// A listener that went away just drops its pending timers
+		uint16_t id = event.target & (MAX_LISTENERS - 1);
+		uint16_t generation = event.target >> LISTENER_BITS;
+		if (listeners[id] && (listener_generations[id] & 0x3FF) == generation) {
+			listeners[id]->on_gameplay_timer(event);
+		}
+	});
+}
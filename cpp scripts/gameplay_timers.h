@@ -0,0 +1,78 @@
+#pragma once
+
+#ifndef GAMEPLAY_TIMERS_H
+#define GAMEPLAY_TIMERS_H
+
+#include <Godot.hpp>
+#include <Engine.hpp>
+
+#include "timer_wheel.h"
+
+namespace godot {
+
+    // ============================================================
+    // TIMER KINDS
+    // ============================================================
+    enum GameplayTimerKind : uint16_t {
+        TIMER_STUN_END,
+        TIMER_KNOCKDOWN_END,
+        TIMER_COUNTER_END,
+        TIMER_IMMORTALITY_END,
+    };
+
+    // ============================================================
+    // LISTENER
+    // Mixed into any node that schedules gameplay timers. Registered on
+    // first schedule, unregistered on destruction.
+    // ============================================================
+    class TimerListener {
+    public:
+        virtual ~TimerListener();
+        virtual void on_gameplay_timer(const TimerEvent& event) = 0;
+
+    private:
+        friend class GameplayTimers;
+        uint16_t timer_listener_id = 0xFFFF;
+    };
+
+    // ============================================================
+    // GAMEPLAY TIMERS
+    // One frame-based TimerWheel for the whole match, advanced from
+    // MatchManager::_physics_process. Replaces per-node Timer children
+    // and SceneTree timers for short gameplay delays.
+    // ============================================================
+    class GameplayTimers {
+    public:
+        static const int LISTENER_BITS = 6;
+        static const int MAX_LISTENERS = 1 << LISTENER_BITS;
+
+        GameplayTimers();
+
+        static GameplayTimers* get_singleton();
+        static void set_singleton(GameplayTimers* timers);
+
+        TimerHandle schedule(TimerListener* listener, float seconds, GameplayTimerKind kind, int32_t arg = 0);
+        bool cancel(TimerHandle& handle);
+        bool is_active(TimerHandle handle) const { return wheel.is_active(handle); }
+
+        void advance();
+
+        // Snapshot: the wheel is plain data, listener ids stay valid while the nodes live
+        TimerWheel save_state() const { return wheel; }
+        void load_state(const TimerWheel& state) { wheel = state; }
+
+        void remove_listener(TimerListener* listener);
+
+    private:
+        static GameplayTimers* singleton;
+
+        TimerWheel wheel;
+        TimerListener* listeners[MAX_LISTENERS];
+        uint16_t listener_generations[MAX_LISTENERS]; // stale timers of a recycled slot don't fire
+
+        uint16_t add_listener(TimerListener* listener);
+    };
+
+} // namespace godot
+
+#endif
@@ -0,0 +1,108 @@
+// Label::set_text vs GlyphCounter for numeric HUD counters.
+// Drop a GlyphBench node into any scene; results go to the output log.
+
+#include <Godot.hpp>
+#include <Node.hpp>
+#include <Label.hpp>
+#include <Time.hpp>
+
+#include "glyph_strip.h"
+
+#include <vector>
+
+namespace godot {
+
+    class GlyphBench : public Node {
+        GODOT_CLASS(GlyphBench, Node)
+
+    public:
+        static void _register_methods();
+
+        void _init() override;
+        void _ready() override;
+
+        int updates;
+        int counters;
+        int font_size;
+
+        double run_labels(const std::vector<Label*>& labels);
+        double run_counters(std::vector<GlyphCounter>& glyph_counters);
+    };
+
+} // namespace godot
+
+using namespace godot;
+
+void GlyphBench::_register_methods() {
+	register_method("_ready", &GlyphBench::_ready);
+
+	register_property<GlyphBench, int>("updates", &GlyphBench::updates, 10000);
+	register_property<GlyphBench, int>("counters", &GlyphBench::counters, 16);
+	register_property<GlyphBench, int>("font_size", &GlyphBench::font_size, 64);
+}
+
+void GlyphBench::_init() {
+	updates = 10000;
+	counters = 16;
+	font_size = 64;
+}
+
+// ------------------ LABEL --------------------
+double GlyphBench::run_labels(const std::vector<Label*>& labels) {
+	uint64_t start = Time::get_singleton()->get_ticks_usec();
+
+	for (int i = 0; i < updates; i++) {
+		Label* label = labels[i % labels.size()];
+		label->set_text(String::num_int64(i % 100));
+		// Forces the shaping a visible label would do before drawing
+		label->get_minimum_size();
+	}
+
+	return double(Time::get_singleton()->get_ticks_usec() - start);
+}
+
+// ------------------ GLYPH COUNTER --------------------
+double GlyphBench::run_counters(std::vector<GlyphCounter>& glyph_counters) {
+	uint64_t start = Time::get_singleton()->get_ticks_usec();
+
+	for (int i = 0; i < updates; i++) {
+		glyph_counters[i % glyph_counters.size()].set_number(i % 100);
+	}
+
+	return double(Time::get_singleton()->get_ticks_usec() - start);
+}
+
+void GlyphBench::_ready() {
+	ERR_FAIL_COND_MSG(counters < 1, "GlyphBench: counters must be at least 1");
+
+	std::vector<Label*> labels;
+	for (int i = 0; i < counters; i++) {
+		Label* label = Label::_new();
+		label->add_theme_font_size_override("font_size", font_size);
+		add_child(label);
+		labels.push_back(label);
+	}
+
+	GlyphStrip strip;
+	if (!strip.build(labels[0]->get_theme_font("font"), font_size)) {
+		ERR_PRINT("GlyphBench: could not build glyph strip");
+		return;
+	}
+
+	double label_usec = run_labels(labels);
+
+	std::vector<GlyphCounter> glyph_counters(counters);
+	for (int i = 0; i < counters; i++) {
+		glyph_counters[i].attach(labels[i], &strip);
+	}
+	double counter_usec = run_counters(glyph_counters);
+
+	Godot::print("GlyphBench: " + String::num_int64(updates) + " updates over " + String::num_int64(counters) + " counters");
+	Godot::print("  Label::set_text  " + String::num(label_usec / 1000.0, 2) + " ms  (" + String::num(label_usec * 1000.0 / updates, 0) + " ns/update)");
+	Godot::print("  GlyphCounter     " + String::num(counter_usec / 1000.0, 2) + " ms  (" + String::num(counter_usec * 1000.0 / updates, 0) + " ns/update)");
+
+	glyph_counters.clear();
+	for (Label* label : labels) {
+		label->queue_free();
+	}
+}
@@ -0,0 +1,196 @@
+#include "glyph_strip.h"
+
+using namespace godot;
+
+// Sentinels for shown_a / shown_b
+static const int SHOWN_NOTHING = -2;
+static const int SHOWN_NUMBER = -3;
+
+// ------------------ STRIP --------------------
+GlyphStrip::GlyphStrip() :
+		count(0),
+		ascent(0.0f),
+		height(0.0f) {
+	for (int i = 0; i < 128; i++) {
+		lookup[i] = -1;
+	}
+}
+
+bool GlyphStrip::build(const Ref<Font>& font, int font_size, const char* charset) {
+	ERR_FAIL_COND_V(font.is_null(), false);
+
+	TextServer* ts = TextServerManager::get_singleton()->get_primary_interface().ptr();
+	TypedArray<RID> rids = font->get_rids();
+	ERR_FAIL_COND_V(rids.is_empty(), false);
+	RID font_rid = rids[0];
+
+	Vector2i cache_size(font_size, 0);
+	count = 0;
+	for (int i = 0; i < 128; i++) {
+		lookup[i] = -1;
+	}
+
+	for (const char* c = charset; *c && count < MAX_GLYPHS; c++) {
+		char32_t code = (char32_t)*c;
+		int32_t index = ts->font_get_glyph_index(font_rid, font_size, code, 0);
+
+		// Rasterises into the font's atlas now rather than on first draw
+		ts->font_render_glyph(font_rid, cache_size, index);
+
+		Glyph& glyph = glyphs[count];
+		glyph.advance = ts->font_get_glyph_advance(font_rid, font_size, index).x;
+		glyph.offset = ts->font_get_glyph_offset(font_rid, cache_size, index);
+		glyph.size = ts->font_get_glyph_size(font_rid, cache_size, index);
+		glyph.uv_rect = ts->font_get_glyph_uv_rect(font_rid, cache_size, index);
+		glyph.texture = ts->font_get_glyph_texture_rid(font_rid, cache_size, index);
+
+		lookup[(unsigned char)*c & 127] = (int8_t)count;
+		count++;
+	}
+
+	ascent = font->get_ascent(font_size);
+	height = font->get_height(font_size);
+	return true;
+}
+
+const GlyphStrip::Glyph* GlyphStrip::find(char c) const {
+	int index = lookup[(unsigned char)c & 127];
+	return index < 0 ? nullptr : &glyphs[index];
+}
+
+// ------------------ COUNTER --------------------
+GlyphCounter::GlyphCounter() :
+		host(nullptr),
+		strip(nullptr),
+		alignment(HORIZONTAL_ALIGNMENT_LEFT),
+		shown_a(SHOWN_NOTHING),
+		shown_b(SHOWN_NOTHING),
+		redraws(0) {}
+
+GlyphCounter::~GlyphCounter() {
+	detach();
+}
+
+void GlyphCounter::attach(Label* host, const GlyphStrip* strip) {
+	ERR_FAIL_COND(!host || !strip || !strip->is_built());
+	detach();
+
+	this->host = host;
+	this->strip = strip;
+
+	color = host->get_theme_color("font_color");
+	shadow_color = host->get_theme_color("font_shadow_color");
+	shadow_offset = Vector2(host->get_theme_constant("shadow_offset_x"), host->get_theme_constant("shadow_offset_y"));
+	alignment = host->get_horizontal_alignment();
+
+	RenderingServer* rs = RenderingServer::get_singleton();
+	canvas_item = rs->canvas_item_create();
+	rs->canvas_item_set_parent(canvas_item, host->get_canvas_item());
+
+	host->set_text("");
+	shown_a = shown_b = SHOWN_NOTHING;
+}
+
+void GlyphCounter::detach() {
+	if (canvas_item.is_valid()) {
+		RenderingServer::get_singleton()->free_rid(canvas_item);
+		canvas_item = RID();
+	}
+	host = nullptr;
+	strip = nullptr;
+}
+
+int GlyphCounter::write_int(char* out, int value) {
+	char reversed[12];
+	int length = 0;
+	unsigned int v = value < 0 ? 0u - (unsigned int)value : (unsigned int)value;
+
+	do {
+		reversed[length++] = char('0' + v % 10);
+		v /= 10;
+	} while (v);
+
+	int written = 0;
+	if (value < 0) out[written++] = '-';
+	while (length) out[written++] = reversed[--length];
+	return written;
+}
+
+void GlyphCounter::set_number(int value) {
+	if (!canvas_item.is_valid()) return;
+	if (value < 0) {
+		clear();
+		return;
+	}
+	if (shown_b == SHOWN_NUMBER && shown_a == value) return;
+
+	char chars[MAX_CHARS];
+	int length = write_int(chars, value);
+	draw(chars, length);
+
+	shown_a = value;
+	shown_b = SHOWN_NUMBER;
+}
+
+void GlyphCounter::set_pair(int a, int b) {
+	if (!canvas_item.is_valid()) return;
+	if (shown_a == a && shown_b == b) return;
+
+	char chars[MAX_CHARS];
+	int length = write_int(chars, a);
+	chars[length++] = ' ';
+	chars[length++] = '-';
+	chars[length++] = ' ';
+	length += write_int(chars + length, b);
+	draw(chars, length);
+
+	shown_a = a;
+	shown_b = b;
+}
+
+void GlyphCounter::clear() {
+	if (!canvas_item.is_valid() || shown_a == SHOWN_NOTHING) return;
+
+	RenderingServer::get_singleton()->canvas_item_clear(canvas_item);
+	shown_a = shown_b = SHOWN_NOTHING;
+	redraws++;
+}
+
+void GlyphCounter::draw(const char* chars, int length) {
+	RenderingServer* rs = RenderingServer::get_singleton();
+	rs->canvas_item_clear(canvas_item);
+	redraws++;
+
+	float width = 0.0f;
+	for (int i = 0; i < length; i++) {
+		if (const GlyphStrip::Glyph* glyph = strip->find(chars[i])) {
+			width += glyph->advance;
+		}
+	}
+
+	float x = 0.0f;
+	float host_width = host->get_size().x;
+	if (alignment == HORIZONTAL_ALIGNMENT_CENTER) {
+		x = (host_width - width) * 0.5f;
+	} else if (alignment == HORIZONTAL_ALIGNMENT_RIGHT) {
+		x = host_width - width;
+	}
+	Vector2 pen(x, strip->get_ascent());
+
+	// Shadow pass first so the glyphs land on top, same as Label
+	bool shadow = shadow_color.a > 0.0f;
+	for (int pass = shadow ? 0 : 1; pass < 2; pass++) {
+		Vector2 origin = pass == 0 ? pen + shadow_offset : pen;
+		const Color& modulate = pass == 0 ? shadow_color : color;
+
+		for (int i = 0; i < length; i++) {
+			const GlyphStrip::Glyph* glyph = strip->find(chars[i]);
+			if (!glyph) continue;
+
+			if (glyph->texture.is_valid() && glyph->size.x > 0.0f) {
+				rs->canvas_item_add_texture_rect_region(canvas_item, Rect2(origin + glyph->offset, glyph->size), glyph->texture, glyph->uv_rect, modulate);
+			}
+			origin.x += glyph->advance;
+		}
+	}
+}
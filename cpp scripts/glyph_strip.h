@@ -0,0 +1,100 @@
+#pragma once
+
+#ifndef GLYPH_STRIP_H
+#define GLYPH_STRIP_H
+
+#include <Godot.hpp>
+#include <Control.hpp>
+#include <Label.hpp>
+#include <Font.hpp>
+#include <RenderingServer.hpp>
+#include <TextServer.hpp>
+#include <TextServerManager.hpp>
+
+#include <cstdint>
+
+namespace godot {
+
+    // ============================================================
+    // GLYPH STRIP
+    // The handful of glyphs a counter needs ("0-9", "-", " "),
+    // rasterised once at load by the font's own glyph cache. After
+    // build() a number is drawn by looking up quads: no shaping, no
+    // String.
+    // ============================================================
+    class GlyphStrip {
+    public:
+        static const int MAX_GLYPHS = 16;
+
+        struct Glyph {
+            RID texture;
+            Rect2 uv_rect;
+            Vector2 offset;     // from the pen position on the baseline
+            Vector2 size;
+            float advance = 0.0f;
+        };
+
+        GlyphStrip();
+
+        bool build(const Ref<Font>& font, int font_size, const char* charset = "0123456789- ");
+
+        bool is_built() const { return count > 0; }
+        const Glyph* find(char c) const;
+        float get_ascent() const { return ascent; }
+        float get_height() const { return height; }
+
+    private:
+        Glyph glyphs[MAX_GLYPHS];
+        int8_t lookup[128];
+        int count;
+        float ascent;
+        float height;
+    };
+
+    // ============================================================
+    // GLYPH COUNTER
+    // Draws a number (or "a - b") into its own canvas item parented to a
+    // host Control, so the scene keeps the layout and the host Label just
+    // stays empty. Colour, shadow and alignment are read off the host
+    // label once at attach. Setting the same value again is free.
+    // ============================================================
+    class GlyphCounter {
+    public:
+        GlyphCounter();
+        ~GlyphCounter();
+        GlyphCounter(const GlyphCounter&) = delete;
+        GlyphCounter& operator=(const GlyphCounter&) = delete;
+
+        void attach(Label* host, const GlyphStrip* strip);
+        void detach();
+        bool is_attached() const { return canvas_item.is_valid(); }
+
+        void set_number(int value);         // negative = blank
+        void set_pair(int a, int b);        // "a - b"
+        void clear();
+
+        uint64_t get_redraws() const { return redraws; }
+
+    private:
+        static const int MAX_CHARS = 24;
+
+        RID canvas_item;
+        Label* host;
+        const GlyphStrip* strip;
+
+        Color color;
+        Color shadow_color;
+        Vector2 shadow_offset;
+        HorizontalAlignment alignment;
+
+        int shown_a;
+        int shown_b;
+        uint64_t redraws;
+
+        static int write_int(char* out, int value);
+        void draw(const char* chars, int length);
+    };
+
+} // namespace godot
+
+#endif
@@ -14,6 +14,11 @@ void HealthSystem::_register_methods() {
 	register_method("set_immortality", &HealthSystem::set_immortality);
 	register_method("get_immortality", &HealthSystem::get_immortality);
 	register_method("set_temporary_immortality", &HealthSystem::set_temporary_immortality);
+	register_method("cancel_temporary_immortality", &HealthSystem::cancel_temporary_immortality);
+	register_method("end_temporary_immortality", &HealthSystem::end_temporary_immortality);
+
+	// Properties
+	register_property<HealthSystem, int>("fighter_slot", &HealthSystem::set_fighter_slot, &HealthSystem::get_fighter_slot, -1);
 
 	// Signals
 	register_signal<HealthSystem>("max_health_changed", "diff", GODOT_VARIANT_TYPE_INT);
@@ -25,7 +30,9 @@ void HealthSystem::_init() {
 	_max_health = 3;
 	_health = _max_health;
 	_immortality = false;
-	immortality_timer = nullptr;
+	immortality_timer = TimerHandle();
+	fallback_timer = nullptr;
+	fighter_slot = -1;
 }
 
 // ============================================================
@@ -41,7 +48,7 @@ void HealthSystem::set_max_health(int value) {
 	if (clamped_value != _max_health) {
 		int difference = clamped_value - _max_health;
 		_max_health = clamped_value;
-		emit_signal("max_health_changed", difference);
+		emit_max_health_changed(difference);
 	}
 
 	if (_health > _max_health) {
@@ -60,10 +67,10 @@ void HealthSystem::set_health(int value) {
 	if (clamped_value != _health) {
 		int difference = clamped_value - _health;
 		_health = clamped_value;
-		emit_signal("health_changed", difference);
+		emit_health_changed(difference);
 
 		if (_health == 0) {
-			emit_signal("health_depleted");
+			emit_health_depleted();
 		}
 	}
 }
@@ -76,23 +83,81 @@ void HealthSystem::set_immortality(bool value) {
 	_immortality = value;
 }
 
+int HealthSystem::get_fighter_slot() const {
+	return fighter_slot;
+}
+
+void HealthSystem::set_fighter_slot(int value) {
+	fighter_slot = value;
+}
+
+// ============================================================
+// SIGNALS
+// Fighters go through the typed event bus; anything else still
+// gets the string signals.
+// ============================================================
+void HealthSystem::emit_max_health_changed(int diff) {
+	emit_signal("max_health_changed", diff);
+}
+
+void HealthSystem::emit_health_changed(int diff) {
+	MatchEventBus* bus = MatchEventBus::get_singleton();
+	if (fighter_slot >= 0 && bus) {
+		bus->push(EVENT_HEALTH_CHANGED, fighter_slot, _health, diff);
+		return;
+	}
+	emit_signal("health_changed", diff);
+}
+
+void HealthSystem::emit_health_depleted() {
+	MatchEventBus* bus = MatchEventBus::get_singleton();
+	if (fighter_slot >= 0 && bus) {
+		bus->push(EVENT_FIGHTER_DIED, fighter_slot);
+		return;
+	}
+	emit_signal("health_depleted");
+}
+
 // ============================================================
 // TEMPORARY IMMORTALITY
 // ============================================================
 void HealthSystem::set_temporary_immortality(float time) {
-	if (!immortality_timer) {
-		immortality_timer = Timer::_new();
-		immortality_timer->set_one_shot(true);
-		add_child(immortality_timer);
+	_immortality = true;
+
+	// Re-arming just replaces the pending expiry
+	GameplayTimers* timers = GameplayTimers::get_singleton();
+	if (timers) {
+		timers->cancel(immortality_timer);
+		immortality_timer = timers->schedule(this, time, TIMER_IMMORTALITY_END);
+		return;
 	}
 
-	if (immortality_timer->is_connected("timeout", this, "set_immortality")) {
-		immortality_timer->disconnect("timeout", this, "set_immortality");
+	if (!fallback_timer) {
+		fallback_timer = Timer::_new();
+		fallback_timer->set_one_shot(true);
+		add_child(fallback_timer);
+		fallback_timer->connect("timeout", Callable(this, "end_temporary_immortality"));
 	}
+	fallback_timer->start(time);
+}
 
-	immortality_timer->set_wait_time(time);
-	immortality_timer->connect("timeout", this, "set_immortality", Array::make(false));
+void HealthSystem::cancel_temporary_immortality() {
+	GameplayTimers* timers = GameplayTimers::get_singleton();
+	if (timers) {
+		timers->cancel(immortality_timer);
+	}
+	if (fallback_timer) {
+		fallback_timer->stop();
+	}
+	_immortality = false;
+}
 
-	_immortality = true;
-	immortality_timer->start();
+void HealthSystem::end_temporary_immortality() {
+	set_immortality(false);
+}
+
+void HealthSystem::on_gameplay_timer(const TimerEvent& event) {
+	if (event.kind == TIMER_IMMORTALITY_END) {
+		end_temporary_immortality();
+	}
 }
@@ -0,0 +1,224 @@
+#include "health_bar_batch.h"
+
+#include <algorithm>
+
+using namespace godot;
+
+static const int VERTICES_PER_BAR = 12;     // 3 quads
+static const int INDICES_PER_BAR = 18;
+
+HealthBarBatch::HealthBarBatch() {}
+HealthBarBatch::~HealthBarBatch() {}
+
+void HealthBarBatch::_register_methods() {
+	register_method("_ready", &HealthBarBatch::_ready);
+	register_method("_process", &HealthBarBatch::_process);
+
+	register_method("add_bar", &HealthBarBatch::add_bar);
+	register_method("remove_bar", &HealthBarBatch::remove_bar);
+	register_method("set_bar_value", &HealthBarBatch::set_bar_value);
+	register_method("set_bar_position", &HealthBarBatch::set_bar_position);
+	register_method("get_bar_count", &HealthBarBatch::get_bar_count);
+
+	register_property<HealthBarBatch, Vector2>("bar_size", &HealthBarBatch::bar_size, Vector2(117, 8));
+	register_property<HealthBarBatch, float>("trail_delay", &HealthBarBatch::trail_delay, 0.4);
+	register_property<HealthBarBatch, float>("trail_speed", &HealthBarBatch::trail_speed, 1.5);
+	register_property<HealthBarBatch, Color>("background_color", &HealthBarBatch::background_color, Color(0.133, 0.133, 0.133));
+	register_property<HealthBarBatch, Color>("trail_color", &HealthBarBatch::trail_color, Color(0.85, 0.85, 0.85));
+	register_property<HealthBarBatch, Color>("fill_color", &HealthBarBatch::fill_color, Color(0.081, 0.504, 0.491));
+}
+
+void HealthBarBatch::_init() {
+	bar_size = Vector2(117, 8);
+	trail_delay = 0.4;
+	trail_speed = 1.5;
+	background_color = Color(0.133, 0.133, 0.133);
+	trail_color = Color(0.85, 0.85, 0.85);
+	fill_color = Color(0.081, 0.504, 0.491);
+}
+
+void HealthBarBatch::_ready() {
+	// Bars are placed in global coordinates
+	set_as_top_level(true);
+	set_global_position(Vector2());
+	add_to_group("health_bar_batch");
+}
+
+void HealthBarBatch::_process(double delta) {
+	update_bars((float)delta);
+	build_mesh();
+}
+
+// ------------------ BARS --------------------
+int HealthBarBatch::add_bar(Node2D* owner, float max_value, Vector2 offset) {
+	int id;
+	if (!free_ids.empty()) {
+		id = free_ids.back();
+		free_ids.pop_back();
+	} else {
+		id = (int)id_slots.size();
+		id_slots.push_back(-1);
+	}
+
+	if (max_value <= 0.0f) max_value = 1.0f;
+
+	id_slots[id] = (int)owners.size();
+	owners.push_back(owner ? owner->get_instance_id() : 0);
+	offsets.push_back(offset);
+	positions.push_back(owner ? owner->get_global_position() + offset : offset);
+	values.push_back(max_value);
+	trails.push_back(max_value);
+	max_values.push_back(max_value);
+	holds.push_back(0.0f);
+	slot_ids.push_back(id);
+
+	return id;
+}
+
+int HealthBarBatch::index_of(int id) const {
+	if (id < 0 || id >= (int)id_slots.size()) return -1;
+	return id_slots[id];
+}
+
+void HealthBarBatch::remove_bar(int id) {
+	int slot = index_of(id);
+	ERR_FAIL_COND(slot < 0);
+	remove_slot(slot);
+}
+
+void HealthBarBatch::remove_slot(int slot) {
+	int last = (int)owners.size() - 1;
+	int id = slot_ids[slot];
+
+	// Keep the arrays dense: move the last bar into the hole
+	if (slot != last) {
+		owners[slot] = owners[last];
+		offsets[slot] = offsets[last];
+		positions[slot] = positions[last];
+		values[slot] = values[last];
+		trails[slot] = trails[last];
+		max_values[slot] = max_values[last];
+		holds[slot] = holds[last];
+		slot_ids[slot] = slot_ids[last];
+		id_slots[slot_ids[slot]] = slot;
+	}
+
+	owners.pop_back();
+	offsets.pop_back();
+	positions.pop_back();
+	values.pop_back();
+	trails.pop_back();
+	max_values.pop_back();
+	holds.pop_back();
+	slot_ids.pop_back();
+
+	id_slots[id] = -1;
+	free_ids.push_back(id);
+}
+
+void HealthBarBatch::set_bar_value(int id, float value) {
+	int slot = index_of(id);
+	ERR_FAIL_COND(slot < 0);
+
+	value = CLAMP(value, 0.0f, max_values[slot]);
+	if (value < values[slot]) {
+		// Same as HealthBar restarting its timer on each hit
+		holds[slot] = trail_delay;
+	} else {
+		trails[slot] = value;
+	}
+	values[slot] = value;
+}
+
+void HealthBarBatch::set_bar_position(int id, Vector2 position) {
+	int slot = index_of(id);
+	ERR_FAIL_COND(slot < 0);
+	positions[slot] = position + offsets[slot];
+}
+
+int HealthBarBatch::get_bar_count() const {
+	return (int)owners.size();
+}
+
+// ------------------ UPDATE --------------------
+void HealthBarBatch::update_bars(float delta) {
+	// Follow owners; drop bars whose owner was freed
+	for (int i = (int)owners.size() - 1; i >= 0; i--) {
+		if (!owners[i]) continue;
+
+		Node2D* owner = Object::cast_to<Node2D>(ObjectDB::get_instance(owners[i]));
+		if (!owner) {
+			remove_slot(i);
+			continue;
+		}
+		positions[i] = owner->get_global_position() + offsets[i];
+	}
+
+	// Trail decay: straight-line over packed floats, no branches
+	const int count = (int)values.size();
+	float* hold = holds.data();
+	float* trail = trails.data();
+	const float* value = values.data();
+	const float* max_value = max_values.data();
+	const float drain = trail_speed * delta;
+
+	for (int i = 0; i < count; i++) {
+		float remaining = hold[i] - delta;
+		float drained = std::max(trail[i] - drain * max_value[i], value[i]);
+		trail[i] = remaining > 0.0f ? trail[i] : drained;
+		hold[i] = std::max(remaining, 0.0f);
+	}
+}
+
+// ------------------ DRAW --------------------
+void HealthBarBatch::build_mesh() {
+	RenderingServer* rs = RenderingServer::get_singleton();
+	RID canvas_item = get_canvas_item();
+	rs->canvas_item_clear(canvas_item);
+
+	const int count = (int)values.size();
+	if (count == 0) return;
+
+	// The index pattern never changes; only new bars need filling in
+	int needed_indices = count * INDICES_PER_BAR;
+	if (indices.size() != needed_indices) {
+		int old_bars = std::min((int)indices.size() / INDICES_PER_BAR, count);
+		indices.resize(needed_indices);
+		int32_t* out = indices.ptrw();
+		for (int quad = old_bars * 3; quad < count * 3; quad++) {
+			int32_t base = quad * 4;
+			int32_t* q = out + quad * 6;
+			q[0] = base; q[1] = base + 1; q[2] = base + 2;
+			q[3] = base; q[4] = base + 2; q[5] = base + 3;
+		}
+	}
+
+	points.resize(count * VERTICES_PER_BAR);
+	colors.resize(count * VERTICES_PER_BAR);
+	Vector2* p = points.ptrw();
+	Color* c = colors.ptrw();
+
+	const float width = bar_size.x;
+	const float height = bar_size.y;
+
+	for (int i = 0; i < count; i++) {
+		Vector2 origin = positions[i];
+		float fill_width = width * (values[i] / max_values[i]);
+		float trail_width = width * (trails[i] / max_values[i]);
+
+		float widths[3] = { width, trail_width, fill_width };
+		const Color* quad_colors[3] = { &background_color, &trail_color, &fill_color };
+
+		for (int q = 0; q < 3; q++) {
+			p[0] = origin;
+			p[1] = Vector2(origin.x + widths[q], origin.y);
+			p[2] = Vector2(origin.x + widths[q], origin.y + height);
+			p[3] = Vector2(origin.x, origin.y + height);
+			c[0] = c[1] = c[2] = c[3] = *quad_colors[q];
+			p += 4;
+			c += 4;
+		}
+	}
+
+	rs->canvas_item_add_triangle_array(canvas_item, indices, points, colors);
+}
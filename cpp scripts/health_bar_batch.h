@@ -0,0 +1,83 @@
+#pragma once
+
+#ifndef HEALTH_BAR_BATCH_H
+#define HEALTH_BAR_BATCH_H
+
+#include <Godot.hpp>
+#include <Node2D.hpp>
+#include <RenderingServer.hpp>
+
+#include <vector>
+
+namespace godot {
+
+    // ============================================================
+    // HEALTH BAR BATCH
+    // Every enemy health bar in the level, drawn by one canvas item as a
+    // single triangle array (background, damage trail, fill per bar).
+    // Replaces one HealthBar ProgressBar + damage bar + Timer per enemy.
+    // Bars live in packed arrays; ids stay stable while the arrays are
+    // kept dense by swap-removal. A bar bound to an owner follows its
+    // global position and goes away with it.
+    // ============================================================
+    class HealthBarBatch : public Node2D {
+        GODOT_CLASS(HealthBarBatch, Node2D)
+
+    public:
+        HealthBarBatch();
+        ~HealthBarBatch();
+
+        static void _register_methods();
+
+        void _init() override;
+        void _ready() override;
+        void _process(double delta) override;
+
+        // ============================================================
+        // SETTINGS
+        // ============================================================
+        Vector2 bar_size;
+        float trail_delay;          // seconds the trail holds before draining
+        float trail_speed;          // fraction of max per second
+        Color background_color;
+        Color trail_color;
+        Color fill_color;
+
+        // ============================================================
+        // BARS
+        // ============================================================
+        int add_bar(Node2D* owner, float max_value, Vector2 offset);
+        void remove_bar(int id);
+        void set_bar_value(int id, float value);
+        void set_bar_position(int id, Vector2 position);
+        int get_bar_count() const;
+
+        void update_bars(float delta);
+        void build_mesh();
+
+    private:
+        // Packed, index = dense slot
+        std::vector<uint64_t> owners;       // ObjectID, 0 = positioned by hand
+        std::vector<Vector2> offsets;
+        std::vector<Vector2> positions;
+        std::vector<float> values;
+        std::vector<float> trails;
+        std::vector<float> max_values;
+        std::vector<float> holds;
+        std::vector<int> slot_ids;
+
+        // id -> dense slot, -1 when free
+        std::vector<int> id_slots;
+        std::vector<int> free_ids;
+
+        PackedVector2Array points;
+        PackedColorArray colors;
+        PackedInt32Array indices;
+
+        int index_of(int id) const;
+        void remove_slot(int slot);
+    };
+
+} // namespace godot
+
+#endif
@@ -0,0 +1,180 @@
+// Frame time with N health_bar.tscn nodes vs one HealthBarBatch.
+// Drop a HealthBarBench node into an empty scene and run it; each phase
+// runs for `frames` frames, damaging a few bars every frame, then the
+// averages go to the output log.
+
+#include <Godot.hpp>
+#include <Node2D.hpp>
+#include <ProgressBar.hpp>
+#include <Timer.hpp>
+#include <PackedScene.hpp>
+#include <ResourceLoader.hpp>
+#include <Performance.hpp>
+
+#include "health_bar_batch.h"
+
+#include <vector>
+
+namespace godot {
+
+    class HealthBarBench : public Node2D {
+        GODOT_CLASS(HealthBarBench, Node2D)
+
+    public:
+        static void _register_methods();
+
+        void _init() override;
+        void _process(double delta) override;
+
+        int bar_count;
+        int frames;
+
+    private:
+        enum Phase { START, NODES, BATCH, DONE };
+        Phase phase;
+        int frame;
+        uint32_t rng;
+
+        double frame_time_total;
+        double process_time_total;
+        double draw_calls_total;
+
+        std::vector<ProgressBar*> nodes;
+        HealthBarBatch* batch;
+        std::vector<int> bar_ids;
+        std::vector<float> health;
+
+        Vector2 slot_position(int i) const;
+        int next_victim();
+        void begin_nodes();
+        void begin_batch();
+        void report(const char* name);
+    };
+
+} // namespace godot
+
+using namespace godot;
+
+void HealthBarBench::_register_methods() {
+	register_method("_process", &HealthBarBench::_process);
+
+	register_property<HealthBarBench, int>("bar_count", &HealthBarBench::bar_count, 1000);
+	register_property<HealthBarBench, int>("frames", &HealthBarBench::frames, 600);
+}
+
+void HealthBarBench::_init() {
+	bar_count = 1000;
+	frames = 600;
+
+	phase = START;
+	frame = 0;
+	rng = 0x9E3779B9u;
+	batch = nullptr;
+
+	frame_time_total = 0.0;
+	process_time_total = 0.0;
+	draw_calls_total = 0.0;
+}
+
+Vector2 HealthBarBench::slot_position(int i) const {
+	return Vector2(20 + (i % 25) * 130, 20 + (i / 25) * 16);
+}
+
+int HealthBarBench::next_victim() {
+	rng ^= rng << 13;
+	rng ^= rng >> 17;
+	rng ^= rng << 5;
+	return (int)(rng % (uint32_t)bar_count);
+}
+
+// ------------------ PHASES --------------------
+void HealthBarBench::begin_nodes() {
+	Ref<PackedScene> scene = ResourceLoader::get_singleton()->load("res://scenes/health_bar.tscn");
+	ERR_FAIL_COND(scene.is_null());
+
+	health.assign(bar_count, 100.0f);
+	for (int i = 0; i < bar_count; i++) {
+		ProgressBar* bar = cast_to<ProgressBar>(scene->instantiate());
+		bar->set_position(slot_position(i));
+		add_child(bar);
+		bar->set_max(100);
+		bar->set_value(100);
+		nodes.push_back(bar);
+	}
+}
+
+void HealthBarBench::begin_batch() {
+	for (ProgressBar* bar : nodes) {
+		bar->queue_free();
+	}
+	nodes.clear();
+
+	batch = HealthBarBatch::_new();
+	add_child(batch);
+
+	health.assign(bar_count, 100.0f);
+	for (int i = 0; i < bar_count; i++) {
+		bar_ids.push_back(batch->add_bar(nullptr, 100.0f, slot_position(i)));
+	}
+}
+
+void HealthBarBench::report(const char* name) {
+	double n = frame > 0 ? double(frame) : 1.0;
+	Godot::print(String(name) + ": " + String::num_int64(bar_count) + " bars, "
+			+ String::num(frame_time_total * 1000.0 / n, 3) + " ms/frame, "
+			+ String::num(process_time_total * 1000.0 / n, 3) + " ms process, "
+			+ String::num(draw_calls_total / n, 1) + " draw calls");
+
+	frame = 0;
+	frame_time_total = 0.0;
+	process_time_total = 0.0;
+	draw_calls_total = 0.0;
+}
+
+void HealthBarBench::_process(double delta) {
+	Performance* performance = Performance::get_singleton();
+
+	switch (phase) {
+		case START:
+			begin_nodes();
+			phase = NODES;
+			return;
+
+		case NODES:
+			// 2% of the bars take a hit each frame
+			for (int i = 0; i < bar_count / 50; i++) {
+				int victim = next_victim();
+				health[victim] = health[victim] > 1.0f ? health[victim] - 1.0f : 100.0f;
+				// What health_bar.gd does per hit: new value, restart the trail timer
+				nodes[victim]->set_value(health[victim]);
+				cast_to<Timer>(nodes[victim]->get_node("Timer"))->start();
+			}
+			break;
+
+		case BATCH:
+			for (int i = 0; i < bar_count / 50; i++) {
+				int victim = next_victim();
+				health[victim] = health[victim] > 1.0f ? health[victim] - 1.0f : 100.0f;
+				batch->set_bar_value(bar_ids[victim], health[victim]);
+			}
+			break;
+
+		case DONE:
+			return;
+	}
+
+	frame_time_total += delta;
+	process_time_total += performance->get_monitor(Performance::TIME_PROCESS);
+	draw_calls_total += performance->get_monitor(Performance::RENDER_TOTAL_DRAW_CALLS_IN_FRAME);
+
+	if (++frame < frames) return;
+
+	if (phase == NODES) {
+		report("health_bar.tscn nodes");
+		begin_batch();
+		phase = BATCH;
+	} else {
+		report("HealthBarBatch");
+		phase = DONE;
+	}
+}
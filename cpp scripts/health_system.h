@@ -7,9 +7,12 @@
 #include <Node.hpp>
 #include <Timer.hpp>
 
+#include "gameplay_timers.h"
+#include "match_events.h"
+
 namespace godot {
 
-    class HealthSystem : public Node {
+    class HealthSystem : public Node, public TimerListener {
         GODOT_CLASS(HealthSystem, Node)
 
     public:
@@ -35,7 +38,11 @@ namespace godot {
         int _health;
         bool _immortality;
 
-        Timer* immortality_timer;
+        TimerHandle immortality_timer;
+        Timer* fallback_timer;      // outside a match: no GameplayTimers to schedule into
+
+        // Fighter slot this health belongs to; -1 keeps the plain signals
+        int fighter_slot;
 
     public:
         int get_max_health() const;
@@ -47,7 +54,13 @@ namespace godot {
         bool get_immortality() const;
         void set_immortality(bool value);
 
+        int get_fighter_slot() const;
+        void set_fighter_slot(int value);
+
         void set_temporary_immortality(float time);
+        void cancel_temporary_immortality();
+        void end_temporary_immortality();
+        void on_gameplay_timer(const TimerEvent& event) override;
     };
 
 } // namespace godot
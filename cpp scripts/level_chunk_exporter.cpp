@@ -0,0 +1,394 @@
+// Offline exporter from a PvE level scene to a streamed .level file.
+// Drop a LevelChunkExporter node into an empty scene and run it once. It
+// instantiates `source_scene` and writes `output_path` (see
+// level_chunks.h) for LevelStreamer, with:
+//   tiles      every enabled TileMapLayer, cell by cell
+//   collision  tile collision merged into rects (TileCollisionMerger's
+//              merge), plus rect / polygon shapes of static bodies;
+//              non-convex polygons split into convex pieces
+//   kill rects rect shapes of killzone_scene instances
+//   spawns     instances of any scene in spawn_scenes (enemy, coin,
+//              platforms), by position
+// Built-in TileSets are saved next to the output so the streamer can
+// load them by path. Players, cameras, UI and world boundaries don't fit
+// in a chunk and stay in the host scene; their count is printed.
+// repeat_x > 1 tiles the whole level that many times to the right, to
+// make a long level out of a short one for streaming tests (exact when
+// the layers' cell widths divide one another).
+
+#include <Godot.hpp>
+#include <Node.hpp>
+#include <Node2D.hpp>
+#include <CanvasLayer.hpp>
+#include <PackedScene.hpp>
+#include <ResourceLoader.hpp>
+#include <ResourceSaver.hpp>
+#include <DirAccess.hpp>
+#include <FileAccess.hpp>
+#include <TileMapLayer.hpp>
+#include <TileSet.hpp>
+#include <CollisionObject2D.hpp>
+#include <StaticBody2D.hpp>
+#include <Area2D.hpp>
+#include <CollisionShape2D.hpp>
+#include <CollisionPolygon2D.hpp>
+#include <RectangleShape2D.hpp>
+#include <Geometry2D.hpp>
+
+#include "level_chunks.h"
+#include "tile_collision.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace godot {
+
+    class LevelChunkExporter : public Node {
+        GODOT_CLASS(LevelChunkExporter, Node)
+
+    public:
+        static void _register_methods();
+
+        void _init() override;
+        void _ready() override;
+
+        String source_scene;
+        String output_path;
+        PackedStringArray spawn_scenes;
+        String killzone_scene;
+        float chunk_size;
+        float tolerance;
+        int repeat_x;
+
+    private:
+        struct Tile {
+            int layer;
+            int type;
+            Vector2i cell;
+            Vector2 position;       // level space, cell centre
+        };
+
+        struct Shape {
+            int group;
+            Rect2 rect;             // rects
+            PackedVector2Array points;      // convex polygons, level space
+        };
+
+        struct Spawn {
+            int scene;
+            Vector2 position;
+        };
+
+        LevelChunksWriter writer;
+        std::vector<float> cell_widths;     // per layer, level units
+        std::vector<Tile> tiles;
+        std::vector<Shape> shapes;
+        std::vector<Spawn> spawns;
+        Rect2 bounds;
+        bool has_bounds;
+        int skipped;
+
+        bool export_level();
+        void walk(Node* node, Node* root);
+        void add_layer(TileMapLayer* layer);
+        void add_body(CollisionObject2D* body, int group);
+        void add_polygon(int group, const PackedVector2Array& points);
+        void grow(const Rect2& rect);
+        String save_tile_set(const Ref<TileSet>& tile_set, int index);
+    };
+
+} // namespace godot
+
+using namespace godot;
+
+void LevelChunkExporter::_register_methods() {
+	register_method("_ready", &LevelChunkExporter::_ready);
+
+	PackedStringArray defaults;
+	defaults.push_back("res://scenes/enemy.tscn");
+	defaults.push_back("res://scenes/coin.tscn");
+	defaults.push_back("res://scenes/platforms.tscn");
+
+	register_property<LevelChunkExporter, String>("source_scene", &LevelChunkExporter::source_scene, "res://scenes/game_1.tscn");
+	register_property<LevelChunkExporter, String>("output_path", &LevelChunkExporter::output_path, "res://levels/game_1.level");
+	register_property<LevelChunkExporter, PackedStringArray>("spawn_scenes", &LevelChunkExporter::spawn_scenes, defaults);
+	register_property<LevelChunkExporter, String>("killzone_scene", &LevelChunkExporter::killzone_scene, "res://scenes/killzone.tscn");
+	register_property<LevelChunkExporter, float>("chunk_size", &LevelChunkExporter::chunk_size, 1024.0f);
+	register_property<LevelChunkExporter, float>("tolerance", &LevelChunkExporter::tolerance, 0.5f);
+	register_property<LevelChunkExporter, int>("repeat_x", &LevelChunkExporter::repeat_x, 1);
+}
+
+void LevelChunkExporter::_init() {
+	source_scene = "res://scenes/game_1.tscn";
+	output_path = "res://levels/game_1.level";
+	spawn_scenes.push_back("res://scenes/enemy.tscn");
+	spawn_scenes.push_back("res://scenes/coin.tscn");
+	spawn_scenes.push_back("res://scenes/platforms.tscn");
+	killzone_scene = "res://scenes/killzone.tscn";
+	chunk_size = 1024.0f;
+	tolerance = 0.5f;
+	repeat_x = 1;
+
+	has_bounds = false;
+	skipped = 0;
+}
+
+void LevelChunkExporter::_ready() {
+	export_level();
+}
+
+// ------------------ COLLECT --------------------
+void LevelChunkExporter::grow(const Rect2& rect) {
+	bounds = has_bounds ? bounds.merge(rect) : rect;
+	has_bounds = true;
+}
+
+String LevelChunkExporter::save_tile_set(const Ref<TileSet>& tile_set, int index) {
+	String path = tile_set->get_path();
+	if (!path.is_empty() && !path.contains("::")) return path;
+
+	// Built into the scene: give it a file of its own
+	String saved = output_path.get_basename() + "_tiles_" + String::num_int64(index) + ".res";
+	ERR_FAIL_COND_V_MSG(ResourceSaver::get_singleton()->save(tile_set, saved) != OK, String(), "LevelChunkExporter: cannot write " + saved);
+	return saved;
+}
+
+void LevelChunkExporter::add_layer(TileMapLayer* node) {
+	Transform2D transform = root_transform(node);
+	if (Math::abs(transform.get_skew()) > 1e-4f || Math::abs(transform.get_rotation()) > 1e-4f) {
+		WARN_PRINT("LevelChunkExporter: " + String(node->get_name()) + " is rotated or skewed, skipped");
+		skipped++;
+		return;
+	}
+
+	Vector2 scale = transform.get_scale();
+	String tile_set_path = save_tile_set(node->get_tile_set(), (int)cell_widths.size());
+	int layer = writer.add_layer(tile_set_path.utf8().get_data(), node->get_z_index(), transform.get_origin().x, transform.get_origin().y, scale.x, scale.y);
+	cell_widths.push_back(node->get_tile_set()->get_tile_size().x * Math::abs(scale.x));
+
+	TypedArray<Vector2i> cells = node->get_used_cells();
+	for (int i = 0; i < cells.size(); i++) {
+		Vector2i cell = cells[i];
+
+		LevelTileType type = {};
+		type.source = node->get_cell_source_id(cell);
+		Vector2i atlas = node->get_cell_atlas_coords(cell);
+		type.atlas_x = (int16_t)atlas.x;
+		type.atlas_y = (int16_t)atlas.y;
+		type.alternative = node->get_cell_alternative_tile(cell);
+
+		Tile tile;
+		tile.layer = layer;
+		tile.type = writer.add_tile_type(layer, type);
+		tile.cell = cell;
+		tile.position = transform.xform(node->map_to_local(cell));
+		tiles.push_back(tile);
+		grow(Rect2(tile.position, Vector2()));
+	}
+
+	if (!node->is_collision_enabled()) return;
+
+	Ref<TileSet> tile_set = node->get_tile_set();
+	for (int physics = 0; physics < tile_set->get_physics_layers_count(); physics++) {
+		MergedCollision merged;
+		merge_tile_collision(node, physics, transform, tolerance, merged);
+
+		uint32_t collision_layer = tile_set->get_physics_layer_collision_layer(physics);
+		uint32_t collision_mask = tile_set->get_physics_layer_collision_mask(physics);
+		int solid = writer.add_group(collision_layer, collision_mask, LEVEL_GROUP_SOLID);
+
+		for (const MergeRect& r : merged.rects) {
+			Shape shape;
+			shape.group = solid;
+			shape.rect = Rect2(r.min_x, r.min_y, r.max_x - r.min_x, r.max_y - r.min_y);
+			shapes.push_back(shape);
+			grow(shape.rect);
+		}
+		for (size_t p = 0; p < merged.polygons.size(); p++) {
+			int group = merged.one_way[p] ? writer.add_group(collision_layer, collision_mask, LEVEL_GROUP_ONE_WAY) : solid;
+			add_polygon(group, merged.polygons[p]);
+		}
+	}
+}
+
+void LevelChunkExporter::add_polygon(int group, const PackedVector2Array& points) {
+	TypedArray<PackedVector2Array> pieces = Geometry2D::get_singleton()->decompose_polygon_in_convex(points);
+	for (int i = 0; i < pieces.size(); i++) {
+		Shape shape;
+		shape.group = group;
+		shape.points = pieces[i];
+
+		Rect2 box(shape.points[0], Vector2());
+		for (int k = 1; k < shape.points.size(); k++) {
+			box.expand_to(shape.points[k]);
+		}
+		shape.rect = box;
+		shapes.push_back(shape);
+		grow(box);
+	}
+}
+
+void LevelChunkExporter::add_body(CollisionObject2D* body, int group) {
+	for (int i = 0; i < body->get_child_count(); i++) {
+		Node* child = body->get_child(i);
+
+		if (CollisionShape2D* shape_node = Object::cast_to<CollisionShape2D>(child)) {
+			Ref<RectangleShape2D> rect = shape_node->get_shape();
+			if (shape_node->is_disabled()) continue;
+			if (rect.is_null()) {
+				// World boundaries and round shapes have no place in a chunk
+				skipped++;
+				continue;
+			}
+
+			Transform2D transform = root_transform(shape_node);
+			Vector2 half = rect->get_size() * 0.5f;
+			Rect2 box(transform.xform(-half), Vector2());
+			box.expand_to(transform.xform(Vector2(half.x, -half.y)));
+			box.expand_to(transform.xform(half));
+			box.expand_to(transform.xform(Vector2(-half.x, half.y)));
+
+			Shape shape;
+			shape.group = group;
+			if (shape_node->is_one_way_collision_enabled()) {
+				shape.group = writer.add_group(body->get_collision_layer(), body->get_collision_mask(), LEVEL_GROUP_ONE_WAY);
+			}
+			shape.rect = box;
+			shapes.push_back(shape);
+			grow(box);
+		} else if (CollisionPolygon2D* polygon = Object::cast_to<CollisionPolygon2D>(child)) {
+			if (polygon->is_disabled() || polygon->get_polygon().size() < 3) continue;
+
+			Transform2D transform = root_transform(polygon);
+			PackedVector2Array points = polygon->get_polygon();
+			for (int k = 0; k < points.size(); k++) {
+				points.set(k, transform.xform(points[k]));
+			}
+			int polygon_group = polygon->is_one_way_collision_enabled()
+					? writer.add_group(body->get_collision_layer(), body->get_collision_mask(), LEVEL_GROUP_ONE_WAY)
+					: group;
+			add_polygon(polygon_group, points);
+		}
+	}
+}
+
+void LevelChunkExporter::walk(Node* node, Node* root) {
+	if (Object::cast_to<CanvasLayer>(node)) {
+		skipped++;
+		return;
+	}
+
+	if (node != root) {
+		String scene = node->get_scene_file_path();
+
+		int spawn_scene = spawn_scenes.find(scene);
+		if (spawn_scene >= 0) {
+			Node2D* node_2d = Object::cast_to<Node2D>(node);
+			Spawn spawn;
+			spawn.scene = writer.add_scene(scene.utf8().get_data());
+			spawn.position = node_2d ? root_transform(node_2d).get_origin() : Vector2();
+			spawns.push_back(spawn);
+			grow(Rect2(spawn.position, Vector2()));
+			return;
+		}
+
+		if (!scene.is_empty() && scene == killzone_scene) {
+			Area2D* area = Object::cast_to<Area2D>(node);
+			if (area) add_body(area, writer.add_group(area->get_collision_layer(), area->get_collision_mask(), LEVEL_GROUP_KILL));
+			return;
+		}
+
+		if (!scene.is_empty()) {
+			// Players and other instanced scenes stay in the host scene
+			skipped++;
+			return;
+		}
+	}
+
+	if (TileMapLayer* layer = Object::cast_to<TileMapLayer>(node)) {
+		if (layer->is_enabled() && layer->get_tile_set().is_valid()) add_layer(layer);
+	} else if (StaticBody2D* body = Object::cast_to<StaticBody2D>(node)) {
+		add_body(body, writer.add_group(body->get_collision_layer(), body->get_collision_mask(), LEVEL_GROUP_SOLID));
+	}
+
+	for (int i = 0; i < node->get_child_count(); i++) {
+		walk(node->get_child(i), root);
+	}
+}
+
+// ------------------ EXPORT --------------------
+bool LevelChunkExporter::export_level() {
+	Ref<PackedScene> scene = ResourceLoader::get_singleton()->load(source_scene);
+	ERR_FAIL_COND_V_MSG(scene.is_null(), false, "LevelChunkExporter: cannot load " + source_scene);
+	ERR_FAIL_COND_V(chunk_size <= 0.0f, false);
+
+	// Instanced outside the tree so none of the level's scripts run
+	Node* root = scene->instantiate();
+	ERR_FAIL_COND_V(!root, false);
+	DirAccess::make_dir_recursive_absolute(output_path.get_base_dir());
+
+	// Collected first: the grid needs the level's extent
+	walk(root, root);
+	root->free();
+	ERR_FAIL_COND_V_MSG(!has_bounds, false, "LevelChunkExporter: nothing to export in " + source_scene);
+
+	// Copies are one whole number of cells of every layer apart
+	int repeats = std::max(repeat_x, 1);
+	float cell_width = 1.0f;
+	for (float width : cell_widths) {
+		cell_width = std::max(cell_width, width);
+	}
+	float period = (std::floor(bounds.size.x / cell_width) + 1.0f) * cell_width;
+
+	int chunks_x = (int)std::floor((bounds.size.x + period * (repeats - 1)) / chunk_size) + 1;
+	int chunks_y = (int)std::floor(bounds.size.y / chunk_size) + 1;
+	ERR_FAIL_COND_V_MSG(chunks_x > 0xFFFF || chunks_y > 0xFFFF, false, "LevelChunkExporter: level too large for chunk_size");
+	writer.set_grid(chunk_size, bounds.position.x, bounds.position.y, chunks_x, chunks_y);
+
+	for (int r = 0; r < repeats; r++) {
+		float dx = period * r;
+
+		for (const Tile& tile : tiles) {
+			int shift = (int)std::lround(dx / cell_widths[tile.layer]);
+			writer.add_tile(tile.layer, tile.type, tile.cell.x + shift, tile.cell.y, tile.position.x + dx, tile.position.y);
+		}
+
+		std::vector<float> xy;
+		for (const Shape& shape : shapes) {
+			if (shape.points.is_empty()) {
+				writer.add_rect(shape.group, shape.rect.position.x + dx, shape.rect.position.y, shape.rect.get_end().x + dx, shape.rect.get_end().y);
+				continue;
+			}
+
+			xy.clear();
+			for (int k = 0; k < shape.points.size(); k++) {
+				xy.push_back(shape.points[k].x + dx);
+				xy.push_back(shape.points[k].y);
+			}
+			writer.add_polygon(shape.group, xy.data(), shape.points.size());
+		}
+
+		for (const Spawn& spawn : spawns) {
+			writer.add_spawn(spawn.scene, spawn.position.x + dx, spawn.position.y);
+		}
+	}
+
+	std::vector<uint8_t> bytes = writer.build();
+	PackedByteArray buffer;
+	buffer.resize((int64_t)bytes.size());
+	memcpy(buffer.ptrw(), bytes.data(), bytes.size());
+
+	Ref<FileAccess> file = FileAccess::open(output_path, FileAccess::WRITE);
+	ERR_FAIL_COND_V_MSG(file.is_null(), false, "LevelChunkExporter: cannot write " + output_path);
+	file->store_buffer(buffer);
+
+	int64_t total = (int64_t)repeats;
+	Godot::print("LevelChunkExporter " + source_scene.get_file() + ": " + String::num_int64(chunks_x) + "x" + String::num_int64(chunks_y)
+			+ " chunks, " + String::num_int64(cell_widths.size()) + " layers, " + String::num_int64(tiles.size() * total) + " tiles, "
+			+ String::num_int64(shapes.size() * total) + " shapes, " + String::num_int64(spawns.size() * total) + " spawns, "
+			+ String::num(bytes.size() / 1024.0, 1) + " KB");
+	Godot::print("  " + String::num_int64(skipped) + " nodes left to the host scene");
+	return true;
+}
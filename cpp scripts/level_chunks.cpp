@@ -0,0 +1,361 @@
+#include "level_chunks.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace godot;
+
+static size_t align4(size_t value) {
+	return (value + 3) & ~(size_t)3;
+}
+
+// ------------------ CHUNKS --------------------
+LevelChunks::LevelChunks() :
+		header(nullptr),
+		layers(nullptr),
+		palette(nullptr),
+		groups(nullptr),
+		scenes(nullptr),
+		chunks(nullptr),
+		tiles(nullptr),
+		rects(nullptr),
+		polygons(nullptr),
+		points(nullptr),
+		spawns(nullptr),
+		strings(nullptr) {}
+
+bool LevelChunks::open(const char* path) {
+	close();
+	if (!file.open(path)) return false;
+
+	if (!bind()) {
+		close();
+		return false;
+	}
+	return true;
+}
+
+void LevelChunks::close() {
+	file.close();
+	header = nullptr;
+}
+
+bool LevelChunks::bind() {
+	const uint8_t* data = file.get_data();
+	size_t size = file.get_size();
+	if (size < sizeof(LevelChunksHeader)) return false;
+
+	const LevelChunksHeader* h = reinterpret_cast<const LevelChunksHeader*>(data);
+	if (h->magic != LEVEL_CHUNKS_MAGIC || h->version != LEVEL_CHUNKS_VERSION) return false;
+	if (h->chunks_x == 0 || h->chunks_y == 0 || !(h->chunk_size > 0.0f)) return false;
+
+	size_t chunk_count = (size_t)h->chunks_x * h->chunks_y;
+
+	size_t offset = sizeof(LevelChunksHeader);
+	size_t layers_at = offset;
+	offset += (size_t)h->layer_count * sizeof(LevelLayerRecord);
+	size_t palette_at = offset;
+	offset += (size_t)h->palette_count * sizeof(LevelTileType);
+	size_t groups_at = offset;
+	offset += (size_t)h->group_count * sizeof(LevelGroupRecord);
+	size_t scenes_at = offset;
+	offset += (size_t)h->scene_count * sizeof(uint32_t);
+	size_t chunks_at = offset;
+	offset += chunk_count * sizeof(LevelChunkRecord);
+	size_t tiles_at = offset;
+	offset += (size_t)h->tile_count * sizeof(LevelTile);
+	size_t rects_at = offset;
+	offset += (size_t)h->rect_count * sizeof(LevelRect);
+	size_t polygons_at = offset;
+	offset += (size_t)h->polygon_count * sizeof(LevelPolygon);
+	size_t points_at = offset;
+	offset += (size_t)h->point_count * 2 * sizeof(float);
+	size_t spawns_at = offset;
+	offset += (size_t)h->spawn_count * sizeof(LevelSpawn);
+	size_t strings_at = offset;
+	offset += h->strings_size;
+
+	if (offset > size || h->strings_size == 0 || data[strings_at + h->strings_size - 1] != 0) return false;
+
+	layers = reinterpret_cast<const LevelLayerRecord*>(data + layers_at);
+	palette = reinterpret_cast<const LevelTileType*>(data + palette_at);
+	groups = reinterpret_cast<const LevelGroupRecord*>(data + groups_at);
+	scenes = reinterpret_cast<const uint32_t*>(data + scenes_at);
+	chunks = reinterpret_cast<const LevelChunkRecord*>(data + chunks_at);
+	tiles = reinterpret_cast<const LevelTile*>(data + tiles_at);
+	rects = reinterpret_cast<const LevelRect*>(data + rects_at);
+	polygons = reinterpret_cast<const LevelPolygon*>(data + polygons_at);
+	points = reinterpret_cast<const float*>(data + points_at);
+	spawns = reinterpret_cast<const LevelSpawn*>(data + spawns_at);
+	strings = reinterpret_cast<const char*>(data + strings_at);
+
+	// Every range checked here, so chunk loads later are plain indexing
+	for (uint16_t l = 0; l < h->layer_count; l++) {
+		const LevelLayerRecord& layer = layers[l];
+		if (layer.tile_set >= h->strings_size) return false;
+		if ((uint64_t)layer.first_type + layer.type_count > h->palette_count) return false;
+	}
+	for (uint16_t s = 0; s < h->scene_count; s++) {
+		if (scenes[s] >= h->strings_size) return false;
+	}
+	for (size_t c = 0; c < chunk_count; c++) {
+		const LevelChunkRecord& chunk = chunks[c];
+		if ((uint64_t)chunk.first_tile + chunk.tile_count > h->tile_count) return false;
+		if ((uint64_t)chunk.first_rect + chunk.rect_count > h->rect_count) return false;
+		if ((uint64_t)chunk.first_polygon + chunk.polygon_count > h->polygon_count) return false;
+		if ((uint64_t)chunk.first_spawn + chunk.spawn_count > h->spawn_count) return false;
+	}
+	for (uint32_t t = 0; t < h->tile_count; t++) {
+		const LevelTile& tile = tiles[t];
+		if (tile.layer >= h->layer_count || tile.type >= layers[tile.layer].type_count) return false;
+	}
+	for (uint32_t r = 0; r < h->rect_count; r++) {
+		if (rects[r].group >= h->group_count) return false;
+	}
+	for (uint32_t p = 0; p < h->polygon_count; p++) {
+		const LevelPolygon& polygon = polygons[p];
+		if (polygon.group >= h->group_count || (uint64_t)polygon.first_point + polygon.point_count > h->point_count) return false;
+	}
+	for (uint32_t s = 0; s < h->spawn_count; s++) {
+		if (spawns[s].scene >= h->scene_count) return false;
+	}
+
+	header = h;
+	return true;
+}
+
+void LevelChunks::chunk_at(float x, float y, int& cx, int& cy) const {
+	cx = (int)std::floor((x - header->origin_x) / header->chunk_size);
+	cy = (int)std::floor((y - header->origin_y) / header->chunk_size);
+	cx = std::clamp(cx, 0, header->chunks_x - 1);
+	cy = std::clamp(cy, 0, header->chunks_y - 1);
+}
+
+void LevelChunks::prefetch(int index) const {
+	const LevelChunkRecord& chunk = chunks[index];
+	const uint8_t* base = file.get_data();
+
+	auto touch = [&](const void* first, size_t bytes) {
+		if (bytes) file.prefetch((size_t)(static_cast<const uint8_t*>(first) - base), bytes);
+	};
+	touch(tiles + chunk.first_tile, chunk.tile_count * sizeof(LevelTile));
+	touch(rects + chunk.first_rect, chunk.rect_count * sizeof(LevelRect));
+	touch(spawns + chunk.first_spawn, chunk.spawn_count * sizeof(LevelSpawn));
+
+	if (chunk.polygon_count) {
+		const LevelPolygon* first = polygons + chunk.first_polygon;
+		const LevelPolygon& last = first[chunk.polygon_count - 1];
+		touch(first, chunk.polygon_count * sizeof(LevelPolygon));
+		touch(points + first->first_point * 2, (last.first_point + last.point_count - first->first_point) * 2 * sizeof(float));
+	}
+}
+
+// ------------------ WRITER --------------------
+LevelChunksWriter::LevelChunksWriter() {
+	header = {};
+	header.magic = LEVEL_CHUNKS_MAGIC;
+	header.version = LEVEL_CHUNKS_VERSION;
+	set_grid(1.0f, 0.0f, 0.0f, 1, 1);
+}
+
+void LevelChunksWriter::set_grid(float chunk_size, float origin_x, float origin_y, int chunks_x, int chunks_y) {
+	header.chunks_x = (uint16_t)chunks_x;
+	header.chunks_y = (uint16_t)chunks_y;
+	header.chunk_size = chunk_size;
+	header.origin_x = origin_x;
+	header.origin_y = origin_y;
+
+	size_t chunk_count = (size_t)chunks_x * chunks_y;
+	tiles.assign(chunk_count, {});
+	rects.assign(chunk_count, {});
+	spawns.assign(chunk_count, {});
+	polygons.clear();
+}
+
+uint32_t LevelChunksWriter::add_string(const std::string& value) {
+	uint32_t offset = (uint32_t)strings.size();
+	strings += value;
+	strings.push_back('\0');
+	return offset;
+}
+
+int LevelChunksWriter::chunk_of(float x, float y) const {
+	int cx = (int)std::floor((x - header.origin_x) / header.chunk_size);
+	int cy = (int)std::floor((y - header.origin_y) / header.chunk_size);
+	cx = std::clamp(cx, 0, header.chunks_x - 1);
+	cy = std::clamp(cy, 0, header.chunks_y - 1);
+	return cy * header.chunks_x + cx;
+}
+
+int LevelChunksWriter::add_layer(const std::string& tile_set, int z_index, float x, float y, float scale_x, float scale_y) {
+	LevelLayerRecord layer = {};
+	layer.tile_set = add_string(tile_set);
+	layer.z_index = z_index;
+	layer.x = x;
+	layer.y = y;
+	layer.scale_x = scale_x;
+	layer.scale_y = scale_y;
+	layers.push_back(layer);
+	palettes.emplace_back();
+	return (int)layers.size() - 1;
+}
+
+int LevelChunksWriter::add_tile_type(int layer, const LevelTileType& type) {
+	std::vector<LevelTileType>& palette = palettes[layer];
+	for (size_t i = 0; i < palette.size(); i++) {
+		if (memcmp(&palette[i], &type, sizeof(LevelTileType)) == 0) return (int)i;
+	}
+	palette.push_back(type);
+	return (int)palette.size() - 1;
+}
+
+int LevelChunksWriter::add_group(uint32_t collision_layer, uint32_t collision_mask, LevelGroupKind kind) {
+	for (size_t i = 0; i < groups.size(); i++) {
+		const LevelGroupRecord& group = groups[i];
+		if (group.collision_layer == collision_layer && group.collision_mask == collision_mask && group.kind == kind) return (int)i;
+	}
+
+	LevelGroupRecord group = {};
+	group.collision_layer = collision_layer;
+	group.collision_mask = collision_mask;
+	group.kind = kind;
+	groups.push_back(group);
+	return (int)groups.size() - 1;
+}
+
+int LevelChunksWriter::add_scene(const std::string& path) {
+	for (size_t i = 0; i < scenes.size(); i++) {
+		if (path == strings.c_str() + scenes[i]) return (int)i;
+	}
+	scenes.push_back(add_string(path));
+	return (int)scenes.size() - 1;
+}
+
+void LevelChunksWriter::add_tile(int layer, int type, int32_t cell_x, int32_t cell_y, float level_x, float level_y) {
+	tiles[chunk_of(level_x, level_y)].push_back(LevelTile{ cell_x, cell_y, (uint16_t)layer, (uint16_t)type });
+}
+
+void LevelChunksWriter::add_rect(int group, float min_x, float min_y, float max_x, float max_y) {
+	float size = header.chunk_size;
+	int cx0 = chunk_of(min_x, min_y) % header.chunks_x;
+	int cy0 = chunk_of(min_x, min_y) / header.chunks_x;
+	int cx1 = chunk_of(max_x, max_y) % header.chunks_x;
+	int cy1 = chunk_of(max_x, max_y) / header.chunks_x;
+
+	// Clipped at chunk edges; the outermost chunks keep whatever overhangs the grid
+	for (int cy = cy0; cy <= cy1; cy++) {
+		for (int cx = cx0; cx <= cx1; cx++) {
+			float x0 = cx == cx0 ? min_x : header.origin_x + cx * size;
+			float y0 = cy == cy0 ? min_y : header.origin_y + cy * size;
+			float x1 = cx == cx1 ? max_x : header.origin_x + (cx + 1) * size;
+			float y1 = cy == cy1 ? max_y : header.origin_y + (cy + 1) * size;
+			if (x1 <= x0 || y1 <= y0) continue;
+
+			rects[cy * header.chunks_x + cx].push_back(LevelRect{ x0, y0, x1, y1, (uint16_t)group, 0 });
+		}
+	}
+}
+
+void LevelChunksWriter::add_polygon(int group, const float* xy, int point_count) {
+	float min_x = xy[0], max_x = xy[0];
+	float min_y = xy[1], max_y = xy[1];
+	for (int i = 1; i < point_count; i++) {
+		min_x = std::min(min_x, xy[i * 2]);
+		max_x = std::max(max_x, xy[i * 2]);
+		min_y = std::min(min_y, xy[i * 2 + 1]);
+		max_y = std::max(max_y, xy[i * 2 + 1]);
+	}
+
+	Polygon polygon;
+	polygon.chunk = chunk_of((min_x + max_x) * 0.5f, (min_y + max_y) * 0.5f);
+	polygon.group = (uint16_t)group;
+	polygon.points.assign(xy, xy + point_count * 2);
+	polygons.push_back(std::move(polygon));
+}
+
+void LevelChunksWriter::add_spawn(int scene, float x, float y) {
+	spawns[chunk_of(x, y)].push_back(LevelSpawn{ x, y, (uint16_t)scene, 0 });
+}
+
+std::vector<uint8_t> LevelChunksWriter::build() const {
+	size_t chunk_count = tiles.size();
+
+	std::vector<LevelLayerRecord> layer_records = layers;
+	std::vector<LevelTileType> palette;
+	for (size_t l = 0; l < layers.size(); l++) {
+		layer_records[l].first_type = (uint32_t)palette.size();
+		layer_records[l].type_count = (uint32_t)palettes[l].size();
+		palette.insert(palette.end(), palettes[l].begin(), palettes[l].end());
+	}
+
+	// Flatten per-chunk buckets, polygons bucketed here
+	std::vector<std::vector<const Polygon*>> chunk_polygons(chunk_count);
+	for (const Polygon& polygon : polygons) {
+		chunk_polygons[polygon.chunk].push_back(&polygon);
+	}
+
+	std::vector<LevelChunkRecord> chunk_records(chunk_count);
+	std::vector<LevelTile> all_tiles;
+	std::vector<LevelRect> all_rects;
+	std::vector<LevelPolygon> all_polygons;
+	std::vector<float> all_points;
+	std::vector<LevelSpawn> all_spawns;
+
+	for (size_t c = 0; c < chunk_count; c++) {
+		LevelChunkRecord& record = chunk_records[c];
+		record.first_tile = (uint32_t)all_tiles.size();
+		record.tile_count = (uint32_t)tiles[c].size();
+		all_tiles.insert(all_tiles.end(), tiles[c].begin(), tiles[c].end());
+
+		record.first_rect = (uint32_t)all_rects.size();
+		record.rect_count = (uint16_t)rects[c].size();
+		all_rects.insert(all_rects.end(), rects[c].begin(), rects[c].end());
+
+		record.first_polygon = (uint32_t)all_polygons.size();
+		record.polygon_count = (uint16_t)chunk_polygons[c].size();
+		for (const Polygon* polygon : chunk_polygons[c]) {
+			all_polygons.push_back(LevelPolygon{ (uint32_t)(all_points.size() / 2), (uint16_t)(polygon->points.size() / 2), polygon->group });
+			all_points.insert(all_points.end(), polygon->points.begin(), polygon->points.end());
+		}
+
+		record.first_spawn = (uint32_t)all_spawns.size();
+		record.spawn_count = (uint16_t)spawns[c].size();
+		all_spawns.insert(all_spawns.end(), spawns[c].begin(), spawns[c].end());
+	}
+
+	LevelChunksHeader h = header;
+	h.layer_count = (uint16_t)layers.size();
+	h.group_count = (uint16_t)groups.size();
+	h.scene_count = (uint16_t)scenes.size();
+	h.palette_count = (uint32_t)palette.size();
+	h.tile_count = (uint32_t)all_tiles.size();
+	h.rect_count = (uint32_t)all_rects.size();
+	h.polygon_count = (uint32_t)all_polygons.size();
+	h.point_count = (uint32_t)(all_points.size() / 2);
+	h.spawn_count = (uint32_t)all_spawns.size();
+
+	std::string all_strings = strings;
+	if (all_strings.empty()) all_strings.push_back('\0');
+	all_strings.resize(align4(all_strings.size()), '\0');
+	h.strings_size = (uint32_t)all_strings.size();
+
+	std::vector<uint8_t> out;
+	auto append = [&](const void* bytes, size_t count) {
+		const uint8_t* first = static_cast<const uint8_t*>(bytes);
+		out.insert(out.end(), first, first + count);
+	};
+	append(&h, sizeof(h));
+	append(layer_records.data(), layer_records.size() * sizeof(LevelLayerRecord));
+	append(palette.data(), palette.size() * sizeof(LevelTileType));
+	append(groups.data(), groups.size() * sizeof(LevelGroupRecord));
+	append(scenes.data(), scenes.size() * sizeof(uint32_t));
+	append(chunk_records.data(), chunk_records.size() * sizeof(LevelChunkRecord));
+	append(all_tiles.data(), all_tiles.size() * sizeof(LevelTile));
+	append(all_rects.data(), all_rects.size() * sizeof(LevelRect));
+	append(all_polygons.data(), all_polygons.size() * sizeof(LevelPolygon));
+	append(all_points.data(), all_points.size() * sizeof(float));
+	append(all_spawns.data(), all_spawns.size() * sizeof(LevelSpawn));
+	append(all_strings.data(), all_strings.size());
+	return out;
+}
@@ -0,0 +1,258 @@
+#pragma once
+
+#ifndef LEVEL_CHUNKS_H
+#define LEVEL_CHUNKS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mapped_file.h"
+
+namespace godot {
+
+    // ============================================================
+    // LEVEL CHUNK FORMAT (.level)
+    // A PvE level cut into a chunks_x * chunks_y grid of square chunks,
+    // chunk_size level units each, chunk (0,0) at (origin_x, origin_y).
+    // Little-endian, every section 4-byte aligned, in this order:
+    //   LevelChunksHeader
+    //   LevelLayerRecord layers[layer_count]
+    //   LevelTileType palette[palette_count]        grouped by layer
+    //   LevelGroupRecord groups[group_count]
+    //   uint32_t scenes[scene_count]                offsets into strings
+    //   LevelChunkRecord chunks[chunks_x * chunks_y] row-major
+    //   LevelTile tiles[tile_count]                 grouped by chunk
+    //   LevelRect rects[rect_count]                 grouped by chunk
+    //   LevelPolygon polygons[polygon_count]        grouped by chunk
+    //   float points[point_count][2]                grouped by polygon
+    //   LevelSpawn spawns[spawn_count]              grouped by chunk
+    //   char strings[strings_size]                  NUL-terminated
+    // Written by LevelChunkExporter, read in place by LevelChunks.
+    // Tiles are in their layer's cell coordinates; rects, polygons and
+    // spawns in level space (the streaming node's local space). A
+    // chunk's data is one contiguous run per section, so streaming it
+    // in touches a handful of pages.
+    // ============================================================
+    const uint32_t LEVEL_CHUNKS_MAGIC = 0x4B48434C;     // "LCHK"
+    const uint16_t LEVEL_CHUNKS_VERSION = 1;
+
+    enum LevelGroupKind : uint8_t {
+        LEVEL_GROUP_SOLID,          // StaticBody2D
+        LEVEL_GROUP_ONE_WAY,        // StaticBody2D, one-way shapes
+        LEVEL_GROUP_KILL,           // killzone Area2D
+    };
+
+    struct LevelChunksHeader {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t layer_count;
+        uint16_t chunks_x, chunks_y;
+        float chunk_size;
+        float origin_x, origin_y;
+        uint16_t group_count;
+        uint16_t scene_count;
+        uint32_t palette_count;
+        uint32_t tile_count;
+        uint32_t rect_count;
+        uint32_t polygon_count;
+        uint32_t point_count;
+        uint32_t spawn_count;
+        uint32_t strings_size;
+    };
+
+    struct LevelLayerRecord {
+        uint32_t tile_set;          // strings offset, resource path
+        uint32_t first_type;        // into palette
+        uint32_t type_count;
+        int32_t z_index;
+        float x, y;                 // layer transform in level space
+        float scale_x, scale_y;
+    };
+
+    struct LevelTileType {
+        int32_t source;
+        int16_t atlas_x, atlas_y;
+        int32_t alternative;
+    };
+
+    struct LevelGroupRecord {
+        uint32_t collision_layer;
+        uint32_t collision_mask;
+        uint8_t kind;
+        uint8_t reserved[3];
+    };
+
+    struct LevelChunkRecord {
+        uint32_t first_tile;
+        uint32_t tile_count;
+        uint32_t first_rect;
+        uint32_t first_polygon;
+        uint32_t first_spawn;
+        uint16_t rect_count;
+        uint16_t polygon_count;
+        uint16_t spawn_count;
+        uint16_t reserved;
+    };
+
+    struct LevelTile {
+        int32_t x, y;               // cell in its layer
+        uint16_t layer;
+        uint16_t type;              // into the layer's palette run
+    };
+
+    struct LevelRect {
+        float min_x, min_y, max_x, max_y;
+        uint16_t group;
+        uint16_t reserved;
+    };
+
+    struct LevelPolygon {
+        uint32_t first_point;
+        uint16_t point_count;
+        uint16_t group;
+    };
+
+    struct LevelSpawn {
+        float x, y;
+        uint16_t scene;
+        uint16_t reserved;
+    };
+
+    static_assert(sizeof(LevelChunksHeader) == 56, "LevelChunksHeader layout");
+    static_assert(sizeof(LevelLayerRecord) == 32, "LevelLayerRecord layout");
+    static_assert(sizeof(LevelTileType) == 12, "LevelTileType layout");
+    static_assert(sizeof(LevelGroupRecord) == 12, "LevelGroupRecord layout");
+    static_assert(sizeof(LevelChunkRecord) == 28, "LevelChunkRecord layout");
+    static_assert(sizeof(LevelTile) == 12, "LevelTile layout");
+    static_assert(sizeof(LevelRect) == 20, "LevelRect layout");
+    static_assert(sizeof(LevelPolygon) == 8, "LevelPolygon layout");
+    static_assert(sizeof(LevelSpawn) == 12, "LevelSpawn layout");
+
+    // ============================================================
+    // LEVEL CHUNKS
+    // A .level file, memory-mapped read-only and used in place, the
+    // same way FrameTable is. open() validates every range once;
+    // prefetch() faults a chunk's pages in and is safe to call from a
+    // loader thread while the main thread reads other chunks.
+    // ============================================================
+    class LevelChunks {
+    public:
+        LevelChunks();
+
+        LevelChunks(const LevelChunks&) = delete;
+        LevelChunks& operator=(const LevelChunks&) = delete;
+
+        // OS path (ProjectSettings::globalize_path for res://)
+        bool open(const char* path);
+        void close();
+        bool is_open() const { return header != nullptr; }
+        size_t get_size() const { return file.get_size(); }
+
+        const LevelChunksHeader& get_header() const { return *header; }
+        int get_chunks_x() const { return header->chunks_x; }
+        int get_chunks_y() const { return header->chunks_y; }
+        int get_chunk_count() const { return header->chunks_x * header->chunks_y; }
+        float get_chunk_size() const { return header->chunk_size; }
+
+        int get_layer_count() const { return header->layer_count; }
+        const LevelLayerRecord& get_layer(int index) const { return layers[index]; }
+        const LevelTileType& get_tile_type(int layer, int type) const { return palette[layers[layer].first_type + type]; }
+
+        int get_group_count() const { return header->group_count; }
+        const LevelGroupRecord& get_group(int index) const { return groups[index]; }
+
+        int get_scene_count() const { return header->scene_count; }
+        int get_spawn_count() const { return (int)header->spawn_count; }
+
+        const char* get_string(uint32_t offset) const { return strings + offset; }
+        const char* get_scene_path(int index) const { return strings + scenes[index]; }
+
+        const LevelChunkRecord& get_chunk(int index) const { return chunks[index]; }
+        const LevelTile* get_tiles(const LevelChunkRecord& chunk) const { return tiles + chunk.first_tile; }
+        const LevelRect* get_rects(const LevelChunkRecord& chunk) const { return rects + chunk.first_rect; }
+        const LevelPolygon* get_polygons(const LevelChunkRecord& chunk) const { return polygons + chunk.first_polygon; }
+        const float* get_points(const LevelPolygon& polygon) const { return points + polygon.first_point * 2; }
+        const LevelSpawn* get_spawns(const LevelChunkRecord& chunk) const { return spawns + chunk.first_spawn; }
+        // Index into the whole level's spawn list, stable across loads
+        int get_spawn_index(const LevelChunkRecord& chunk, int i) const { return (int)chunk.first_spawn + i; }
+
+        // Chunk containing a level-space point, clamped to the grid
+        void chunk_at(float x, float y, int& cx, int& cy) const;
+
+        void prefetch(int index) const;
+
+    private:
+        MappedFile file;
+
+        const LevelChunksHeader* header;
+        const LevelLayerRecord* layers;
+        const LevelTileType* palette;
+        const LevelGroupRecord* groups;
+        const uint32_t* scenes;
+        const LevelChunkRecord* chunks;
+        const LevelTile* tiles;
+        const LevelRect* rects;
+        const LevelPolygon* polygons;
+        const float* points;
+        const LevelSpawn* spawns;
+        const char* strings;
+
+        bool bind();
+    };
+
+    // ============================================================
+    // LEVEL CHUNKS WRITER
+    // Layers, tile types, groups and scenes can be added first, to get
+    // their ids while the level's extent is still unknown; set_grid()
+    // comes before any tile, rect, polygon or spawn. Tiles are bucketed
+    // by the level-space point passed with them (their cell centre),
+    // polygons by their bounding box centre, rects are clipped at chunk
+    // edges.
+    // ============================================================
+    class LevelChunksWriter {
+    public:
+        LevelChunksWriter();
+
+        void set_grid(float chunk_size, float origin_x, float origin_y, int chunks_x, int chunks_y);
+
+        int add_layer(const std::string& tile_set, int z_index, float x, float y, float scale_x, float scale_y);
+        int add_tile_type(int layer, const LevelTileType& type);
+        int add_group(uint32_t collision_layer, uint32_t collision_mask, LevelGroupKind kind);
+        int add_scene(const std::string& path);
+
+        void add_tile(int layer, int type, int32_t cell_x, int32_t cell_y, float level_x, float level_y);
+        void add_rect(int group, float min_x, float min_y, float max_x, float max_y);
+        void add_polygon(int group, const float* xy, int point_count);
+        void add_spawn(int scene, float x, float y);
+
+        std::vector<uint8_t> build() const;
+
+    private:
+        struct Polygon {
+            int chunk;
+            uint16_t group;
+            std::vector<float> points;
+        };
+
+        LevelChunksHeader header;
+        std::vector<LevelLayerRecord> layers;
+        std::vector<std::vector<LevelTileType>> palettes;
+        std::vector<LevelGroupRecord> groups;
+        std::vector<uint32_t> scenes;
+        std::string strings;
+
+        // per chunk
+        std::vector<std::vector<LevelTile>> tiles;
+        std::vector<std::vector<LevelRect>> rects;
+        std::vector<std::vector<LevelSpawn>> spawns;
+        std::vector<Polygon> polygons;
+
+        int chunk_of(float x, float y) const;
+        uint32_t add_string(const std::string& value);
+    };
+
+} // namespace godot
+
+#endif
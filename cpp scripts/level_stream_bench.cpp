@@ -0,0 +1,161 @@
+// Memory and frame time while streaming a long level end to end.
+// Export a long level first (LevelChunkExporter with repeat_x set so the
+// level is 100+ screens wide), then add a LevelStreamBench node to an
+// empty scene and run it. It streams `level_path` around a camera that
+// flies the level's middle row left to right at `speed` and prints, at
+// every tenth of the way, static memory, object and node counts and
+// resident chunks (flat lines are the point), then the mean / worst
+// process time and how many frames went over hitch_msec.
+
+#include <Godot.hpp>
+#include <Node2D.hpp>
+#include <Camera2D.hpp>
+#include <Viewport.hpp>
+#include <Performance.hpp>
+
+#include "level_streamer.h"
+
+#include <algorithm>
+
+namespace godot {
+
+    class LevelStreamBench : public Node2D {
+        GODOT_CLASS(LevelStreamBench, Node2D)
+
+    public:
+        static void _register_methods();
+
+        void _init() override;
+        void _ready() override;
+        void _process(double delta) override;
+
+        String level_path;
+        float speed;
+        float hitch_msec;
+        int load_radius;
+        int unload_radius;
+        int tiles_per_frame;
+
+    private:
+        LevelStreamer* streamer;
+        Camera2D* camera;
+        float start_x;
+        float end_x;
+        int checkpoint;
+        bool done;
+
+        int64_t frames;
+        double total_msec;
+        double worst_msec;
+        int64_t hitches;
+
+        void print_checkpoint(int tenth);
+    };
+
+} // namespace godot
+
+using namespace godot;
+
+void LevelStreamBench::_register_methods() {
+	register_method("_ready", &LevelStreamBench::_ready);
+	register_method("_process", &LevelStreamBench::_process);
+
+	register_property<LevelStreamBench, String>("level_path", &LevelStreamBench::level_path, "res://levels/game_1.level");
+	register_property<LevelStreamBench, float>("speed", &LevelStreamBench::speed, 4000.0f);
+	register_property<LevelStreamBench, float>("hitch_msec", &LevelStreamBench::hitch_msec, 8.0f);
+	register_property<LevelStreamBench, int>("load_radius", &LevelStreamBench::load_radius, 1);
+	register_property<LevelStreamBench, int>("unload_radius", &LevelStreamBench::unload_radius, 2);
+	register_property<LevelStreamBench, int>("tiles_per_frame", &LevelStreamBench::tiles_per_frame, 256);
+}
+
+void LevelStreamBench::_init() {
+	level_path = "res://levels/game_1.level";
+	speed = 4000.0f;
+	hitch_msec = 8.0f;
+	load_radius = 1;
+	unload_radius = 2;
+	tiles_per_frame = 256;
+
+	streamer = nullptr;
+	camera = nullptr;
+	start_x = 0.0f;
+	end_x = 0.0f;
+	checkpoint = 0;
+	done = true;
+
+	frames = 0;
+	total_msec = 0.0;
+	worst_msec = 0.0;
+	hitches = 0;
+}
+
+void LevelStreamBench::_ready() {
+	camera = memnew(Camera2D);
+	camera->set_name("Camera");
+	add_child(camera);
+	camera->make_current();
+
+	streamer = LevelStreamer::_new();
+	streamer->load_radius = load_radius;
+	streamer->unload_radius = unload_radius;
+	streamer->tiles_per_frame = tiles_per_frame;
+	streamer->focus_path = NodePath("../Camera");
+	add_child(streamer);
+	if (!streamer->open_level(level_path)) return;
+
+	const LevelChunksHeader& header = streamer->get_level().get_header();
+	float screen = get_viewport()->get_visible_rect().size.x;
+	start_x = header.origin_x;
+	end_x = header.origin_x + header.chunk_size * header.chunks_x;
+	camera->set_position(Vector2(start_x, header.origin_y + header.chunk_size * header.chunks_y * 0.5f));
+	streamer->warm(camera->get_position());
+
+	Godot::print("LevelStreamBench: " + String::num(streamer->get_level().get_size() / 1024.0, 1) + " KB, "
+			+ String::num_int64(header.chunks_x) + "x" + String::num_int64(header.chunks_y) + " chunks, "
+			+ String::num((end_x - start_x) / std::max(screen, 1.0f), 1) + " screens wide");
+	print_checkpoint(0);
+	checkpoint = 1;
+	done = false;
+}
+
+void LevelStreamBench::print_checkpoint(int tenth) {
+	Performance* performance = Performance::get_singleton();
+	Dictionary stats = streamer->get_stats();
+
+	Godot::print("  " + String::num_int64(tenth * 10) + "%: static "
+			+ String::num(performance->get_monitor(Performance::MEMORY_STATIC) / (1024.0 * 1024.0), 2) + " MB, objects "
+			+ String::num_int64((int64_t)performance->get_monitor(Performance::OBJECT_COUNT)) + ", nodes "
+			+ String::num_int64((int64_t)performance->get_monitor(Performance::OBJECT_NODE_COUNT)) + ", resident "
+			+ String::num_int64((int64_t)stats["resident_chunks"]) + " chunks");
+}
+
+void LevelStreamBench::_process(double delta) {
+	if (done) return;
+
+	// Previous frame's main-thread process time, streaming included
+	double msec = Performance::get_singleton()->get_monitor(Performance::TIME_PROCESS) * 1000.0;
+	frames++;
+	total_msec += msec;
+	worst_msec = std::max(worst_msec, msec);
+	if (msec > hitch_msec) hitches++;
+
+	Vector2 position = camera->get_position();
+	position.x += speed * (float)delta;
+	camera->set_position(position);
+
+	float progress = (position.x - start_x) / (end_x - start_x);
+	while (checkpoint <= 10 && progress >= checkpoint * 0.1f) {
+		print_checkpoint(checkpoint);
+		checkpoint++;
+	}
+	if (checkpoint <= 10) return;
+
+	done = true;
+	Dictionary stats = streamer->get_stats();
+	Godot::print("  process " + String::num(total_msec / std::max(frames, (int64_t)1), 3) + " ms mean, "
+			+ String::num(worst_msec, 3) + " ms worst, " + String::num_int64(hitches) + "/" + String::num_int64(frames)
+			+ " frames over " + String::num(hitch_msec, 1) + " ms");
+	Godot::print("  " + String::num_int64((int64_t)stats["loads"]) + " loads, " + String::num_int64((int64_t)stats["unloads"])
+			+ " unloads, " + String::num_int64((int64_t)stats["max_tile_ops"]) + " tile edits worst frame, "
+			+ String::num_int64((int64_t)stats["spawn_misses"]) + " spawn misses");
+}
@@ -0,0 +1,642 @@
+#include "level_streamer.h"
+
+#include <ResourceLoader.hpp>
+#include <ProjectSettings.hpp>
+#include <Viewport.hpp>
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+
+using namespace godot;
+
+LevelStreamer::LevelStreamer() {}
+
+LevelStreamer::~LevelStreamer() {
+	// Children go with the tree; only the thread and the mapping are ours
+	stop_loader();
+	level.close();
+}
+
+void LevelStreamer::_register_methods() {
+	register_method("_ready", &LevelStreamer::_ready);
+	register_method("_process", &LevelStreamer::_process);
+
+	register_method("open_level", &LevelStreamer::open_level);
+	register_method("close_level", &LevelStreamer::close_level);
+	register_method("warm", &LevelStreamer::warm);
+	register_method("release", &LevelStreamer::release);
+	register_method("get_resident_count", &LevelStreamer::get_resident_count);
+	register_method("get_stats", &LevelStreamer::get_stats);
+	register_method("finish_park", &LevelStreamer::finish_park);
+
+	register_property<LevelStreamer, String>("level_path", &LevelStreamer::level_path, "");
+	register_property<LevelStreamer, NodePath>("focus_path", &LevelStreamer::focus_path, NodePath());
+	register_property<LevelStreamer, int>("load_radius", &LevelStreamer::load_radius, 1);
+	register_property<LevelStreamer, int>("unload_radius", &LevelStreamer::unload_radius, 2);
+	register_property<LevelStreamer, int>("tiles_per_frame", &LevelStreamer::tiles_per_frame, 256);
+	register_property<LevelStreamer, Ref<PackedScene>>("killzone_scene", &LevelStreamer::killzone_scene, Ref<PackedScene>());
+	register_property<LevelStreamer, bool>("schedule_updates", &LevelStreamer::schedule_updates, true);
+	register_property<LevelStreamer, int>("spawn_budget_usec", &LevelStreamer::spawn_budget_usec, 1000);
+}
+
+void LevelStreamer::_init() {
+	load_radius = 1;
+	unload_radius = 2;
+	tiles_per_frame = 256;
+	schedule_updates = true;
+	spawn_budget_usec = 1000;
+
+	opened = false;
+	resident = 0;
+	waves = nullptr;
+	focus_x = -1;
+	focus_y = -1;
+	quit = false;
+
+	loads = 0;
+	unloads = 0;
+	misses = 0;
+	last_tile_ops = 0;
+	max_tile_ops = 0;
+}
+
+void LevelStreamer::_ready() {
+	// The streamed enemies and coins look it up on their first spawn
+	if (schedule_updates && !get_tree()->get_first_node_in_group("update_scheduler")) {
+		UpdateScheduler* scheduler = UpdateScheduler::_new();
+		scheduler->set_name("UpdateScheduler");
+		scheduler->add_to_group("update_scheduler");
+		add_child(scheduler);
+	}
+
+	if (spawn_budget_usec > 0) {
+		waves = WaveSpawner::_new();
+		waves->set_name("WaveSpawner");
+		waves->budget_usec = spawn_budget_usec;
+		waves->instantiate_on_miss = false;
+		waves->set_source([this](int scene, int spawn_index, Vector2 position) {
+			return spawn_queued(scene, spawn_index, position);
+		});
+		add_child(waves);
+	}
+
+	if (level_path.is_empty()) return;
+	if (!open_level(level_path)) return;
+
+	// Whatever the camera starts on is there on the first frame
+	Vector2 position;
+	if (find_focus(position)) warm(position);
+}
+
+void LevelStreamer::_process(double delta) {
+	Vector2 position;
+	if (!opened || !find_focus(position)) return;
+	update(position, false);
+}
+
+// ------------------ OPEN --------------------
+bool LevelStreamer::open_level(const String& path) {
+	close_level();
+
+	String os_path = ProjectSettings::get_singleton()->globalize_path(path);
+	ERR_FAIL_COND_V_MSG(!level.open(os_path.utf8().get_data()), false, "LevelStreamer: cannot open " + path);
+
+	// Keep a margin so there is always somewhere to unload to
+	unload_radius = std::max(unload_radius, load_radius + 1);
+
+	for (int l = 0; l < level.get_layer_count(); l++) {
+		const LevelLayerRecord& record = level.get_layer(l);
+
+		TileMapLayer* layer = memnew(TileMapLayer);
+		layer->set_name("tiles_" + String::num_int64(l));
+		layer->set_tile_set(ResourceLoader::get_singleton()->load(String::utf8(level.get_string(record.tile_set))));
+		layer->set_position(Vector2(record.x, record.y));
+		layer->set_scale(Vector2(record.scale_x, record.scale_y));
+		layer->set_z_index(record.z_index);
+		// Merged rects in the level file stand in for per-tile bodies
+		layer->set_collision_enabled(false);
+		add_child(layer);
+		layers.push_back(layer);
+	}
+
+	int chunk_count = level.get_chunk_count();
+	state.assign(chunk_count, CHUNK_UNLOADED);
+	slot_of.assign(chunk_count, -1);
+	consumed.assign(level.get_spawn_count(), 0);
+	ready.reserve(chunk_count);
+	ready_swap.reserve(chunk_count);
+
+	build_slots();
+	build_pools();
+
+	quit = false;
+	loader = std::thread(&LevelStreamer::loader_main, this);
+	opened = true;
+	return true;
+}
+
+void LevelStreamer::close_level() {
+	stop_loader();
+	if (!opened) return;
+
+	for (TileMapLayer* layer : layers) {
+		layer->queue_free();
+	}
+	for (Slot& slot : slots) {
+		for (CollisionObject2D* body : slot.bodies) {
+			body->queue_free();
+		}
+	}
+	for (SpawnPool& pool : pools) {
+		for (Node* node : pool.instances) {
+			node->queue_free();
+		}
+	}
+	if (waves) waves->clear_queue();
+	queued_slot.clear();
+
+	layers.clear();
+	slots.clear();
+	free_slots.clear();
+	pools.clear();
+	pool_slots.clear();
+	tile_jobs.clear();
+	resident = 0;
+	focus_x = -1;
+	focus_y = -1;
+
+	level.close();
+	opened = false;
+}
+
+// One slot per chunk the resident window can hold, each with a body per
+// collision group and enough shapes for the busiest chunk
+void LevelStreamer::build_slots() {
+	int side = 2 * unload_radius + 1;
+	int count = std::min(side * side, level.get_chunk_count());
+
+	int max_rects = 0;
+	int max_polygons = 0;
+	int max_spawns = 0;
+	for (int c = 0; c < level.get_chunk_count(); c++) {
+		const LevelChunkRecord& record = level.get_chunk(c);
+		max_rects = std::max(max_rects, (int)record.rect_count);
+		max_polygons = std::max(max_polygons, (int)record.polygon_count);
+		max_spawns = std::max(max_spawns, (int)record.spawn_count);
+	}
+
+	slots.resize(count);
+	for (int i = 0; i < count; i++) {
+		Slot& slot = slots[i];
+
+		for (int g = 0; g < level.get_group_count(); g++) {
+			const LevelGroupRecord& group = level.get_group(g);
+
+			CollisionObject2D* body = nullptr;
+			if (group.kind == LEVEL_GROUP_KILL) {
+				if (killzone_scene.is_valid()) body = Object::cast_to<Area2D>(killzone_scene->instantiate());
+				if (!body) body = memnew(Area2D);
+			} else {
+				body = memnew(StaticBody2D);
+			}
+			body->set_name("chunk_" + String::num_int64(i) + "_group_" + String::num_int64(g));
+			body->set_collision_layer(group.collision_layer);
+			body->set_collision_mask(group.collision_mask);
+			add_child(body);
+			slot.bodies.push_back(body);
+		}
+
+		slot.rect_shapes.resize(max_rects);
+		for (Ref<RectangleShape2D>& shape : slot.rect_shapes) {
+			shape.instantiate();
+		}
+		slot.polygon_shapes.resize(max_polygons);
+		for (Ref<ConvexPolygonShape2D>& shape : slot.polygon_shapes) {
+			shape.instantiate();
+		}
+		slot.owners.reserve(max_rects + max_polygons);
+		slot.spawned.reserve(max_spawns);
+	}
+
+	for (int i = count - 1; i >= 0; i--) {
+		free_slots.push_back(i);
+	}
+}
+
+// Each scene's pool holds the most instances any resident window can ask for
+void LevelStreamer::build_pools() {
+	int width = level.get_chunks_x();
+	int height = level.get_chunks_y();
+	int scene_count = level.get_scene_count();
+
+	// Per scene summed-area table of spawn counts
+	std::vector<std::vector<int>> sums(scene_count, std::vector<int>((width + 1) * (height + 1), 0));
+	for (int cy = 0; cy < height; cy++) {
+		for (int cx = 0; cx < width; cx++) {
+			const LevelChunkRecord& record = level.get_chunk(cy * width + cx);
+			const LevelSpawn* spawns = level.get_spawns(record);
+
+			for (int s = 0; s < scene_count; s++) {
+				int here = 0;
+				for (int i = 0; i < record.spawn_count; i++) {
+					here += spawns[i].scene == s;
+				}
+				std::vector<int>& sum = sums[s];
+				sum[(cy + 1) * (width + 1) + cx + 1] = here + sum[cy * (width + 1) + cx + 1]
+						+ sum[(cy + 1) * (width + 1) + cx] - sum[cy * (width + 1) + cx];
+			}
+		}
+	}
+
+	pools.resize(scene_count);
+	for (int s = 0; s < scene_count; s++) {
+		const std::vector<int>& sum = sums[s];
+		int count = 0;
+		for (int cy = 0; cy < height; cy++) {
+			for (int cx = 0; cx < width; cx++) {
+				int x0 = std::max(cx - unload_radius, 0), x1 = std::min(cx + unload_radius, width - 1) + 1;
+				int y0 = std::max(cy - unload_radius, 0), y1 = std::min(cy + unload_radius, height - 1) + 1;
+				int window = sum[y1 * (width + 1) + x1] - sum[y0 * (width + 1) + x1] - sum[y1 * (width + 1) + x0] + sum[y0 * (width + 1) + x0];
+				count = std::max(count, window);
+			}
+		}
+
+		SpawnPool& pool = pools[s];
+		String path = String::utf8(level.get_scene_path(s));
+		pool.scene = ResourceLoader::get_singleton()->load(path);
+		if (pool.scene.is_null()) {
+			WARN_PRINT("LevelStreamer: cannot load spawn scene " + path);
+			continue;
+		}
+
+		pool.instances.reserve(count);
+		pool.owner.assign(count, -1);
+		for (int i = 0; i < count; i++) {
+			Node* node = pool.scene->instantiate();
+			ERR_CONTINUE(!node);
+
+			// Set before _ready so the scene knows to wait for _on_pool_spawn
+			node->set_meta("pooled", true);
+			park(node);
+			add_child(node);
+
+			pool_slots[node->get_instance_id()] = PoolSlot{ s, (int)pool.instances.size() };
+			pool.instances.push_back(node);
+		}
+		for (int i = (int)pool.instances.size() - 1; i >= 0; i--) {
+			pool.free_slots.push_back(i);
+		}
+	}
+}
+
+// ------------------ LOADER THREAD --------------------
+void LevelStreamer::loader_main() {
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true) {
+		wake.wait(lock, [this] { return quit || !requests.empty(); });
+		if (quit) break;
+
+		int chunk = requests.front();
+		requests.pop_front();
+
+		lock.unlock();
+		level.prefetch(chunk);
+		lock.lock();
+
+		ready.push_back(chunk);
+	}
+}
+
+void LevelStreamer::stop_loader() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		quit = true;
+		requests.clear();
+		ready.clear();
+	}
+	wake.notify_all();
+	if (loader.joinable()) loader.join();
+}
+
+// ------------------ STREAMING --------------------
+bool LevelStreamer::find_focus(Vector2& position) const {
+	if (!focus_path.is_empty()) {
+		Node2D* focus = Object::cast_to<Node2D>(get_node_or_null(focus_path));
+		if (!focus) return false;
+		position = to_local(focus->get_global_position());
+		return true;
+	}
+
+	Camera2D* camera = get_viewport()->get_camera_2d();
+	if (!camera) return false;
+	position = to_local(camera->get_screen_center_position());
+	return true;
+}
+
+void LevelStreamer::warm(Vector2 position) {
+	ERR_FAIL_COND(!opened);
+	update(position, true);
+}
+
+void LevelStreamer::update(Vector2 position, bool unlimited) {
+	int fx, fy;
+	level.chunk_at(position.x, position.y, fx, fy);
+
+	auto distance = [&](int chunk) {
+		int cx = chunk % level.get_chunks_x();
+		int cy = chunk / level.get_chunks_x();
+		return std::max(std::abs(cx - fx), std::abs(cy - fy));
+	};
+
+	if (fx != focus_x || fy != focus_y) {
+		focus_x = fx;
+		focus_y = fy;
+
+		for (Slot& slot : slots) {
+			if (slot.chunk >= 0 && distance(slot.chunk) > unload_radius) unload_chunk(slot.chunk);
+		}
+
+		int x0 = std::max(fx - load_radius, 0), x1 = std::min(fx + load_radius, level.get_chunks_x() - 1);
+		int y0 = std::max(fy - load_radius, 0), y1 = std::min(fy + load_radius, level.get_chunks_y() - 1);
+
+		// Nearest first, so the chunk being walked into is never behind the corners
+		for (int ring = 0; ring <= load_radius; ring++) {
+			for (int cy = y0; cy <= y1; cy++) {
+				for (int cx = x0; cx <= x1; cx++) {
+					int chunk = cy * level.get_chunks_x() + cx;
+					if (distance(chunk) != ring || state[chunk] != CHUNK_UNLOADED) continue;
+
+					if (unlimited) {
+						level.prefetch(chunk);
+						load_chunk(chunk, true);
+					} else {
+						request(chunk);
+					}
+				}
+			}
+		}
+		wake.notify_one();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		ready_swap.swap(ready);
+	}
+	for (int chunk : ready_swap) {
+		if (state[chunk] != CHUNK_QUEUED) continue;
+
+		// Walked away again while it was loading
+		if (distance(chunk) > unload_radius) {
+			state[chunk] = CHUNK_UNLOADED;
+			continue;
+		}
+		load_chunk(chunk, false);
+	}
+	ready_swap.clear();
+
+	last_tile_ops = run_tile_jobs(unlimited ? INT_MAX : std::max(tiles_per_frame, 1));
+	max_tile_ops = std::max(max_tile_ops, last_tile_ops);
+}
+
+void LevelStreamer::request(int chunk) {
+	state[chunk] = CHUNK_QUEUED;
+	std::lock_guard<std::mutex> lock(mutex);
+	requests.push_back(chunk);
+}
+
+void LevelStreamer::load_chunk(int chunk, bool unlimited) {
+	ERR_FAIL_COND_MSG(free_slots.empty(), "LevelStreamer: no free chunk slot");
+	int index = free_slots.back();
+	free_slots.pop_back();
+
+	Slot& slot = slots[index];
+	slot.chunk = chunk;
+	slot_of[chunk] = index;
+
+	const LevelChunkRecord& record = level.get_chunk(chunk);
+
+	const LevelRect* rects = level.get_rects(record);
+	for (int i = 0; i < record.rect_count; i++) {
+		const LevelRect& rect = rects[i];
+		Ref<RectangleShape2D>& shape = slot.rect_shapes[i];
+		shape->set_size(Vector2(rect.max_x - rect.min_x, rect.max_y - rect.min_y));
+
+		CollisionObject2D* body = slot.bodies[rect.group];
+		uint32_t owner = body->create_shape_owner(body);
+		body->shape_owner_add_shape(owner, shape);
+		body->shape_owner_set_transform(owner, Transform2D(0.0f, Vector2((rect.min_x + rect.max_x) * 0.5f, (rect.min_y + rect.max_y) * 0.5f)));
+		body->shape_owner_set_one_way_collision(owner, level.get_group(rect.group).kind == LEVEL_GROUP_ONE_WAY);
+		slot.owners.push_back({ rect.group, owner });
+	}
+
+	const LevelPolygon* polygons = level.get_polygons(record);
+	for (int i = 0; i < record.polygon_count; i++) {
+		const LevelPolygon& polygon = polygons[i];
+		const float* xy = level.get_points(polygon);
+
+		PackedVector2Array points;
+		points.resize(polygon.point_count);
+		for (int k = 0; k < polygon.point_count; k++) {
+			points.set(k, Vector2(xy[k * 2], xy[k * 2 + 1]));
+		}
+		Ref<ConvexPolygonShape2D>& shape = slot.polygon_shapes[i];
+		shape->set_points(points);
+
+		CollisionObject2D* body = slot.bodies[polygon.group];
+		uint32_t owner = body->create_shape_owner(body);
+		body->shape_owner_add_shape(owner, shape);
+		body->shape_owner_set_one_way_collision(owner, level.get_group(polygon.group).kind == LEVEL_GROUP_ONE_WAY);
+		slot.owners.push_back({ polygon.group, owner });
+	}
+
+	const LevelSpawn* spawns = level.get_spawns(record);
+	for (int i = 0; i < record.spawn_count; i++) {
+		int spawn_index = level.get_spawn_index(record, i);
+		if (consumed[spawn_index]) continue;
+
+		Vector2 position(spawns[i].x, spawns[i].y);
+		// Warming fills the first frame, so only streamed-in chunks wait their turn
+		if (waves && !unlimited) {
+			int wave = waves->queue_tagged(spawns[i].scene, to_global(position), spawn_index);
+			slot.queued.push_back({ spawn_index, wave });
+			queued_slot[spawn_index] = index;
+			continue;
+		}
+
+		Node* node = spawn(spawns[i].scene, spawn_index, position);
+		if (node) slot.spawned.push_back({ spawn_index, node });
+	}
+
+	tile_jobs.push_back(TileJob{ chunk, true, 0 });
+	state[chunk] = CHUNK_LOADED;
+	resident++;
+	loads++;
+}
+
+void LevelStreamer::unload_chunk(int chunk) {
+	int index = slot_of[chunk];
+	ERR_FAIL_COND(index < 0);
+	Slot& slot = slots[index];
+
+	for (const std::pair<int, uint32_t>& owner : slot.owners) {
+		slot.bodies[owner.first]->remove_shape_owner(owner.second);
+	}
+	slot.owners.clear();
+
+	// Still waiting in the WaveSpawner: never handed out, so not consumed either
+	for (const std::pair<int, int>& queued : slot.queued) {
+		if (queued_slot.erase(queued.first)) waves->cancel_wave(queued.second);
+	}
+	slot.queued.clear();
+
+	for (const std::pair<int, Node*>& spawned : slot.spawned) {
+		const PoolSlot& pool_slot = pool_slots[spawned.second->get_instance_id()];
+		SpawnPool& pool = pools[pool_slot.pool];
+
+		// Still the instance we handed out for this spawn: take it back.
+		// Otherwise the scene released itself, so the spawn was used up.
+		if (pool.owner[pool_slot.index] == spawned.first) {
+			release(spawned.second);
+		} else {
+			consumed[spawned.first] = 1;
+		}
+	}
+	slot.spawned.clear();
+
+	tile_jobs.push_back(TileJob{ chunk, false, 0 });
+	slot.chunk = -1;
+	slot_of[chunk] = -1;
+	free_slots.push_back(index);
+	state[chunk] = CHUNK_UNLOADED;
+	resident--;
+	unloads++;
+}
+
+// Tile edits in order, so an unload queued behind a half-done load of
+// the same chunk still leaves it empty
+int LevelStreamer::run_tile_jobs(int budget) {
+	int ops = 0;
+	while (!tile_jobs.empty() && ops < budget) {
+		TileJob& job = tile_jobs.front();
+		const LevelChunkRecord& record = level.get_chunk(job.chunk);
+		const LevelTile* tiles = level.get_tiles(record);
+
+		for (; job.next < record.tile_count && ops < budget; job.next++, ops++) {
+			const LevelTile& tile = tiles[job.next];
+			TileMapLayer* layer = layers[tile.layer];
+
+			if (job.load) {
+				const LevelTileType& type = level.get_tile_type(tile.layer, tile.type);
+				layer->set_cell(Vector2i(tile.x, tile.y), type.source, Vector2i(type.atlas_x, type.atlas_y), type.alternative);
+			} else {
+				layer->erase_cell(Vector2i(tile.x, tile.y));
+			}
+		}
+
+		if (job.next >= record.tile_count) tile_jobs.pop_front();
+	}
+	return ops;
+}
+
+// ------------------ SPAWN POOLS --------------------
+void LevelStreamer::park(Node* node) {
+	if (CanvasItem* item = Object::cast_to<CanvasItem>(node)) {
+		item->hide();
+	}
+	node->set_process_mode(Node::PROCESS_MODE_DISABLED);
+}
+
+void LevelStreamer::finish_park(Node* node) {
+	if (!node) return;
+
+	auto found = pool_slots.find(node->get_instance_id());
+	if (found == pool_slots.end()) return;
+
+	// Handed out again before the flush
+	if (pools[found->second.pool].owner[found->second.index] >= 0) return;
+	park(node);
+}
+
+Node* LevelStreamer::spawn(int scene, int spawn_index, Vector2 position) {
+	SpawnPool& pool = pools[scene];
+	if (pool.free_slots.empty()) {
+		misses++;
+		return nullptr;
+	}
+
+	int index = pool.free_slots.back();
+	pool.free_slots.pop_back();
+	pool.owner[index] = spawn_index;
+
+	Node* node = pool.instances[index];
+	if (Node2D* node_2d = Object::cast_to<Node2D>(node)) {
+		node_2d->set_position(position);
+	}
+	if (CanvasItem* item = Object::cast_to<CanvasItem>(node)) {
+		item->show();
+	}
+	node->set_process_mode(Node::PROCESS_MODE_INHERIT);
+	if (node->has_method("_on_pool_spawn")) {
+		node->call("_on_pool_spawn");
+	}
+	return node;
+}
+
+// WaveSpawner's turn for a spawn load_chunk() queued
+Node* LevelStreamer::spawn_queued(int scene, int spawn_index, Vector2 global_position) {
+	auto found = queued_slot.find(spawn_index);
+	ERR_FAIL_COND_V(found == queued_slot.end(), nullptr);
+	Slot& slot = slots[found->second];
+	queued_slot.erase(found);
+
+	Node* node = spawn(scene, spawn_index, to_local(global_position));
+	if (node) slot.spawned.push_back({ spawn_index, node });
+	return node;
+}
+
+void LevelStreamer::release(Node* node) {
+	ERR_FAIL_COND(!node);
+
+	auto found = pool_slots.find(node->get_instance_id());
+	ERR_FAIL_COND_MSG(found == pool_slots.end(), "LevelStreamer: release() of a node this streamer does not own");
+
+	SpawnPool& pool = pools[found->second.pool];
+	int index = found->second.index;
+	if (pool.owner[index] < 0) return;     // released twice in one frame (hit + killzone)
+
+	if (node->has_method("_on_pool_release")) {
+		node->call("_on_pool_release");
+	}
+	// Same as ScenePool: called from physics callbacks, disable once they're done
+	if (CanvasItem* item = Object::cast_to<CanvasItem>(node)) {
+		item->hide();
+	}
+	call_deferred("finish_park", node);
+
+	pool.owner[index] = -1;
+	pool.free_slots.push_back(index);
+}
+
+// ------------------ STATS --------------------
+Dictionary LevelStreamer::get_stats() const {
+	int instances = 0;
+	for (const SpawnPool& pool : pools) {
+		instances += (int)pool.instances.size();
+	}
+
+	Dictionary result;
+	result["resident_chunks"] = (int64_t)resident;
+	result["slots"] = (int64_t)slots.size();
+	result["chunks"] = (int64_t)(opened ? level.get_chunk_count() : 0);
+	result["pool_instances"] = (int64_t)instances;
+	result["tile_jobs"] = (int64_t)tile_jobs.size();
+	result["last_tile_ops"] = (int64_t)last_tile_ops;
+	result["max_tile_ops"] = (int64_t)max_tile_ops;
+	result["loads"] = loads;
+	result["unloads"] = unloads;
+	result["spawn_misses"] = misses;
+	result["spawns_queued"] = (int64_t)queued_slot.size();
+	result["file_kb"] = opened ? (double)level.get_size() / 1024.0 : 0.0;
+	return result;
+}
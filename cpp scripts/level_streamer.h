@@ -0,0 +1,182 @@
+#pragma once
+
+#ifndef LEVEL_STREAMER_H
+#define LEVEL_STREAMER_H
+
+#include <Godot.hpp>
+#include <Node2D.hpp>
+#include <PackedScene.hpp>
+#include <TileMapLayer.hpp>
+#include <TileSet.hpp>
+#include <CollisionObject2D.hpp>
+#include <StaticBody2D.hpp>
+#include <Area2D.hpp>
+#include <RectangleShape2D.hpp>
+#include <ConvexPolygonShape2D.hpp>
+#include <Camera2D.hpp>
+
+#include "level_chunks.h"
+#include "update_scheduler.h"
+#include "wave_spawner.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace godot {
+
+    // ============================================================
+    // LEVEL STREAMER
+    // Streams a .level file (LevelChunkExporter) around the camera:
+    // chunks within load_radius of the focus chunk come in, chunks
+    // further than unload_radius go out, and the gap between the two
+    // keeps a player walking back and forth over a chunk edge from
+    // thrashing it.
+    // A loader thread faults each requested chunk's pages in; the main
+    // thread then adds its collision at once (a few merged rects), its
+    // tiles tiles_per_frame at a time and its spawns through a
+    // WaveSpawner child under spawn_budget_usec, on-screen ones first. Everything that scales with what is resident is sized
+    // once on open for the worst (2 * unload_radius + 1)^2 window:
+    // collision bodies and shapes per chunk slot, and one instance pool
+    // per spawn scene, so walking the level creates no nodes or
+    // resources, and memory stays flat however long the level is.
+    // Spawned scenes follow the ScenePool protocol ("pooled" meta,
+    // _on_pool_spawn / _on_pool_release, get_parent().release(self),
+    // disabled at the deferred flush after release).
+    // A spawn that was released by its scene (coin picked up, enemy
+    // killed) stays consumed when its chunk comes back.
+    // ============================================================
+    class LevelStreamer : public Node2D {
+        GODOT_CLASS(LevelStreamer, Node2D)
+
+    public:
+        LevelStreamer();
+        ~LevelStreamer();
+
+        static void _register_methods();
+
+        void _init() override;
+        void _ready() override;
+        void _process(double delta) override;
+
+        // ============================================================
+        // SETTINGS
+        // ============================================================
+        String level_path;
+        NodePath focus_path;            // empty: the viewport's Camera2D
+        int load_radius;                // in chunks, Chebyshev
+        int unload_radius;              // > load_radius
+        int tiles_per_frame;
+        Ref<PackedScene> killzone_scene;
+        bool schedule_updates;          // add an UpdateScheduler if the level has none
+        int spawn_budget_usec;          // 0: a chunk's spawns all come out on load
+
+        // ============================================================
+        // STREAMING
+        // ============================================================
+        bool open_level(const String& path);
+        void close_level();
+        // Stream everything around `position` (level space) in, no budget
+        void warm(Vector2 position);
+
+        void release(Node* node);
+
+        int get_resident_count() const { return resident; }
+        const LevelChunks& get_level() const { return level; }
+        Dictionary get_stats() const;
+
+    private:
+        enum ChunkState : uint8_t {
+            CHUNK_UNLOADED,
+            CHUNK_QUEUED,           // with the loader thread
+            CHUNK_LOADED,
+        };
+
+        struct Slot {
+            int chunk = -1;
+            std::vector<CollisionObject2D*> bodies;         // per group
+            std::vector<std::pair<int, uint32_t>> owners;   // group, shape owner
+            std::vector<Ref<RectangleShape2D>> rect_shapes;
+            std::vector<Ref<ConvexPolygonShape2D>> polygon_shapes;
+            std::vector<std::pair<int, Node*>> spawned;     // spawn index, instance
+            std::vector<std::pair<int, int>> queued;        // spawn index, wave
+        };
+
+        struct SpawnPool {
+            Ref<PackedScene> scene;
+            std::vector<Node*> instances;
+            std::vector<int> free_slots;
+            std::vector<int> owner;         // spawn index, -1 when free or released
+        };
+
+        struct PoolSlot {
+            int pool;
+            int index;
+        };
+
+        struct TileJob {
+            int chunk;
+            bool load;
+            uint32_t next;
+        };
+
+        LevelChunks level;
+        bool opened;
+
+        std::vector<TileMapLayer*> layers;
+        std::vector<Slot> slots;
+        std::vector<int> free_slots;
+        std::vector<uint8_t> state;         // per chunk
+        std::vector<int> slot_of;           // per chunk
+        std::vector<uint8_t> consumed;      // per spawn
+        std::vector<SpawnPool> pools;       // per scene
+        std::unordered_map<uint64_t, PoolSlot> pool_slots;
+        std::deque<TileJob> tile_jobs;
+        int resident;
+
+        WaveSpawner* waves;
+        std::unordered_map<int, int> queued_slot;  // spawn index -> slot, while in the WaveSpawner
+
+        int focus_x;
+        int focus_y;
+
+        // Loader thread
+        std::thread loader;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::deque<int> requests;
+        std::vector<int> ready;
+        std::vector<int> ready_swap;
+        bool quit;
+
+        // Stats
+        int64_t loads;
+        int64_t unloads;
+        int64_t misses;
+        int last_tile_ops;
+        int max_tile_ops;
+
+        void loader_main();
+        void stop_loader();
+
+        bool find_focus(Vector2& position) const;
+        void update(Vector2 position, bool unlimited);
+        void request(int chunk);
+        void load_chunk(int chunk, bool unlimited);
+        void unload_chunk(int chunk);
+        int run_tile_jobs(int budget);
+
+        void build_slots();
+        void build_pools();
+        Node* spawn(int scene, int spawn_index, Vector2 position);
+        Node* spawn_queued(int scene, int spawn_index, Vector2 global_position);
+        void park(Node* node);
+        void finish_park(Node* node);
+    };
+
+} // namespace godot
+
+#endif
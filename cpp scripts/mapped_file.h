@@ -0,0 +1,48 @@
+#pragma once
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace godot {
+
+    // ============================================================
+    // MAPPED FILE
+    // A whole file, memory-mapped read-only (POSIX mmap / Win32 file
+    // mapping). Files that can't be mapped (inside a .pck, odd
+    // filesystems) are read into memory instead, so callers always get
+    // one contiguous span either way.
+    // ============================================================
+    class MappedFile {
+    public:
+        MappedFile();
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        // OS path (ProjectSettings::globalize_path for res://)
+        bool open(const char* path);
+        void close();
+
+        const uint8_t* get_data() const { return data; }
+        size_t get_size() const { return size; }
+        bool is_mapped() const { return mapping != nullptr; }
+
+        // Touch every page in [offset, offset + length) so later reads
+        // don't fault; meant for a loader thread
+        void prefetch(size_t offset, size_t length) const;
+
+    private:
+        const uint8_t* data;
+        size_t size;
+        void* mapping;              // platform handle, null when data came from a plain read
+        std::vector<uint8_t> fallback;
+    };
+
+} // namespace godot
+
+#endif
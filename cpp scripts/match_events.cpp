@@ -0,0 +1,99 @@
+#include "match_events.h"
+
+#include <cstring>
+
+using namespace godot;
+
+MatchEventBus* MatchEventBus::singleton = nullptr;
+
+MatchEventListener::~MatchEventListener() {
+	if (MatchEventBus* bus = MatchEventBus::get_singleton()) {
+		bus->remove_listener(this);
+	}
+}
+
+MatchEventBus::MatchEventBus() :
+		count(0),
+		listener_count(0) {
+	for (int i = 0; i < MAX_LISTENERS; i++) {
+		listeners[i] = nullptr;
+	}
+}
+
+MatchEventBus* MatchEventBus::get_singleton() {
+	return singleton;
+}
+
+void MatchEventBus::set_singleton(MatchEventBus* bus) {
+	singleton = bus;
+}
+
+// ------------------ LISTENERS --------------------
+void MatchEventBus::add_listener(MatchEventListener* listener) {
+	for (int i = 0; i < listener_count; i++) {
+		if (listeners[i] == listener) return;
+	}
+
+	if (listener_count >= MAX_LISTENERS) {
+		ERR_PRINT("MatchEventBus: out of listener slots");
+		return;
+	}
+	listeners[listener_count++] = listener;
+}
+
+void MatchEventBus::remove_listener(MatchEventListener* listener) {
+	for (int i = 0; i < listener_count; i++) {
+		if (listeners[i] == listener) {
+			listeners[i] = listeners[--listener_count];
+			listeners[listener_count] = nullptr;
+			return;
+		}
+	}
+}
+
+// ------------------ QUEUE --------------------
+void MatchEventBus::push(MatchEventType type, int slot, int value, int delta) {
+	if (count >= CAPACITY) {
+		stats.dropped_events++;
+		return;
+	}
+
+	MatchEvent& event = queue[count++];
+	event.type = type;
+	event.slot = (uint8_t)slot;
+	event.value = (int16_t)value;
+	event.delta = delta;
+}
+
+void MatchEventBus::clear() {
+	count = 0;
+}
+
+// ------------------ DISPATCH --------------------
+void MatchEventBus::dispatch() {
+	int batch_count = count;
+	stats.ticks++;
+	stats.last_tick_events = (uint32_t)batch_count;
+	if (stats.last_tick_events > stats.max_tick_events) stats.max_tick_events = stats.last_tick_events;
+	stats.total_events += batch_count;
+
+	if (batch_count == 0) {
+		stats.last_dispatch_usec = 0;
+		return;
+	}
+
+	// Consumers may push while handling the batch; those land in the now-empty queue
+	memcpy(batch, queue, batch_count * sizeof(MatchEvent));
+	count = 0;
+
+	uint64_t start_usec = Time::get_singleton()->get_ticks_usec();
+
+	for (int i = 0; i < listener_count; i++) {
+		listeners[i]->on_match_events(batch, batch_count);
+	}
+
+	uint64_t elapsed = Time::get_singleton()->get_ticks_usec() - start_usec;
+	stats.last_dispatch_usec = elapsed;
+	stats.total_dispatch_usec += elapsed;
+	if (elapsed > stats.max_dispatch_usec) stats.max_dispatch_usec = elapsed;
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#ifndef MATCH_EVENTS_H
+#define MATCH_EVENTS_H
+
+#include <Godot.hpp>
+#include <Time.hpp>
+
+#include <cstdint>
+
+namespace godot {
+
+    // ============================================================
+    // EVENTS
+    // Fixed-size, no strings: fighters are addressed by slot (0 = P1,
+    // 1 = P2), never by character name.
+    // ============================================================
+    enum MatchEventType : uint8_t {
+        EVENT_HEALTH_CHANGED,   // value = new health, delta = change
+        EVENT_FIGHTER_DIED,
+        EVENT_ROUND_STARTED,    // value = round number
+        EVENT_ROUND_ENDED,      // slot = winner, NO_SLOT on a draw
+        EVENT_MATCH_ENDED,      // slot = winner
+    };
+
+    // ============================================================
+    // FIGHTER STATE
+    // The one thing a fighter is doing, highest priority first when
+    // flags overlap. Reported by get_fighter_state() so MatchManager
+    // can hash fighters it has no header for.
+    // ============================================================
+    enum FighterState : uint8_t {
+        FIGHTER_IDLE,
+        FIGHTER_CROUCHING,
+        FIGHTER_BLOCKING,
+        FIGHTER_ATTACKING,
+        FIGHTER_STUNNED,
+        FIGHTER_KNOCKED_DOWN,
+        FIGHTER_DEAD,
+    };
+
+    inline FighterState resolve_fighter_state(bool dead, bool knocked_down, bool stunned, bool attacking, bool blocking, bool crouching) {
+        if (dead) return FIGHTER_DEAD;
+        if (knocked_down) return FIGHTER_KNOCKED_DOWN;
+        if (stunned) return FIGHTER_STUNNED;
+        if (attacking) return FIGHTER_ATTACKING;
+        if (blocking) return FIGHTER_BLOCKING;
+        if (crouching) return FIGHTER_CROUCHING;
+        return FIGHTER_IDLE;
+    }
+
+    struct MatchEvent {
+        static const uint8_t NO_SLOT = 0xFF;
+
+        MatchEventType type;
+        uint8_t slot;
+        int16_t value;
+        int32_t delta;
+    };
+
+    static_assert(sizeof(MatchEvent) == 8, "MatchEvent should stay 8 bytes");
+
+    // ============================================================
+    // LISTENER
+    // HUD, audio and analytics consumers. Each gets the whole batch
+    // once per tick; registered on add, unregistered on destruction.
+    // ============================================================
+    class MatchEventListener {
+    public:
+        virtual ~MatchEventListener();
+        virtual void on_match_events(const MatchEvent* events, int count) = 0;
+    };
+
+    struct MatchEventStats {
+        uint64_t ticks = 0;
+        uint64_t total_events = 0;
+        uint64_t dropped_events = 0;
+
+        uint32_t last_tick_events = 0;
+        uint32_t max_tick_events = 0;
+
+        uint64_t last_dispatch_usec = 0;
+        uint64_t max_dispatch_usec = 0;
+        uint64_t total_dispatch_usec = 0;
+    };
+
+    // ============================================================
+    // EVENT BUS
+    // Events are queued while the sim ticks and dispatched in one batch
+    // from MatchManager::_physics_process, after the fighters. Anything a
+    // consumer pushes while handling a batch goes out on the next tick.
+    // ============================================================
+    class MatchEventBus {
+    public:
+        static const int CAPACITY = 256;
+        static const int MAX_LISTENERS = 8;
+
+        MatchEventBus();
+
+        static MatchEventBus* get_singleton();
+        static void set_singleton(MatchEventBus* bus);
+
+        void push(MatchEventType type, int slot, int value = 0, int delta = 0);
+        void dispatch();
+        void clear();
+
+        void add_listener(MatchEventListener* listener);
+        void remove_listener(MatchEventListener* listener);
+
+        int get_pending_count() const { return count; }
+        const MatchEventStats& get_stats() const { return stats; }
+
+    private:
+        static MatchEventBus* singleton;
+
+        MatchEvent queue[CAPACITY];
+        MatchEvent batch[CAPACITY];
+        int count;
+
+        MatchEventListener* listeners[MAX_LISTENERS];
+        int listener_count;
+
+        MatchEventStats stats;
+    };
+
+} // namespace godot
+
+#endif
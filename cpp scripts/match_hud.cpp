@@ -0,0 +1,199 @@
+#include "match_hud.h"
+
+using namespace godot;
+
+static const char* WINNER_NAMES[2] = { "Geralt", "Ciri" };
+
+MatchHud::MatchHud() :
+		round_timer_label(nullptr),
+		round_counter_label(nullptr),
+		message_label(nullptr),
+		round_timer_counter(nullptr),
+		round_counter_counter(nullptr),
+		round_seconds(-1),
+		message(HUD_MESSAGE_NONE),
+		message_arg(0),
+		message_shown(false),
+		dirty(0),
+		window_time(0.0),
+		window_updates(0) {
+	for (int i = 0; i < 2; i++) {
+		health_bars[i] = nullptr;
+		trail_bars[i] = nullptr;
+		health[i] = 0;
+		trail[i] = 0;
+		trail_hold[i] = 0;
+		rounds_won[i] = -1;
+	}
+}
+
+void MatchHud::bind(ProgressBar* health_p1, ProgressBar* health_p2, ProgressBar* trail_p1, ProgressBar* trail_p2,
+		Label* round_timer, Label* round_counter, Label* message) {
+	health_bars[0] = health_p1;
+	health_bars[1] = health_p2;
+	trail_bars[0] = trail_p1;
+	trail_bars[1] = trail_p2;
+	round_timer_label = round_timer;
+	round_counter_label = round_counter;
+	message_label = message;
+}
+
+void MatchHud::bind_counters(GlyphCounter* round_timer, GlyphCounter* round_counter) {
+	round_timer_counter = round_timer;
+	round_counter_counter = round_counter;
+}
+
+void MatchHud::reset(int health_p1, int health_p2, bool message_shown) {
+	health[0] = trail[0] = health_p1;
+	health[1] = trail[1] = health_p2;
+	trail_hold[0] = trail_hold[1] = 0;
+
+	// -1 = whatever the scene shows until the sim writes a value
+	round_seconds = -1;
+	rounds_won[0] = rounds_won[1] = -1;
+	if (round_timer_counter) round_timer_counter->clear();
+	if (round_counter_counter) round_counter_counter->clear();
+
+	message = HUD_MESSAGE_NONE;
+	message_arg = 0;
+	this->message_shown = message_shown;
+
+	dirty = 0;
+}
+
+// ------------------ SETTERS --------------------
+void MatchHud::set_health(int slot, int value) {
+	if (health[slot] == value) return;
+
+	if (value < health[slot]) {
+		// Trail holds at the old value, then catches up
+		trail_hold[slot] = TRAIL_DELAY_FRAMES;
+	} else {
+		trail[slot] = value;
+		trail_hold[slot] = 0;
+		dirty |= HUD_DIRTY_TRAIL_P1 << slot;
+	}
+
+	health[slot] = value;
+	dirty |= HUD_DIRTY_HEALTH_P1 << slot;
+}
+
+void MatchHud::set_round_seconds(int seconds) {
+	if (round_seconds == seconds) return;
+	round_seconds = seconds;
+	dirty |= HUD_DIRTY_ROUND_TIMER;
+}
+
+void MatchHud::set_rounds_won(int p1, int p2) {
+	if (rounds_won[0] == p1 && rounds_won[1] == p2) return;
+	rounds_won[0] = p1;
+	rounds_won[1] = p2;
+	dirty |= HUD_DIRTY_ROUND_COUNTER;
+}
+
+void MatchHud::show_message(HudMessage message, int arg) {
+	if (this->message != message || message_arg != arg) {
+		this->message = message;
+		message_arg = arg;
+		dirty |= HUD_DIRTY_MESSAGE;
+	}
+	if (!message_shown) {
+		message_shown = true;
+		dirty |= HUD_DIRTY_MESSAGE_SHOWN;
+	}
+}
+
+void MatchHud::hide_message() {
+	if (!message_shown) return;
+	message_shown = false;
+	dirty |= HUD_DIRTY_MESSAGE_SHOWN;
+}
+
+// ------------------ TICK --------------------
+void MatchHud::tick() {
+	for (int i = 0; i < 2; i++) {
+		if (trail_hold[i] > 0 && --trail_hold[i] == 0) {
+			trail[i] = health[i];
+			dirty |= HUD_DIRTY_TRAIL_P1 << i;
+		}
+	}
+}
+
+// ------------------ FLUSH --------------------
+String MatchHud::message_text() const {
+	switch (message) {
+		case HUD_MESSAGE_ROUND:
+			return "Round " + String::num_int64(message_arg);
+		case HUD_MESSAGE_FIGHT:
+			return "Fight!";
+		case HUD_MESSAGE_ROUND_WINNER:
+			return String(WINNER_NAMES[message_arg & 1]) + " Wins Round!";
+		case HUD_MESSAGE_DRAW:
+			return "Draw!";
+		default:
+			return "";
+	}
+}
+
+void MatchHud::flush(double delta) {
+	stats.flushes++;
+
+	window_time += delta;
+	if (window_time >= 1.0) {
+		stats.updates_per_second = window_updates;
+		window_updates = 0;
+		window_time -= 1.0;
+	}
+
+	if (!dirty) {
+		stats.idle_flushes++;
+		return;
+	}
+
+	uint32_t updates = 0;
+
+	for (int i = 0; i < 2; i++) {
+		if ((dirty & (HUD_DIRTY_HEALTH_P1 << i)) && health_bars[i]) {
+			health_bars[i]->set_value(health[i]);
+			updates++;
+		}
+		if ((dirty & (HUD_DIRTY_TRAIL_P1 << i)) && trail_bars[i]) {
+			trail_bars[i]->set_value(trail[i]);
+			updates++;
+		}
+	}
+
+	if (dirty & HUD_DIRTY_ROUND_TIMER) {
+		if (round_timer_counter && round_timer_counter->is_attached()) {
+			round_timer_counter->set_number(round_seconds);
+			updates++;
+		} else if (round_timer_label) {
+			round_timer_label->set_text(round_seconds < 0 ? String() : String::num_int64(round_seconds));
+			updates++;
+		}
+	}
+
+	if (dirty & HUD_DIRTY_ROUND_COUNTER) {
+		if (round_counter_counter && round_counter_counter->is_attached()) {
+			round_counter_counter->set_pair(rounds_won[0], rounds_won[1]);
+			updates++;
+		} else if (round_counter_label) {
+			round_counter_label->set_text(String::num_int64(rounds_won[0]) + " - " + String::num_int64(rounds_won[1]));
+			updates++;
+		}
+	}
+
+	if ((dirty & HUD_DIRTY_MESSAGE) && message_label) {
+		message_label->set_text(message_text());
+		updates++;
+	}
+
+	if ((dirty & HUD_DIRTY_MESSAGE_SHOWN) && message_label) {
+		message_label->set_visible(message_shown);
+		updates++;
+	}
+
+	dirty = 0;
+	stats.widget_updates += updates;
+	window_updates += updates;
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#ifndef MATCH_HUD_H
+#define MATCH_HUD_H
+
+#include <Godot.hpp>
+#include <ProgressBar.hpp>
+#include <Label.hpp>
+
+#include "glyph_strip.h"
+
+#include <cstdint>
+
+namespace godot {
+
+    // ============================================================
+    // DIRTY BITS
+    // ============================================================
+    enum HudDirty : uint32_t {
+        HUD_DIRTY_HEALTH_P1     = 1 << 0,
+        HUD_DIRTY_HEALTH_P2     = 1 << 1,
+        HUD_DIRTY_TRAIL_P1      = 1 << 2,
+        HUD_DIRTY_TRAIL_P2      = 1 << 3,
+        HUD_DIRTY_ROUND_TIMER   = 1 << 4,
+        HUD_DIRTY_ROUND_COUNTER = 1 << 5,
+        HUD_DIRTY_MESSAGE       = 1 << 6,
+        HUD_DIRTY_MESSAGE_SHOWN = 1 << 7,
+    };
+
+    enum HudMessage : uint8_t {
+        HUD_MESSAGE_NONE,
+        HUD_MESSAGE_ROUND,          // arg = round number
+        HUD_MESSAGE_FIGHT,
+        HUD_MESSAGE_ROUND_WINNER,   // arg = winner slot
+        HUD_MESSAGE_DRAW,
+    };
+
+    struct HudStats {
+        uint64_t flushes = 0;
+        uint64_t idle_flushes = 0;          // nothing was dirty
+        uint64_t widget_updates = 0;
+        uint32_t updates_per_second = 0;    // over the last full second
+    };
+
+    // ============================================================
+    // MATCH HUD
+    // The sim writes plain values in here; setters only mark a widget
+    // dirty when its value actually changes. flush() runs once per
+    // render frame and touches only the dirty widgets, so an idle fight
+    // frame costs a bitmask test.
+    // The damage trail catches up after TRAIL_DELAY_FRAMES without a
+    // Timer node: tick() counts it down on physics frames.
+    // ============================================================
+    class MatchHud {
+    public:
+        static const int TRAIL_DELAY_FRAMES = 24;   // 0.4s, matches health_bar.tscn
+
+        MatchHud();
+
+        // trail bars may be null (health_bar.tscn has no damage bar yet)
+        void bind(ProgressBar* health_p1, ProgressBar* health_p2, ProgressBar* trail_p1, ProgressBar* trail_p2,
+                Label* round_timer, Label* round_counter, Label* message);
+
+        // Optional: draw the numeric widgets from a glyph strip instead of set_text
+        void bind_counters(GlyphCounter* round_timer, GlyphCounter* round_counter);
+
+        // Re-seed after the widgets were written directly (rematch snapshot)
+        void reset(int health_p1, int health_p2, bool message_shown);
+
+        void set_health(int slot, int value);
+        void set_round_seconds(int seconds);
+        void set_rounds_won(int p1, int p2);
+        void show_message(HudMessage message, int arg = 0);
+        void hide_message();
+
+        void tick();
+        void flush(double delta);
+
+        uint32_t get_dirty() const { return dirty; }
+        const HudStats& get_stats() const { return stats; }
+
+    private:
+        ProgressBar* health_bars[2];
+        ProgressBar* trail_bars[2];
+        Label* round_timer_label;
+        Label* round_counter_label;
+        Label* message_label;
+        GlyphCounter* round_timer_counter;
+        GlyphCounter* round_counter_counter;
+
+        // ------------------ MODEL --------------------
+        int health[2];
+        int trail[2];
+        int trail_hold[2];
+        int round_seconds;
+        int rounds_won[2];
+        HudMessage message;
+        int message_arg;
+        bool message_shown;
+
+        uint32_t dirty;
+
+        HudStats stats;
+        double window_time;
+        uint32_t window_updates;
+
+        String message_text() const;
+    };
+
+} // namespace godot
+
+#endif
@@ -0,0 +1,259 @@
+#include "match_sequencer.h"
+
+using namespace godot;
+
+static const size_t FRAME_HEADER = 16;
+
+// ------------------ FRAME POOL --------------------
+void SequenceTask::promise_type::operator delete(void* ptr, size_t) noexcept {
+	unsigned char* block = static_cast<unsigned char*>(ptr) - FRAME_HEADER;
+	MatchSequencer* sequencer = *reinterpret_cast<MatchSequencer**>(block);
+	sequencer->free_frame(ptr);
+}
+
+void* MatchSequencer::allocate_frame(size_t size) {
+	if (size + FRAME_HEADER > FRAME_BLOCK_SIZE) {
+		ERR_PRINT("MatchSequencer: sequence frame too large for the pool");
+		return nullptr;
+	}
+
+	for (int i = 0; i < MAX_SEQUENCES; i++) {
+		if (!block_used[i]) {
+			block_used[i] = true;
+			*reinterpret_cast<MatchSequencer**>(blocks[i].bytes) = this;
+			return blocks[i].bytes + FRAME_HEADER;
+		}
+	}
+
+	ERR_PRINT("MatchSequencer: out of sequence frames");
+	return nullptr;
+}
+
+void MatchSequencer::free_frame(void* ptr) {
+	unsigned char* block = static_cast<unsigned char*>(ptr) - FRAME_HEADER;
+	int index = (int)((FrameBlock*)block - blocks);
+	block_used[index] = false;
+}
+
+// ------------------ SEQUENCER --------------------
+MatchSequencer::MatchSequencer() :
+		factory(nullptr),
+		owner(nullptr),
+		frame(0),
+		current(-1),
+		restoring(false) {
+	for (int i = 0; i < MAX_SEQUENCES; i++) {
+		block_used[i] = false;
+	}
+}
+
+MatchSequencer::~MatchSequencer() {
+	stop_all();
+}
+
+void MatchSequencer::set_factory(Factory factory, void* owner) {
+	this->factory = factory;
+	this->owner = owner;
+}
+
+void MatchSequencer::start(uint8_t script, int32_t arg) {
+	// While restoring, anything a replayed sequence starts is either in the
+	// snapshot already or had finished before it was taken
+	if (restoring) return;
+
+	launch(script, arg, frame);
+}
+
+void MatchSequencer::launch(uint8_t script, int32_t arg, uint32_t start_frame) {
+	ERR_FAIL_COND(!factory);
+
+	int index = -1;
+	for (int i = 0; i < MAX_SEQUENCES; i++) {
+		if (!slots[i].handle) {
+			index = i;
+			break;
+		}
+	}
+	ERR_FAIL_COND(index < 0);
+
+	SequenceTask task = factory(*this, owner, script, arg);
+	std::coroutine_handle<SequenceTask::promise_type> handle = task.release();
+	if (!handle) return;
+
+	Slot& slot = slots[index];
+	slot = Slot();
+	slot.handle = handle;
+	slot.script = script;
+	slot.arg = arg;
+	slot.start_frame = start_frame;
+	slot.clock = start_frame;
+
+	// Runs up to the first await that is still in the future
+	resume(index);
+}
+
+void MatchSequencer::stop(uint8_t script) {
+	for (int i = 0; i < MAX_SEQUENCES; i++) {
+		if (is_live(i) && slots[i].script == script) {
+			finish(i);
+		}
+	}
+}
+
+void MatchSequencer::stop_all() {
+	for (int i = 0; i < MAX_SEQUENCES; i++) {
+		if (is_live(i)) {
+			finish(i);
+		}
+	}
+}
+
+bool MatchSequencer::is_running(uint8_t script) const {
+	for (int i = 0; i < MAX_SEQUENCES; i++) {
+		if (is_live(i) && slots[i].script == script) return true;
+	}
+	return false;
+}
+
+int64_t MatchSequencer::get_elapsed(uint8_t script) const {
+	for (int i = 0; i < MAX_SEQUENCES; i++) {
+		if (is_live(i) && slots[i].script == script) return (int64_t)frame - slots[i].start_frame;
+	}
+	return -1;
+}
+
+int MatchSequencer::get_running_count() const {
+	int count = 0;
+	for (int i = 0; i < MAX_SEQUENCES; i++) {
+		if (is_live(i)) count++;
+	}
+	return count;
+}
+
+bool MatchSequencer::is_catching_up() const {
+	return current >= 0 && slots[current].clock < frame;
+}
+
+void MatchSequencer::tick() {
+	frame++;
+
+	for (int i = 0; i < MAX_SEQUENCES; i++) {
+		Slot& slot = slots[i];
+		if (!is_live(i)) continue;
+
+		if (slot.tweening) {
+			apply_tween(slot, frame);
+		}
+		if (slot.clock <= frame) {
+			resume(i);
+		}
+	}
+}
+
+void MatchSequencer::resume(int index) {
+	int previous = current;
+	current = index;
+	slots[index].resuming = true;
+	slots[index].handle.resume();
+	slots[index].resuming = false;
+	current = previous;
+
+	if (slots[index].stopped || slots[index].handle.done()) {
+		release(index);
+	}
+}
+
+void MatchSequencer::finish(int index) {
+	Slot& slot = slots[index];
+
+	// Its frame is still executing; resume() releases it on the way out
+	if (slot.resuming) {
+		slot.stopped = true;
+		slot.tweening = false;
+		return;
+	}
+	release(index);
+}
+
+void MatchSequencer::release(int index) {
+	Slot& slot = slots[index];
+	std::coroutine_handle<SequenceTask::promise_type> handle = slot.handle;
+	slot = Slot();
+	handle.destroy();
+}
+
+// ------------------ AWAITABLES --------------------
+bool MatchSequencer::Wait::await_ready() {
+	Slot& slot = sequencer->slots[sequencer->current];
+	slot.clock += frames;
+	return slot.clock <= sequencer->frame;
+}
+
+bool MatchSequencer::Tween::await_ready() {
+	Slot& slot = sequencer->slots[sequencer->current];
+
+	slot.tween_target = target->get_instance_id();
+	slot.tween_property = property;
+	slot.tween_from = from;
+	slot.tween_to = to;
+	slot.tween_start = slot.clock;
+	slot.tween_end = slot.clock + frames;
+	slot.clock = slot.tween_end;
+
+	slot.tweening = true;
+	sequencer->apply_tween(slot, sequencer->frame);
+
+	if (slot.clock <= sequencer->frame) {
+		slot.tweening = false;
+		return true;
+	}
+	return false;
+}
+
+void MatchSequencer::Tween::await_resume() {
+	Slot& slot = sequencer->slots[sequencer->current];
+	if (slot.tweening) {
+		sequencer->apply_tween(slot, slot.tween_end);
+		slot.tweening = false;
+	}
+}
+
+void MatchSequencer::apply_tween(Slot& slot, uint32_t at_frame) {
+	Object* target = ObjectDB::get_instance(slot.tween_target);
+	if (!target) return;
+
+	float t = 1.0f;
+	if (slot.tween_end > slot.tween_start && at_frame < slot.tween_end) {
+		t = float(at_frame - slot.tween_start) / float(slot.tween_end - slot.tween_start);
+	}
+	target->set_indexed(*slot.tween_property, Math::lerp(slot.tween_from, slot.tween_to, t));
+}
+
+// ------------------ SNAPSHOT --------------------
+MatchSequencer::Snapshot MatchSequencer::save() const {
+	Snapshot snapshot;
+	snapshot.frame = frame;
+
+	for (int i = 0; i < MAX_SEQUENCES; i++) {
+		if (!is_live(i)) continue;
+
+		Snapshot::Entry& entry = snapshot.entries[snapshot.count++];
+		entry.script = slots[i].script;
+		entry.arg = slots[i].arg;
+		entry.start_frame = slots[i].start_frame;
+	}
+
+	return snapshot;
+}
+
+void MatchSequencer::restore(const Snapshot& snapshot) {
+	stop_all();
+	frame = snapshot.frame;
+
+	restoring = true;
+	for (int i = 0; i < snapshot.count; i++) {
+		const Snapshot::Entry& entry = snapshot.entries[i];
+		launch(entry.script, entry.arg, entry.start_frame);
+	}
+	restoring = false;
+}
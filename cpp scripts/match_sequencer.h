@@ -0,0 +1,191 @@
+#pragma once
+
+#ifndef MATCH_SEQUENCER_H
+#define MATCH_SEQUENCER_H
+
+#include <Godot.hpp>
+#include <Object.hpp>
+#include <NodePath.hpp>
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+
+namespace godot {
+
+    class MatchSequencer;
+
+    // ============================================================
+    // SEQUENCE TASK
+    // Coroutine type for match flow scripts. The first parameter of a
+    // sequence must be the MatchSequencer: its frame comes out of the
+    // sequencer's fixed pool, never the heap.
+    // ============================================================
+    struct SequenceTask {
+        struct promise_type {
+            template <typename... Args>
+            static void* operator new(size_t size, MatchSequencer& sequencer, Args&&...) noexcept;
+            static void operator delete(void* ptr, size_t size) noexcept;
+
+            static SequenceTask get_return_object_on_allocation_failure() { return SequenceTask(); }
+            SequenceTask get_return_object() { return SequenceTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() {}
+        };
+
+        SequenceTask() {}
+        explicit SequenceTask(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+        SequenceTask(SequenceTask&& other) noexcept : handle(other.handle) { other.handle = nullptr; }
+        SequenceTask(const SequenceTask&) = delete;
+        ~SequenceTask() { if (handle) handle.destroy(); }
+
+        std::coroutine_handle<promise_type> release() {
+            std::coroutine_handle<promise_type> result = handle;
+            handle = nullptr;
+            return result;
+        }
+
+    private:
+        std::coroutine_handle<promise_type> handle;
+    };
+
+    // ============================================================
+    // MATCH SEQUENCER
+    // Runs match flow scripts on sim frames. Every await is measured in
+    // frames from the sequence's start, so a running sequence is fully
+    // described by (script, arg, start frame): that is all a snapshot
+    // keeps. On restore each script is restarted and fast-forwarded to
+    // the current frame; awaits that are already in the past complete
+    // immediately and tweens jump to the value they would have.
+    // Code between awaits should set state, not accumulate it, or check
+    // is_catching_up().
+    // A sequence stopped while its own step is running (it ended the
+    // round that stops it) counts as stopped at once but runs on to its
+    // next await; its frame is released when the step returns.
+    // ============================================================
+    class MatchSequencer {
+    public:
+        static const int MAX_SEQUENCES = 8;
+        static const size_t FRAME_BLOCK_SIZE = 512;
+
+        typedef SequenceTask (*Factory)(MatchSequencer& sequencer, void* owner, uint8_t script, int32_t arg);
+
+        struct Snapshot {
+            struct Entry {
+                uint8_t script;
+                int32_t arg;
+                uint32_t start_frame;
+            };
+
+            uint32_t frame = 0;
+            int count = 0;
+            Entry entries[MAX_SEQUENCES];
+        };
+
+        // ------------------ AWAITABLES --------------------
+        struct Wait {
+            MatchSequencer* sequencer;
+            uint32_t frames;
+
+            bool await_ready();
+            void await_suspend(std::coroutine_handle<>) {}
+            void await_resume() {}
+        };
+
+        struct Tween {
+            MatchSequencer* sequencer;
+            Object* target;
+            const NodePath* property;
+            float from;
+            float to;
+            uint32_t frames;
+
+            bool await_ready();
+            void await_suspend(std::coroutine_handle<>) {}
+            void await_resume();
+        };
+
+        MatchSequencer();
+        ~MatchSequencer();
+
+        void set_factory(Factory factory, void* owner);
+
+        void start(uint8_t script, int32_t arg = 0);
+        void stop(uint8_t script);
+        void stop_all();
+        bool is_running(uint8_t script) const;
+        // Frames since `script` started, -1 when it isn't running
+        int64_t get_elapsed(uint8_t script) const;
+
+        void tick();
+
+        Wait wait(uint32_t frames) { return Wait{ this, frames }; }
+        // property must outlive the tween (keep NodePaths as members)
+        Tween tween(Object* target, const NodePath& property, float from, float to, uint32_t frames) {
+            return Tween{ this, target, &property, from, to, frames };
+        }
+
+        bool is_catching_up() const;
+        uint32_t get_frame() const { return frame; }
+        int get_running_count() const;
+
+        Snapshot save() const;
+        void restore(const Snapshot& snapshot);
+
+        // Frame pool, used by SequenceTask::promise_type
+        void* allocate_frame(size_t size);
+        void free_frame(void* ptr);
+
+    private:
+        struct Slot {
+            std::coroutine_handle<SequenceTask::promise_type> handle;
+            uint8_t script = 0;
+            int32_t arg = 0;
+            uint32_t start_frame = 0;
+            uint32_t clock = 0;                 // frame this sequence has reached
+            bool resuming = false;              // its step is on the stack
+            bool stopped = false;               // finish() ran mid-step; release after it
+
+            bool tweening = false;
+            uint64_t tween_target = 0;          // ObjectID
+            const NodePath* tween_property = nullptr;
+            float tween_from = 0.0f;
+            float tween_to = 0.0f;
+            uint32_t tween_start = 0;
+            uint32_t tween_end = 0;
+        };
+
+        struct alignas(16) FrameBlock {
+            unsigned char bytes[FRAME_BLOCK_SIZE];
+        };
+
+        Slot slots[MAX_SEQUENCES];
+        FrameBlock blocks[MAX_SEQUENCES];
+        bool block_used[MAX_SEQUENCES];
+
+        Factory factory;
+        void* owner;
+
+        uint32_t frame;
+        int current;
+        bool restoring;
+
+        void launch(uint8_t script, int32_t arg, uint32_t start_frame);
+        void resume(int index);
+        void finish(int index);
+        void release(int index);
+        bool is_live(int index) const { return slots[index].handle && !slots[index].stopped; }
+        void apply_tween(Slot& slot, uint32_t at_frame);
+    };
+
+    template <typename... Args>
+    void* SequenceTask::promise_type::operator new(size_t size, MatchSequencer& sequencer, Args&&...) noexcept {
+        return sequencer.allocate_frame(size);
+    }
+
+} // namespace godot
+
+#endif
@@ -0,0 +1,281 @@
+#include "match_server.h"
+
+#include <algorithm>
+#include <chrono>
+
+using namespace godot;
+
+typedef std::chrono::steady_clock Clock;
+
+static uint64_t elapsed_ns(Clock::time_point from, Clock::time_point to) {
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count();
+}
+
+// ------------------ HISTOGRAM --------------------
+void TickHistogram::record(uint64_t ns) {
+	uint64_t bucket = ns / BUCKET_NS;
+	buckets[bucket < BUCKET_COUNT ? bucket : BUCKET_COUNT - 1]++;
+	samples++;
+	if (ns > max_ns) max_ns = ns;
+}
+
+void TickHistogram::merge(const TickHistogram& other) {
+	for (int i = 0; i < BUCKET_COUNT; i++) {
+		buckets[i] += other.buckets[i];
+	}
+	samples += other.samples;
+	if (other.max_ns > max_ns) max_ns = other.max_ns;
+}
+
+double TickHistogram::percentile_us(double p) const {
+	if (samples == 0) return 0.0;
+
+	uint64_t target = (uint64_t)(samples * p);
+	uint64_t seen = 0;
+	for (int i = 0; i < BUCKET_COUNT; i++) {
+		seen += buckets[i];
+		if (seen > target) {
+			return (i + 1) * BUCKET_NS / 1000.0;
+		}
+	}
+	return max_ns / 1000.0;
+}
+
+// ------------------ WORK QUEUE --------------------
+void WorkQueue::push(uint32_t match_index) {
+	std::lock_guard<std::mutex> lock(mutex);
+	items.push_back(match_index);
+}
+
+void WorkQueue::push(const uint32_t* match_indices, size_t count) {
+	std::lock_guard<std::mutex> lock(mutex);
+	items.insert(items.end(), match_indices, match_indices + count);
+}
+
+bool WorkQueue::pop(uint32_t& match_index) {
+	std::lock_guard<std::mutex> lock(mutex);
+	if (items.empty()) return false;
+	match_index = items.back();
+	items.pop_back();
+	return true;
+}
+
+bool WorkQueue::steal(uint32_t& match_index) {
+	std::lock_guard<std::mutex> lock(mutex);
+	if (items.empty()) return false;
+	match_index = items.front();
+	items.pop_front();
+	return true;
+}
+
+// ------------------ SERVER --------------------
+MatchServer::MatchServer(const MatchServerConfig& config) :
+		config(config),
+		next_seed(config.seed),
+		frame_generation(0),
+		ticks_remaining(0),
+		shutting_down(false) {
+	if (this->config.worker_count < 1) this->config.worker_count = 1;
+
+	matches.reserve(config.match_count);
+	for (int i = 0; i < config.match_count; i++) {
+		matches.emplace_back(new MatchSim(next_seed++));
+		matches.back()->start_match();
+	}
+	finished.assign(config.match_count, 0);
+
+	// Contiguous slices, so a worker keeps ticking the same matches frame after frame
+	for (int i = 0; i < this->config.worker_count; i++) {
+		Worker* worker = new Worker();
+		worker->first_slot = (uint32_t)((uint64_t)config.match_count * i / this->config.worker_count);
+		worker->end_slot = (uint32_t)((uint64_t)config.match_count * (i + 1) / this->config.worker_count);
+		worker->live.reserve(worker->end_slot - worker->first_slot);
+		workers.emplace_back(worker);
+	}
+	for (int i = 0; i < this->config.worker_count; i++) {
+		threads.emplace_back(&MatchServer::worker_loop, this, i);
+	}
+}
+
+MatchServer::~MatchServer() {
+	{
+		std::lock_guard<std::mutex> lock(frame_mutex);
+		shutting_down = true;
+	}
+	frame_start.notify_all();
+
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+}
+
+void MatchServer::run(uint64_t frames) {
+	const auto frame_budget = std::chrono::nanoseconds(1000000000 / SIM_TICK_RATE);
+	Clock::time_point started = Clock::now();
+	Clock::time_point deadline = started;
+
+	frame_times.reserve(frame_times.size() + frames);
+
+	for (uint64_t i = 0; i < frames; i++) {
+		deadline += frame_budget;
+
+		Clock::time_point frame_begin = Clock::now();
+		run_frame();
+		Clock::time_point frame_end = Clock::now();
+
+		frame_times.push_back(elapsed_ns(frame_begin, frame_end));
+		if (frame_end > deadline) {
+			stats.deadline_misses++;
+		}
+		stats.frames++;
+
+		refill_finished();
+
+		if (config.realtime) {
+			if (frame_end < deadline) {
+				std::this_thread::sleep_until(deadline);
+			} else {
+				deadline = frame_end; // don't try to catch up on missed frames
+			}
+		}
+	}
+
+	stats.elapsed_sec += elapsed_ns(started, Clock::now()) / 1e9;
+}
+
+void MatchServer::run_frame() {
+	int live = 0;
+	for (uint32_t i = 0; i < matches.size(); i++) {
+		if (!finished[i]) live++;
+	}
+	if (live == 0) return;
+
+	// Workers queue their own slices once they wake, see worker_loop()
+	ticks_remaining.store(live);
+
+	std::unique_lock<std::mutex> lock(frame_mutex);
+	frame_generation++;
+	frame_start.notify_all();
+	frame_done.wait(lock, [this]() { return ticks_remaining.load() == 0; });
+}
+
+void MatchServer::submit(const MatchDescriptor& match) {
+	pending.push_back(match);
+}
+
+void MatchServer::refill_finished() {
+	// Every pending pairing gets a freed slot before any slot goes to a refill seed
+	for (uint32_t i = 0; i < matches.size(); i++) {
+		if (finished[i] == 0) continue;
+
+		if (finished[i] == 1) {
+			stats.matches_completed++;
+			finished[i] = 2; // counted, parked until something takes the slot
+		}
+
+		if (!pending.empty()) {
+			const MatchDescriptor& match = pending.front();
+			matches[i].reset(new MatchSim(match.seed));
+			matches[i]->set_players(match.match_id, match.player_ids, match.ratings);
+			pending.pop_front();
+
+			matches[i]->start_match();
+			finished[i] = 0;
+		}
+	}
+
+	if (!config.refill) return;
+
+	for (uint32_t i = 0; i < matches.size(); i++) {
+		if (finished[i] == 0) continue;
+
+		matches[i].reset(new MatchSim(next_seed++));
+		matches[i]->start_match();
+		finished[i] = 0;
+	}
+}
+
+bool MatchServer::take_work(int id, uint32_t& match_index) {
+	Worker& self = *workers[id];
+	if (self.queue.pop(match_index)) return true;
+
+	for (int i = 1; i < config.worker_count; i++) {
+		Worker& victim = *workers[(id + i) % config.worker_count];
+		if (victim.queue.steal(match_index)) {
+			self.steals++;
+			return true;
+		}
+	}
+	return false;
+}
+
+void MatchServer::worker_loop(int id) {
+	Worker& self = *workers[id];
+	uint64_t seen_generation = 0;
+
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(frame_mutex);
+			frame_start.wait(lock, [&]() { return shutting_down || frame_generation != seen_generation; });
+			if (shutting_down) return;
+			seen_generation = frame_generation;
+		}
+
+		// Nothing from this slice is queued yet, so no thief can be writing its
+		// finished flags, and run() won't refill them until the frame is done
+		self.live.clear();
+		for (uint32_t i = self.first_slot; i < self.end_slot; i++) {
+			if (!finished[i]) self.live.push_back(i);
+		}
+		self.queue.push(self.live.data(), self.live.size());
+
+		uint32_t match_index;
+		while (take_work(id, match_index)) {
+			MatchSim& match = *matches[match_index];
+
+			Clock::time_point begin = Clock::now();
+			match.tick_bots();
+			self.histogram.record(elapsed_ns(begin, Clock::now()));
+			self.ticks++;
+
+			if (match.is_finished()) {
+				finished[match_index] = 1;
+			}
+
+			if (ticks_remaining.fetch_sub(1) == 1) {
+				std::lock_guard<std::mutex> lock(frame_mutex);
+				frame_done.notify_one();
+			}
+		}
+	}
+}
+
+// ------------------ STATS --------------------
+MatchServerStats MatchServer::get_stats() const {
+	MatchServerStats result = stats;
+
+	TickHistogram ticks;
+	for (const std::unique_ptr<Worker>& worker : workers) {
+		ticks.merge(worker->histogram);
+		result.ticks += worker->ticks;
+		result.steals += worker->steals;
+	}
+
+	result.p50_tick_us = ticks.percentile_us(0.50);
+	result.p99_tick_us = ticks.percentile_us(0.99);
+	result.max_tick_us = ticks.max_ns / 1000.0;
+	if (!frame_times.empty()) {
+		std::vector<uint64_t> sorted = frame_times;
+		size_t index = (size_t)(sorted.size() * 0.99);
+		if (index >= sorted.size()) index = sorted.size() - 1;
+		std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+		result.p99_frame_ms = sorted[index] / 1e6;
+	}
+
+	result.matches_per_core = double(config.match_count) / config.worker_count;
+	if (result.elapsed_sec > 0.0) {
+		result.completed_per_core_sec = result.matches_completed / result.elapsed_sec / config.worker_count;
+	}
+
+	return result;
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#ifndef MATCH_SERVER_H
+#define MATCH_SERVER_H
+
+#include "match_sim.h"
+#include "matchmaking.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace godot {
+
+    // ============================================================
+    // TICK HISTOGRAM
+    // Fixed buckets so workers never allocate while recording.
+    // ============================================================
+    struct TickHistogram {
+        static const int BUCKET_NS = 50;
+        static const int BUCKET_COUNT = 4000; // 0 - 200us, last bucket is overflow
+
+        uint64_t buckets[BUCKET_COUNT] = {};
+        uint64_t samples = 0;
+        uint64_t max_ns = 0;
+
+        void record(uint64_t ns);
+        void merge(const TickHistogram& other);
+        double percentile_us(double p) const;
+    };
+
+    // ============================================================
+    // WORK QUEUE
+    // Owner pops from the back, thieves steal from the front.
+    // ============================================================
+    class WorkQueue {
+    public:
+        void push(uint32_t match_index);
+        void push(const uint32_t* match_indices, size_t count);
+        bool pop(uint32_t& match_index);
+        bool steal(uint32_t& match_index);
+
+    private:
+        std::mutex mutex;
+        std::deque<uint32_t> items;
+    };
+
+    // ============================================================
+    // SERVER
+    // ============================================================
+    struct MatchServerConfig {
+        int worker_count = 1;
+        int match_count = 100;
+        uint32_t seed = 1;
+        bool realtime = true;       // pace frames at SIM_TICK_RATE
+        bool refill = true;         // start a new match when one ends
+    };
+
+    struct MatchServerStats {
+        uint64_t frames = 0;
+        uint64_t ticks = 0;
+        uint64_t matches_completed = 0;
+        uint64_t deadline_misses = 0;
+        uint64_t steals = 0;
+
+        double elapsed_sec = 0.0;
+        double p50_tick_us = 0.0;
+        double p99_tick_us = 0.0;
+        double max_tick_us = 0.0;
+        double p99_frame_ms = 0.0;
+
+        double matches_per_core = 0.0;          // concurrent matches hosted per worker
+        double completed_per_core_sec = 0.0;    // finished matches per worker per second
+    };
+
+    // Each worker owns a fixed slice of match slots and queues its own live
+    // matches at the start of every frame; stealing only evens out slices
+    // that run long. A refilled or submitted match takes the freed slot, so
+    // it lands on the worker whose match just ended.
+    class MatchServer {
+    public:
+        explicit MatchServer(const MatchServerConfig& config);
+        ~MatchServer();
+
+        void run(uint64_t frames);
+
+        // Queued matches take the next free slot ahead of refill seeds
+        void submit(const MatchDescriptor& match);
+        size_t get_pending_count() const { return pending.size(); }
+
+        MatchServerStats get_stats() const;
+
+    private:
+        struct Worker {
+            WorkQueue queue;
+            uint32_t first_slot = 0;
+            uint32_t end_slot = 0;
+            std::vector<uint32_t> live;
+            TickHistogram histogram;
+            uint64_t ticks = 0;
+            uint64_t steals = 0;
+        };
+
+        MatchServerConfig config;
+
+        std::vector<std::unique_ptr<MatchSim>> matches;
+        std::vector<uint8_t> finished;
+        uint32_t next_seed;
+        std::deque<MatchDescriptor> pending;
+
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::vector<std::thread> threads;
+
+        std::mutex frame_mutex;
+        std::condition_variable frame_start;
+        std::condition_variable frame_done;
+        uint64_t frame_generation;
+        std::atomic<int> ticks_remaining;
+        bool shutting_down;
+
+        std::vector<uint64_t> frame_times;
+        MatchServerStats stats;
+
+        void worker_loop(int id);
+        bool take_work(int id, uint32_t& match_index);
+        void run_frame();
+        void refill_finished();
+    };
+
+} // namespace godot
+
+#endif
@@ -0,0 +1,347 @@
+#include "match_sim.h"
+
+#include <cmath>
+
+using namespace godot;
+
+static const float SPAWN_X[2] = { 1701.0f, 2127.0f };
+static const float SPAWN_Y[2] = { -446.0f, -430.0f };
+
+static const float WALK_SPEED = 800.0f / SIM_TICK_RATE;
+static const float KNOCKBACK_SPEED = 700.0f / SIM_TICK_RATE;
+static const float STUN_FRICTION = 400.0f / (SIM_TICK_RATE * SIM_TICK_RATE);
+
+// ------------------ ARENA --------------------
+MatchArena::MatchArena(size_t capacity) :
+		memory(new unsigned char[capacity]),
+		capacity(capacity),
+		used(0) {}
+
+// ------------------ BOT --------------------
+uint32_t SimBot::next() {
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+
+SimInput SimBot::think(const SimFighter& self, const SimFighter& other) {
+	SimInput input;
+	uint32_t roll = next();
+	float gap = other.x - self.x;
+
+	if (std::fabs(gap) > 150.0f) {
+		input.buttons |= gap > 0 ? SIM_RIGHT : SIM_LEFT;
+	} else if ((roll & 7) == 0) {
+		input.buttons |= SIM_BLOCK;
+	} else if ((roll & 3) == 1) {
+		input.buttons |= (roll & 16) ? SIM_KICK : SIM_PUNCH;
+	}
+
+	if ((roll & 63) == 2) {
+		input.buttons |= SIM_CROUCH;
+	}
+
+	return input;
+}
+
+// ------------------ MATCH --------------------
+MatchSim::MatchSim(uint32_t seed) :
+		arena(ARENA_SIZE) {
+	fighters = arena.alloc<SimFighter>(2);
+	bots = arena.alloc<SimBot>(2);
+	timers = arena.alloc<TimerWheel>(1);
+
+	bots[0].state = seed ? seed : 1;
+	bots[1].state = (seed * 2654435761u) | 1;
+
+	input_log_capacity = (uint32_t)((arena.get_capacity() - arena.get_used()) / sizeof(SimInput)) - 8;
+	input_log = arena.alloc<SimInput>(input_log_capacity);
+	input_log_size = 0;
+
+	match_id = 0;
+	for (int i = 0; i < 2; i++) {
+		player_ids[i] = 0;
+		ratings[i] = 0;
+	}
+
+	current_state = IDLE;
+	rounds_won_p1 = 0;
+	rounds_won_p2 = 0;
+	rounds_played = 0;
+
+	frame = 0;
+	fight_text_visible = false;
+}
+
+void MatchSim::set_players(uint32_t match_id, const uint32_t player_ids[2], const int ratings[2]) {
+	this->match_id = match_id;
+	for (int i = 0; i < 2; i++) {
+		this->player_ids[i] = player_ids[i];
+		this->ratings[i] = ratings[i];
+	}
+}
+
+void MatchSim::start_match() {
+	reset_fighter(0);
+	reset_fighter(1);
+
+	current_state = INTRO;
+	state_timer = schedule(SIM_INTRO_FRAMES, SIM_TIMER_INTRO);
+}
+
+void MatchSim::tick_bots() {
+	SimInput inputs[2] = {
+		bots[0].think(fighters[0], fighters[1]),
+		bots[1].think(fighters[1], fighters[0]),
+	};
+	tick(inputs);
+}
+
+void MatchSim::tick(const SimInput inputs[2]) {
+	frame++;
+
+	timers->advance([this](const TimerEvent& event) { on_timer(event); });
+
+	if (current_state == FIGHT) {
+		for (int i = 0; i < 2; i++) {
+			SimInput input = inputs[i];
+			input.pressed = input.buttons & ~fighters[i].last_buttons;
+			fighters[i].last_buttons = input.buttons;
+
+			if (input_log_size + 1 < input_log_capacity) {
+				input_log[input_log_size++] = input;
+			}
+
+			tick_fighter(i, input);
+		}
+
+		resolve_hits();
+
+		if (fighters[0].health == 0 || fighters[1].health == 0) {
+			end_round();
+		}
+	}
+}
+
+// ------------------ TIMERS --------------------
+TimerHandle MatchSim::schedule(uint32_t frames, SimTimerKind kind, int target) {
+	TimerEvent event;
+	event.kind = kind;
+	event.target = (uint16_t)target;
+	return timers->schedule(frames, event);
+}
+
+void MatchSim::on_timer(const TimerEvent& event) {
+	switch (event.kind) {
+		case SIM_TIMER_INTRO:
+			start_fight();
+			break;
+		case SIM_TIMER_FIGHT_TEXT:
+			fight_text_visible = false;
+			break;
+		case SIM_TIMER_ROUND_TIME:
+			if (current_state == FIGHT) end_round();
+			break;
+		case SIM_TIMER_ROUND_RESET:
+			reset_round();
+			break;
+		case SIM_TIMER_STUN:
+			fighters[event.target].stunned = false;
+			break;
+		case SIM_TIMER_KNOCKDOWN:
+			fighters[event.target].knocked_down = false;
+			break;
+		case SIM_TIMER_COUNTER:
+			fighters[event.target].counter_window = false;
+			break;
+	}
+}
+
+// ------------------ START FIGHT --------------------
+void MatchSim::start_fight() {
+	current_state = FIGHT;
+	fight_text_visible = true;
+	timers->cancel(fight_text_timer);
+	fight_text_timer = schedule(SIM_FIGHT_TEXT_FRAMES, SIM_TIMER_FIGHT_TEXT);
+	round_timer = schedule(SIM_ROUND_FRAMES, SIM_TIMER_ROUND_TIME);
+}
+
+// ------------------ END ROUND --------------------
+void MatchSim::end_round() {
+	current_state = ROUND_END;
+	timers->cancel(round_timer);
+
+	if (fighters[0].health > fighters[1].health) {
+		rounds_won_p1++;
+	} else if (fighters[1].health > fighters[0].health) {
+		rounds_won_p2++;
+	}
+	rounds_played++;
+
+	// Drawn rounds count towards MAX_ROUNDS, so a match always ends
+	if (rounds_won_p1 >= ROUNDS_TO_WIN || rounds_won_p2 >= ROUNDS_TO_WIN || rounds_played >= MAX_ROUNDS) {
+		end_match();
+	} else {
+		state_timer = schedule(SIM_ROUND_END_FRAMES, SIM_TIMER_ROUND_RESET);
+	}
+}
+
+// ------------------ RESET ROUND --------------------
+void MatchSim::reset_round() {
+	reset_fighter(0);
+	reset_fighter(1);
+
+	start_fight();
+}
+
+// ------------------ END MATCH --------------------
+void MatchSim::end_match() {
+	current_state = MATCH_END;
+}
+
+int MatchSim::get_winner() const {
+	if (rounds_won_p1 == rounds_won_p2) return -1;
+	return rounds_won_p1 > rounds_won_p2 ? 0 : 1;
+}
+
+// ------------------ FIGHTER --------------------
+void MatchSim::reset_fighter(int slot) {
+	SimFighter& f = fighters[slot];
+	timers->cancel(f.stun_timer);
+	timers->cancel(f.knockdown_timer);
+	timers->cancel(f.counter_timer);
+
+	f = SimFighter();
+	f.x = SPAWN_X[slot];
+	f.y = SPAWN_Y[slot];
+	f.facing = slot == 0 ? 1.0f : -1.0f;
+}
+
+void MatchSim::tick_fighter(int slot, SimInput input) {
+	SimFighter& f = fighters[slot];
+
+	if (f.knocked_down) {
+		f.velocity_x = 0.0f;
+		return;
+	}
+
+	if (f.stunned) {
+		f.x += f.velocity_x;
+		f.velocity_x = f.velocity_x > 0 ? std::fmax(f.velocity_x - STUN_FRICTION, 0.0f) : std::fmin(f.velocity_x + STUN_FRICTION, 0.0f);
+		return;
+	}
+
+	if (f.attacking) {
+		if (++f.attack_frame >= f.attack_length) {
+			f.attacking = false;
+		}
+		return;
+	}
+
+	f.crouching = (input.buttons & SIM_CROUCH) != 0;
+	f.blocking = (input.buttons & SIM_BLOCK) != 0;
+
+	float direction = ((input.buttons & SIM_RIGHT) ? 1.0f : 0.0f) - ((input.buttons & SIM_LEFT) ? 1.0f : 0.0f);
+	if (direction != 0.0f) {
+		f.facing = direction;
+	}
+
+	f.velocity_x = f.crouching || f.blocking ? 0.0f : direction * WALK_SPEED;
+	f.x += f.velocity_x;
+
+	if (f.blocking) return;
+
+	if ((input.pressed & SIM_PUNCH) || (f.counter_window && (input.pressed & SIM_KICK))) {
+		f.attacking = true;
+		f.attack_frame = 0;
+		f.attack_length = 20;
+		f.attack_damage = 10;
+		f.attack_reach = 140.0f;
+		f.counter_window = false;
+		timers->cancel(f.counter_timer);
+	} else if (input.pressed & SIM_KICK) {
+		f.attacking = true;
+		f.attack_frame = 0;
+		f.attack_length = 24;
+		f.attack_damage = 5;
+		f.attack_reach = 170.0f;
+	}
+}
+
+void MatchSim::resolve_hits() {
+	const int ACTIVE_FRAME = 6;
+
+	for (int i = 0; i < 2; i++) {
+		SimFighter& attacker = fighters[i];
+		if (!attacker.attacking || attacker.attack_frame != ACTIVE_FRAME) continue;
+
+		SimFighter& target = fighters[1 - i];
+		float gap = (target.x - attacker.x) * attacker.facing;
+		if (gap >= 0.0f && gap <= attacker.attack_reach) {
+			take_damage(1 - i, attacker.attack_damage, attacker.x);
+		}
+	}
+}
+
+// ------------------ DAMAGE --------------------
+void MatchSim::take_damage(int slot, int amount, float hit_x) {
+	SimFighter& f = fighters[slot];
+	if (f.knocked_down) return;
+
+	int final_damage = amount;
+	bool apply_stun = true;
+
+	if (f.blocking) {
+		final_damage = int(amount * 0.2);
+		apply_stun = false;
+
+		f.counter_window = true;
+		timers->cancel(f.counter_timer);
+		f.counter_timer = schedule(SIM_COUNTER_FRAMES, SIM_TIMER_COUNTER, slot);
+	}
+
+	f.health -= final_damage;
+	if (f.health < 0) f.health = 0;
+
+	f.velocity_x = (f.x >= hit_x ? 1.0f : -1.0f) * KNOCKBACK_SPEED;
+
+	if (final_damage >= 25) {
+		f.knocked_down = true;
+		f.knockdown_timer = schedule(SIM_KNOCKDOWN_FRAMES, SIM_TIMER_KNOCKDOWN, slot);
+		return;
+	}
+
+	if (apply_stun) {
+		f.stunned = true;
+		f.attacking = false;
+		timers->cancel(f.stun_timer);
+		f.stun_timer = schedule(SIM_HITSTUN_FRAMES, SIM_TIMER_STUN, slot);
+	}
+}
+
+// ------------------ STATE HASH --------------------
+uint64_t MatchSim::hash_state() const {
+	// FNV-1a over the gameplay-relevant fields
+	uint64_t h = 1469598103934665603ull;
+	auto mix = [&h](const void* data, size_t size) {
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		for (size_t i = 0; i < size; i++) {
+			h ^= bytes[i];
+			h *= 1099511628211ull;
+		}
+	};
+
+	int header[5] = { (int)current_state, rounds_won_p1, rounds_won_p2, rounds_played, fight_text_visible };
+	mix(header, sizeof(header));
+
+	for (int i = 0; i < 2; i++) {
+		const SimFighter& f = fighters[i];
+		int ints[9] = { f.health, f.max_health, f.attacking, f.attack_frame, f.crouching, f.blocking, f.stunned, f.knocked_down, f.counter_window };
+		float floats[4] = { f.x, f.y, f.velocity_x, f.facing };
+		mix(ints, sizeof(ints));
+		mix(floats, sizeof(floats));
+	}
+
+	return timers->hash(h);
+}
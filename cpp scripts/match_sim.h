@@ -0,0 +1,219 @@
+#pragma once
+
+#ifndef MATCH_SIM_H
+#define MATCH_SIM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+#include "timer_wheel.h"
+
+namespace godot {
+
+    // ============================================================
+    // HEADLESS MATCH SIMULATION
+    // Frame-based mirror of MatchManager + FighterCharacter with no
+    // nodes, no signals and no engine calls, so many matches can run
+    // side by side in one process (see match_server.h).
+    // ============================================================
+
+    const int SIM_TICK_RATE = 60;
+
+    const int SIM_INTRO_FRAMES = 60;            // start_match tween (1.0s)
+    const int SIM_FIGHT_TEXT_FRAMES = 60;       // "Fight!" label (1.0s)
+    const int SIM_ROUND_END_FRAMES = 180;       // create_timer(3.0) before reset_round
+    const int SIM_ROUND_FRAMES = 60 * SIM_TICK_RATE; // round_timer wait_time
+
+    const int SIM_HITSTUN_FRAMES = 15;          // hitstun_duration 0.25s
+    const int SIM_KNOCKDOWN_FRAMES = 60;        // knockdown_duration 1.0s
+    const int SIM_COUNTER_FRAMES = 12;          // counter window 0.2s
+
+    // ============================================================
+    // INPUT
+    // ============================================================
+    enum SimButton : uint8_t {
+        SIM_LEFT = 1 << 0,
+        SIM_RIGHT = 1 << 1,
+        SIM_CROUCH = 1 << 2,
+        SIM_BLOCK = 1 << 3,
+        SIM_PUNCH = 1 << 4,
+        SIM_KICK = 1 << 5,
+    };
+
+    // ============================================================
+    // TIMERS
+    // Everything timed in the sim goes through the match's TimerWheel.
+    // ============================================================
+    enum SimTimerKind : uint16_t {
+        SIM_TIMER_INTRO,            // target unused
+        SIM_TIMER_FIGHT_TEXT,
+        SIM_TIMER_ROUND_TIME,
+        SIM_TIMER_ROUND_RESET,
+        SIM_TIMER_STUN,             // target = fighter slot
+        SIM_TIMER_KNOCKDOWN,
+        SIM_TIMER_COUNTER,
+    };
+
+    struct SimInput {
+        uint8_t buttons = 0;
+        uint8_t pressed = 0; // just-pressed edge, filled in by the sim
+    };
+
+    // ============================================================
+    // PER-MATCH ARENA
+    // One block per match, carved up at setup. Nothing is freed
+    // individually; the whole block goes away with the match.
+    // ============================================================
+    class MatchArena {
+    public:
+        explicit MatchArena(size_t capacity);
+
+        template <typename T>
+        T* alloc(size_t count) {
+            size_t aligned = (used + alignof(T) - 1) & ~(alignof(T) - 1);
+            size_t bytes = sizeof(T) * count;
+            if (aligned + bytes > capacity) return nullptr;
+            used = aligned + bytes;
+            T* ptr = reinterpret_cast<T*>(memory.get() + aligned);
+            for (size_t i = 0; i < count; i++) new (ptr + i) T();
+            return ptr;
+        }
+
+        size_t get_used() const { return used; }
+        size_t get_capacity() const { return capacity; }
+
+    private:
+        std::unique_ptr<unsigned char[]> memory;
+        size_t capacity;
+        size_t used;
+    };
+
+    // ============================================================
+    // FIGHTER
+    // ============================================================
+    struct SimFighter {
+        int health = 100;
+        int max_health = 100;
+
+        float x = 0.0f;
+        float y = 0.0f;
+        float velocity_x = 0.0f;
+        float facing = 1.0f;
+
+        bool attacking = false;
+        int attack_frame = 0;
+        int attack_length = 0;
+        int attack_damage = 0;
+        float attack_reach = 0.0f;
+
+        bool crouching = false;
+        bool blocking = false;
+
+        bool stunned = false;
+        bool knocked_down = false;
+        bool counter_window = false;
+
+        TimerHandle stun_timer;
+        TimerHandle knockdown_timer;
+        TimerHandle counter_timer;
+
+        uint8_t last_buttons = 0;
+    };
+
+    // ============================================================
+    // BOT
+    // Deterministic xorshift driver so matches can run unattended.
+    // ============================================================
+    struct SimBot {
+        uint32_t state = 1;
+
+        uint32_t next();
+        SimInput think(const SimFighter& self, const SimFighter& other);
+    };
+
+    // ============================================================
+    // MATCH
+    // ============================================================
+    class MatchSim {
+    public:
+        enum State { IDLE, INTRO, FIGHT, ROUND_END, MATCH_END };
+
+        static const size_t ARENA_SIZE = 64 * 1024;
+        static const int MAX_ROUNDS = 3;
+        static const int ROUNDS_TO_WIN = MAX_ROUNDS / 2 + 1;
+
+        explicit MatchSim(uint32_t seed);
+
+        // Who plays, as matchmaking paired them; refill matches keep zeros
+        void set_players(uint32_t match_id, const uint32_t player_ids[2], const int ratings[2]);
+
+        void start_match();
+        void tick(const SimInput inputs[2]);
+        void tick_bots();
+
+        State get_state() const { return current_state; }
+        bool is_finished() const { return current_state == MATCH_END; }
+
+        int get_rounds_won_p1() const { return rounds_won_p1; }
+        int get_rounds_won_p2() const { return rounds_won_p2; }
+        int get_rounds_played() const { return rounds_played; }
+        // Slot with more rounds won, -1 for a draw; meaningful once finished
+        int get_winner() const;
+        int get_round_time_left() const { return timers->get_remaining(round_timer) / SIM_TICK_RATE; }
+        uint32_t get_frame() const { return frame; }
+
+        uint32_t get_match_id() const { return match_id; }
+        uint32_t get_player_id(int slot) const { return player_ids[slot]; }
+        int get_rating(int slot) const { return ratings[slot]; }
+
+        const SimFighter& get_fighter(int slot) const { return fighters[slot]; }
+        const MatchArena& get_arena() const { return arena; }
+
+        uint64_t hash_state() const;
+
+    private:
+        MatchArena arena;
+
+        SimFighter* fighters;
+        SimBot* bots;
+        TimerWheel* timers;
+
+        // Input log for replay / netplay validation, one entry per fighter per fight frame.
+        SimInput* input_log;
+        uint32_t input_log_size;
+        uint32_t input_log_capacity;
+
+        uint32_t match_id;
+        uint32_t player_ids[2];
+        int ratings[2];
+
+        State current_state;
+        int rounds_won_p1;
+        int rounds_won_p2;
+        int rounds_played;
+
+        uint32_t frame;
+        TimerHandle state_timer;
+        TimerHandle fight_text_timer;
+        TimerHandle round_timer;
+        bool fight_text_visible;
+
+        void start_fight();
+        void end_round();
+        void reset_round();
+        void end_match();
+
+        void on_timer(const TimerEvent& event);
+        TimerHandle schedule(uint32_t frames, SimTimerKind kind, int target = 0);
+
+        void reset_fighter(int slot);
+        void tick_fighter(int slot, SimInput input);
+        void resolve_hits();
+        void take_damage(int slot, int amount, float hit_x);
+    };
+
+} // namespace godot
+
+#endif
@@ -0,0 +1,200 @@
+#include "matchmaking.h"
+
+#include <climits>
+
+using namespace godot;
+
+MatchmakingQueue::MatchmakingQueue(size_t capacity) :
+		base_window(50),
+		widen_per_sec(25.0f),
+		max_window(400),
+		players(capacity),
+		queue_head(NONE),
+		queue_tail(NONE),
+		count(0),
+		next_match_id(1) {
+	free_slots.reserve(capacity);
+	for (size_t i = capacity; i > 0; i--) {
+		free_slots.push_back((uint32_t)(i - 1));
+	}
+	slot_of.reserve(capacity);
+
+	for (int i = 0; i < OCCUPIED_WORDS; i++) {
+		occupied[i] = 0;
+	}
+}
+
+int MatchmakingQueue::bucket_of(int rating) {
+	if (rating < MIN_RATING) rating = MIN_RATING;
+	if (rating > MAX_RATING) rating = MAX_RATING;
+	return rating - MIN_RATING;
+}
+
+int MatchmakingQueue::window_of(const QueuedPlayer& player, double now) const {
+	int window = base_window + int(widen_per_sec * (now - player.enqueued_at));
+	return window < max_window ? window : max_window;
+}
+
+// First non-empty bucket at or above `bucket`, -1 if none
+int MatchmakingQueue::next_occupied(int bucket) const {
+	if (bucket >= BUCKET_COUNT) return -1;
+
+	int word = bucket >> 6;
+	uint64_t bits = occupied[word] & (~0ull << (bucket & 63));
+	while (!bits) {
+		if (++word == OCCUPIED_WORDS) return -1;
+		bits = occupied[word];
+	}
+	return (word << 6) + __builtin_ctzll(bits);
+}
+
+// Last non-empty bucket at or below `bucket`, -1 if none
+int MatchmakingQueue::prev_occupied(int bucket) const {
+	if (bucket < 0) return -1;
+
+	int word = bucket >> 6;
+	uint64_t bits = occupied[word] & (~0ull >> (63 - (bucket & 63)));
+	while (!bits) {
+		if (--word < 0) return -1;
+		bits = occupied[word];
+	}
+	return (word << 6) + 63 - __builtin_clzll(bits);
+}
+
+// ------------------ ENQUEUE / CANCEL --------------------
+bool MatchmakingQueue::enqueue(uint32_t player_id, int rating, double now) {
+	if (free_slots.empty() || slot_of.count(player_id)) return false;
+
+	uint32_t slot = free_slots.back();
+	free_slots.pop_back();
+	slot_of[player_id] = slot;
+
+	QueuedPlayer& p = players[slot];
+	p.player_id = player_id;
+	p.rating = rating;
+	p.enqueued_at = now;
+
+	int b = bucket_of(rating);
+	Bucket& bucket = buckets[b];
+	p.bucket_prev = bucket.tail;
+	p.bucket_next = NONE;
+	if (bucket.tail != NONE) players[bucket.tail].bucket_next = slot;
+	else bucket.head = slot;
+	bucket.tail = slot;
+	bucket.size++;
+	occupied[b >> 6] |= 1ull << (b & 63);
+
+	p.queue_prev = queue_tail;
+	p.queue_next = NONE;
+	if (queue_tail != NONE) players[queue_tail].queue_next = slot;
+	else queue_head = slot;
+	queue_tail = slot;
+
+	count++;
+	return true;
+}
+
+bool MatchmakingQueue::cancel(uint32_t player_id) {
+	auto it = slot_of.find(player_id);
+	if (it == slot_of.end()) return false;
+
+	remove(it->second);
+	return true;
+}
+
+void MatchmakingQueue::remove(uint32_t slot) {
+	QueuedPlayer& p = players[slot];
+
+	int b = bucket_of(p.rating);
+	Bucket& bucket = buckets[b];
+	if (p.bucket_prev != NONE) players[p.bucket_prev].bucket_next = p.bucket_next;
+	else bucket.head = p.bucket_next;
+	if (p.bucket_next != NONE) players[p.bucket_next].bucket_prev = p.bucket_prev;
+	else bucket.tail = p.bucket_prev;
+	if (--bucket.size == 0) occupied[b >> 6] &= ~(1ull << (b & 63));
+
+	if (p.queue_prev != NONE) players[p.queue_prev].queue_next = p.queue_next;
+	else queue_head = p.queue_next;
+	if (p.queue_next != NONE) players[p.queue_next].queue_prev = p.queue_prev;
+	else queue_tail = p.queue_prev;
+
+	slot_of.erase(p.player_id);
+	free_slots.push_back(slot);
+	count--;
+}
+
+// ------------------ PAIRING --------------------
+uint32_t MatchmakingQueue::find_opponent(uint32_t slot, double now) const {
+	const QueuedPlayer& p = players[slot];
+	int window = window_of(p, now);
+	int home = bucket_of(p.rating);
+
+	// A bucket's head has waited longest, so it has the widest window of
+	// its bucket: if it won't accept the gap nobody behind it will, and if
+	// it will, it also wins the tie on age. Probe outwards one occupied
+	// bucket at a time; the first gap with a taker is the best gap.
+	int up = next_occupied(home);
+	int down = prev_occupied(home - 1);
+
+	while (true) {
+		int up_gap = up < 0 ? INT_MAX : up - home;
+		int down_gap = down < 0 ? INT_MAX : home - down;
+		int gap = up_gap < down_gap ? up_gap : down_gap;
+		if (gap > window) return NONE;
+
+		uint32_t best = NONE;
+		int sides[2] = { up_gap == gap ? up : -1, down_gap == gap ? down : -1 };
+		for (int b : sides) {
+			if (b < 0) continue;
+
+			uint32_t c = buckets[b].head;
+			if (c == slot) c = players[c].bucket_next;
+			if (c == NONE) continue;
+
+			// Both sides have to accept the pairing; the older candidate wins ties
+			if (gap <= window_of(players[c], now) && (best == NONE || players[c].enqueued_at < players[best].enqueued_at)) {
+				best = c;
+			}
+		}
+		if (best != NONE) return best;
+
+		if (up_gap == gap) up = next_occupied(up + 1);
+		if (down_gap == gap) down = prev_occupied(down - 1);
+	}
+}
+
+int MatchmakingQueue::form_pairs(double now, std::vector<MatchDescriptor>& out, int max_pairs) {
+	int formed = 0;
+	uint32_t slot = queue_head;
+
+	while (slot != NONE && formed < max_pairs) {
+		uint32_t opponent = find_opponent(slot, now);
+		if (opponent == NONE) {
+			slot = players[slot].queue_next;
+			continue;
+		}
+
+		const QueuedPlayer& a = players[slot];
+		const QueuedPlayer& b = players[opponent];
+
+		MatchDescriptor match;
+		match.match_id = next_match_id++;
+		match.player_ids[0] = a.player_id;
+		match.player_ids[1] = b.player_id;
+		match.ratings[0] = a.rating;
+		match.ratings[1] = b.rating;
+		match.seed = match.match_id * 2654435761u ^ a.player_id ^ (b.player_id << 16);
+		out.push_back(match);
+		formed++;
+
+		// The opponent may be the next entry in the global queue, so advance past both
+		uint32_t next = a.queue_next;
+		if (next == opponent) next = b.queue_next;
+
+		remove(slot);
+		remove(opponent);
+		slot = next;
+	}
+
+	return formed;
+}
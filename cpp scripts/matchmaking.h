@@ -0,0 +1,97 @@
+#pragma once
+
+#ifndef MATCHMAKING_H
+#define MATCHMAKING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace godot {
+
+    // ============================================================
+    // MATCH DESCRIPTOR
+    // What the queue hands to MatchServer::submit().
+    // ============================================================
+    struct MatchDescriptor {
+        uint32_t match_id = 0;
+        uint32_t player_ids[2] = { 0, 0 };
+        int ratings[2] = { 0, 0 };
+        uint32_t seed = 0;
+    };
+
+    // ============================================================
+    // MATCHMAKING QUEUE
+    // Players sit in one bucket per rating (FIFO per bucket) and on one
+    // global FIFO. Pairing walks the global FIFO oldest-first and probes
+    // the occupied buckets outwards from the player's rating, looking only
+    // at each bucket's head, so cost per pair depends on how many ratings
+    // are queued inside the window, not on queue size.
+    // Ratings outside [MIN_RATING, MAX_RATING] are matched as the bound.
+    // ============================================================
+    class MatchmakingQueue {
+    public:
+        static const int MIN_RATING = 0;
+        static const int MAX_RATING = 4000;
+        static const int BUCKET_COUNT = MAX_RATING - MIN_RATING + 1;
+        static const int OCCUPIED_WORDS = (BUCKET_COUNT + 63) / 64;
+
+        explicit MatchmakingQueue(size_t capacity);
+
+        // Window = base_window + widen_per_sec * seconds waited, capped at max_window
+        int base_window;
+        float widen_per_sec;
+        int max_window;
+
+        bool enqueue(uint32_t player_id, int rating, double now);
+        bool cancel(uint32_t player_id);
+
+        int form_pairs(double now, std::vector<MatchDescriptor>& out, int max_pairs);
+
+        size_t size() const { return count; }
+        size_t get_capacity() const { return players.size(); }
+        int get_bucket_size(int bucket) const { return buckets[bucket].size; }
+
+    private:
+        static const uint32_t NONE = 0xFFFFFFFFu;
+
+        struct QueuedPlayer {
+            uint32_t player_id;
+            int rating;
+            double enqueued_at;
+
+            uint32_t bucket_prev, bucket_next;
+            uint32_t queue_prev, queue_next;
+        };
+
+        struct Bucket {
+            uint32_t head = NONE;
+            uint32_t tail = NONE;
+            int size = 0;
+        };
+
+        std::vector<QueuedPlayer> players;
+        std::vector<uint32_t> free_slots;
+        std::unordered_map<uint32_t, uint32_t> slot_of;
+
+        Bucket buckets[BUCKET_COUNT];
+        uint64_t occupied[OCCUPIED_WORDS];      // bit per non-empty bucket
+        uint32_t queue_head;
+        uint32_t queue_tail;
+        size_t count;
+
+        uint32_t next_match_id;
+
+        static int bucket_of(int rating);
+        int window_of(const QueuedPlayer& player, double now) const;
+        int next_occupied(int bucket) const;
+        int prev_occupied(int bucket) const;
+
+        uint32_t find_opponent(uint32_t slot, double now) const;
+        void remove(uint32_t slot);
+    };
+
+} // namespace godot
+
+#endif
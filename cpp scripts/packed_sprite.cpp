@@ -0,0 +1,287 @@
+#include "packed_sprite.h"
+
+#include <FileAccess.hpp>
+#include <ProjectSettings.hpp>
+#include <ResourceLoader.hpp>
+
+using namespace godot;
+
+PackedSprite::PackedSprite() :
+		lod(0),
+		animation(-1),
+		frame(0),
+		frame_time(0.0),
+		playing(false) {}
+
+PackedSprite::~PackedSprite() {}
+
+void PackedSprite::_register_methods() {
+	register_method("_ready", &PackedSprite::_ready);
+	register_method("_process", &PackedSprite::_process);
+	register_method("_draw", &PackedSprite::_draw);
+
+	register_method("load_table", &PackedSprite::load_table);
+	register_method("is_loaded", &PackedSprite::is_loaded);
+	register_method("find_animation", &PackedSprite::find_animation);
+	register_method("play", &PackedSprite::play);
+	register_method("play_id", &PackedSprite::play_id);
+	register_method("stop", &PackedSprite::stop);
+	register_method("set_frame", &PackedSprite::set_frame);
+	register_method("show_frame", &PackedSprite::show_frame);
+	register_method("set_flip_h", &PackedSprite::set_flip_h);
+	register_method("get_animation", &PackedSprite::get_animation);
+	register_method("get_frame", &PackedSprite::get_frame);
+	register_method("is_playing", &PackedSprite::is_playing);
+	register_method("get_frame_boxes", &PackedSprite::get_frame_boxes);
+	register_method("get_lod", &PackedSprite::get_lod);
+	register_method("get_lod_stats", &PackedSprite::get_lod_stats);
+
+	register_property<PackedSprite, String>("frame_table", &PackedSprite::frame_table, "");
+	register_property<PackedSprite, String>("autoplay", &PackedSprite::autoplay, "");
+	register_property<PackedSprite, bool>("centered", &PackedSprite::centered, true);
+	register_property<PackedSprite, bool>("flip_h", &PackedSprite::flip_h, false);
+	register_property<PackedSprite, float>("speed_scale", &PackedSprite::speed_scale, 1.0f);
+	register_property<PackedSprite, int>("min_lod", &PackedSprite::min_lod, 0);
+	register_property<PackedSprite, float>("lod_bias", &PackedSprite::lod_bias, 0.0f);
+
+	register_signal<PackedSprite>("animation_finished");
+}
+
+void PackedSprite::_init() {
+	centered = true;
+	flip_h = false;
+	speed_scale = 1.0f;
+	min_lod = 0;
+	lod_bias = 0.0f;
+}
+
+void PackedSprite::_ready() {
+	// Not repacked yet is not an error, the owner falls back to its AnimatedSprite2D
+	if (frame_table.is_empty() || !FileAccess::file_exists(frame_table)) return;
+
+	if (load_table(frame_table) && !autoplay.is_empty()) {
+		play(autoplay);
+	}
+}
+
+// ------------------ LOAD --------------------
+bool PackedSprite::load_table(const String& path) {
+	stop();
+	animation = -1;
+	lod_pages.clear();
+
+	String os_path = ProjectSettings::get_singleton()->globalize_path(path);
+	ERR_FAIL_COND_V_MSG(!table.open(os_path.utf8().get_data()), false, "PackedSprite: cannot open frame table " + path);
+
+	lod_pages.resize(table.get_lod_count());
+	lod = pick_lod();
+	if (!load_lod(lod)) {
+		table.close();
+		return false;
+	}
+
+	timeline.build(table);
+	frame_table = path;
+	queue_redraw();
+	return true;
+}
+
+// The only Resources a character needs: one texture per page of the LODs in use
+bool PackedSprite::load_lod(int level) {
+	std::vector<Ref<Texture2D>>& pages = lod_pages[level];
+	if (!pages.empty()) return true;
+
+	for (int p = 0; p < table.get_page_count(); p++) {
+		String page_path = String::utf8(table.get_page_path(p, level));
+		Ref<Texture2D> page = ResourceLoader::get_singleton()->load(page_path);
+		if (page.is_null()) {
+			pages.clear();
+			ERR_FAIL_V_MSG(false, "PackedSprite: missing page " + page_path);
+		}
+		pages.push_back(page);
+	}
+	return true;
+}
+
+int PackedSprite::pick_lod() const {
+	int coarsest = table.get_lod_count() - 1;
+	int finest = Math::clamp(min_lod, 0, coarsest);
+
+	// Texels per screen pixel at LOD 0 is 1 / scale; each LOD halves it
+	float scale = Math::abs(get_global_transform_with_canvas().get_scale().x);
+	if (scale <= 0.0f) return coarsest;
+
+	int level = (int)Math::floor(Math::log(1.0f / scale) / Math_LN2 + lod_bias);
+	return Math::clamp(level, finest, coarsest);
+}
+
+void PackedSprite::update_lod() {
+	if (!table.is_open()) return;
+
+	int level = pick_lod();
+	if (level == lod) return;
+
+	// Fall back to whatever is resident if the new LOD can't load
+	if (!load_lod(level)) return;
+	lod = level;
+	queue_redraw();
+}
+
+Dictionary PackedSprite::get_lod_stats() const {
+	Dictionary result;
+	Array lods;
+	for (const std::vector<Ref<Texture2D>>& pages : lod_pages) {
+		int64_t bytes = 0;
+		for (const Ref<Texture2D>& page : pages) {
+			bytes += (int64_t)page->get_width() * page->get_height() * 4;
+		}
+
+		Dictionary entry;
+		entry["loaded"] = !pages.empty();
+		entry["bytes"] = bytes;
+		lods.push_back(entry);
+	}
+	result["current"] = lod;
+	result["lods"] = lods;
+	return result;
+}
+
+int PackedSprite::find_animation(const String& name) const {
+	if (!table.is_open()) return -1;
+	return table.find_animation(name.utf8().get_data());
+}
+
+// ------------------ PLAYBACK --------------------
+void PackedSprite::play(const String& name) {
+	int id = find_animation(name);
+	ERR_FAIL_COND_MSG(id < 0, "PackedSprite: no animation " + name);
+	play_id(id);
+}
+
+void PackedSprite::play_id(int id) {
+	ERR_FAIL_COND(!table.is_open());
+	ERR_FAIL_INDEX(id, table.get_animation_count());
+
+	playing = true;
+	if (id == animation) return;       // same as AnimatedSprite2D: keep going
+
+	animation = id;
+	frame = 0;
+	frame_time = 0.0;
+	queue_redraw();
+}
+
+void PackedSprite::stop() {
+	playing = false;
+}
+
+void PackedSprite::set_frame(int id, int index) {
+	ERR_FAIL_COND(!table.is_open());
+	ERR_FAIL_INDEX(id, table.get_animation_count());
+	ERR_FAIL_INDEX(index, table.get_frame_count(id));
+
+	animation = id;
+	frame = index;
+	frame_time = 0.0;
+	queue_redraw();
+}
+
+void PackedSprite::show_state(const AnimState& state) {
+	ERR_FAIL_COND(!table.is_open());
+	ERR_FAIL_INDEX(state.animation, table.get_animation_count());
+
+	playing = false;
+	int index = timeline.sample(state);
+	if (state.animation == animation && index == frame) return;
+
+	animation = state.animation;
+	frame = index;
+	queue_redraw();
+}
+
+void PackedSprite::show_frame(int id, int frames_elapsed) {
+	AnimState state;
+	state.restart(id);
+	state.frame = (uint32_t)frames_elapsed;
+	show_state(state);
+}
+
+void PackedSprite::set_flip_h(bool value) {
+	if (flip_h == value) return;
+	flip_h = value;
+	queue_redraw();
+}
+
+void PackedSprite::_process(double delta) {
+	update_lod();
+	if (!playing || animation < 0) return;
+
+	const FrameAnimationRecord& record = table.get_animation(animation);
+	if (record.frame_count == 0 || record.speed <= 0.0f) return;
+
+	// Durations are relative, as in SpriteFrames: seconds = duration / speed.
+	// Every frame holds for at least one tick, as in AnimTimeline, so zero
+	// durations can't spin this loop forever
+	frame_time += delta * speed_scale * record.speed;
+	const double min_duration = (double)record.speed / timeline.get_tick_rate();
+	bool changed = false;
+
+	while (true) {
+		double duration = MAX((double)table.get_frame(animation, frame).duration, min_duration);
+		if (frame_time < duration) break;
+		frame_time -= duration;
+
+		if (frame + 1 < record.frame_count) {
+			frame++;
+		} else if (record.loop) {
+			frame = 0;
+		} else {
+			frame_time = 0.0;
+			playing = false;
+			emit_signal("animation_finished");
+			break;
+		}
+		changed = true;
+	}
+
+	if (changed) queue_redraw();
+}
+
+// ------------------ DRAW --------------------
+void PackedSprite::_draw() {
+	if (animation < 0) return;
+
+	const FrameRecord& record = table.get_frame(animation, frame);
+	if (record.page < 0) return;
+
+	Vector2 origin(record.offset_x, record.offset_y);
+	if (centered) {
+		origin -= Vector2(record.source_width, record.source_height) * 0.5f;
+	}
+
+	if (flip_h) {
+		draw_set_transform(Vector2(), 0.0, Vector2(-1, 1));
+	}
+
+	// Rects are LOD 0 pixels on a 2^(lod_count - 1) grid, so the shift is exact;
+	// the rounded-up size only adds transparent gutter
+	int scale = 1 << lod;
+	Vector2 source_position(record.x >> lod, record.y >> lod);
+	Vector2 source_size((record.width + scale - 1) >> lod, (record.height + scale - 1) >> lod);
+	draw_texture_rect_region(lod_pages[lod][record.page], Rect2(origin, source_size * scale), Rect2(source_position, source_size));
+}
+
+Array PackedSprite::get_frame_boxes() const {
+	Array result;
+	if (animation < 0) return result;
+
+	const FrameRecord& record = table.get_frame(animation, frame);
+	const FrameBox* boxes = table.get_boxes(record);
+
+	for (int b = 0; b < record.box_count; b++) {
+		Rect2 rect(boxes[b].x, boxes[b].y, boxes[b].width, boxes[b].height);
+		if (flip_h) rect.position.x = -rect.position.x - rect.size.x;
+		result.push_back(Array::make((int64_t)boxes[b].kind, rect));
+	}
+	return result;
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#ifndef PACKED_SPRITE_H
+#define PACKED_SPRITE_H
+
+#include <Godot.hpp>
+#include <Node2D.hpp>
+#include <Texture2D.hpp>
+#include <RenderingServer.hpp>
+
+#include <vector>
+
+#include "frame_table.h"
+#include "anim_timeline.h"
+
+namespace godot {
+
+    // ============================================================
+    // PACKED SPRITE
+    // Stand-in for the fighters' AnimatedSprite2D that draws from a
+    // repacked frame table (SpriteRepacker's .frames.bin) instead of a
+    // SpriteFrames full of AtlasTextures. The table is memory-mapped and
+    // the page textures are the only Resources it loads; a frame is an
+    // (animation id, index) pair and drawing it is one rect-region quad.
+    // Same origin, centering and flip as AnimatedSprite2D, so it drops
+    // into facing_container in its place. The fighter scenes carry one
+    // next to their AnimatedSprite2D; until SpriteRepacker has written
+    // the table it stays unloaded and the fighter keeps the original.
+    // LODs: every frame, the on-screen scale (node scale x camera zoom)
+    // picks the page set whose texels are closest to one per pixel.
+    // A LOD's pages are loaded the first time it is picked; min_lod
+    // keeps the finer ones from ever loading on low-end machines.
+    // ============================================================
+    class PackedSprite : public Node2D {
+        GODOT_CLASS(PackedSprite, Node2D)
+
+    public:
+        PackedSprite();
+        ~PackedSprite();
+
+        static void _register_methods();
+
+        void _init() override;
+        void _ready() override;
+        void _process(double delta) override;
+        void _draw() override;
+
+        // ============================================================
+        // SETTINGS
+        // ============================================================
+        String frame_table;         // res:// path to <name>.frames.bin
+        String autoplay;
+        bool centered;
+        bool flip_h;
+        float speed_scale;
+        int min_lod;
+        float lod_bias;             // > 0 picks coarser LODs earlier
+
+        // ============================================================
+        // PLAYBACK
+        // ============================================================
+        bool load_table(const String& path);
+        bool is_loaded() const { return table.is_open(); }
+        int find_animation(const String& name) const;
+
+        void play(const String& name);
+        void play_id(int animation);
+        void stop();
+        void set_frame(int animation, int index);
+        // Stateless: show what `state` samples to, no clock of our own
+        void show_state(const AnimState& state);
+        void show_frame(int animation, int frames_elapsed);
+        void set_flip_h(bool value);
+
+        int get_animation() const { return animation; }
+        int get_frame() const { return frame; }
+        bool is_playing() const { return playing; }
+        const FrameTable& get_table() const { return table; }
+        const AnimTimeline& get_timeline() const { return timeline; }
+
+        // [[kind, Rect2], ...] for the current frame in local space, flip applied
+        Array get_frame_boxes() const;
+
+        int get_lod() const { return lod; }
+        // { current, lods: [{ loaded, bytes }, ...] }
+        Dictionary get_lod_stats() const;
+
+    private:
+        FrameTable table;
+        AnimTimeline timeline;
+        std::vector<std::vector<Ref<Texture2D>>> lod_pages;     // empty until first used
+        int lod;
+
+        int animation;
+        int frame;
+        double frame_time;
+        bool playing;
+
+        int pick_lod() const;
+        bool load_lod(int level);
+        void update_lod();
+    };
+
+} // namespace godot
+
+#endif
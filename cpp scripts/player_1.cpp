@@ -2,13 +2,17 @@
 
 #include <godot_cpp/classes/character_body2d.hpp>
 #include <godot_cpp/classes/animation_player.hpp>
+#include <godot_cpp/classes/animation.hpp>
 #include <godot_cpp/classes/area2d.hpp>
-#include <godot_cpp/classes/timer.hpp>
 #include <godot_cpp/classes/input.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 #include <godot_cpp/variant/dictionary.hpp>
 #include <godot_cpp/variant/array.hpp>
 
+#include "gameplay_timers.h"
+#include "match_events.h"
+#include "anim_timeline.h"
+
 using namespace godot;
 
 
@@ -26,9 +30,9 @@ struct CombatState {
 };
 
 struct Timers {
-	double stun = 0.0;
-	double knockdown = 0.0;
-	double counter = 0.0;
+	TimerHandle stun;
+	TimerHandle knockdown;
+	TimerHandle counter;
 };
 
 struct MovementState {
@@ -43,12 +47,10 @@ struct NodeRefs {
 
 	Area2D *hitboxes[2] = { nullptr, nullptr };
 	Area2D *hurtboxes[2] = { nullptr, nullptr };
-
-	Timer *counter_timer = nullptr;
 };
 
 
-class FighterCharacter : public CharacterBody2D {
+class FighterCharacter : public CharacterBody2D, public TimerListener {
 	GDCLASS(FighterCharacter, CharacterBody2D);
 
 public:
@@ -57,20 +59,35 @@ public:
 
 	void _ready();
 	void _physics_process(double delta);
+	void _process(double delta);
 
 	void take_damage(int amount, Vector2 hit_pos);
 	void reset_stats();
 
+	void set_fighter_slot(int slot);
+	int get_fighter_slot() const;
+
+	int get_health() const;
+	int get_fighter_state() const;
+
+	void on_gameplay_timer(const TimerEvent &event) override;
+
 protected:
 	static void _bind_methods();
 
 private:
 	// ================= CORE STATE =================
+	int fighter_slot = 0;
 	VitalStats vitals;
 	CombatState combat;
 	Timers timers;
 	MovementState movement;
 	NodeRefs nodes;
+	AnimState anim;			// what the AnimationPlayer shows is sampled from this
+
+	AnimTimeline anim_timeline;
+	PackedStringArray anim_names;	// timeline id -> AnimationPlayer name
+	Dictionary anim_ids;
 
 	Dictionary combos;
 	Array input_buffer;
@@ -95,10 +112,16 @@ private:
 	// ================= DAMAGE SYSTEM =================
 	void apply_knockback(Vector2 hit_pos, double force);
 	void apply_stun(double duration);
+	void push_event(MatchEventType type, int value = 0, int delta = 0);
+
+	// ================= TIMERS =================
+	void schedule_timer(TimerHandle &handle, double seconds, GameplayTimerKind kind);
+	void cancel_timers();
 
 	// ================= HELPERS =================
 	void apply_gravity(double delta);
-	void safe_play(const String &anim);
+	void build_anim_timeline();
+	void safe_play(const String &anim_name, bool restart = false);
 	bool can_accept_input() const;
 };
 
@@ -120,8 +143,33 @@ FighterCharacter::~FighterCharacter() {
 void FighterCharacter::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("_ready"), &FighterCharacter::_ready);
 	ClassDB::bind_method(D_METHOD("_physics_process", "delta"), &FighterCharacter::_physics_process);
+	ClassDB::bind_method(D_METHOD("_process", "delta"), &FighterCharacter::_process);
 	ClassDB::bind_method(D_METHOD("take_damage", "amount", "hit_pos"), &FighterCharacter::take_damage);
 	ClassDB::bind_method(D_METHOD("reset_stats"), &FighterCharacter::reset_stats);
+
+	ClassDB::bind_method(D_METHOD("set_fighter_slot", "slot"), &FighterCharacter::set_fighter_slot);
+	ClassDB::bind_method(D_METHOD("get_fighter_slot"), &FighterCharacter::get_fighter_slot);
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "fighter_slot"), "set_fighter_slot", "get_fighter_slot");
+
+	ClassDB::bind_method(D_METHOD("get_health"), &FighterCharacter::get_health);
+	ClassDB::bind_method(D_METHOD("get_fighter_state"), &FighterCharacter::get_fighter_state);
+}
+
+void FighterCharacter::set_fighter_slot(int slot) {
+	fighter_slot = slot;
+}
+
+int FighterCharacter::get_fighter_slot() const {
+	return fighter_slot;
+}
+
+int FighterCharacter::get_health() const {
+	return vitals.health;
+}
+
+int FighterCharacter::get_fighter_state() const {
+	return resolve_fighter_state(vitals.health <= 0, combat.knocked_down, combat.stunned,
+			combat.attacking, combat.blocking, movement.crouching);
 }
 
 void FighterCharacter::_ready() {
@@ -134,19 +182,24 @@ void FighterCharacter::_ready() {
 	nodes.hurtboxes[0] = Object::cast_to<Area2D>(get_node("facing_container/hurtbox_standing"));
 	nodes.hurtboxes[1] = Object::cast_to<Area2D>(get_node("facing_container/hurtbox_crouching"));
 
-	nodes.counter_timer = memnew(Timer);
-	nodes.counter_timer->set_one_shot(true);
-	add_child(nodes.counter_timer);
-
 	// Disable all hitboxes at start
 	for (int i = 0; i < 2; i++) {
 		if (nodes.hitboxes[i]) {
 			nodes.hitboxes[i]->set_deferred("monitoring", false);
 		}
 	}
+
+	build_anim_timeline();
 }
 
 void FighterCharacter::_physics_process(double delta) {
+	// Attacks last as long as their animation, counted here rather
+	// than waiting on the player to finish
+	anim.step();
+	if (combat.attacking && anim_timeline.is_finished(anim)) {
+		stop_attack();
+	}
+
 	process_state(delta);
 	process_buffer(delta);
 	check_combos();
@@ -155,20 +208,8 @@ void FighterCharacter::_physics_process(double delta) {
 
 
 void FighterCharacter::process_state(double delta) {
-	if (combat.knocked_down) {
-		timers.knockdown -= delta;
-		if (timers.knockdown <= 0.0) {
-			combat.knocked_down = false;
-			safe_play("p1_get_up");
-		}
-		return;
-	}
-
-	if (combat.stunned) {
-		timers.stun -= delta;
-		if (timers.stun <= 0.0) {
-			combat.stunned = false;
-		}
+	// Knockdown and stun end from on_gameplay_timer
+	if (combat.knocked_down || combat.stunned) {
 		return;
 	}
 
@@ -231,11 +272,11 @@ void FighterCharacter::start_attack(const String &id) {
 	combat.attacking = true;
 
 	if (id == "punch") {
-		safe_play("p1_attack_j_simple");
+		safe_play("p1_attack_j_simple", true);
 		toggle_hitboxes(true, false);
 	}
 	else if (id == "kick") {
-		safe_play("p1_attack_k_simple");
+		safe_play("p1_attack_k_simple", true);
 		toggle_hitboxes(false, true);
 	}
 }
@@ -278,7 +319,7 @@ void FighterCharacter::check_combos() {
 	for (int i = 0; i < keys.size(); i++) {
 		Array seq = combos[keys[i]];
 		if (match_combo_recursive(seq, seq.size() - 1, input_buffer.size() - 1)) {
-			safe_play("combo_punch_punch_kick");
+			safe_play("combo_punch_punch_kick", true);
 			input_buffer.clear();
 			combat.attacking = true;
 			return;
@@ -307,17 +348,23 @@ void FighterCharacter::take_damage(int amount, Vector2 hit_pos) {
 	if (combat.blocking) {
 		final_damage *= 0.2;
 		combat.counter_window = true;
-		nodes.counter_timer->start(0.2);
+		schedule_timer(timers.counter, 0.2, TIMER_COUNTER_END);
 	}
 
+	int previous_health = vitals.health;
 	vitals.health -= final_damage;
 
 	if (vitals.health <= 0) {
 		vitals.health = 0;
+		push_event(EVENT_HEALTH_CHANGED, vitals.health, vitals.health - previous_health);
+		if (previous_health > 0)
+			push_event(EVENT_FIGHTER_DIED);
 		safe_play("p1_defeat");
 		return;
 	}
 
+	push_event(EVENT_HEALTH_CHANGED, vitals.health, vitals.health - previous_health);
+
 	apply_knockback(hit_pos, 700);
 	apply_stun(0.25);
 }
@@ -330,7 +377,46 @@ void FighterCharacter::apply_knockback(Vector2 hit_pos, double force) {
 
 void FighterCharacter::apply_stun(double duration) {
 	combat.stunned = true;
-	timers.stun = duration;
+	schedule_timer(timers.stun, duration, TIMER_STUN_END);
+}
+
+void FighterCharacter::push_event(MatchEventType type, int value, int delta) {
+	if (MatchEventBus *bus = MatchEventBus::get_singleton()) {
+		bus->push(type, fighter_slot, value, delta);
+	}
+}
+
+
+void FighterCharacter::schedule_timer(TimerHandle &handle, double seconds, GameplayTimerKind kind) {
+	GameplayTimers *gameplay_timers = GameplayTimers::get_singleton();
+	ERR_FAIL_COND(!gameplay_timers);
+
+	gameplay_timers->cancel(handle);
+	handle = gameplay_timers->schedule(this, seconds, kind);
+}
+
+void FighterCharacter::cancel_timers() {
+	if (GameplayTimers *gameplay_timers = GameplayTimers::get_singleton()) {
+		gameplay_timers->cancel(timers.stun);
+		gameplay_timers->cancel(timers.knockdown);
+		gameplay_timers->cancel(timers.counter);
+	}
+	timers = Timers();
+}
+
+void FighterCharacter::on_gameplay_timer(const TimerEvent &event) {
+	switch (event.kind) {
+		case TIMER_KNOCKDOWN_END:
+			combat.knocked_down = false;
+			safe_play("p1_get_up");
+			break;
+		case TIMER_STUN_END:
+			combat.stunned = false;
+			break;
+		case TIMER_COUNTER_END:
+			combat.counter_window = false;
+			break;
+	}
 }
 
 
@@ -354,17 +440,65 @@ void FighterCharacter::process_animation() {
 	}
 }
 
-void FighterCharacter::safe_play(const String &anim) {
-	if (nodes.anim && nodes.anim->has_animation(anim)) {
-		nodes.anim->play(anim);
+// One whole-clip entry per AnimationPlayer animation. The player is
+// switched to manual processing and only ever seeked to the sampled
+// time, so a rollback or resimulation never has to touch it.
+void FighterCharacter::build_anim_timeline() {
+	anim_timeline.clear();
+	anim_ids.clear();
+	anim_names.clear();
+	if (!nodes.anim) return;
+
+	PackedStringArray names = nodes.anim->get_animation_list();
+	for (int i = 0; i < names.size(); i++) {
+		Ref<Animation> clip = nodes.anim->get_animation(names[i]);
+		if (clip.is_null()) continue;
+
+		anim_ids[names[i]] = anim_timeline.add_clip(clip->get_length(), clip->get_loop_mode() != Animation::LOOP_NONE);
+		anim_names.push_back(names[i]);
 	}
+
+	nodes.anim->set_callback_mode_process(AnimationMixer::ANIMATION_CALLBACK_MODE_PROCESS_MANUAL);
+}
+
+void FighterCharacter::safe_play(const String &anim_name, bool restart) {
+	if (!anim_ids.has(anim_name)) {
+		// Missing clip: reads as finished, so an attack on it still ends
+		if (restart) anim.restart(-1);
+		return;
+	}
+
+	int id = anim_ids[anim_name];
+	if (restart) {
+		anim.restart(id);
+	} else {
+		anim.enter(id);
+	}
+}
+
+void FighterCharacter::_process(double) {
+	if (!nodes.anim || anim.animation < 0) return;
+
+	StringName name = anim_names[anim.animation];
+	if (nodes.anim->get_assigned_animation() != name) {
+		nodes.anim->play(name);
+	}
+	nodes.anim->seek((double)anim_timeline.get_pass_frame(anim) / anim_timeline.get_tick_rate(), true);
 }
 
 
 void FighterCharacter::reset_stats() {
+	int previous_health = vitals.health;
 	vitals.health = vitals.max_health;
+	push_event(EVENT_HEALTH_CHANGED, vitals.health, vitals.health - previous_health);
+
 	combat = CombatState();
-	timers = Timers();
+	cancel_timers();
+	movement = MovementState();
 	velocity = Vector2(0, 0);
-	safe_play("p1_idle");
+
+	input_buffer.clear();
+	toggle_hitboxes(false, false);
+
+	safe_play("p1_idle", true);
 }
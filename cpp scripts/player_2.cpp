@@ -1,5 +1,9 @@
 #include "Player2.h"
 
+#include <SpriteFrames.hpp>
+
+#include <vector>
+
 using namespace godot;
 
 Player2::Player2() {}
@@ -9,10 +13,14 @@ Player2::~Player2() {}
 void Player2::_register_methods() {
 	register_method("_ready", &Player2::_ready);
 	register_method("_physics_process", &Player2::_physics_process);
+	register_method("_process", &Player2::_process);
 	register_method("take_damage", &Player2::take_damage);
-	register_method("_on_animation_finished", &Player2::_on_animation_finished);
+	register_method("reset_stats", &Player2::reset_stats);
+	register_method("get_health", &Player2::get_health);
+	register_method("get_fighter_state", &Player2::get_fighter_state);
 
 	register_property<Player2, String>("character_name", &Player2::character_name, "Player_2");
+	register_property<Player2, int>("fighter_slot", &Player2::fighter_slot, 1);
 	register_property<Player2, int>("max_health", &Player2::max_health, 100);
 	register_property<Player2, float>("hitstun_duration", &Player2::hitstun_duration, 0.25);
 	register_property<Player2, float>("knockdown_duration", &Player2::knockdown_duration, 1.0);
@@ -29,8 +37,9 @@ void Player2::_init() {
 	is_blocking = false;
 	is_counter_window_active = false;
 
-	stun_timer = 0;
-	knockdown_time = 0;
+	stun_timer = TimerHandle();
+	knockdown_timer = TimerHandle();
+	counter_timer = TimerHandle();
 	buffer_timer = 0;
 
 	crouch_state = "none";
@@ -55,14 +64,15 @@ void Player2::_ready() {
 	hitbox_punch->disable();
 	hitbox_kick->disable();
 
-	counter_timer = Timer::_new();
-	counter_timer->set_one_shot(true);
-	add_child(counter_timer);
-	counter_timer->connect("timeout", Callable(this, "reset_counter"));
+	build_anim_timeline();
+	play_anim("p2_idle", true);
 }
 
 
 void Player2::_physics_process(float delta) {
+	anim.step();
+	if (is_attacking && anim_timeline.is_finished(anim))
+		_end_attack();
 
 	if (is_knocked_down) {
 		handle_knockdown(delta);
@@ -167,7 +177,7 @@ void Player2::start_attack(String type) {
 	else if (type == "counter_crouch")
 		current_attack = "p2_crouch_block_counter";
 
-	animated_sprite->play(current_attack);
+	play_anim(current_attack, true);
 }
 
 
@@ -179,50 +189,75 @@ void Player2::take_damage(int amount, Vector2 hit_pos) {
 	if (is_blocking) {
 		dmg *= 0.2;
 		is_counter_window_active = true;
-		counter_timer->start(0.2);
+		schedule_timer(counter_timer, 0.2, TIMER_COUNTER_END);
 	}
 
+	int previous_health = health;
 	health -= dmg;
 	health = Math::clamp(health, 0, max_health);
 
+	push_event(EVENT_HEALTH_CHANGED, health, health - previous_health);
+	if (health == 0 && previous_health > 0)
+		push_event(EVENT_FIGHTER_DIED);
+
 	velocity.x = Math::sign(global_position.x - hit_pos.x) * 800;
 	velocity.y = -200;
 
 	if (dmg >= 25) {
 		is_knocked_down = true;
-		knockdown_time = knockdown_duration;
-		animated_sprite->play("p2_knockdown");
+		schedule_timer(knockdown_timer, knockdown_duration, TIMER_KNOCKDOWN_END);
+		play_anim("p2_knockdown");
 		return;
 	}
 
 	is_stunned = true;
-	stun_timer = hitstun_duration;
-	animated_sprite->play(is_crouching ? "p2_get_hit_crouch" : "p2_get_hit");
+	schedule_timer(stun_timer, hitstun_duration, TIMER_STUN_END);
+	play_anim(is_crouching ? "p2_get_hit_crouch" : "p2_get_hit");
 
 	if (health <= 0)
-		animated_sprite->play("p2_defeat");
+		play_anim("p2_defeat");
+}
+
+
+void Player2::push_event(MatchEventType type, int value, int delta) {
+	if (MatchEventBus* bus = MatchEventBus::get_singleton())
+		bus->push(type, fighter_slot, value, delta);
 }
 
 
 void Player2::handle_stun(float delta) {
-	stun_timer -= delta;
 	velocity.x = move_toward(velocity.x, 0, 400 * delta);
 	move_and_slide();
-
-	if (stun_timer <= 0) {
-		is_stunned = false;
-		animated_sprite->play("p2_idle");
-	}
 }
 
 void Player2::handle_knockdown(float delta) {
-	knockdown_time -= delta;
 	apply_gravity(delta);
 	move_and_slide();
+}
+
 
-	if (knockdown_time <= 0) {
-		is_knocked_down = false;
-		animated_sprite->play("p2_knockdown_get_up");
+// ------------------ GAMEPLAY TIMERS --------------------
+void Player2::schedule_timer(TimerHandle& handle, float seconds, GameplayTimerKind kind) {
+	GameplayTimers* timers = GameplayTimers::get_singleton();
+	ERR_FAIL_COND(!timers);
+
+	timers->cancel(handle);
+	handle = timers->schedule(this, seconds, kind);
+}
+
+void Player2::on_gameplay_timer(const TimerEvent& event) {
+	switch (event.kind) {
+		case TIMER_STUN_END:
+			is_stunned = false;
+			play_anim("p2_idle");
+			break;
+		case TIMER_KNOCKDOWN_END:
+			is_knocked_down = false;
+			play_anim("p2_knockdown_get_up");
+			break;
+		case TIMER_COUNTER_END:
+			reset_counter();
+			break;
 	}
 }
 
@@ -232,7 +267,7 @@ void Player2::handle_block() {
 
 	if (block && !is_attacking && is_on_floor()) {
 		is_blocking = true;
-		animated_sprite->play(is_crouching ? "p2_block_crouch_idle" : "p2_block_standing_idle");
+		play_anim(is_crouching ? "p2_block_crouch_idle" : "p2_block_standing_idle");
 	} else {
 		is_blocking = false;
 	}
@@ -265,7 +300,7 @@ void Player2::check_for_combos() {
 		if (input_buffer.size() >= seq.size()) {
 			Array slice = input_buffer.slice(input_buffer.size() - seq.size(), input_buffer.size());
 			if (slice == seq) {
-				animated_sprite->play("p2_combo_" + key);
+				play_anim("p2_combo_" + key, true);
 				is_attacking = true;
 				input_buffer.clear();
 				return;
@@ -277,10 +312,110 @@ void Player2::check_for_combos() {
 
 void Player2::reset_counter() {
 	is_counter_window_active = false;
+
+	if (GameplayTimers* timers = GameplayTimers::get_singleton()) {
+		timers->cancel(counter_timer);
+	}
 }
 
-void Player2::_on_animation_finished() {
+void Player2::_end_attack() {
 	is_attacking = false;
 	hitbox_punch->disable();
 	hitbox_kick->disable();
 }
+
+int Player2::get_health() const {
+	return health;
+}
+
+int Player2::get_fighter_state() const {
+	return resolve_fighter_state(health <= 0, is_knocked_down, is_stunned, is_attacking, is_blocking, is_crouching);
+}
+
+void Player2::reset_stats() {
+	int previous_health = health;
+	health = max_health;
+	push_event(EVENT_HEALTH_CHANGED, health, health - previous_health);
+
+	is_attacking = false;
+	is_stunned = false;
+	is_knocked_down = false;
+	is_crouching = false;
+	is_blocking = false;
+	is_counter_window_active = false;
+
+	if (GameplayTimers* timers = GameplayTimers::get_singleton()) {
+		timers->cancel(stun_timer);
+		timers->cancel(knockdown_timer);
+		timers->cancel(counter_timer);
+	}
+	buffer_timer = 0;
+
+	crouch_state = "none";
+	current_attack = "";
+	input_buffer.clear();
+	velocity = Vector2(0, 0);
+
+	hitbox_punch->disable();
+	hitbox_kick->disable();
+	hurtbox_standing->set_disabled(false);
+	hurtbox_crouching->set_disabled(true);
+
+	play_anim("p2_idle", true);
+}
+
+
+// ------------------ ANIMATION --------------------
+// The sprite never runs its own clock: the frame on screen is sampled
+// from `anim` every render frame, and attacks end when the sim has
+// counted their length, so resimulating never touches the sprite.
+void Player2::build_anim_timeline() {
+	Ref<SpriteFrames> frames = animated_sprite->get_sprite_frames();
+	ERR_FAIL_COND(frames.is_null());
+
+	anim_timeline.clear();
+	anim_names = frames->get_animation_names();
+	anim_ids.clear();
+
+	std::vector<float> durations;
+	for (int a = 0; a < anim_names.size(); a++) {
+		StringName name = anim_names[a];
+		int count = frames->get_frame_count(name);
+
+		durations.resize(count);
+		for (int f = 0; f < count; f++)
+			durations[f] = frames->get_frame_duration(name, f);
+
+		anim_ids[anim_names[a]] = anim_timeline.add_animation(
+			frames->get_animation_speed(name), frames->get_animation_loop(name), durations.data(), count);
+	}
+
+	animated_sprite->pause();
+}
+
+void Player2::play_anim(const String& name, bool restart) {
+	if (!anim_ids.has(name)) {
+		// Reads as finished, so an attack on a missing animation still ends
+		anim.restart(-1);
+		ERR_FAIL_MSG("Player2: no animation " + name);
+	}
+	int id = anim_ids[name];
+
+	if (restart)
+		anim.restart(id);
+	else
+		anim.enter(id);
+}
+
+void Player2::_process(float) {
+	sync_sprite();
+}
+
+void Player2::sync_sprite() {
+	if (anim.animation < 0) return;
+
+	StringName name = anim_names[anim.animation];
+	if (animated_sprite->get_animation() != name)
+		animated_sprite->set_animation(name);
+	animated_sprite->set_frame_and_progress(anim_timeline.sample(anim), 0.0);
+}
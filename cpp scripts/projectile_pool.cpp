@@ -0,0 +1,223 @@
+#include "projectile_pool.h"
+
+#include <cstring>
+#include <limits>
+#include <new>
+
+using namespace godot;
+
+static const size_t ALIGNMENT = 32;
+static const int WIDE_FIELDS = 10;      // 4-byte fields, x .. owners
+static const int BYTE_FIELDS = 2;       // kinds, spent
+
+static const float THROWN_GRAVITY = 2200.0f;    // FighterCharacter::apply_gravity
+
+ProjectilePool::ProjectilePool(int capacity) :
+		count(0),
+		frame(0),
+		dropped(0),
+		boxes(capacity) {
+	this->capacity = (capacity + LANES - 1) / LANES * LANES;
+
+	const float inf = std::numeric_limits<float>::infinity();
+	bounds_min_x = bounds_min_y = -inf;
+	bounds_max_x = bounds_max_y = inf;
+
+	size_t wide_bytes = (size_t)this->capacity * 4;
+	size_t total = wide_bytes * WIDE_FIELDS + (size_t)this->capacity * BYTE_FIELDS;
+	block = ::operator new(total, std::align_val_t(ALIGNMENT));
+	memset(block, 0, total);
+
+	unsigned char* base = static_cast<unsigned char*>(block);
+	x = reinterpret_cast<float*>(base + wide_bytes * 0);
+	y = reinterpret_cast<float*>(base + wide_bytes * 1);
+	velocity_x = reinterpret_cast<float*>(base + wide_bytes * 2);
+	velocity_y = reinterpret_cast<float*>(base + wide_bytes * 3);
+	gravity = reinterpret_cast<float*>(base + wide_bytes * 4);
+	half_width = reinterpret_cast<float*>(base + wide_bytes * 5);
+	half_height = reinterpret_cast<float*>(base + wide_bytes * 6);
+	life = reinterpret_cast<int32_t*>(base + wide_bytes * 7);
+	damage = reinterpret_cast<int32_t*>(base + wide_bytes * 8);
+	owners = reinterpret_cast<int32_t*>(base + wide_bytes * 9);
+	kinds = base + wide_bytes * WIDE_FIELDS;
+	spent = kinds + this->capacity;
+
+	// A hurtbox can touch every projectile at most once per query
+	pairs.reserve(this->capacity);
+}
+
+ProjectilePool::~ProjectilePool() {
+	::operator delete(block, std::align_val_t(ALIGNMENT));
+}
+
+// ------------------ FIRE --------------------
+int ProjectilePool::fire(ProjectileKind kind, int owner, float px, float py, float vx, float vy,
+		float hw, float hh, int amount, int lifetime_frames) {
+	if (count >= capacity) {
+		dropped++;
+		return -1;
+	}
+
+	int i = count++;
+	x[i] = px;
+	y[i] = py;
+	velocity_x[i] = vx;
+	velocity_y[i] = vy;
+	gravity[i] = kind == PROJECTILE_THROWN ? THROWN_GRAVITY : 0.0f;
+	half_width[i] = hw;
+	half_height[i] = hh;
+	life[i] = lifetime_frames;
+	damage[i] = amount;
+	owners[i] = owner;
+	kinds[i] = kind;
+	spent[i] = 0;
+	return i;
+}
+
+void ProjectilePool::clear() {
+	count = 0;
+}
+
+void ProjectilePool::set_bounds(float min_x, float min_y, float max_x, float max_y) {
+	bounds_min_x = min_x;
+	bounds_min_y = min_y;
+	bounds_max_x = max_x;
+	bounds_max_y = max_y;
+}
+
+// ------------------ STEP --------------------
+void ProjectilePool::step(const RectBuffer& hurtboxes, const int32_t* hurtbox_owners, std::vector<ProjectileHit>& hits) {
+	frame++;
+	if (count == 0) return;
+
+	integrate();
+	resolve(hurtboxes, hurtbox_owners, hits);
+	compact();
+}
+
+void ProjectilePool::integrate() {
+	// Whole blocks: the padding past count is never read back
+	const int blocks = (count + LANES - 1) / LANES * LANES;
+	const float min_x = bounds_min_x;
+	const float min_y = bounds_min_y;
+	const float max_x = bounds_max_x;
+	const float max_y = bounds_max_y;
+
+	float* __restrict px = x;
+	float* __restrict py = y;
+	float* __restrict pvy = velocity_y;
+	const float* __restrict pvx = velocity_x;
+	const float* __restrict pg = gravity;
+	int32_t* __restrict plife = life;
+	uint8_t* __restrict pspent = spent;
+
+	for (int i = 0; i < blocks; i++) {
+		float vy = pvy[i] + pg[i] * TICK;
+		float nx = px[i] + pvx[i] * TICK;
+		float ny = py[i] + vy * TICK;
+		pvy[i] = vy;
+		px[i] = nx;
+		py[i] = ny;
+
+		int left = plife[i] - 1;
+		plife[i] = left;
+		pspent[i] = (left <= 0) | (nx < min_x) | (nx > max_x) | (ny < min_y) | (ny > max_y);
+	}
+}
+
+void ProjectilePool::resolve(const RectBuffer& hurtboxes, const int32_t* hurtbox_owners, std::vector<ProjectileHit>& hits) {
+	if (hurtboxes.get_count() == 0) return;
+
+	boxes.clear();
+	for (int i = 0; i < count; i++) {
+		boxes.add(x[i] - half_width[i], y[i] - half_height[i], x[i] + half_width[i], y[i] + half_height[i]);
+	}
+
+	// Few hurtboxes, many projectiles: run the kernel across the projectiles
+	const float* min_x = hurtboxes.get_min_x();
+	const float* min_y = hurtboxes.get_min_y();
+	const float* max_x = hurtboxes.get_max_x();
+	const float* max_y = hurtboxes.get_max_y();
+
+	for (int h = 0; h < hurtboxes.get_count(); h++) {
+		pairs.clear();
+		AabbKernel::overlap(h, min_x[h], min_y[h], max_x[h], max_y[h], boxes, pairs);
+
+		for (const HitPair& pair : pairs) {
+			int p = pair.target;
+			if (spent[p] || owners[p] == hurtbox_owners[h]) continue;
+
+			spent[p] = 1;
+			hits.push_back(ProjectileHit{ owners[p], h, damage[p], x[p], y[p] });
+		}
+	}
+}
+
+void ProjectilePool::compact() {
+	// Backwards so every swap pulls in an entry that was already checked
+	for (int i = count - 1; i >= 0; i--) {
+		if (!spent[i]) continue;
+
+		int last = --count;
+		if (i == last) continue;
+
+		x[i] = x[last];
+		y[i] = y[last];
+		velocity_x[i] = velocity_x[last];
+		velocity_y[i] = velocity_y[last];
+		gravity[i] = gravity[last];
+		half_width[i] = half_width[last];
+		half_height[i] = half_height[last];
+		life[i] = life[last];
+		damage[i] = damage[last];
+		owners[i] = owners[last];
+		kinds[i] = kinds[last];
+		spent[i] = 0;
+	}
+}
+
+// ------------------ SNAPSHOT --------------------
+void ProjectilePool::save(ProjectileSnapshot& snapshot) const {
+	size_t full = (size_t)capacity * (WIDE_FIELDS * 4 + 1);
+	if (snapshot.data.size() < full) snapshot.data.resize(full);
+
+	snapshot.frame = frame;
+	snapshot.count = count;
+
+	const void* wide[WIDE_FIELDS] = { x, y, velocity_x, velocity_y, gravity, half_width, half_height, life, damage, owners };
+	unsigned char* out = snapshot.data.data();
+	for (const void* field : wide) {
+		memcpy(out, field, (size_t)count * 4);
+		out += (size_t)count * 4;
+	}
+	memcpy(out, kinds, count);
+}
+
+void ProjectilePool::restore(const ProjectileSnapshot& snapshot) {
+	frame = snapshot.frame;
+	count = snapshot.count;
+
+	void* wide[WIDE_FIELDS] = { x, y, velocity_x, velocity_y, gravity, half_width, half_height, life, damage, owners };
+	const unsigned char* in = snapshot.data.data();
+	for (void* field : wide) {
+		memcpy(field, in, (size_t)count * 4);
+		in += (size_t)count * 4;
+	}
+	memcpy(kinds, in, count);
+	memset(spent, 0, count);
+}
+
+uint64_t ProjectilePool::hash(uint64_t h) const {
+	const void* wide[WIDE_FIELDS] = { x, y, velocity_x, velocity_y, gravity, half_width, half_height, life, damage, owners };
+	h ^= (uint64_t)count;
+	h *= 1099511628211ull;
+
+	for (const void* field : wide) {
+		const uint32_t* words = static_cast<const uint32_t*>(field);
+		for (int i = 0; i < count; i++) {
+			h ^= words[i];
+			h *= 1099511628211ull;
+		}
+	}
+	return h;
+}
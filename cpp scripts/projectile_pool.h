@@ -0,0 +1,120 @@
+#pragma once
+
+#ifndef PROJECTILE_POOL_H
+#define PROJECTILE_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "aabb_kernel.h"
+
+namespace godot {
+
+    enum ProjectileKind : uint8_t {
+        PROJECTILE_FIREBALL,        // straight line
+        PROJECTILE_THROWN,          // arcs under gravity
+    };
+
+    struct ProjectileHit {
+        int32_t owner;              // fighter slot that fired it
+        int32_t target;             // hurtbox index passed to step()
+        int32_t damage;
+        float x;
+        float y;
+    };
+
+    // Live projectiles only; sized once, reused every frame
+    struct ProjectileSnapshot {
+        uint32_t frame = 0;
+        int count = 0;
+        std::vector<unsigned char> data;
+    };
+
+    // ============================================================
+    // PROJECTILE POOL
+    // Fireballs and thrown items as plain data: a fixed-capacity pool in
+    // structure-of-arrays layout, allocated once, dense (swap-remove),
+    // stepped on fixed sim frames. No node per shot - whatever draws
+    // them reads the packed arrays.
+    // step() integrates, ages, resolves hits against the frame's
+    // hurtboxes with AabbKernel (SIMD over the projectiles) and drops
+    // spent ones, all in batch. Every projectile hits at most one
+    // hurtbox and never its owner's.
+    // save()/restore() copy the live range only, so rollback cost
+    // follows the projectile count, not the capacity.
+    // ============================================================
+    class ProjectilePool {
+    public:
+        static const int LANES = RectBuffer::LANES;
+        static constexpr float TICK = 1.0f / 60.0f;
+
+        explicit ProjectilePool(int capacity);
+        ~ProjectilePool();
+
+        ProjectilePool(const ProjectilePool&) = delete;
+        ProjectilePool& operator=(const ProjectilePool&) = delete;
+
+        // Returns the index, or -1 when the pool is full (the shot is dropped)
+        int fire(ProjectileKind kind, int owner, float x, float y, float velocity_x, float velocity_y,
+                float half_width, float half_height, int damage, int lifetime_frames);
+        void clear();
+
+        // Anything leaving these bounds is dropped
+        void set_bounds(float min_x, float min_y, float max_x, float max_y);
+
+        // One sim frame. hurtbox_owners[i] is the fighter slot of hurtboxes[i];
+        // hits are appended to `hits` in (hurtbox, projectile) order
+        void step(const RectBuffer& hurtboxes, const int32_t* hurtbox_owners, std::vector<ProjectileHit>& hits);
+
+        int get_count() const { return count; }
+        int get_capacity() const { return capacity; }
+        uint32_t get_frame() const { return frame; }
+        int get_dropped_count() const { return dropped; }
+
+        const float* get_x() const { return x; }
+        const float* get_y() const { return y; }
+        const float* get_velocity_x() const { return velocity_x; }
+        const int32_t* get_life() const { return life; }
+        const uint8_t* get_kinds() const { return kinds; }
+
+        void save(ProjectileSnapshot& snapshot) const;
+        void restore(const ProjectileSnapshot& snapshot);
+        uint64_t hash(uint64_t h) const;
+
+    private:
+        int capacity;
+        int count;
+        uint32_t frame;
+        int dropped;
+
+        float bounds_min_x;
+        float bounds_min_y;
+        float bounds_max_x;
+        float bounds_max_y;
+
+        void* block;
+        float* x;
+        float* y;
+        float* velocity_x;
+        float* velocity_y;
+        float* gravity;
+        float* half_width;
+        float* half_height;
+        int32_t* life;
+        int32_t* damage;
+        int32_t* owners;
+        uint8_t* kinds;
+        uint8_t* spent;
+
+        RectBuffer boxes;
+        std::vector<HitPair> pairs;
+
+        void integrate();
+        void resolve(const RectBuffer& hurtboxes, const int32_t* hurtbox_owners, std::vector<ProjectileHit>& hits);
+        void compact();
+    };
+
+} // namespace godot
+
+#endif
@@ -0,0 +1,170 @@
+// Per-query cost of RayCast2D polling vs one RaycastService pass.
+// Add a RaycastBench node as a child of a stage scene (the root of
+// whatever holds the TileMapLayers / killzone) and run it. It scatters
+// patrol-style rays over the stage, then for 1k and 10k queries times
+// force_raycast_update() + is_colliding() on RayCast2D nodes against the
+// batched service and prints ns/query and how many answers agree.
+
+#include <Godot.hpp>
+#include <Node2D.hpp>
+#include <RayCast2D.hpp>
+#include <Time.hpp>
+
+#include "raycast_service.h"
+#include "stage_collision.h"
+
+#include <vector>
+
+namespace godot {
+
+    class RaycastBench : public Node2D {
+        GODOT_CLASS(RaycastBench, Node2D)
+
+    public:
+        static void _register_methods();
+
+        void _init() override;
+        void _physics_process(double delta) override;
+
+        int collision_mask;
+        float cell_size;
+        int repeats;
+
+    private:
+        int physics_frames;
+        bool done;
+        uint32_t rng;
+
+        RaycastService service;
+        std::vector<RayCast2D*> nodes;
+        std::vector<Vector2> origins;
+        std::vector<float> reach;
+
+        float random_unit();
+        void scatter(int count);
+        void run(int count);
+    };
+
+} // namespace godot
+
+using namespace godot;
+
+static const int QUERY_COUNTS[] = { 1000, 10000 };
+
+void RaycastBench::_register_methods() {
+	register_method("_physics_process", &RaycastBench::_physics_process);
+
+	register_property<RaycastBench, int>("collision_mask", &RaycastBench::collision_mask, 4);
+	register_property<RaycastBench, float>("cell_size", &RaycastBench::cell_size, 4.0f);
+	register_property<RaycastBench, int>("repeats", &RaycastBench::repeats, 30);
+}
+
+void RaycastBench::_init() {
+	collision_mask = 4;
+	cell_size = 4.0f;
+	repeats = 30;
+
+	physics_frames = 0;
+	done = false;
+	rng = 0x9E3779B9u;
+}
+
+float RaycastBench::random_unit() {
+	rng ^= rng << 13;
+	rng ^= rng >> 17;
+	rng ^= rng << 5;
+	return (float)(rng & 0xFFFFFF) / (float)0x1000000;
+}
+
+// ------------------ SETUP --------------------
+void RaycastBench::scatter(int count) {
+	const OccupancyGrid& grid = service.get_grid();
+	float span_x = grid.get_width() * grid.get_cell_size();
+	float span_y = grid.get_height() * grid.get_cell_size();
+
+	for (int i = 0; i < count; i++) {
+		Vector2 origin(grid.get_origin_x() + random_unit() * span_x, grid.get_origin_y() + random_unit() * span_y);
+		// Same probes enemy.tscn uses, half facing each way
+		float target = (i & 1) ? 26.0f : -10.0f;
+
+		RayCast2D* ray = RayCast2D::_new();
+		ray->set_enabled(false);
+		ray->set_collision_mask(collision_mask);
+		ray->set_target_position(Vector2(target, 0.0f));
+		add_child(ray);
+		ray->set_global_position(origin);
+
+		nodes.push_back(ray);
+		origins.push_back(origin);
+		reach.push_back(target);
+	}
+}
+
+// ------------------ RUN --------------------
+void RaycastBench::run(int count) {
+	Time* time = Time::get_singleton();
+	std::vector<uint8_t> node_hits(count);
+
+	uint64_t node_usec = 0;
+	for (int r = 0; r < repeats; r++) {
+		uint64_t start = time->get_ticks_usec();
+		for (int i = 0; i < count; i++) {
+			nodes[i]->force_raycast_update();
+			node_hits[i] = nodes[i]->is_colliding();
+		}
+		node_usec += time->get_ticks_usec() - start;
+	}
+
+	uint64_t service_usec = 0;
+	for (int r = 0; r < repeats; r++) {
+		uint64_t start = time->get_ticks_usec();
+		service.begin(count);
+		for (int i = 0; i < count; i++) {
+			service.add_ray(origins[i].x, origins[i].y, reach[i], 0.0f);
+		}
+		service.resolve();
+		service_usec += time->get_ticks_usec() - start;
+	}
+
+	const uint8_t* hits = service.get_hits();
+	int agree = 0;
+	int node_hit_count = 0;
+	for (int i = 0; i < count; i++) {
+		agree += (hits[i] != 0) == (node_hits[i] != 0);
+		node_hit_count += node_hits[i];
+	}
+
+	double queries = (double)count * repeats;
+	Godot::print("RaycastBench " + String::num_int64(count) + " queries: RayCast2D "
+			+ String::num(node_usec * 1000.0 / queries, 1) + " ns/query, service "
+			+ String::num(service_usec * 1000.0 / queries, 1) + " ns/query, "
+			+ String::num_int64(agree) + "/" + String::num_int64(count) + " agree ("
+			+ String::num_int64(node_hit_count) + " hits)");
+}
+
+void RaycastBench::_physics_process(double delta) {
+	if (done) return;
+
+	// Let the stage's bodies reach the physics server before querying
+	if (++physics_frames < 3) return;
+	done = true;
+
+	Node* stage = get_parent();
+	ERR_FAIL_COND(!stage);
+	if (!bake_stage_collision(stage, collision_mask, cell_size, service)) return;
+
+	const OccupancyGrid& grid = service.get_grid();
+	ERR_FAIL_COND_MSG(grid.get_width() == 0, "RaycastBench: no tile collision under the parent node");
+	Godot::print("RaycastBench: baked " + String::num_int64(grid.get_width()) + "x"
+			+ String::num_int64(grid.get_height()) + " cells");
+
+	scatter(QUERY_COUNTS[1]);
+	for (int count : QUERY_COUNTS) {
+		run(count);
+	}
+
+	for (RayCast2D* ray : nodes) {
+		ray->queue_free();
+	}
+	nodes.clear();
+}
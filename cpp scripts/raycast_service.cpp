@@ -0,0 +1,231 @@
+#include "raycast_service.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace godot;
+
+// ------------------ GRID --------------------
+OccupancyGrid::OccupancyGrid() :
+		origin_x(0.0f),
+		origin_y(0.0f),
+		cell_size(1.0f),
+		inv_cell_size(1.0f),
+		width(0),
+		height(0),
+		words_per_row(0) {}
+
+void OccupancyGrid::reset(float origin_x, float origin_y, float cell_size, int width, int height) {
+	this->origin_x = origin_x;
+	this->origin_y = origin_y;
+	this->cell_size = cell_size;
+	this->inv_cell_size = 1.0f / cell_size;
+	this->width = width;
+	this->height = height;
+
+	words_per_row = (width + 63) / 64;
+	bits.assign((size_t)words_per_row * height, 0);
+}
+
+int OccupancyGrid::cell_x(float x) const {
+	return (int)std::floor((x - origin_x) * inv_cell_size);
+}
+
+int OccupancyGrid::cell_y(float y) const {
+	return (int)std::floor((y - origin_y) * inv_cell_size);
+}
+
+void OccupancyGrid::fill_rect(float min_x, float min_y, float max_x, float max_y) {
+	// Any cell the rect touches counts as solid
+	int x0 = std::max(cell_x(min_x), 0);
+	int y0 = std::max(cell_y(min_y), 0);
+	int x1 = std::min(cell_x(max_x), width - 1);
+	int y1 = std::min(cell_y(max_y), height - 1);
+
+	for (int y = y0; y <= y1; y++) {
+		uint64_t* row = &bits[(size_t)y * words_per_row];
+		for (int x = x0; x <= x1; x++) {
+			row[x >> 6] |= 1ull << (x & 63);
+		}
+	}
+}
+
+bool OccupancyGrid::is_solid(int x, int y) const {
+	if (x < 0 || y < 0 || x >= width || y >= height) return false;
+	return (bits[(size_t)y * words_per_row + (x >> 6)] >> (x & 63)) & 1;
+}
+
+bool OccupancyGrid::is_solid_at(float x, float y) const {
+	return is_solid(cell_x(x), cell_y(y));
+}
+
+int OccupancyGrid::first_solid_in_row(int row, int from, int to) const {
+	if (row < 0 || row >= height) return -1;
+
+	const uint64_t* words = &bits[(size_t)row * words_per_row];
+
+	if (from <= to) {
+		from = std::max(from, 0);
+		to = std::min(to, width - 1);
+
+		for (int x = from; x <= to;) {
+			int word = x >> 6;
+			uint64_t bitset = words[word] & (~0ull << (x & 63));
+			if (bitset) {
+				int hit = (word << 6) + __builtin_ctzll(bitset);
+				return hit <= to ? hit : -1;
+			}
+			x = (word + 1) << 6;
+		}
+	} else {
+		from = std::min(from, width - 1);
+		to = std::max(to, 0);
+
+		for (int x = from; x >= to;) {
+			int word = x >> 6;
+			int shift = 63 - (x & 63);
+			uint64_t bitset = words[word] & (~0ull >> shift);
+			if (bitset) {
+				int hit = (word << 6) + 63 - __builtin_clzll(bitset);
+				return hit >= to ? hit : -1;
+			}
+			x = (word << 6) - 1;
+		}
+	}
+
+	return -1;
+}
+
+int OccupancyGrid::first_solid_in_column(int column, int from, int to) const {
+	if (column < 0 || column >= width) return -1;
+
+	int step = from <= to ? 1 : -1;
+	for (int y = from; y != to + step; y += step) {
+		if (is_solid(column, y)) return y;
+	}
+	return -1;
+}
+
+// ------------------ SERVICE --------------------
+RaycastService::RaycastService() {}
+
+void RaycastService::add_boundary(float normal_x, float normal_y, float distance) {
+	boundaries.push_back(Boundary{ normal_x, normal_y, distance });
+}
+
+void RaycastService::clear_boundaries() {
+	boundaries.clear();
+}
+
+void RaycastService::begin(int expected) {
+	from_x.clear();
+	from_y.clear();
+	ray_x.clear();
+	ray_y.clear();
+
+	if (expected > 0) {
+		from_x.reserve(expected);
+		from_y.reserve(expected);
+		ray_x.reserve(expected);
+		ray_y.reserve(expected);
+	}
+}
+
+int RaycastService::add_ray(float x, float y, float dx, float dy) {
+	from_x.push_back(x);
+	from_y.push_back(y);
+	ray_x.push_back(dx);
+	ray_y.push_back(dy);
+	return (int)from_x.size() - 1;
+}
+
+void RaycastService::resolve() {
+	const int count = (int)from_x.size();
+	hits.resize(count);
+	fractions.resize(count);
+
+	for (int i = 0; i < count; i++) {
+		float fraction = cast_grid(from_x[i], from_y[i], ray_x[i], ray_y[i]);
+		if (!boundaries.empty()) {
+			fraction = std::min(fraction, cast_boundaries(from_x[i], from_y[i], ray_x[i], ray_y[i]));
+		}
+		fractions[i] = fraction;
+		hits[i] = fraction < 1.0f;
+	}
+}
+
+float RaycastService::cast_grid(float x, float y, float dx, float dy) const {
+	const float cell = grid.get_cell_size();
+
+	// Horizontal: one bitset row
+	if (dy == 0.0f) {
+		if (dx == 0.0f) return grid.is_solid_at(x, y) ? 0.0f : 1.0f;
+
+		int start = grid.cell_x(x);
+		int hit = grid.first_solid_in_row(grid.cell_y(y), start, grid.cell_x(x + dx));
+		if (hit < 0) return 1.0f;
+		if (hit == start) return 0.0f;
+
+		float edge = grid.get_origin_x() + (dx > 0.0f ? hit : hit + 1) * cell;
+		return std::min(std::max((edge - x) / dx, 0.0f), 1.0f);
+	}
+
+	// Vertical: one column
+	if (dx == 0.0f) {
+		int start = grid.cell_y(y);
+		int hit = grid.first_solid_in_column(grid.cell_x(x), start, grid.cell_y(y + dy));
+		if (hit < 0) return 1.0f;
+		if (hit == start) return 0.0f;
+
+		float edge = grid.get_origin_y() + (dy > 0.0f ? hit : hit + 1) * cell;
+		return std::min(std::max((edge - y) / dy, 0.0f), 1.0f);
+	}
+
+	// Anything else: DDA through the cells the segment crosses
+	int cx = grid.cell_x(x);
+	int cy = grid.cell_y(y);
+	const int end_x = grid.cell_x(x + dx);
+	const int end_y = grid.cell_y(y + dy);
+	const int step_x = dx > 0.0f ? 1 : -1;
+	const int step_y = dy > 0.0f ? 1 : -1;
+
+	float next_x = grid.get_origin_x() + (dx > 0.0f ? cx + 1 : cx) * cell;
+	float next_y = grid.get_origin_y() + (dy > 0.0f ? cy + 1 : cy) * cell;
+	float t_max_x = (next_x - x) / dx;
+	float t_max_y = (next_y - y) / dy;
+	const float t_delta_x = cell / std::fabs(dx);
+	const float t_delta_y = cell / std::fabs(dy);
+
+	float t = 0.0f;
+	for (;;) {
+		if (grid.is_solid(cx, cy)) return std::min(t, 1.0f);
+		if (cx == end_x && cy == end_y) return 1.0f;
+
+		if (t_max_x < t_max_y) {
+			t = t_max_x;
+			t_max_x += t_delta_x;
+			cx += step_x;
+		} else {
+			t = t_max_y;
+			t_max_y += t_delta_y;
+			cy += step_y;
+		}
+		if (t > 1.0f) return 1.0f;
+	}
+}
+
+float RaycastService::cast_boundaries(float x, float y, float dx, float dy) const {
+	float best = 1.0f;
+
+	for (const Boundary& b : boundaries) {
+		float start = b.normal_x * x + b.normal_y * y - b.distance;
+		if (start < 0.0f) return 0.0f;
+
+		float along = b.normal_x * dx + b.normal_y * dy;
+		if (along >= 0.0f) continue;
+
+		best = std::min(best, start / -along);
+	}
+
+	return best;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#ifndef RAYCAST_SERVICE_H
+#define RAYCAST_SERVICE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace godot {
+
+    // ============================================================
+    // OCCUPANCY GRID
+    // The stage's static collision baked once into solid/empty cells.
+    // Each row is a bitset so a horizontal ray is a few word scans.
+    // ============================================================
+    class OccupancyGrid {
+    public:
+        OccupancyGrid();
+
+        void reset(float origin_x, float origin_y, float cell_size, int width, int height);
+        void fill_rect(float min_x, float min_y, float max_x, float max_y);
+
+        bool is_solid(int cell_x, int cell_y) const;
+        bool is_solid_at(float x, float y) const;
+
+        int cell_x(float x) const;
+        int cell_y(float y) const;
+
+        float get_origin_x() const { return origin_x; }
+        float get_origin_y() const { return origin_y; }
+        float get_cell_size() const { return cell_size; }
+        int get_width() const { return width; }
+        int get_height() const { return height; }
+
+        // First solid cell in [from, to] on a row/column, or -1
+        int first_solid_in_row(int row, int from, int to) const;
+        int first_solid_in_column(int column, int from, int to) const;
+
+    private:
+        float origin_x;
+        float origin_y;
+        float cell_size;
+        float inv_cell_size;
+        int width;
+        int height;
+        int words_per_row;
+
+        std::vector<uint64_t> bits;
+    };
+
+    // ============================================================
+    // RAYCAST SERVICE
+    // Patrol rays are queued during the tick and answered in one pass
+    // with resolve(). Axis-aligned rays (all enemy probes) scan a single
+    // grid row or column; anything else walks the grid with a DDA.
+    // World boundaries are half-planes checked analytically.
+    // Results are packed arrays indexed by query order.
+    // ============================================================
+    class RaycastService {
+    public:
+        RaycastService();
+
+        OccupancyGrid& get_grid() { return grid; }
+        const OccupancyGrid& get_grid() const { return grid; }
+
+        // Solid where normal . p < distance (WorldBoundaryShape2D convention)
+        void add_boundary(float normal_x, float normal_y, float distance);
+        void clear_boundaries();
+
+        void begin(int expected = 0);
+        int add_ray(float x, float y, float dx, float dy);
+        void resolve();
+
+        int get_query_count() const { return (int)from_x.size(); }
+        const uint8_t* get_hits() const { return hits.data(); }
+        const float* get_fractions() const { return fractions.data(); }     // 0..1 along the ray, 1 = no hit
+
+    private:
+        struct Boundary {
+            float normal_x;
+            float normal_y;
+            float distance;
+        };
+
+        OccupancyGrid grid;
+        std::vector<Boundary> boundaries;
+
+        std::vector<float> from_x;
+        std::vector<float> from_y;
+        std::vector<float> ray_x;
+        std::vector<float> ray_y;
+
+        std::vector<uint8_t> hits;
+        std::vector<float> fractions;
+
+        float cast_grid(float x, float y, float dx, float dy) const;
+        float cast_boundaries(float x, float y, float dx, float dy) const;
+    };
+
+} // namespace godot
+
+#endif
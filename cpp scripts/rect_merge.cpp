@@ -0,0 +1,75 @@
+#include "rect_merge.h"
+
+#include <algorithm>
+#include <cstdint>
+
+using namespace godot;
+
+static void unique_edges(std::vector<float>& edges) {
+	std::sort(edges.begin(), edges.end());
+	edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+}
+
+static int edge_index(const std::vector<float>& edges, float value) {
+	return (int)(std::lower_bound(edges.begin(), edges.end(), value) - edges.begin());
+}
+
+bool godot::merge_rects(const std::vector<MergeRect>& in, std::vector<MergeRect>& out, size_t max_cells) {
+	out.clear();
+	if (in.empty()) return true;
+
+	std::vector<float> xs;
+	std::vector<float> ys;
+	xs.reserve(in.size() * 2);
+	ys.reserve(in.size() * 2);
+	for (const MergeRect& r : in) {
+		if (r.max_x <= r.min_x || r.max_y <= r.min_y) continue;
+		xs.push_back(r.min_x);
+		xs.push_back(r.max_x);
+		ys.push_back(r.min_y);
+		ys.push_back(r.max_y);
+	}
+	unique_edges(xs);
+	unique_edges(ys);
+	if (xs.size() < 2 || ys.size() < 2) return true;
+
+	size_t width = xs.size() - 1;
+	size_t height = ys.size() - 1;
+	if (width * height > max_cells) {
+		out = in;
+		return false;
+	}
+
+	// 1 = solid, 2 = already covered by an emitted rect
+	std::vector<uint8_t> cells(width * height, 0);
+	for (const MergeRect& r : in) {
+		if (r.max_x <= r.min_x || r.max_y <= r.min_y) continue;
+		int x0 = edge_index(xs, r.min_x), x1 = edge_index(xs, r.max_x);
+		int y0 = edge_index(ys, r.min_y), y1 = edge_index(ys, r.max_y);
+		for (int y = y0; y < y1; y++) {
+			std::fill(cells.begin() + y * width + x0, cells.begin() + y * width + x1, (uint8_t)1);
+		}
+	}
+
+	for (size_t y = 0; y < height; y++) {
+		for (size_t x = 0; x < width; x++) {
+			if (cells[y * width + x] != 1) continue;
+
+			size_t x1 = x + 1;
+			while (x1 < width && cells[y * width + x1] == 1) x1++;
+
+			size_t y1 = y + 1;
+			while (y1 < height) {
+				const uint8_t* row = cells.data() + y1 * width;
+				if (std::any_of(row + x, row + x1, [](uint8_t c) { return c != 1; })) break;
+				y1++;
+			}
+
+			for (size_t yy = y; yy < y1; yy++) {
+				std::fill(cells.begin() + yy * width + x, cells.begin() + yy * width + x1, (uint8_t)2);
+			}
+			out.push_back(MergeRect{ xs[x], ys[y], xs[x1], ys[y1] });
+		}
+	}
+	return true;
+}
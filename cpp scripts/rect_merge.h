@@ -0,0 +1,28 @@
+#pragma once
+
+#ifndef RECT_MERGE_H
+#define RECT_MERGE_H
+
+#include <cstddef>
+#include <vector>
+
+namespace godot {
+
+    struct MergeRect {
+        float min_x, min_y, max_x, max_y;
+    };
+
+    // ============================================================
+    // RECT MERGE
+    // Union of axis-aligned rects as few non-overlapping maximal rects:
+    // edges are coordinate-compressed into a grid, then covered greedily
+    // (longest run along a row first, grown downwards while the whole run
+    // stays solid). Tiles sit on a grid already, so the compressed grid is
+    // about the size of the tile map. Returns false, and copies `in`
+    // through, if it would exceed max_cells.
+    // ============================================================
+    bool merge_rects(const std::vector<MergeRect>& in, std::vector<MergeRect>& out, size_t max_cells = 16u << 20);
+
+} // namespace godot
+
+#endif
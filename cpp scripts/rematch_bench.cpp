@@ -0,0 +1,129 @@
+// Rematch against a fresh load of the level.
+// Add a RematchBench node to an empty scene of its own, set match_scene
+// to game_1.tscn and run it. It first loads the match once, hashes it
+// right after _ready and frees it again, so only one match (and one
+// owner of the GameplayTimers / MatchEventBus singletons) is ever alive.
+// Then it loads the match again, lets it play for play_frames physics
+// frames (hitting player_1 at hit_frame so health, bars and fighter
+// state have something to undo) and calls rematch(). Both hashes are
+// taken just after start_match(), so hash_match_state() must agree; it
+// prints them and the rematch's reset time.
+
+#include <Godot.hpp>
+#include <Node.hpp>
+#include <PackedScene.hpp>
+
+namespace godot {
+
+    class RematchBench : public Node {
+        GODOT_CLASS(RematchBench, Node)
+
+    public:
+        static void _register_methods();
+
+        void _init() override;
+        void _ready() override;
+        void _physics_process(double delta) override;
+
+        Ref<PackedScene> match_scene;
+        int play_frames;
+        int hit_frame;
+        int hit_damage;
+
+    private:
+        Node* played;
+        int64_t loaded;
+        int frame;
+        bool done;
+
+        Node* load_match(const String& name);
+        void compare();
+    };
+
+} // namespace godot
+
+using namespace godot;
+
+void RematchBench::_register_methods() {
+	register_method("_ready", &RematchBench::_ready);
+	register_method("_physics_process", &RematchBench::_physics_process);
+
+	register_property<RematchBench, Ref<PackedScene>>("match_scene", &RematchBench::match_scene, Ref<PackedScene>());
+	register_property<RematchBench, int>("play_frames", &RematchBench::play_frames, 600);
+	register_property<RematchBench, int>("hit_frame", &RematchBench::hit_frame, 300);
+	register_property<RematchBench, int>("hit_damage", &RematchBench::hit_damage, 30);
+}
+
+void RematchBench::_init() {
+	play_frames = 600;
+	hit_frame = 300;
+	hit_damage = 30;
+
+	played = nullptr;
+	loaded = 0;
+	frame = 0;
+	done = false;
+}
+
+Node* RematchBench::load_match(const String& name) {
+	Node* match = match_scene->instantiate();
+	ERR_FAIL_COND_V(!match, nullptr);
+	match->set_name(name);
+	add_child(match);
+	return match;
+}
+
+void RematchBench::_ready() {
+	ERR_FAIL_COND_MSG(match_scene.is_null(), "RematchBench: set match_scene");
+	ERR_FAIL_COND_MSG(play_frames <= hit_frame, "RematchBench: play_frames must be past hit_frame");
+
+	// Fresh load first, gone before the played match is constructed
+	Node* fresh = load_match("Fresh");
+	ERR_FAIL_COND(!fresh);
+	ERR_FAIL_COND_MSG(!fresh->has_method("rematch") || !fresh->has_method("hash_match_state"),
+			"RematchBench: match_scene root has no rematch()/hash_match_state()");
+	loaded = fresh->call("hash_match_state");
+	remove_child(fresh);
+	memdelete(fresh);
+
+	played = load_match("Played");
+	ERR_FAIL_COND(!played);
+
+	Godot::print("RematchBench: playing " + String::num_int64(play_frames) + " frames before rematch");
+}
+
+// ------------------ RUN --------------------
+void RematchBench::_physics_process(double) {
+	if (done || !played) return;
+
+	frame++;
+	if (frame == hit_frame) {
+		Node* fighter = played->get_node_or_null("player_1");
+		if (fighter && fighter->has_method("take_damage")) {
+			fighter->call("take_damage", hit_damage, Vector2());
+		}
+	}
+
+	if (frame >= play_frames) {
+		done = true;
+		compare();
+	}
+}
+
+void RematchBench::compare() {
+	played->call("rematch");
+	int64_t rematched = played->call("hash_match_state");
+
+	int64_t reset_usec = played->has_method("get_last_restart_usec") ? (int64_t)played->call("get_last_restart_usec") : -1;
+
+	if (rematched == loaded) {
+		Godot::print("  rematch matches fresh load (" + String::num_int64(rematched) + "), reset in "
+				+ String::num_int64(reset_usec) + " us");
+	} else {
+		ERR_PRINT("RematchBench: rematch state " + String::num_int64(rematched) + " differs from fresh load "
+				+ String::num_int64(loaded));
+	}
+
+	played->queue_free();
+	played = nullptr;
+}
@@ -0,0 +1,190 @@
+#include "scene_pool.h"
+
+#include <algorithm>
+
+using namespace godot;
+
+static const char* KIND_NAMES[POOL_KIND_COUNT] = { "enemy", "coin", "effect" };
+
+ScenePool::ScenePool() {}
+ScenePool::~ScenePool() {}
+
+void ScenePool::_register_methods() {
+	register_method("_ready", &ScenePool::_ready);
+
+	register_method("spawn", &ScenePool::spawn);
+	register_method("release", &ScenePool::release);
+	register_method("release_all", &ScenePool::release_all);
+	register_method("get_free_count", &ScenePool::get_free_count);
+	register_method("get_stats", &ScenePool::get_stats);
+	register_method("finish_park", &ScenePool::finish_park);
+
+	register_property<ScenePool, Ref<PackedScene>>("enemy_scene", &ScenePool::enemy_scene, Ref<PackedScene>());
+	register_property<ScenePool, Ref<PackedScene>>("coin_scene", &ScenePool::coin_scene, Ref<PackedScene>());
+	register_property<ScenePool, Ref<PackedScene>>("effect_scene", &ScenePool::effect_scene, Ref<PackedScene>());
+	register_property<ScenePool, int>("enemy_count", &ScenePool::enemy_count, 64);
+	register_property<ScenePool, int>("coin_count", &ScenePool::coin_count, 64);
+	register_property<ScenePool, int>("effect_count", &ScenePool::effect_count, 32);
+}
+
+void ScenePool::_init() {
+	enemy_count = 64;
+	coin_count = 64;
+	effect_count = 32;
+}
+
+void ScenePool::_ready() {
+	add_to_group("scene_pool");
+
+	prewarm(POOL_ENEMY, enemy_scene, enemy_count);
+	prewarm(POOL_COIN, coin_scene, coin_count);
+	prewarm(POOL_EFFECT, effect_scene, effect_count);
+}
+
+// ------------------ LOAD --------------------
+void ScenePool::prewarm(PoolKind kind, const Ref<PackedScene>& scene, int count) {
+	if (scene.is_null() || count <= 0) return;
+
+	Pool& pool = pools[kind];
+	pool.instances.reserve(count);
+	pool.free_slots.reserve(count);
+	pool.in_use.assign(count, 0);
+	slots.reserve(slots.size() + count);
+
+	for (int i = 0; i < count; i++) {
+		Node* node = scene->instantiate();
+		ERR_FAIL_COND(!node);
+
+		// Set before _ready so the scene knows to wait for _on_pool_spawn
+		node->set_meta("pooled", true);
+		park(node);
+		add_child(node);
+
+		pool.instances.push_back(node);
+		slots[node->get_instance_id()] = Slot{ (uint8_t)kind, i };
+	}
+
+	// Hand out low indices first
+	for (int i = count - 1; i >= 0; i--) {
+		pool.free_slots.push_back(i);
+	}
+	pool.stats.capacity = count;
+}
+
+void ScenePool::park(Node* node) {
+	if (CanvasItem* item = Object::cast_to<CanvasItem>(node)) {
+		item->hide();
+	}
+	node->set_process_mode(Node::PROCESS_MODE_DISABLED);
+}
+
+void ScenePool::finish_park(Node* node) {
+	if (!node) return;
+
+	auto found = slots.find(node->get_instance_id());
+	if (found == slots.end()) return;
+
+	// Handed out again before the flush
+	if (pools[found->second.kind].in_use[found->second.index]) return;
+	park(node);
+}
+
+void ScenePool::wake(Node* node, Vector2 position) {
+	if (Node2D* node_2d = Object::cast_to<Node2D>(node)) {
+		node_2d->set_global_position(position);
+	}
+	if (CanvasItem* item = Object::cast_to<CanvasItem>(node)) {
+		item->show();
+	}
+	node->set_process_mode(Node::PROCESS_MODE_INHERIT);
+}
+
+// ------------------ POOL --------------------
+Node* ScenePool::spawn(int kind, Vector2 position) {
+	ERR_FAIL_INDEX_V(kind, POOL_KIND_COUNT, nullptr);
+	Pool& pool = pools[kind];
+
+	if (pool.free_slots.empty()) {
+		pool.stats.misses++;
+		return nullptr;
+	}
+
+	int index = pool.free_slots.back();
+	pool.free_slots.pop_back();
+	pool.in_use[index] = 1;
+
+	pool.stats.spawns++;
+	pool.stats.in_use++;
+	pool.stats.high_water = std::max(pool.stats.high_water, pool.stats.in_use);
+
+	Node* node = pool.instances[index];
+	wake(node, position);
+	if (node->has_method("_on_pool_spawn")) {
+		node->call("_on_pool_spawn");
+	}
+	return node;
+}
+
+void ScenePool::release(Node* node) {
+	ERR_FAIL_COND(!node);
+
+	auto found = slots.find(node->get_instance_id());
+	ERR_FAIL_COND_MSG(found == slots.end(), "ScenePool: release() of a node this pool does not own");
+
+	Pool& pool = pools[found->second.kind];
+	int index = found->second.index;
+	if (!pool.in_use[index]) return;       // released twice in one frame (hit + killzone)
+
+	if (node->has_method("_on_pool_release")) {
+		node->call("_on_pool_release");
+	}
+	// Disabling pulls its Area2Ds out of the physics space, which can't
+	// happen while the server is flushing queries (hit, killzone)
+	if (CanvasItem* item = Object::cast_to<CanvasItem>(node)) {
+		item->hide();
+	}
+	call_deferred("finish_park", node);
+
+	pool.in_use[index] = 0;
+	pool.free_slots.push_back(index);
+	pool.stats.in_use--;
+}
+
+void ScenePool::release_all(int kind) {
+	ERR_FAIL_INDEX(kind, POOL_KIND_COUNT);
+	Pool& pool = pools[kind];
+
+	for (size_t i = 0; i < pool.instances.size(); i++) {
+		if (pool.in_use[i]) release(pool.instances[i]);
+	}
+}
+
+int ScenePool::get_free_count(int kind) const {
+	ERR_FAIL_INDEX_V(kind, POOL_KIND_COUNT, 0);
+	return (int)pools[kind].free_slots.size();
+}
+
+Ref<PackedScene> ScenePool::get_scene(int kind) const {
+	switch (kind) {
+		case POOL_ENEMY: return enemy_scene;
+		case POOL_COIN: return coin_scene;
+		case POOL_EFFECT: return effect_scene;
+		default: return Ref<PackedScene>();
+	}
+}
+
+Dictionary ScenePool::get_stats() const {
+	Dictionary result;
+	for (int kind = 0; kind < POOL_KIND_COUNT; kind++) {
+		const PoolStats& stats = pools[kind].stats;
+
+		Dictionary entry;
+		entry["capacity"] = (int64_t)stats.capacity;
+		entry["in_use"] = (int64_t)stats.in_use;
+		entry["high_water"] = (int64_t)stats.high_water;
+		entry["spawns"] = (int64_t)stats.spawns;
+		entry["misses"] = (int64_t)stats.misses;
+		result[KIND_NAMES[kind]] = entry;
+	}
+	return result;
+}
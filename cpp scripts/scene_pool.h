@@ -0,0 +1,103 @@
+#pragma once
+
+#ifndef SCENE_POOL_H
+#define SCENE_POOL_H
+
+#include <Godot.hpp>
+#include <Node2D.hpp>
+#include <PackedScene.hpp>
+#include <CanvasItem.hpp>
+
+#include <unordered_map>
+#include <vector>
+
+namespace godot {
+
+    enum PoolKind : uint8_t {
+        POOL_ENEMY,         // enemy.tscn
+        POOL_COIN,          // coin.tscn
+        POOL_EFFECT,        // one-shot effects
+        POOL_KIND_COUNT
+    };
+
+    struct PoolStats {
+        int capacity = 0;
+        int in_use = 0;
+        int high_water = 0;
+        int64_t spawns = 0;
+        int64_t misses = 0;     // spawn() found nothing free
+    };
+
+    // ============================================================
+    // SCENE POOL
+    // Instantiates every enemy, coin and effect the level can have at
+    // once when it loads, as children of this node, and hands them out
+    // instead of instantiate()/queue_free(). A parked instance is hidden
+    // and PROCESS_MODE_DISABLED, which also takes its Area2Ds out of
+    // the physics space. Spawning never instantiates: an empty pool is a
+    // miss and spawn() returns null.
+    // Pooled scenes get the "pooled" meta before they enter the tree and
+    // may implement _on_pool_spawn() (reset state) and _on_pool_release();
+    // they give themselves back with get_parent().release(self). That
+    // usually happens inside a physics callback, so release() only
+    // hides the instance; it is disabled at the next deferred flush.
+    // ============================================================
+    class ScenePool : public Node2D {
+        GODOT_CLASS(ScenePool, Node2D)
+
+    public:
+        ScenePool();
+        ~ScenePool();
+
+        static void _register_methods();
+
+        void _init() override;
+        void _ready() override;
+
+        // ============================================================
+        // SETTINGS
+        // ============================================================
+        Ref<PackedScene> enemy_scene;
+        Ref<PackedScene> coin_scene;
+        Ref<PackedScene> effect_scene;
+        int enemy_count;
+        int coin_count;
+        int effect_count;
+
+        // ============================================================
+        // POOL
+        // ============================================================
+        Node* spawn(int kind, Vector2 position);
+        void release(Node* node);
+        void release_all(int kind);
+
+        int get_free_count(int kind) const;
+        Ref<PackedScene> get_scene(int kind) const;
+        const PoolStats& get_pool_stats(int kind) const { return pools[kind].stats; }
+        Dictionary get_stats() const;
+
+    private:
+        struct Pool {
+            std::vector<Node*> instances;
+            std::vector<int> free_slots;
+            std::vector<uint8_t> in_use;
+            PoolStats stats;
+        };
+
+        struct Slot {
+            uint8_t kind;
+            int index;
+        };
+
+        Pool pools[POOL_KIND_COUNT];
+        std::unordered_map<uint64_t, Slot> slots;      // instance id -> slot, filled at load
+
+        void prewarm(PoolKind kind, const Ref<PackedScene>& scene, int count);
+        void park(Node* node);
+        void finish_park(Node* node);
+        void wake(Node* node, Vector2 position);
+    };
+
+} // namespace godot
+
+#endif
@@ -0,0 +1,365 @@
+#include "spatial_hash.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace godot;
+
+// Source kind -> what it is tested against and what the pair is called
+static const int SOURCE_NONE = -1;
+static const int SOURCE_TYPE[VOLUME_KIND_COUNT] = { OVERLAP_HIT, SOURCE_NONE, OVERLAP_PICKUP, OVERLAP_KILL, SOURCE_NONE };
+static const VolumeKind TARGET_KIND[OVERLAP_TYPE_COUNT] = { VOLUME_HURTBOX, VOLUME_BODY, VOLUME_BODY };
+
+static inline uint64_t pair_key(int type, int source, int target) {
+	return ((uint64_t)type << 48) | ((uint64_t)source << 24) | (uint64_t)target;
+}
+
+SpatialHash::SpatialHash(float cell_size, int bucket_bits) :
+		cell_size(cell_size),
+		inv_cell_size(1.0f / cell_size),
+		bucket_mask((1u << bucket_bits) - 1),
+		swept(false),
+		binned(false) {
+	buckets.assign((size_t)bucket_mask + 1, BucketRange{ 0, 0 });
+	stats = SpatialHashStats{};
+}
+
+// ------------------ VOLUMES --------------------
+int SpatialHash::add(VolumeKind kind, int owner, float min_x, float min_y, float max_x, float max_y) {
+	int id;
+	if (!free_ids.empty()) {
+		id = free_ids.back();
+		free_ids.pop_back();
+	} else {
+		if ((int)id_slots.size() >= MAX_VOLUMES) return INVALID_ID;
+		id = (int)id_slots.size();
+		id_slots.push_back(-1);
+	}
+
+	id_slots[id] = (int)kinds.size();
+	box_min_x.push_back(min_x);
+	box_min_y.push_back(min_y);
+	box_max_x.push_back(max_x);
+	box_max_y.push_back(max_y);
+	kinds.push_back(kind);
+	enabled.push_back(1);
+	owners.push_back(owner);
+	ids.push_back(id);
+
+	binned = false;
+	return id;
+}
+
+int SpatialHash::index_of(int id) const {
+	if (id < 0 || id >= (int)id_slots.size()) return -1;
+	return id_slots[id];
+}
+
+void SpatialHash::move(int id, float min_x, float min_y, float max_x, float max_y) {
+	int i = index_of(id);
+	if (i < 0) return;
+
+	box_min_x[i] = min_x;
+	box_min_y[i] = min_y;
+	box_max_x[i] = max_x;
+	box_max_y[i] = max_y;
+	binned = false;
+}
+
+void SpatialHash::set_enabled(int id, bool on) {
+	int i = index_of(id);
+	if (i < 0) return;
+	enabled[i] = on;
+	binned = false;
+}
+
+void SpatialHash::remove(int id) {
+	int index = index_of(id);
+	if (index < 0) return;
+
+	int last = (int)kinds.size() - 1;
+	if (index != last) {
+		box_min_x[index] = box_min_x[last];
+		box_min_y[index] = box_min_y[last];
+		box_max_x[index] = box_max_x[last];
+		box_max_y[index] = box_max_y[last];
+		kinds[index] = kinds[last];
+		enabled[index] = enabled[last];
+		owners[index] = owners[last];
+		ids[index] = ids[last];
+		id_slots[ids[index]] = index;
+	}
+
+	box_min_x.pop_back();
+	box_min_y.pop_back();
+	box_max_x.pop_back();
+	box_max_y.pop_back();
+	kinds.pop_back();
+	enabled.pop_back();
+	owners.pop_back();
+	ids.pop_back();
+
+	id_slots[id] = -1;
+	pending_free.push_back(id);
+	binned = false;
+}
+
+void SpatialHash::clear() {
+	// Everything still overlapping gets its exit event on the next update
+	while (!ids.empty()) {
+		remove(ids.back());
+	}
+}
+
+VolumeKind SpatialHash::get_kind(int id) const {
+	int i = index_of(id);
+	return i >= 0 ? kinds[i] : VOLUME_KIND_COUNT;
+}
+
+int SpatialHash::get_owner(int id) const {
+	int i = index_of(id);
+	return i >= 0 ? owners[i] : NO_OWNER;
+}
+
+// ------------------ BINNING --------------------
+int SpatialHash::cell_of(float v) const {
+	return (int)std::floor(v * inv_cell_size);
+}
+
+uint32_t SpatialHash::bucket_of(int cell_x, int cell_y) const {
+	return ((uint32_t)cell_x * 73856093u ^ (uint32_t)cell_y * 19349663u) & bucket_mask;
+}
+
+void SpatialHash::rebin() {
+	const int count = (int)kinds.size();
+	entry_bucket.clear();
+	entry_volume.clear();
+	oversized.clear();
+
+	for (int i = 0; i < count; i++) {
+		if (!enabled[i]) continue;
+
+		int x0 = cell_of(box_min_x[i]);
+		int y0 = cell_of(box_min_y[i]);
+		int x1 = cell_of(box_max_x[i]);
+		int y1 = cell_of(box_max_y[i]);
+
+		if ((int64_t)(x1 - x0 + 1) * (y1 - y0 + 1) > MAX_CELLS_PER_VOLUME) {
+			oversized.push_back(i);
+			continue;
+		}
+
+		for (int y = y0; y <= y1; y++) {
+			for (int x = x0; x <= x1; x++) {
+				entry_bucket.push_back(bucket_of(x, y));
+				entry_volume.push_back(i);
+			}
+		}
+	}
+
+	// Keep buckets at least as many as entries so a bucket is about one cell
+	if (entry_bucket.size() > bucket_mask + 1) {
+		uint32_t grown = bucket_mask + 1;
+		while (grown < entry_bucket.size()) grown <<= 1;
+		bucket_mask = grown - 1;
+		buckets.assign(grown, BucketRange{ 0, 0 });
+		touched.clear();
+		swept = false;
+		// Only on growth: bin again with the wider mask
+		rebin();
+		return;
+	}
+
+	// Empty last tick's buckets
+	if (swept) {
+		std::fill(buckets.begin(), buckets.end(), BucketRange{ 0, 0 });
+	} else {
+		for (uint32_t b : touched) {
+			buckets[b] = BucketRange{ 0, 0 };
+		}
+	}
+	touched.clear();
+
+	// Counting sort by bucket, counts in `end` for now; volumes stay in
+	// index order inside each bucket. With entries for a good share of the
+	// table, visiting buckets at random costs more than one pass over all
+	uint32_t offset = 0;
+	auto place = [&](BucketRange& range) {
+		range.begin = offset;
+		offset += range.end;
+		range.end = range.begin;
+	};
+
+	swept = entry_bucket.size() * 8 > (size_t)bucket_mask + 1;
+	if (swept) {
+		for (uint32_t b : entry_bucket) {
+			buckets[b].end++;
+		}
+		for (BucketRange& range : buckets) {
+			place(range);
+		}
+	} else {
+		for (uint32_t b : entry_bucket) {
+			if (buckets[b].end++ == 0) touched.push_back(b);
+		}
+		for (uint32_t b : touched) {
+			place(buckets[b]);
+		}
+	}
+
+	entries.resize(entry_volume.size());
+	for (size_t e = 0; e < entry_volume.size(); e++) {
+		entries[buckets[entry_bucket[e]].end++] = entry_volume[e];
+	}
+
+	binned = true;
+}
+
+// ------------------ PAIRS --------------------
+bool SpatialHash::overlaps(int a, int b) const {
+	return box_min_x[a] < box_max_x[b] && box_min_x[b] < box_max_x[a]
+			&& box_min_y[a] < box_max_y[b] && box_min_y[b] < box_max_y[a];
+}
+
+void SpatialHash::test_candidate(int source, int target, OverlapType type, VolumeKind target_kind) {
+	if (kinds[target] != target_kind || !enabled[target]) return;
+	if (owners[source] != NO_OWNER && owners[source] == owners[target]) return;
+
+	stats.candidates++;
+	if (overlaps(source, target)) {
+		pairs.push_back(pair_key(type, ids[source], ids[target]));
+	}
+}
+
+void SpatialHash::find_pairs() {
+	const int count = (int)kinds.size();
+	pairs.clear();
+	stats.candidates = 0;
+
+	for (int i = 0; i < count; i++) {
+		int type = SOURCE_TYPE[kinds[i]];
+		if (type == SOURCE_NONE || !enabled[i]) continue;
+
+		OverlapType overlap = (OverlapType)type;
+		VolumeKind target_kind = TARGET_KIND[type];
+
+		int x0 = cell_of(box_min_x[i]);
+		int y0 = cell_of(box_min_y[i]);
+		int x1 = cell_of(box_max_x[i]);
+		int y1 = cell_of(box_max_y[i]);
+
+		if ((int64_t)(x1 - x0 + 1) * (y1 - y0 + 1) > MAX_CELLS_PER_VOLUME) {
+			// Oversized sources (a level-wide killzone) just check everything once
+			for (int j = 0; j < count; j++) {
+				test_candidate(i, j, overlap, target_kind);
+			}
+			continue;
+		}
+
+		for (int y = y0; y <= y1; y++) {
+			for (int x = x0; x <= x1; x++) {
+				uint32_t b = bucket_of(x, y);
+				for (uint32_t e = buckets[b].begin; e < buckets[b].end; e++) {
+					test_candidate(i, entries[e], overlap, target_kind);
+				}
+			}
+		}
+		for (int j : oversized) {
+			test_candidate(i, j, overlap, target_kind);
+		}
+	}
+
+	// A pair sharing several cells (or a hash collision) shows up more than once
+	std::sort(pairs.begin(), pairs.end());
+	pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+}
+
+void SpatialHash::diff_pairs() {
+	events.clear();
+
+	// Both lists are sorted, so one merge yields the events in key order
+	size_t a = 0;
+	size_t b = 0;
+	while (a < pairs.size() || b < previous_pairs.size()) {
+		uint64_t key;
+		bool entered;
+		if (b == previous_pairs.size() || (a < pairs.size() && pairs[a] < previous_pairs[b])) {
+			key = pairs[a++];
+			entered = true;
+		} else if (a == pairs.size() || previous_pairs[b] < pairs[a]) {
+			key = previous_pairs[b++];
+			entered = false;
+		} else {
+			a++;
+			b++;
+			continue;
+		}
+
+		OverlapEvent event;
+		event.type = (OverlapType)(key >> 48);
+		event.entered = entered;
+		event.source = (int32_t)((key >> 24) & 0xFFFFFF);
+		event.target = (int32_t)(key & 0xFFFFFF);
+		events.push_back(event);
+	}
+
+	previous_pairs.swap(pairs);
+}
+
+// ------------------ UPDATE --------------------
+void SpatialHash::update() {
+	rebin();
+	find_pairs();
+	diff_pairs();
+
+	// Exit events for removed volumes are out; their ids can be handed out again
+	free_ids.insert(free_ids.end(), pending_free.begin(), pending_free.end());
+	pending_free.clear();
+
+	stats.volumes = (int)kinds.size();
+	stats.cell_entries = (int)entries.size();
+	stats.pairs = (int)previous_pairs.size();
+	stats.events = (int)events.size();
+}
+
+// ------------------ QUERY --------------------
+int SpatialHash::query(float min_x, float min_y, float max_x, float max_y, uint32_t kind_mask, std::vector<int>& out) const {
+	const size_t first = out.size();
+	const int count = (int)kinds.size();
+
+	auto test = [&](int i) {
+		if (!enabled[i] || !((kind_mask >> kinds[i]) & 1)) return;
+		if (min_x < box_max_x[i] && box_min_x[i] < max_x && min_y < box_max_y[i] && box_min_y[i] < max_y) {
+			out.push_back(ids[i]);
+		}
+	};
+
+	int x0 = cell_of(min_x);
+	int y0 = cell_of(min_y);
+	int x1 = cell_of(max_x);
+	int y1 = cell_of(max_y);
+
+	// Bins go stale on any add/move/remove; fall back to a scan until the next update
+	if (!binned || (int64_t)(x1 - x0 + 1) * (y1 - y0 + 1) > MAX_CELLS_PER_VOLUME) {
+		for (int i = 0; i < count; i++) {
+			test(i);
+		}
+		return (int)(out.size() - first);
+	}
+
+	for (int y = y0; y <= y1; y++) {
+		for (int x = x0; x <= x1; x++) {
+			uint32_t b = bucket_of(x, y);
+			for (uint32_t e = buckets[b].begin; e < buckets[b].end; e++) {
+				test(entries[e]);
+			}
+		}
+	}
+	for (int i : oversized) {
+		test(i);
+	}
+
+	std::sort(out.begin() + first, out.end());
+	out.erase(std::unique(out.begin() + first, out.end()), out.end());
+	return (int)(out.size() - first);
+}
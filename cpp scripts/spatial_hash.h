@@ -0,0 +1,145 @@
+#pragma once
+
+#ifndef SPATIAL_HASH_H
+#define SPATIAL_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace godot {
+
+    // ============================================================
+    // GAMEPLAY VOLUMES
+    // What used to be one Area2D each: fighter hitbox_punch/kick and
+    // hurtbox_standing/crouching, coin.tscn, killzone.tscn and the
+    // enemy attack hitbox/killzone pair. BODY is whatever the Area2Ds
+    // were watching for in body_entered (fighters, the player).
+    // ============================================================
+    enum VolumeKind : uint8_t {
+        VOLUME_HITBOX,
+        VOLUME_HURTBOX,
+        VOLUME_PICKUP,
+        VOLUME_KILLZONE,
+        VOLUME_BODY,
+        VOLUME_KIND_COUNT
+    };
+
+    // Which pairs are tested: the source kind is always the first volume
+    enum OverlapType : uint8_t {
+        OVERLAP_HIT,        // hitbox -> hurtbox of another owner
+        OVERLAP_PICKUP,     // pickup -> body
+        OVERLAP_KILL,       // killzone -> body of another owner
+        OVERLAP_TYPE_COUNT
+    };
+
+    struct OverlapEvent {
+        OverlapType type;
+        bool entered;       // false: the pair stopped overlapping (or a volume went away)
+        int32_t source;     // volume ids
+        int32_t target;
+    };
+
+    struct SpatialHashStats {
+        int volumes;
+        int cell_entries;
+        int candidates;     // box tests run by the last update
+        int pairs;
+        int events;
+    };
+
+    // ============================================================
+    // SPATIAL HASH
+    // Owned by the simulation, not the scene tree. Volumes live in
+    // packed arrays (boxes as structure-of-arrays); update() rebins every
+    // enabled volume into a fixed bucket table with a counting sort,
+    // finds all overlapping pairs, and diffs them against last tick's
+    // to produce entered/exited events - Area2D semantics without the
+    // physics server. Events come out sorted by (type, source, target)
+    // so every peer sees the same order.
+    // Ids stay reserved until the update after remove(), so an exit
+    // event never refers to a reused id.
+    // ============================================================
+    class SpatialHash {
+    public:
+        static const int INVALID_ID = -1;
+        static const int NO_OWNER = -1;
+        static const int MAX_VOLUMES = 1 << 24;
+        static const int MAX_CELLS_PER_VOLUME = 64;
+
+        explicit SpatialHash(float cell_size = 64.0f, int bucket_bits = 12);
+
+        int add(VolumeKind kind, int owner, float min_x, float min_y, float max_x, float max_y);
+        void move(int id, float min_x, float min_y, float max_x, float max_y);
+        void set_enabled(int id, bool enabled);
+        void remove(int id);
+        void clear();
+
+        // Rebin, find pairs, emit events; call once per tick after moving volumes
+        void update();
+
+        const std::vector<OverlapEvent>& get_events() const { return events; }
+        const SpatialHashStats& get_stats() const { return stats; }
+
+        // Ids of enabled volumes of the masked kinds overlapping the box. Uses the bins
+        // from update() when nothing changed since, otherwise a linear scan
+        int query(float min_x, float min_y, float max_x, float max_y, uint32_t kind_mask, std::vector<int>& out) const;
+
+        VolumeKind get_kind(int id) const;
+        int get_owner(int id) const;
+        int get_volume_count() const { return (int)kinds.size(); }
+
+    private:
+        float cell_size;
+        float inv_cell_size;
+        uint32_t bucket_mask;
+
+        // Dense volume storage, index != id
+        std::vector<float> box_min_x;
+        std::vector<float> box_min_y;
+        std::vector<float> box_max_x;
+        std::vector<float> box_max_y;
+        std::vector<VolumeKind> kinds;
+        std::vector<uint8_t> enabled;
+        std::vector<int32_t> owners;
+        std::vector<int32_t> ids;
+
+        std::vector<int> id_slots;      // id -> index, -1 when free
+        std::vector<int> free_ids;
+        std::vector<int> pending_free;
+
+        // Counting-sorted cell entries: bucket b holds entries[begin .. end) of buckets[b].
+        // A sparse table (a 1v1 match) lists its non-empty buckets in `touched`
+        // and resets just those; a crowded one is swept in order instead
+        struct BucketRange {
+            uint32_t begin;
+            uint32_t end;
+        };
+        std::vector<BucketRange> buckets;
+        std::vector<uint32_t> touched;
+        bool swept;                         // last rebin didn't track `touched`
+        std::vector<int32_t> entries;
+        std::vector<uint32_t> entry_bucket;
+        std::vector<int32_t> entry_volume;
+        std::vector<int32_t> oversized;     // volumes spanning too many cells to bin, tested linearly
+        bool binned;                        // false after add/remove until the next update()
+
+        std::vector<uint64_t> pairs;
+        std::vector<uint64_t> previous_pairs;
+        std::vector<OverlapEvent> events;
+        SpatialHashStats stats;
+
+        int index_of(int id) const;
+        uint32_t bucket_of(int cell_x, int cell_y) const;
+        int cell_of(float v) const;
+        bool overlaps(int a, int b) const;
+        void test_candidate(int source, int target, OverlapType type, VolumeKind target_kind);
+
+        void rebin();
+        void find_pairs();
+        void diff_pairs();
+    };
+
+} // namespace godot
+
+#endif
@@ -0,0 +1,552 @@
+// Offline repacker for the fighter sprite sheets.
+// Drop a SpriteRepacker node into an empty scene and run it once. For
+// each character scene it walks the AnimatedSprite2D's SpriteFrames,
+// cuts every AtlasTexture region out of the source sheet, trims the
+// transparent border, merges identical frames, shelf-packs what is left
+// into RGBA pages and writes:
+//   <output_dir>/<name>_<page>.png
+//   <output_dir>/<name>_<page>_lod<n>.png  1/2^n scale, n < lod_count,
+//                                     alpha-weighted box filtered
+//   <output_dir>/<name>.frames.json   page, packed rect, trim offset,
+//                                     source size and duration per frame
+//   <output_dir>/<name>.frames.bin    the same table plus per-frame
+//                                     hurt/hit boxes, in the FrameTable
+//                                     format PackedSprite maps at runtime
+// Rendering a packed frame as an AtlasTexture with
+// margin = Rect2(offset, source_size - rect.size) is pixel-identical to
+// the original region. With LODs, rects and gutters are aligned to
+// 2^(lod_count - 1) so every LOD reuses the same table shifted right.
+// Decoded memory per LOD and PNG decode time before/after go to the
+// output log.
+
+#include <Godot.hpp>
+#include <Node.hpp>
+#include <PackedScene.hpp>
+#include <ResourceLoader.hpp>
+#include <AnimatedSprite2D.hpp>
+#include <SpriteFrames.hpp>
+#include <AtlasTexture.hpp>
+#include <Image.hpp>
+#include <Area2D.hpp>
+#include <CollisionShape2D.hpp>
+#include <Shape2D.hpp>
+#include <FileAccess.hpp>
+#include <DirAccess.hpp>
+#include <JSON.hpp>
+#include <Time.hpp>
+
+#include "frame_table.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+namespace godot {
+
+    class SpriteRepacker : public Node {
+        GODOT_CLASS(SpriteRepacker, Node)
+
+    public:
+        static void _register_methods();
+
+        void _init() override;
+        void _ready() override;
+
+        PackedStringArray character_scenes;
+        String output_dir;
+        int page_size;
+        int padding;
+        int lod_count;
+
+    private:
+        struct Frame {
+            String animation;
+            int index;
+            float duration;
+            Vector2i source_size;
+            Vector2i offset;        // trim offset inside the source region
+            int unique;             // -1: fully transparent
+        };
+
+        struct Unique {
+            Ref<Image> image;
+            uint64_t hash;
+            int page;
+            Vector2i position;
+        };
+
+        // The scenes' boxes are static and toggled by the player scripts;
+        // baked per frame here from the animation name the same way
+        enum BakedBox {
+            BOX_HURT_STANDING,
+            BOX_HURT_CROUCHING,
+            BOX_HIT_PUNCH,
+            BOX_HIT_KICK,
+            BOX_COUNT
+        };
+
+        struct Character {
+            String name;
+            std::vector<String> sheets;
+            int64_t source_bytes = 0;
+            std::vector<Frame> frames;
+            std::vector<Unique> uniques;
+            std::vector<Vector2i> page_sizes;
+            Ref<SpriteFrames> sprite_frames;
+            Rect2 boxes[BOX_COUNT];
+            bool has_box[BOX_COUNT] = {};
+        };
+
+        bool collect(const String& scene_path, Character& character);
+        void pack(Character& character);
+        // page_paths: every LOD 0 page, then every LOD 1 page, ...
+        bool write(Character& character, std::vector<String>& page_paths);
+        bool write_table(const Character& character, const std::vector<String>& page_paths);
+        void report(const Character& character, const std::vector<String>& page_paths);
+
+        int get_alignment() const { return 1 << (lod_count - 1); }
+    };
+
+} // namespace godot
+
+using namespace godot;
+
+static uint64_t hash_image(const Ref<Image>& image) {
+	PackedByteArray data = image->get_data();
+	const uint8_t* bytes = data.ptr();
+
+	uint64_t h = 14695981039346656037ull;
+	h ^= (uint64_t)image->get_width() << 32 | (uint64_t)image->get_height();
+	h *= 1099511628211ull;
+	for (int64_t i = 0; i < data.size(); i++) {
+		h ^= bytes[i];
+		h *= 1099511628211ull;
+	}
+	return h;
+}
+
+static bool same_pixels(const Ref<Image>& a, const Ref<Image>& b) {
+	if (a->get_size() != b->get_size()) return false;
+	PackedByteArray da = a->get_data();
+	PackedByteArray db = b->get_data();
+	return da.size() == db.size() && memcmp(da.ptr(), db.ptr(), da.size()) == 0;
+}
+
+static AnimatedSprite2D* find_sprite(Node* node) {
+	if (AnimatedSprite2D* sprite = Object::cast_to<AnimatedSprite2D>(node)) return sprite;
+	for (int i = 0; i < node->get_child_count(); i++) {
+		if (AnimatedSprite2D* sprite = find_sprite(node->get_child(i))) return sprite;
+	}
+	return nullptr;
+}
+
+// First CollisionShape2D of `area`, as a rect in the sprite's local space
+static bool sprite_box(AnimatedSprite2D* sprite, const char* area_name, Rect2& out) {
+	Node* container = sprite->get_parent();
+	Area2D* area = Object::cast_to<Area2D>(container->get_node_or_null(NodePath(area_name)));
+	if (!area) return false;
+
+	for (int i = 0; i < area->get_child_count(); i++) {
+		CollisionShape2D* shape = Object::cast_to<CollisionShape2D>(area->get_child(i));
+		if (!shape || shape->get_shape().is_null()) continue;
+
+		Transform2D to_sprite = sprite->get_transform().affine_inverse() * area->get_transform() * shape->get_transform();
+		out = to_sprite.xform(shape->get_shape()->get_rect());
+		return true;
+	}
+	return false;
+}
+
+void SpriteRepacker::_register_methods() {
+	register_method("_ready", &SpriteRepacker::_ready);
+
+	PackedStringArray defaults;
+	defaults.push_back("res://scenes/player.tscn");
+	defaults.push_back("res://scenes/player_2.tscn");
+
+	register_property<SpriteRepacker, PackedStringArray>("character_scenes", &SpriteRepacker::character_scenes, defaults);
+	register_property<SpriteRepacker, String>("output_dir", &SpriteRepacker::output_dir, "res://assets/SPRITES/packed");
+	register_property<SpriteRepacker, int>("page_size", &SpriteRepacker::page_size, 2048);
+	register_property<SpriteRepacker, int>("padding", &SpriteRepacker::padding, 1);
+	register_property<SpriteRepacker, int>("lod_count", &SpriteRepacker::lod_count, 3);
+}
+
+void SpriteRepacker::_init() {
+	character_scenes.push_back("res://scenes/player.tscn");
+	character_scenes.push_back("res://scenes/player_2.tscn");
+	output_dir = "res://assets/SPRITES/packed";
+	page_size = 2048;
+	padding = 1;
+	lod_count = 3;
+}
+
+void SpriteRepacker::_ready() {
+	lod_count = Math::clamp(lod_count, 1, 4);
+	DirAccess::make_dir_recursive_absolute(output_dir);
+
+	for (int i = 0; i < character_scenes.size(); i++) {
+		Character character;
+		if (!collect(character_scenes[i], character)) continue;
+
+		pack(character);
+
+		std::vector<String> page_paths;
+		if (!write(character, page_paths)) continue;
+		if (!write_table(character, page_paths)) continue;
+		report(character, page_paths);
+	}
+}
+
+// ------------------ COLLECT --------------------
+bool SpriteRepacker::collect(const String& scene_path, Character& character) {
+	Ref<PackedScene> scene = ResourceLoader::get_singleton()->load(scene_path);
+	ERR_FAIL_COND_V_MSG(scene.is_null(), false, "SpriteRepacker: cannot load " + scene_path);
+
+	Node* root = scene->instantiate();
+	ERR_FAIL_COND_V(!root, false);
+	AnimatedSprite2D* sprite = find_sprite(root);
+	character.sprite_frames = sprite ? sprite->get_sprite_frames() : Ref<SpriteFrames>();
+	if (sprite) {
+		const char* areas[BOX_COUNT] = { "hurtbox_standing", "hurtbox_crouching", "hitbox_punch", "hitbox_kick" };
+		for (int b = 0; b < BOX_COUNT; b++) {
+			character.has_box[b] = sprite_box(sprite, areas[b], character.boxes[b]);
+		}
+	}
+	root->free();
+	ERR_FAIL_COND_V_MSG(character.sprite_frames.is_null(), false, "SpriteRepacker: no AnimatedSprite2D in " + scene_path);
+
+	character.name = scene_path.get_file().get_basename();
+
+	// Decoded once per sheet, however many frames point into it
+	std::unordered_map<int64_t, Ref<Image>> sheets;
+	std::unordered_map<uint64_t, std::vector<int>> by_hash;
+
+	PackedStringArray animations = character.sprite_frames->get_animation_names();
+	for (int a = 0; a < animations.size(); a++) {
+		StringName animation = animations[a];
+
+		for (int f = 0; f < character.sprite_frames->get_frame_count(animation); f++) {
+			Ref<AtlasTexture> atlas = character.sprite_frames->get_frame_texture(animation, f);
+			if (atlas.is_null() || atlas->get_atlas().is_null()) {
+				WARN_PRINT("SpriteRepacker: " + character.name + " " + String(animation) + " frame is not an AtlasTexture, skipped");
+				continue;
+			}
+
+			Ref<Texture2D> sheet = atlas->get_atlas();
+			int64_t sheet_id = sheet->get_instance_id();
+			if (sheets.find(sheet_id) == sheets.end()) {
+				Ref<Image> image = sheet->get_image();
+				if (image->is_compressed()) image->decompress();
+				image->convert(Image::FORMAT_RGBA8);
+				sheets[sheet_id] = image;
+				character.sheets.push_back(sheet->get_path());
+				character.source_bytes += (int64_t)sheet->get_width() * sheet->get_height() * 4;
+			}
+
+			Rect2i region = Rect2i(atlas->get_region());
+			Ref<Image> cut = sheets[sheet_id]->get_region(region);
+			Rect2i used = cut->get_used_rect();
+
+			Frame frame;
+			frame.animation = animation;
+			frame.index = f;
+			frame.duration = character.sprite_frames->get_frame_duration(animation, f);
+			frame.source_size = region.size;
+			frame.offset = used.position;
+			frame.unique = -1;
+
+			if (used.size.x > 0 && used.size.y > 0) {
+				Ref<Image> trimmed = cut->get_region(used);
+				uint64_t h = hash_image(trimmed);
+
+				std::vector<int>& candidates = by_hash[h];
+				for (int u : candidates) {
+					if (same_pixels(character.uniques[u].image, trimmed)) {
+						frame.unique = u;
+						break;
+					}
+				}
+				if (frame.unique < 0) {
+					frame.unique = (int)character.uniques.size();
+					candidates.push_back(frame.unique);
+					character.uniques.push_back(Unique{ trimmed, h, -1, Vector2i() });
+				}
+			}
+
+			character.frames.push_back(frame);
+		}
+	}
+
+	return true;
+}
+
+// ------------------ PACK --------------------
+void SpriteRepacker::pack(Character& character) {
+	// Tallest first onto shelves; each page is cropped to its last shelf
+	std::vector<int> order(character.uniques.size());
+	for (size_t i = 0; i < order.size(); i++) order[i] = (int)i;
+	std::sort(order.begin(), order.end(), [&](int a, int b) {
+		Vector2i sa = character.uniques[a].image->get_size();
+		Vector2i sb = character.uniques[b].image->get_size();
+		return sa.y != sb.y ? sa.y > sb.y : (sa.x != sb.x ? sa.x > sb.x : a < b);
+	});
+
+	int page = -1;
+	int shelf_x = 0;
+	int shelf_y = 0;
+	int shelf_h = 0;
+	int page_w = 0;
+
+	// Cells on the LOD grid, with at least one texel of gutter at the coarsest LOD
+	int align = get_alignment();
+	int gutter = (std::max(padding, lod_count > 1 ? align : 0) + align - 1) & ~(align - 1);
+
+	auto close_page = [&]() {
+		if (page >= 0) character.page_sizes.push_back(Vector2i(page_w, shelf_y + shelf_h));
+	};
+
+	for (int u : order) {
+		Unique& unique = character.uniques[u];
+		Vector2i size = unique.image->get_size();
+		size.x = ((size.x + align - 1) & ~(align - 1)) + gutter;
+		size.y = ((size.y + align - 1) & ~(align - 1)) + gutter;
+		ERR_CONTINUE_MSG(size.x > page_size || size.y > page_size, "SpriteRepacker: frame larger than page_size");
+
+		if (page >= 0 && shelf_x + size.x > page_size) {
+			shelf_y += shelf_h;
+			shelf_x = 0;
+			shelf_h = 0;
+		}
+		if (page < 0 || shelf_y + size.y > page_size) {
+			close_page();
+			page++;
+			shelf_x = shelf_y = shelf_h = page_w = 0;
+		}
+
+		unique.page = page;
+		unique.position = Vector2i(shelf_x, shelf_y);
+		shelf_x += size.x;
+		shelf_h = std::max(shelf_h, size.y);
+		page_w = std::max(page_w, shelf_x);
+	}
+	close_page();
+}
+
+// ------------------ WRITE --------------------
+// 2x2 box filter weighted by alpha, so transparent texels don't darken edges
+static Ref<Image> halve(const Ref<Image>& source) {
+	int w = source->get_width() / 2;
+	int h = source->get_height() / 2;
+	int stride = source->get_width() * 4;
+
+	PackedByteArray in = source->get_data();
+	PackedByteArray out;
+	out.resize((int64_t)w * h * 4);
+	const uint8_t* src = in.ptr();
+	uint8_t* dst = out.ptrw();
+
+	for (int y = 0; y < h; y++) {
+		for (int x = 0; x < w; x++) {
+			const uint8_t* p[4] = {
+				src + (2 * y) * stride + 8 * x, src + (2 * y) * stride + 8 * x + 4,
+				src + (2 * y + 1) * stride + 8 * x, src + (2 * y + 1) * stride + 8 * x + 4
+			};
+
+			uint32_t alpha = p[0][3] + p[1][3] + p[2][3] + p[3][3];
+			uint8_t* o = dst + ((int64_t)y * w + x) * 4;
+			for (int c = 0; c < 3; c++) {
+				uint32_t sum = p[0][c] * p[0][3] + p[1][c] * p[1][3] + p[2][c] * p[2][3] + p[3][c] * p[3][3];
+				o[c] = alpha ? (uint8_t)((sum + alpha / 2) / alpha) : 0;
+			}
+			o[3] = (uint8_t)((alpha + 2) / 4);
+		}
+	}
+	return Image::create_from_data(w, h, false, Image::FORMAT_RGBA8, out);
+}
+
+bool SpriteRepacker::write(Character& character, std::vector<String>& page_paths) {
+	std::vector<Ref<Image>> pages;
+	for (const Vector2i& size : character.page_sizes) {
+		pages.push_back(Image::create_empty(size.x, size.y, false, Image::FORMAT_RGBA8));
+	}
+
+	for (const Unique& unique : character.uniques) {
+		if (unique.page < 0) continue;
+		pages[unique.page]->blit_rect(unique.image, Rect2i(Vector2i(), unique.image->get_size()), unique.position);
+	}
+
+	Array page_list;
+	Array lod_list;
+	for (int lod = 0; lod < lod_count; lod++) {
+		Array lod_pages;
+		for (size_t p = 0; p < pages.size(); p++) {
+			if (lod > 0) pages[p] = halve(pages[p]);
+
+			String suffix = lod > 0 ? "_lod" + String::num_int64(lod) : String();
+			String path = output_dir.path_join(character.name + "_" + String::num_int64(p) + suffix + ".png");
+			ERR_FAIL_COND_V_MSG(pages[p]->save_png(path) != OK, false, "SpriteRepacker: cannot write " + path);
+			page_paths.push_back(path);
+			lod_pages.push_back(path);
+		}
+		if (lod == 0) page_list = lod_pages;
+		lod_list.push_back(lod_pages);
+	}
+
+	Dictionary animations;
+	PackedStringArray names = character.sprite_frames->get_animation_names();
+	for (int a = 0; a < names.size(); a++) {
+		Dictionary animation;
+		animation["speed"] = character.sprite_frames->get_animation_speed(names[a]);
+		animation["loop"] = character.sprite_frames->get_animation_loop(names[a]);
+		animation["frames"] = Array();
+		animations[names[a]] = animation;
+	}
+
+	for (const Frame& frame : character.frames) {
+		Dictionary entry;
+		entry["duration"] = frame.duration;
+		entry["source_size"] = Array::make(frame.source_size.x, frame.source_size.y);
+		if (frame.unique >= 0) {
+			const Unique& unique = character.uniques[frame.unique];
+			Vector2i size = unique.image->get_size();
+			entry["page"] = unique.page;
+			entry["rect"] = Array::make(unique.position.x, unique.position.y, size.x, size.y);
+			entry["offset"] = Array::make(frame.offset.x, frame.offset.y);
+		} else {
+			entry["page"] = -1;
+		}
+
+		Dictionary animation = animations[frame.animation];
+		Array frames = animation["frames"];
+		frames.push_back(entry);
+	}
+
+	Dictionary table;
+	table["character"] = character.name;
+	table["pages"] = page_list;
+	table["lods"] = lod_list;
+	table["animations"] = animations;
+
+	String table_path = output_dir.path_join(character.name + ".frames.json");
+	Ref<FileAccess> file = FileAccess::open(table_path, FileAccess::WRITE);
+	ERR_FAIL_COND_V_MSG(file.is_null(), false, "SpriteRepacker: cannot write " + table_path);
+	file->store_string(JSON::stringify(table, "\t"));
+	return true;
+}
+
+static bool is_punch(const String& animation) {
+	return animation.contains("attack") && (animation.contains("_j_") || animation.contains("_4_"));
+}
+
+static bool is_kick(const String& animation) {
+	return animation.contains("attack") && (animation.contains("_k_") || animation.contains("_5_"));
+}
+
+static FrameBox to_frame_box(FrameBoxKind kind, const Rect2& rect) {
+	FrameBox box = {};
+	box.kind = kind;
+	box.x = (int16_t)Math::floor(rect.position.x);
+	box.y = (int16_t)Math::floor(rect.position.y);
+	box.width = (uint16_t)Math::ceil(rect.size.x);
+	box.height = (uint16_t)Math::ceil(rect.size.y);
+	return box;
+}
+
+bool SpriteRepacker::write_table(const Character& character, const std::vector<String>& page_paths) {
+	FrameTableWriter writer;
+	writer.set_lod_count(lod_count);
+	for (const String& path : page_paths) {
+		writer.add_page(path.utf8().get_data());
+	}
+
+	String current;
+	FrameBox boxes[2];
+	int box_count = 0;
+
+	// character.frames is in animation order, one run per animation
+	for (const Frame& frame : character.frames) {
+		if (frame.animation != current) {
+			current = frame.animation;
+			writer.begin_animation(current.utf8().get_data(),
+					(float)character.sprite_frames->get_animation_speed(current),
+					character.sprite_frames->get_animation_loop(current));
+
+			box_count = 0;
+			BakedBox hurt = current.contains("crouch") ? BOX_HURT_CROUCHING : BOX_HURT_STANDING;
+			if (character.has_box[hurt]) boxes[box_count++] = to_frame_box(FRAME_BOX_HURT, character.boxes[hurt]);
+			if (is_punch(current) && character.has_box[BOX_HIT_PUNCH]) boxes[box_count++] = to_frame_box(FRAME_BOX_HIT, character.boxes[BOX_HIT_PUNCH]);
+			else if (is_kick(current) && character.has_box[BOX_HIT_KICK]) boxes[box_count++] = to_frame_box(FRAME_BOX_HIT, character.boxes[BOX_HIT_KICK]);
+		}
+
+		FrameRecord record = {};
+		record.page = -1;
+		record.source_width = (uint16_t)frame.source_size.x;
+		record.source_height = (uint16_t)frame.source_size.y;
+		record.duration = frame.duration;
+		if (frame.unique >= 0) {
+			const Unique& unique = character.uniques[frame.unique];
+			Vector2i size = unique.image->get_size();
+			record.page = (int16_t)unique.page;
+			record.x = (uint16_t)unique.position.x;
+			record.y = (uint16_t)unique.position.y;
+			record.width = (uint16_t)size.x;
+			record.height = (uint16_t)size.y;
+			record.offset_x = (int16_t)frame.offset.x;
+			record.offset_y = (int16_t)frame.offset.y;
+		}
+		writer.add_frame(record, boxes, box_count);
+	}
+
+	std::vector<uint8_t> bytes = writer.build();
+	PackedByteArray buffer;
+	buffer.resize((int64_t)bytes.size());
+	memcpy(buffer.ptrw(), bytes.data(), bytes.size());
+
+	String table_path = output_dir.path_join(character.name + ".frames.bin");
+	Ref<FileAccess> file = FileAccess::open(table_path, FileAccess::WRITE);
+	ERR_FAIL_COND_V_MSG(file.is_null(), false, "SpriteRepacker: cannot write " + table_path);
+	file->store_buffer(buffer);
+	return true;
+}
+
+// ------------------ REPORT --------------------
+static double decode_msec(const std::vector<String>& paths) {
+	uint64_t start = Time::get_singleton()->get_ticks_usec();
+	for (const String& path : paths) {
+		Ref<Image> image = Image::load_from_file(path);
+	}
+	return double(Time::get_singleton()->get_ticks_usec() - start) / 1000.0;
+}
+
+void SpriteRepacker::report(const Character& character, const std::vector<String>& page_paths) {
+	int64_t lod_bytes[4] = {};
+	for (int lod = 0; lod < lod_count; lod++) {
+		for (const Vector2i& size : character.page_sizes) {
+			lod_bytes[lod] += (int64_t)(size.x >> lod) * (size.y >> lod) * 4;
+		}
+	}
+	int64_t packed_bytes = lod_bytes[0];
+
+	std::vector<String> lod0_paths(page_paths.begin(), page_paths.begin() + character.page_sizes.size());
+
+	int empty = 0;
+	for (const Frame& frame : character.frames) {
+		empty += frame.unique < 0;
+	}
+
+	double before_ms = decode_msec(character.sheets);
+	double after_ms = decode_msec(lod0_paths);
+
+	Godot::print("SpriteRepacker " + character.name + ": " + String::num_int64(character.frames.size()) + " frames, "
+			+ String::num_int64(character.uniques.size()) + " unique, " + String::num_int64(empty) + " empty, "
+			+ String::num_int64(character.page_sizes.size()) + " page(s)");
+	Godot::print("  decoded " + String::num(character.source_bytes / 1048576.0, 1) + " MB -> "
+			+ String::num(packed_bytes / 1048576.0, 1) + " MB ("
+			+ String::num(character.source_bytes ? 100.0 * packed_bytes / character.source_bytes : 0.0, 1) + "%)");
+	Godot::print("  PNG decode " + String::num(before_ms, 1) + " ms -> " + String::num(after_ms, 1) + " ms");
+	for (int lod = 0; lod < lod_count; lod++) {
+		Godot::print("  LOD " + String::num_int64(lod) + " (1/" + String::num_int64(1 << lod) + "): "
+				+ String::num(lod_bytes[lod] / 1048576.0, 2) + " MB resident");
+	}
+}
@@ -0,0 +1,136 @@
+#include "stage_collision.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace godot;
+
+struct SolidRect {
+	float min_x, min_y, max_x, max_y;
+};
+
+static void collect_tiles(TileMapLayer* layer, uint32_t collision_mask, const Transform2D& to_space, std::vector<SolidRect>& out) {
+	Ref<TileSet> tile_set = layer->get_tile_set();
+	if (tile_set.is_null()) return;
+
+	Transform2D transform = to_space * layer->get_global_transform();
+	TypedArray<Vector2i> cells = layer->get_used_cells();
+
+	for (int physics = 0; physics < tile_set->get_physics_layers_count(); physics++) {
+		if (!(tile_set->get_physics_layer_collision_layer(physics) & collision_mask)) continue;
+
+		for (int i = 0; i < cells.size(); i++) {
+			Vector2i coords = cells[i];
+			TileData* data = layer->get_cell_tile_data(coords);
+			if (!data) continue;
+
+			Vector2 center = layer->map_to_local(coords);
+			for (int p = 0; p < data->get_collision_polygons_count(physics); p++) {
+				PackedVector2Array points = data->get_collision_polygon_points(physics, p);
+				if (points.is_empty()) continue;
+
+				Rect2 bounds(transform.xform(center + points[0]), Vector2());
+				for (int k = 1; k < points.size(); k++) {
+					bounds.expand_to(transform.xform(center + points[k]));
+				}
+				out.push_back(SolidRect{ bounds.position.x, bounds.position.y, bounds.position.x + bounds.size.x, bounds.position.y + bounds.size.y });
+			}
+		}
+	}
+}
+
+static void bounds_of(const Transform2D& transform, const PackedVector2Array& points, std::vector<SolidRect>& out) {
+	Rect2 bounds(transform.xform(points[0]), Vector2());
+	for (int k = 1; k < points.size(); k++) {
+		bounds.expand_to(transform.xform(points[k]));
+	}
+	out.push_back(SolidRect{ bounds.position.x, bounds.position.y, bounds.position.x + bounds.size.x, bounds.position.y + bounds.size.y });
+}
+
+static void collect_shape(CollisionShape2D* shape_node, uint32_t collision_mask, const Transform2D& to_space, std::vector<SolidRect>& rects, RaycastService& service) {
+	CollisionObject2D* body = Object::cast_to<CollisionObject2D>(shape_node->get_parent());
+	if (!body || !(body->get_collision_layer() & collision_mask) || shape_node->is_disabled()) return;
+
+	Transform2D transform = to_space * shape_node->get_global_transform();
+
+	Ref<RectangleShape2D> rect = shape_node->get_shape();
+	if (rect.is_valid()) {
+		Vector2 half = rect->get_size() * 0.5f;
+		PackedVector2Array corners;
+		corners.push_back(Vector2(-half.x, -half.y));
+		corners.push_back(Vector2(half.x, -half.y));
+		corners.push_back(Vector2(half.x, half.y));
+		corners.push_back(Vector2(-half.x, half.y));
+		bounds_of(transform, corners, rects);
+		return;
+	}
+
+	Ref<WorldBoundaryShape2D> boundary = shape_node->get_shape();
+	if (boundary.is_null()) return;
+
+	Vector2 normal = transform.basis_xform(boundary->get_normal()).normalized();
+	float distance = boundary->get_distance() + normal.dot(transform.get_origin());
+	service.add_boundary(normal.x, normal.y, distance);
+}
+
+static void collect_polygon(CollisionPolygon2D* polygon, uint32_t collision_mask, const Transform2D& to_space, std::vector<SolidRect>& out) {
+	CollisionObject2D* body = Object::cast_to<CollisionObject2D>(polygon->get_parent());
+	if (!body || !(body->get_collision_layer() & collision_mask) || polygon->is_disabled()) return;
+
+	PackedVector2Array points = polygon->get_polygon();
+	if (points.is_empty()) return;
+
+	bounds_of(to_space * polygon->get_global_transform(), points, out);
+}
+
+static void walk(Node* node, uint32_t collision_mask, const Transform2D& to_space, std::vector<SolidRect>& rects, RaycastService& service) {
+	if (TileMapLayer* layer = Object::cast_to<TileMapLayer>(node)) {
+		if (layer->is_enabled() && layer->is_collision_enabled()) {
+			collect_tiles(layer, collision_mask, to_space, rects);
+		}
+	} else if (CollisionShape2D* shape = Object::cast_to<CollisionShape2D>(node)) {
+		collect_shape(shape, collision_mask, to_space, rects, service);
+	} else if (CollisionPolygon2D* polygon = Object::cast_to<CollisionPolygon2D>(node)) {
+		collect_polygon(polygon, collision_mask, to_space, rects);
+	}
+
+	for (int i = 0; i < node->get_child_count(); i++) {
+		walk(node->get_child(i), collision_mask, to_space, rects, service);
+	}
+}
+
+bool godot::bake_stage_collision(Node* stage, uint32_t collision_mask, float cell_size, RaycastService& service,
+		const Transform2D& to_space) {
+	ERR_FAIL_COND_V(!stage || cell_size <= 0.0f, false);
+
+	std::vector<SolidRect> rects;
+	service.clear_boundaries();
+	walk(stage, collision_mask, to_space, rects, service);
+
+	if (rects.empty()) {
+		service.get_grid().reset(0.0f, 0.0f, cell_size, 0, 0);
+		return true;
+	}
+
+	SolidRect extent = rects[0];
+	for (const SolidRect& r : rects) {
+		extent.min_x = std::fmin(extent.min_x, r.min_x);
+		extent.min_y = std::fmin(extent.min_y, r.min_y);
+		extent.max_x = std::fmax(extent.max_x, r.max_x);
+		extent.max_y = std::fmax(extent.max_y, r.max_y);
+	}
+
+	// One empty cell of margin all round
+	float origin_x = extent.min_x - cell_size;
+	float origin_y = extent.min_y - cell_size;
+	int width = (int)std::ceil((extent.max_x - origin_x) / cell_size) + 1;
+	int height = (int)std::ceil((extent.max_y - origin_y) / cell_size) + 1;
+
+	OccupancyGrid& grid = service.get_grid();
+	grid.reset(origin_x, origin_y, cell_size, width, height);
+	for (const SolidRect& r : rects) {
+		grid.fill_rect(r.min_x, r.min_y, r.max_x, r.max_y);
+	}
+
+	return true;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#ifndef STAGE_COLLISION_H
+#define STAGE_COLLISION_H
+
+#include <Godot.hpp>
+#include <Node.hpp>
+#include <TileMapLayer.hpp>
+#include <TileSet.hpp>
+#include <TileData.hpp>
+#include <CollisionObject2D.hpp>
+#include <CollisionShape2D.hpp>
+#include <CollisionPolygon2D.hpp>
+#include <WorldBoundaryShape2D.hpp>
+#include <RectangleShape2D.hpp>
+
+#include "raycast_service.h"
+
+namespace godot {
+
+    // ============================================================
+    // STAGE COLLISION BAKE
+    // Walks a stage's TileMapLayers, CollisionPolygon2Ds,
+    // RectangleShape2Ds and WorldBoundaryShape2Ds once and bakes whatever
+    // matches `collision_mask` into a RaycastService: tiles, body polygons
+    // and rects become solid grid cells (by their bounding box), world
+    // boundaries become half-planes. Bodies cover stages whose tile
+    // collision was merged (TileCollisionMerger, BackgroundBaker).
+    // `to_space` maps global coordinates into the space the grid is
+    // queried in: identity for global, a node's inverse global transform
+    // to query with that node's local positions.
+    // ============================================================
+    bool bake_stage_collision(Node* stage, uint32_t collision_mask, float cell_size, RaycastService& service,
+            const Transform2D& to_space = Transform2D());
+
+} // namespace godot
+
+#endif
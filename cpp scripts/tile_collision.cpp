@@ -0,0 +1,177 @@
+#include "tile_collision.h"
+
+#include <cmath>
+
+using namespace godot;
+
+// ------------------ MERGE --------------------
+// All corners of the bounding box present and every point on one of them
+static bool is_box(const PackedVector2Array& points, const Rect2& box, float tolerance) {
+	Vector2 end = box.get_end();
+	int corners = 0;
+
+	for (int k = 0; k < points.size(); k++) {
+		Vector2 p = points[k];
+		bool left = Math::abs(p.x - box.position.x) <= tolerance;
+		bool right = Math::abs(p.x - end.x) <= tolerance;
+		bool top = Math::abs(p.y - box.position.y) <= tolerance;
+		bool bottom = Math::abs(p.y - end.y) <= tolerance;
+		if (!(left || right) || !(top || bottom)) return false;
+
+		corners |= (left ? 1 : 2) << (top ? 0 : 2);
+	}
+	return corners == 15;
+}
+
+void godot::merge_tile_collision(TileMapLayer* layer, int physics_layer, const Transform2D& to_space, float tolerance, MergedCollision& out) {
+	out = MergedCollision();
+
+	std::vector<MergeRect> boxes;
+	TypedArray<Vector2i> cells = layer->get_used_cells();
+
+	for (int i = 0; i < cells.size(); i++) {
+		Vector2i cell = cells[i];
+		TileData* data = layer->get_cell_tile_data(cell);
+		if (!data) continue;
+
+		Vector2 center = layer->map_to_local(cell);
+		for (int p = 0; p < data->get_collision_polygons_count(physics_layer); p++) {
+			PackedVector2Array points = data->get_collision_polygon_points(physics_layer, p);
+			if (points.size() < 3) continue;
+			out.source_polygons++;
+
+			for (int k = 0; k < points.size(); k++) {
+				points.set(k, to_space.xform(center + points[k]));
+			}
+
+			Rect2 box(points[0], Vector2());
+			for (int k = 1; k < points.size(); k++) {
+				box.expand_to(points[k]);
+			}
+
+			bool one_way = data->is_collision_polygon_one_way(physics_layer, p);
+			if (!one_way && is_box(points, box, tolerance)) {
+				boxes.push_back(MergeRect{ box.position.x, box.position.y, box.get_end().x, box.get_end().y });
+			} else {
+				out.polygons.push_back(points);
+				out.one_way.push_back(one_way);
+			}
+		}
+	}
+
+	if (!merge_rects(boxes, out.rects)) {
+		WARN_PRINT("merge_tile_collision: " + String(layer->get_name()) + " too irregular to merge, rects kept per tile");
+	}
+}
+
+Transform2D godot::root_transform(Node* node) {
+	Transform2D transform;
+	for (Node* n = node; n && n->get_parent(); n = n->get_parent()) {
+		if (Node2D* node_2d = Object::cast_to<Node2D>(n)) {
+			transform = node_2d->get_transform() * transform;
+		}
+	}
+	return transform;
+}
+
+StaticBody2D* godot::build_merged_body(const MergedCollision& merged, uint32_t collision_layer, uint32_t collision_mask) {
+	if (merged.rects.empty() && merged.polygons.empty()) return nullptr;
+
+	StaticBody2D* body = memnew(StaticBody2D);
+	body->set_collision_layer(collision_layer);
+	body->set_collision_mask(collision_mask);
+
+	for (const MergeRect& r : merged.rects) {
+		Ref<RectangleShape2D> rect;
+		rect.instantiate();
+		rect->set_size(Vector2(r.max_x - r.min_x, r.max_y - r.min_y));
+
+		CollisionShape2D* shape = memnew(CollisionShape2D);
+		shape->set_shape(rect);
+		shape->set_position(Vector2((r.min_x + r.max_x) * 0.5f, (r.min_y + r.max_y) * 0.5f));
+		body->add_child(shape);
+	}
+
+	for (size_t i = 0; i < merged.polygons.size(); i++) {
+		CollisionPolygon2D* polygon = memnew(CollisionPolygon2D);
+		polygon->set_polygon(merged.polygons[i]);
+		polygon->set_one_way_collision(merged.one_way[i]);
+		body->add_child(polygon);
+	}
+	return body;
+}
+
+// ------------------ MERGER NODE --------------------
+void TileCollisionMerger::_register_methods() {
+	register_method("_ready", &TileCollisionMerger::_ready);
+	register_method("get_stats", &TileCollisionMerger::get_stats);
+
+	register_property<TileCollisionMerger, NodePath>("stage_path", &TileCollisionMerger::stage_path, NodePath(".."));
+	register_property<TileCollisionMerger, float>("tolerance", &TileCollisionMerger::tolerance, 0.5f);
+}
+
+void TileCollisionMerger::_init() {
+	stage_path = NodePath("..");
+	tolerance = 0.5f;
+
+	source_shapes = 0;
+	merged_shapes = 0;
+	bodies = 0;
+}
+
+void TileCollisionMerger::_ready() {
+	Node* stage = get_node_or_null(stage_path);
+	ERR_FAIL_COND_MSG(!stage, "TileCollisionMerger: stage_path does not resolve");
+	merge(stage);
+}
+
+int TileCollisionMerger::merge(Node* stage) {
+	int before = bodies;
+	walk(stage);
+	return bodies - before;
+}
+
+void TileCollisionMerger::walk(Node* node) {
+	if (TileMapLayer* layer = Object::cast_to<TileMapLayer>(node)) {
+		if (layer->is_enabled() && layer->is_collision_enabled() && layer->get_tile_set().is_valid()) {
+			merge_layer(layer);
+		}
+	}
+
+	for (int i = 0; i < node->get_child_count(); i++) {
+		walk(node->get_child(i));
+	}
+}
+
+void TileCollisionMerger::merge_layer(TileMapLayer* layer) {
+	Ref<TileSet> tile_set = layer->get_tile_set();
+	bool replaced = false;
+
+	for (int physics = 0; physics < tile_set->get_physics_layers_count(); physics++) {
+		MergedCollision merged;
+		merge_tile_collision(layer, physics, layer->get_transform(), tolerance, merged);
+
+		StaticBody2D* body = build_merged_body(merged,
+				tile_set->get_physics_layer_collision_layer(physics), tile_set->get_physics_layer_collision_mask(physics));
+		source_shapes += merged.source_polygons;
+		if (!body) continue;
+
+		body->set_name(String(layer->get_name()) + "_merged_" + String::num_int64(physics));
+		layer->get_parent()->call_deferred("add_child", body);
+		merged_shapes += body->get_child_count();
+		bodies++;
+		replaced = true;
+	}
+
+	if (replaced) {
+		layer->call_deferred("set_collision_enabled", false);
+	}
+}
+
+Dictionary TileCollisionMerger::get_stats() const {
+	Dictionary result;
+	result["source_shapes"] = (int64_t)source_shapes;
+	result["merged_shapes"] = (int64_t)merged_shapes;
+	result["bodies"] = (int64_t)bodies;
+	return result;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#ifndef TILE_COLLISION_H
+#define TILE_COLLISION_H
+
+#include <Godot.hpp>
+#include <Node.hpp>
+#include <Node2D.hpp>
+#include <TileMapLayer.hpp>
+#include <TileSet.hpp>
+#include <TileData.hpp>
+#include <StaticBody2D.hpp>
+#include <CollisionShape2D.hpp>
+#include <CollisionPolygon2D.hpp>
+#include <RectangleShape2D.hpp>
+
+#include "rect_merge.h"
+
+#include <vector>
+
+namespace godot {
+
+    // ============================================================
+    // TILE COLLISION MERGE
+    // One physics layer of a TileMapLayer, transformed by `to_space`
+    // (the layer's transform for its parent's space).
+    // Polygons within `tolerance` of their bounding box count as solid
+    // rects and are merged; anything else (slopes, one-way platforms)
+    // is passed through unchanged.
+    // ============================================================
+    struct MergedCollision {
+        std::vector<MergeRect> rects;
+        std::vector<PackedVector2Array> polygons;
+        std::vector<bool> one_way;          // per polygon
+        int source_polygons = 0;
+    };
+
+    void merge_tile_collision(TileMapLayer* layer, int physics_layer, const Transform2D& to_space, float tolerance, MergedCollision& out);
+
+    // Node2D transform from `node` into its topmost ancestor's space,
+    // worked out by hand so it also holds for scenes instanced outside
+    // the tree (offline bakers)
+    Transform2D root_transform(Node* node);
+
+    // One StaticBody2D holding `merged` as RectangleShape2Ds and
+    // CollisionPolygon2Ds; null if there is nothing to hold. The caller
+    // adds it to the tree.
+    StaticBody2D* build_merged_body(const MergedCollision& merged, uint32_t collision_layer, uint32_t collision_mask);
+
+    // ============================================================
+    // TILE COLLISION MERGER
+    // Load-time version: on _ready, every collision-enabled TileMapLayer
+    // under `stage_path` (default: parent) gets its tile shapes replaced by
+    // one merged StaticBody2D per physics layer, added next to it, and
+    // its own per-tile bodies switched off. Both happen deferred, in the
+    // same flush, since the stage is still setting up its children.
+    // ============================================================
+    class TileCollisionMerger : public Node {
+        GODOT_CLASS(TileCollisionMerger, Node)
+
+    public:
+        static void _register_methods();
+
+        void _init() override;
+        void _ready() override;
+
+        NodePath stage_path;
+        float tolerance;
+
+        int merge(Node* stage);
+
+        int get_source_shapes() const { return source_shapes; }
+        int get_merged_shapes() const { return merged_shapes; }
+        int get_bodies() const { return bodies; }
+        Dictionary get_stats() const;
+
+    private:
+        int source_shapes;
+        int merged_shapes;
+        int bodies;
+
+        void merge_layer(TileMapLayer* layer);
+        void walk(Node* node);
+    };
+
+} // namespace godot
+
+#endif
@@ -0,0 +1,164 @@
+#include "timer_wheel.h"
+
+using namespace godot;
+
+TimerWheel::TimerWheel() {
+	clear();
+}
+
+void TimerWheel::clear() {
+	for (int level = 0; level < LEVELS; level++) {
+		for (int slot = 0; slot < SLOTS; slot++) {
+			heads[level][slot] = NIL;
+		}
+	}
+
+	for (int i = 0; i < CAPACITY; i++) {
+		nodes[i] = Node();
+		nodes[i].next = i + 1 < CAPACITY ? (uint16_t)(i + 1) : NIL;
+		nodes[i].generation = 0;
+		nodes[i].active = 0;
+	}
+
+	free_head = 0;
+	active_count = 0;
+	now = 0;
+	next_sequence = 0;
+}
+
+// ------------------ SCHEDULE / CANCEL --------------------
+TimerHandle TimerWheel::schedule(uint32_t delay_frames, const TimerEvent& event) {
+	TimerHandle handle;
+	if (free_head == NIL) return handle;
+
+	if (delay_frames == 0) delay_frames = 1;
+	if (delay_frames > MAX_DELAY) delay_frames = MAX_DELAY;
+
+	uint16_t index = free_head;
+	Node& node = nodes[index];
+	free_head = node.next;
+
+	node.deadline = now + delay_frames;
+	node.sequence = next_sequence++;
+	node.event = event;
+	node.active = 1;
+	active_count++;
+	place(index);
+
+	handle.index = index;
+	handle.generation = node.generation;
+	return handle;
+}
+
+bool TimerWheel::cancel(TimerHandle& handle) {
+	bool was_active = is_active(handle);
+	if (was_active) {
+		unlink(handle.index);
+		release(handle.index);
+	}
+
+	handle = TimerHandle();
+	return was_active;
+}
+
+bool TimerWheel::is_active(TimerHandle handle) const {
+	return handle.is_valid() && handle.index < CAPACITY &&
+			nodes[handle.index].active && nodes[handle.index].generation == handle.generation;
+}
+
+uint32_t TimerWheel::get_remaining(TimerHandle handle) const {
+	return is_active(handle) ? nodes[handle.index].deadline - now : 0;
+}
+
+// ------------------ WHEEL --------------------
+void TimerWheel::place(uint16_t index) {
+	Node& node = nodes[index];
+	uint32_t delta = node.deadline - now;
+
+	int level = 0;
+	if (delta >= (uint32_t)SLOTS * SLOTS) level = 2;
+	else if (delta >= (uint32_t)SLOTS) level = 1;
+
+	node.level = (uint8_t)level;
+	node.slot = (uint8_t)((node.deadline >> (SLOT_BITS * level)) & (SLOTS - 1));
+
+	// Keep each slot in scheduling order. A fresh timer is always the
+	// newest and appends; a cascaded one can be older than timers that
+	// went straight into this slot, so it walks back from the tail.
+	uint16_t& head = heads[level][node.slot];
+	if (head == NIL) {
+		node.prev = index;
+		node.next = NIL;
+		head = index;
+		return;
+	}
+
+	uint16_t tail = nodes[head].prev;
+	uint16_t after = tail;
+	while (after != NIL && (int32_t)(nodes[after].sequence - node.sequence) > 0) {
+		after = after == head ? NIL : nodes[after].prev;
+	}
+
+	if (after == NIL) {
+		node.prev = tail;
+		node.next = head;
+		nodes[head].prev = index;
+		head = index;
+	} else {
+		node.prev = after;
+		node.next = nodes[after].next;
+		if (node.next != NIL) nodes[node.next].prev = index;
+		else nodes[head].prev = index;
+		nodes[after].next = index;
+	}
+}
+
+void TimerWheel::unlink(uint16_t index) {
+	Node& node = nodes[index];
+	uint16_t& head = heads[node.level][node.slot];
+
+	if (head == index) {
+		head = node.next;
+		if (head != NIL) nodes[head].prev = node.prev;
+	} else {
+		nodes[node.prev].next = node.next;
+		if (node.next != NIL) nodes[node.next].prev = node.prev;
+		else nodes[head].prev = node.prev;
+	}
+}
+
+void TimerWheel::release(uint16_t index) {
+	Node& node = nodes[index];
+	node.active = 0;
+	node.generation++;
+	node.next = free_head;
+	free_head = index;
+	active_count--;
+}
+
+void TimerWheel::cascade(int level, int slot) {
+	uint16_t index = heads[level][slot];
+	heads[level][slot] = NIL;
+
+	while (index != NIL) {
+		uint16_t next = nodes[index].next;
+		place(index);
+		index = next;
+	}
+}
+
+// ------------------ SNAPSHOT --------------------
+uint64_t TimerWheel::hash(uint64_t h) const {
+	// Only what changes behaviour: which timers are pending, when, and what they fire
+	for (int i = 0; i < CAPACITY; i++) {
+		const Node& node = nodes[i];
+		if (!node.active) continue;
+
+		uint64_t fields[4] = { (uint64_t)i, node.deadline - now, node.event.kind | ((uint64_t)node.event.target << 16), (uint64_t)(uint32_t)node.event.arg };
+		for (uint64_t field : fields) {
+			h ^= field;
+			h *= 1099511628211ull;
+		}
+	}
+	return h;
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <cstdint>
+
+namespace godot {
+
+    // ============================================================
+    // TIMER HANDLE / EVENT
+    // ============================================================
+    struct TimerHandle {
+        uint16_t index = 0xFFFF;
+        uint16_t generation = 0;
+
+        bool is_valid() const { return index != 0xFFFF; }
+    };
+
+    // What fires. Kind and target are owner-defined (fighter slot,
+    // listener id...), so no function pointers live in the wheel and
+    // a copy of it is a complete snapshot.
+    struct TimerEvent {
+        uint16_t kind = 0;
+        uint16_t target = 0;
+        int32_t arg = 0;
+    };
+
+    // ============================================================
+    // TIMER WHEEL
+    // Frame-based, three levels of 64 slots (64 / 4096 / 262144 frames).
+    // schedule() and cancel() are O(1); advance() touches one level-0
+    // slot per frame plus an occasional cascade. Fixed capacity, no
+    // allocation, trivially copyable.
+    // ============================================================
+    class TimerWheel {
+    public:
+        static const int CAPACITY = 256;
+        static const int SLOT_BITS = 6;
+        static const int SLOTS = 1 << SLOT_BITS;
+        static const int LEVELS = 3;
+        static const uint32_t MAX_DELAY = (1u << (SLOT_BITS * LEVELS)) - (1u << (SLOT_BITS * 2));
+
+        TimerWheel();
+
+        void clear();
+
+        // delay_frames of 0 is treated as 1: it fires on the next advance()
+        TimerHandle schedule(uint32_t delay_frames, const TimerEvent& event);
+        bool cancel(TimerHandle& handle);
+
+        bool is_active(TimerHandle handle) const;
+        uint32_t get_remaining(TimerHandle handle) const;
+
+        // Advance one frame and call callback(const TimerEvent&) for every
+        // timer that expires, in scheduling order (cascaded timers are
+        // merged back into order by their sequence number). Callbacks may
+        // schedule or cancel timers.
+        template <typename F>
+        void advance(F&& callback) {
+            now++;
+
+            if ((now & (SLOTS * SLOTS - 1)) == 0) cascade(2, (now >> (SLOT_BITS * 2)) & (SLOTS - 1));
+            if ((now & (SLOTS - 1)) == 0) cascade(1, (now >> SLOT_BITS) & (SLOTS - 1));
+
+            uint16_t& head = heads[0][now & (SLOTS - 1)];
+            while (head != NIL) {
+                uint16_t index = head;
+                unlink(index);
+
+                TimerEvent event = nodes[index].event;
+                release(index);
+                callback(event);
+            }
+        }
+
+        uint32_t get_frame() const { return now; }
+        int get_active_count() const { return active_count; }
+
+        uint64_t hash(uint64_t h) const;
+
+    private:
+        static const uint16_t NIL = 0xFFFF;
+
+        struct Node {
+            uint32_t deadline;
+            uint32_t sequence;                  // schedule() order, kept through cascades
+            TimerEvent event;
+            uint16_t prev;
+            uint16_t next;
+            uint16_t generation;
+            uint8_t level;
+            uint8_t active;
+            uint8_t slot;
+        };
+
+        Node nodes[CAPACITY];
+        uint16_t heads[LEVELS][SLOTS];
+        uint16_t free_head;
+        int active_count;
+        uint32_t now;
+        uint32_t next_sequence;
+
+        void place(uint16_t index);
+        void unlink(uint16_t index);
+        void release(uint16_t index);
+        void cascade(int level, int slot);
+    };
+
+} // namespace godot
+
+#endif
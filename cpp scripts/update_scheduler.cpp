@@ -0,0 +1,264 @@
+#include "update_scheduler.h"
+
+#include <algorithm>
+
+using namespace godot;
+
+// After every entity's own _process (see the header)
+static const int LATE_PRIORITY = 1 << 20;
+
+static const char* const BUCKET_NAMES[BUCKET_COUNT] = { "on_screen", "near", "far", "distant" };
+
+UpdateScheduler::UpdateScheduler() {}
+UpdateScheduler::~UpdateScheduler() {}
+
+void UpdateScheduler::_register_methods() {
+	register_method("_ready", &UpdateScheduler::_ready);
+	register_method("_process", &UpdateScheduler::_process);
+
+	register_method("add_entity", &UpdateScheduler::add_entity);
+	register_method("remove_entity", &UpdateScheduler::remove_entity);
+	register_method("get_entity_count", &UpdateScheduler::get_entity_count);
+	register_method("get_bucket_count", &UpdateScheduler::get_bucket_count);
+	register_method("get_stats", &UpdateScheduler::get_stats);
+
+	register_property<UpdateScheduler, float>("margin", &UpdateScheduler::margin, 128.0f);
+	register_property<UpdateScheduler, float>("near_distance", &UpdateScheduler::near_distance, 800.0f);
+	register_property<UpdateScheduler, float>("far_distance", &UpdateScheduler::far_distance, 2400.0f);
+	register_property<UpdateScheduler, int>("near_period", &UpdateScheduler::near_period, 2);
+	register_property<UpdateScheduler, int>("far_period", &UpdateScheduler::far_period, 4);
+	register_property<UpdateScheduler, int>("distant_period", &UpdateScheduler::distant_period, 16);
+	register_property<UpdateScheduler, bool>("print_stats", &UpdateScheduler::print_stats, false);
+}
+
+void UpdateScheduler::_init() {
+	margin = 128.0f;
+	near_distance = 800.0f;
+	far_distance = 2400.0f;
+	near_period = 2;
+	far_period = 4;
+	distant_period = 16;
+	print_stats = false;
+
+	frame = 0;
+	for (int b = 0; b < BUCKET_COUNT; b++) {
+		periods[b] = 1;
+		bucket_counts[b] = 0;
+	}
+	lod_calls = 0;
+	skipped = 0;
+	lod_usec = 0;
+	window = 0.0;
+}
+
+void UpdateScheduler::_ready() {
+	set_process_priority(LATE_PRIORITY);
+	add_to_group("update_scheduler");
+}
+
+void UpdateScheduler::_process(double delta) {
+	update((float)delta);
+
+	if (!print_stats) return;
+
+	window += delta;
+	if (window >= 1.0) {
+		Dictionary stats = get_stats();
+		Godot::print("UpdateScheduler: " + String::num_int64(get_entity_count()) + " entities, "
+				+ String::num_int64(bucket_counts[BUCKET_ON_SCREEN]) + " on screen / "
+				+ String::num_int64(bucket_counts[BUCKET_NEAR]) + " near / "
+				+ String::num_int64(bucket_counts[BUCKET_FAR]) + " far / "
+				+ String::num_int64(bucket_counts[BUCKET_DISTANT]) + " distant, "
+				+ String::num_int64(lod_calls) + " lod updates in " + String::num((double)lod_usec, 0) + " us, "
+				+ String::num_int64(skipped) + " skipped, ~" + String::num((double)stats["saved_usec"], 0) + " us saved");
+		lod_calls = skipped = 0;
+		lod_usec = 0;
+		window -= 1.0;
+	}
+}
+
+// ------------------ ENTITIES --------------------
+int UpdateScheduler::add_entity(Node2D* entity) {
+	ERR_FAIL_COND_V(!entity, -1);
+
+	int id;
+	if (!free_ids.empty()) {
+		id = free_ids.back();
+		free_ids.pop_back();
+	} else {
+		id = (int)id_slots.size();
+		id_slots.push_back(-1);
+	}
+
+	uint64_t sprite = 0;
+	for (int i = 0; i < entity->get_child_count(); i++) {
+		AnimatedSprite2D* child = Object::cast_to<AnimatedSprite2D>(entity->get_child(i));
+		if (child) {
+			sprite = child->get_instance_id();
+			break;
+		}
+	}
+
+	// Starts on screen: the first update() moves it if it isn't
+	id_slots[id] = (int)owners.size();
+	owners.push_back(entity->get_instance_id());
+	sprites.push_back(sprite);
+	buckets.push_back(BUCKET_ON_SCREEN);
+	has_lod.push_back(entity->has_method("_lod_process"));
+	paused.push_back(0);
+	pending.push_back(0.0f);
+	slot_ids.push_back(id);
+
+	return id;
+}
+
+int UpdateScheduler::index_of(int id) const {
+	if (id < 0 || id >= (int)id_slots.size()) return -1;
+	return id_slots[id];
+}
+
+void UpdateScheduler::remove_entity(int id) {
+	int slot = index_of(id);
+	ERR_FAIL_COND(slot < 0);
+
+	// Hand it back the way it came
+	Node2D* entity = Object::cast_to<Node2D>(ObjectDB::get_instance(owners[slot]));
+	if (entity && buckets[slot] != BUCKET_ON_SCREEN) {
+		set_on_screen(slot, entity, true);
+	}
+	remove_slot(slot);
+}
+
+void UpdateScheduler::remove_slot(int slot) {
+	int last = (int)owners.size() - 1;
+	int id = slot_ids[slot];
+
+	// Keep the arrays dense: move the last entity into the hole
+	if (slot != last) {
+		owners[slot] = owners[last];
+		sprites[slot] = sprites[last];
+		buckets[slot] = buckets[last];
+		has_lod[slot] = has_lod[last];
+		paused[slot] = paused[last];
+		pending[slot] = pending[last];
+		slot_ids[slot] = slot_ids[last];
+		id_slots[slot_ids[slot]] = slot;
+	}
+
+	owners.pop_back();
+	sprites.pop_back();
+	buckets.pop_back();
+	has_lod.pop_back();
+	paused.pop_back();
+	pending.pop_back();
+	slot_ids.pop_back();
+
+	id_slots[id] = -1;
+	free_ids.push_back(id);
+}
+
+int UpdateScheduler::get_bucket_count(int bucket) const {
+	ERR_FAIL_INDEX_V(bucket, BUCKET_COUNT, 0);
+	return bucket_counts[bucket];
+}
+
+// ------------------ UPDATE --------------------
+void UpdateScheduler::set_on_screen(int slot, Node2D* entity, bool on_screen) {
+	entity->set_process(on_screen);
+
+	AnimatedSprite2D* sprite = Object::cast_to<AnimatedSprite2D>(ObjectDB::get_instance(sprites[slot]));
+	if (!sprite) return;
+
+	if (on_screen) {
+		if (paused[slot]) sprite->play();
+		paused[slot] = 0;
+	} else if (sprite->is_playing()) {
+		sprite->pause();
+		paused[slot] = 1;
+	}
+}
+
+void UpdateScheduler::call_lod(int slot, Node2D* entity) {
+	if (has_lod[slot] && pending[slot] > 0.0f) {
+		uint64_t start = Time::get_singleton()->get_ticks_usec();
+		entity->call("_lod_process", pending[slot]);
+		lod_usec += Time::get_singleton()->get_ticks_usec() - start;
+		lod_calls++;
+	}
+	pending[slot] = 0.0f;
+}
+
+void UpdateScheduler::update(float delta) {
+	periods[BUCKET_NEAR] = std::max(near_period, 1);
+	periods[BUCKET_FAR] = std::max(far_period, 1);
+	periods[BUCKET_DISTANT] = std::max(distant_period, 1);
+	for (int b = 0; b < BUCKET_COUNT; b++) {
+		bucket_counts[b] = 0;
+	}
+
+	// The camera's view in world space
+	Rect2 view = get_viewport()->get_visible_rect();
+	Rect2 world = get_viewport()->get_canvas_transform().affine_inverse().xform(view).grow(margin);
+	const float near_sq = near_distance * near_distance;
+	const float far_sq = far_distance * far_distance;
+
+	// Backwards, so swap-removal of freed entities doesn't skip anyone
+	for (int slot = (int)owners.size() - 1; slot >= 0; slot--) {
+		Node2D* entity = Object::cast_to<Node2D>(ObjectDB::get_instance(owners[slot]));
+		if (!entity) {
+			remove_slot(slot);
+			continue;
+		}
+		// Parked by a pool or paused with the tree: no time passes for it
+		if (!entity->can_process()) continue;
+
+		Vector2 p = entity->get_global_position();
+		float dx = std::max(std::max(world.position.x - p.x, p.x - (world.position.x + world.size.x)), 0.0f);
+		float dy = std::max(std::max(world.position.y - p.y, p.y - (world.position.y + world.size.y)), 0.0f);
+		float distance_sq = dx * dx + dy * dy;
+
+		uint8_t bucket = distance_sq <= 0.0f ? BUCKET_ON_SCREEN
+				: distance_sq <= near_sq ? BUCKET_NEAR
+				: distance_sq <= far_sq ? BUCKET_FAR
+				: BUCKET_DISTANT;
+		bucket_counts[bucket]++;
+
+		uint8_t previous = buckets[slot];
+		buckets[slot] = bucket;
+
+		if (previous == BUCKET_ON_SCREEN) {
+			// Its own _process already ran this frame
+			if (bucket != BUCKET_ON_SCREEN) set_on_screen(slot, entity, false);
+			continue;
+		}
+
+		pending[slot] += delta;
+		if (bucket == BUCKET_ON_SCREEN) {
+			call_lod(slot, entity);
+			set_on_screen(slot, entity, true);
+			continue;
+		}
+
+		if ((frame + (uint64_t)slot_ids[slot]) % periods[bucket] != 0) {
+			skipped++;
+			continue;
+		}
+		call_lod(slot, entity);
+	}
+
+	frame++;
+}
+
+Dictionary UpdateScheduler::get_stats() const {
+	Dictionary stats;
+	stats["entities"] = get_entity_count();
+	for (int b = 0; b < BUCKET_COUNT; b++) {
+		stats[BUCKET_NAMES[b]] = bucket_counts[b];
+	}
+	stats["lod_updates"] = lod_calls;
+	stats["skipped_updates"] = skipped;
+	stats["lod_usec"] = (int64_t)lod_usec;
+	// What the skipped updates would have cost at the measured rate
+	stats["saved_usec"] = lod_calls ? (double)lod_usec / lod_calls * skipped : 0.0;
+	return stats;
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#ifndef UPDATE_SCHEDULER_H
+#define UPDATE_SCHEDULER_H
+
+#include <Godot.hpp>
+#include <Node.hpp>
+#include <Node2D.hpp>
+#include <AnimatedSprite2D.hpp>
+#include <Viewport.hpp>
+#include <Time.hpp>
+
+#include <vector>
+
+namespace godot {
+
+    enum UpdateBucket : uint8_t {
+        BUCKET_ON_SCREEN,       // own _process, every frame
+        BUCKET_NEAR,            // within near_distance of the view
+        BUCKET_FAR,             // within far_distance
+        BUCKET_DISTANT,
+        BUCKET_COUNT
+    };
+
+    // ============================================================
+    // UPDATE SCHEDULER
+    // Distance-based update rate for enemies and pickups. Every frame
+    // each registered entity is bucketed by its distance to the
+    // camera's view rect (the viewport's canvas transform, so whatever
+    // CameraController did to the Camera2D's position and zoom counts).
+    // On screen it runs its own _process as usual. Off screen its
+    // _process is switched off, its AnimatedSprite2D paused, and this
+    // node calls its _lod_process(delta) once every near / far /
+    // distant_period frames with all the delta since its last update.
+    // An entity updates on frames where (frame + id) % period == 0, so a
+    // bucket's work is spread evenly over its period.
+    // This node processes after everything else: an entity coming on
+    // screen gets its outstanding delta (this frame's included) in one
+    // last _lod_process before its own _process takes over next frame,
+    // so it has always been advanced by exactly the elapsed time, and
+    // where it is depends only on the frame deltas and the camera path.
+    // Scenes register with add_entity(self) (found through the
+    // "update_scheduler" group) and leave with remove_entity(id); freed
+    // entities drop out on their own. Entities without _lod_process
+    // just stop processing and animating while off screen.
+    // ============================================================
+    class UpdateScheduler : public Node {
+        GODOT_CLASS(UpdateScheduler, Node)
+
+    public:
+        UpdateScheduler();
+        ~UpdateScheduler();
+
+        static void _register_methods();
+
+        void _init() override;
+        void _ready() override;
+        void _process(double delta) override;
+
+        // ============================================================
+        // SETTINGS
+        // ============================================================
+        float margin;               // px around the view still counted on screen
+        float near_distance;
+        float far_distance;
+        int near_period;            // frames between updates
+        int far_period;
+        int distant_period;
+        bool print_stats;           // once a second
+
+        // ============================================================
+        // ENTITIES
+        // ============================================================
+        int add_entity(Node2D* entity);
+        void remove_entity(int id);
+        int get_entity_count() const { return (int)owners.size(); }
+        int get_bucket_count(int bucket) const;
+
+        void update(float delta);
+        Dictionary get_stats() const;
+
+    private:
+        // Packed, index = dense slot
+        std::vector<uint64_t> owners;       // ObjectID
+        std::vector<uint64_t> sprites;      // first AnimatedSprite2D child, 0 if none
+        std::vector<uint8_t> buckets;
+        std::vector<uint8_t> has_lod;       // implements _lod_process
+        std::vector<uint8_t> paused;        // sprite paused by us
+        std::vector<float> pending;         // delta not yet given to the entity
+        std::vector<int> slot_ids;
+
+        // id -> dense slot, -1 when free
+        std::vector<int> id_slots;
+        std::vector<int> free_ids;
+
+        int periods[BUCKET_COUNT];
+        uint64_t frame;
+
+        // Stats, reset every second when print_stats is on
+        int bucket_counts[BUCKET_COUNT];
+        int64_t lod_calls;
+        int64_t skipped;
+        uint64_t lod_usec;
+        double window;
+
+        int index_of(int id) const;
+        void remove_slot(int slot);
+        void set_on_screen(int slot, Node2D* entity, bool on_screen);
+        void call_lod(int slot, Node2D* entity);
+    };
+
+} // namespace godot
+
+#endif
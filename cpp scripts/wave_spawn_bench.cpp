@@ -0,0 +1,201 @@
+// Spawn-frame cost of a survival wave, all at once vs time-sliced.
+// Add a WaveSpawnBench node to an empty scene, set enemy_scene to
+// enemy.tscn and run it. It spawns one wave of wave_size enemies three
+// ways, a second apart: instantiated in a single frame, instantiated
+// through a WaveSpawner with budget_usec, and activated from a prewarmed
+// ScenePool through the same WaveSpawner. For each it prints the worst
+// frame's spawn time, how many frames the wave took and how many of
+// them went over budget.
+
+#include <Godot.hpp>
+#include <Node2D.hpp>
+#include <PackedScene.hpp>
+#include <Time.hpp>
+
+#include "scene_pool.h"
+#include "wave_spawner.h"
+
+#include <algorithm>
+
+namespace godot {
+
+    class WaveSpawnBench : public Node2D {
+        GODOT_CLASS(WaveSpawnBench, Node2D)
+
+    public:
+        static void _register_methods();
+
+        void _init() override;
+        void _ready() override;
+        void _process(double delta) override;
+
+        Ref<PackedScene> enemy_scene;
+        int wave_size;
+        int budget_usec;
+
+    private:
+        enum Phase {
+            PHASE_BURST,
+            PHASE_SLICED,
+            PHASE_POOLED,
+            PHASE_DONE,
+        };
+
+        int phase;
+        double wait;
+        bool running;
+        int64_t phase_frames;
+        int64_t worst_usec;
+
+        Node2D* container;
+        ScenePool* empty_pool;
+        ScenePool* full_pool;
+        WaveSpawner* instancer;
+        WaveSpawner* activator;
+
+        PackedVector2Array wave_positions() const;
+        void start_phase();
+        void end_phase(const String& name, WaveSpawner* spawner);
+    };
+
+} // namespace godot
+
+using namespace godot;
+
+void WaveSpawnBench::_register_methods() {
+	register_method("_ready", &WaveSpawnBench::_ready);
+	register_method("_process", &WaveSpawnBench::_process);
+
+	register_property<WaveSpawnBench, Ref<PackedScene>>("enemy_scene", &WaveSpawnBench::enemy_scene, Ref<PackedScene>());
+	register_property<WaveSpawnBench, int>("wave_size", &WaveSpawnBench::wave_size, 40);
+	register_property<WaveSpawnBench, int>("budget_usec", &WaveSpawnBench::budget_usec, 1500);
+}
+
+void WaveSpawnBench::_init() {
+	wave_size = 40;
+	budget_usec = 1500;
+
+	phase = PHASE_BURST;
+	wait = 1.0;
+	running = false;
+	phase_frames = 0;
+	worst_usec = 0;
+
+	container = nullptr;
+	empty_pool = nullptr;
+	full_pool = nullptr;
+	instancer = nullptr;
+	activator = nullptr;
+}
+
+void WaveSpawnBench::_ready() {
+	ERR_FAIL_COND_MSG(enemy_scene.is_null(), "WaveSpawnBench: set enemy_scene");
+
+	container = memnew(Node2D);
+	container->set_name("Spawned");
+	add_child(container);
+
+	// No free instances: every request instantiates
+	empty_pool = ScenePool::_new();
+	empty_pool->set_name("EmptyPool");
+	empty_pool->enemy_scene = enemy_scene;
+	empty_pool->enemy_count = 0;
+	add_child(empty_pool);
+
+	full_pool = ScenePool::_new();
+	full_pool->set_name("FullPool");
+	full_pool->enemy_scene = enemy_scene;
+	full_pool->enemy_count = wave_size;
+	add_child(full_pool);
+
+	instancer = WaveSpawner::_new();
+	instancer->pool_path = NodePath("../EmptyPool");
+	instancer->spawn_parent_path = NodePath("../Spawned");
+	activator = WaveSpawner::_new();
+	activator->pool_path = NodePath("../FullPool");
+
+	// Stepped from _process below, so each frame's cost is timed here
+	for (WaveSpawner* spawner : { instancer, activator }) {
+		spawner->budget_usec = budget_usec;
+		add_child(spawner);
+		spawner->set_process(false);
+	}
+
+	Godot::print("WaveSpawnBench: waves of " + String::num_int64(wave_size) + ", "
+			+ String::num_int64(budget_usec) + " us budget");
+}
+
+PackedVector2Array WaveSpawnBench::wave_positions() const {
+	PackedVector2Array positions;
+	for (int i = 0; i < wave_size; i++) {
+		positions.push_back(Vector2((i % 10) * 80.0f, (i / 10) * 140.0f));
+	}
+	return positions;
+}
+
+void WaveSpawnBench::start_phase() {
+	running = true;
+	phase_frames = 0;
+	worst_usec = 0;
+
+	if (phase == PHASE_BURST) {
+		uint64_t start = Time::get_singleton()->get_ticks_usec();
+		PackedVector2Array positions = wave_positions();
+		for (int i = 0; i < positions.size(); i++) {
+			Node2D* node = Object::cast_to<Node2D>(enemy_scene->instantiate());
+			ERR_FAIL_COND(!node);
+			container->add_child(node);
+			node->set_global_position(positions[i]);
+		}
+		worst_usec = (int64_t)(Time::get_singleton()->get_ticks_usec() - start);
+		phase_frames = 1;
+	} else {
+		WaveSpawner* spawner = phase == PHASE_SLICED ? instancer : activator;
+		spawner->queue_wave(POOL_ENEMY, wave_positions());
+	}
+}
+
+void WaveSpawnBench::end_phase(const String& name, WaveSpawner* spawner) {
+	String overruns = "-";
+	if (spawner) {
+		Dictionary stats = spawner->get_stats();
+		overruns = String::num_int64((int64_t)stats["overruns"]);
+	}
+	Godot::print("  " + name + ": worst frame " + String::num(worst_usec / 1000.0, 3) + " ms, "
+			+ String::num_int64(phase_frames) + " frames, " + overruns + " over budget");
+
+	for (int i = container->get_child_count() - 1; i >= 0; i--) {
+		container->get_child(i)->queue_free();
+	}
+	full_pool->release_all(POOL_ENEMY);
+
+	running = false;
+	wait = 1.0;
+	phase++;
+}
+
+void WaveSpawnBench::_process(double delta) {
+	if (phase >= PHASE_DONE || enemy_scene.is_null()) return;
+
+	if (!running) {
+		wait -= delta;
+		if (wait <= 0.0) start_phase();
+		return;
+	}
+
+	if (phase == PHASE_BURST) {
+		end_phase("burst instantiate", nullptr);
+		return;
+	}
+
+	// Same per-frame step the spawner's own _process would take
+	WaveSpawner* spawner = phase == PHASE_SLICED ? instancer : activator;
+	uint64_t start = Time::get_singleton()->get_ticks_usec();
+	spawner->_process(delta);
+	worst_usec = std::max(worst_usec, (int64_t)(Time::get_singleton()->get_ticks_usec() - start));
+	phase_frames++;
+
+	if (spawner->get_queue_depth() == 0) {
+		end_phase(phase == PHASE_SLICED ? "sliced instantiate" : "sliced pool activation", spawner);
+	}
+}
@@ -0,0 +1,277 @@
+#include "wave_spawner.h"
+
+#include <algorithm>
+
+using namespace godot;
+
+WaveSpawner::WaveSpawner() {}
+WaveSpawner::~WaveSpawner() {}
+
+void WaveSpawner::_register_methods() {
+	register_method("_ready", &WaveSpawner::_ready);
+	register_method("_process", &WaveSpawner::_process);
+
+	register_method("queue_wave", &WaveSpawner::queue_wave);
+	register_method("queue_spawn", &WaveSpawner::queue_spawn);
+	register_method("clear_queue", &WaveSpawner::clear_queue);
+	register_method("cancel_wave", &WaveSpawner::cancel_wave);
+	register_method("get_queue_depth", &WaveSpawner::get_queue_depth);
+	register_method("get_stats", &WaveSpawner::get_stats);
+
+	register_property<WaveSpawner, NodePath>("pool_path", &WaveSpawner::pool_path, NodePath());
+	register_property<WaveSpawner, NodePath>("spawn_parent_path", &WaveSpawner::spawn_parent_path, NodePath(".."));
+	register_property<WaveSpawner, int>("budget_usec", &WaveSpawner::budget_usec, 1500);
+	register_property<WaveSpawner, float>("on_screen_margin", &WaveSpawner::on_screen_margin, 64.0f);
+	register_property<WaveSpawner, bool>("instantiate_on_miss", &WaveSpawner::instantiate_on_miss, true);
+	register_property<WaveSpawner, bool>("print_stats", &WaveSpawner::print_stats, false);
+
+	register_signal<WaveSpawner>("spawned", "node", GODOT_VARIANT_TYPE_OBJECT);
+	register_signal<WaveSpawner>("wave_spawned", "wave", GODOT_VARIANT_TYPE_INT);
+}
+
+void WaveSpawner::_init() {
+	spawn_parent_path = NodePath("..");
+	budget_usec = 1500;
+	on_screen_margin = 64.0f;
+	instantiate_on_miss = true;
+	print_stats = false;
+
+	pool = nullptr;
+	spawn_parent = nullptr;
+	next_wave = 0;
+
+	expected_usec = 0.0;
+	spawned = 0;
+	activated = 0;
+	instantiated = 0;
+	dropped = 0;
+	frames = 0;
+	busy_frames = 0;
+	overruns = 0;
+	max_overrun_usec = 0;
+	max_depth = 0;
+	max_per_frame = 0;
+	spawn_usec = 0;
+	window = 0.0;
+}
+
+void WaveSpawner::_ready() {
+	add_to_group("wave_spawner");
+
+	// The source's owner hands out its own instances
+	if (!source) {
+		Node* pool_node = pool_path.is_empty() ? get_tree()->get_first_node_in_group("scene_pool") : get_node_or_null(pool_path);
+		pool = Object::cast_to<ScenePool>(pool_node);
+		if (!pool) {
+			WARN_PRINT("WaveSpawner: no ScenePool found, queued spawns will be dropped");
+		}
+	}
+
+	spawn_parent = get_node_or_null(spawn_parent_path);
+	if (!spawn_parent) spawn_parent = this;
+}
+
+void WaveSpawner::_process(double delta) {
+	frames++;
+	if (get_queue_depth() > 0) {
+		busy_frames++;
+		uint64_t start = Time::get_singleton()->get_ticks_usec();
+		int count = run(budget_usec);
+		int64_t spent = (int64_t)(Time::get_singleton()->get_ticks_usec() - start);
+
+		max_per_frame = std::max(max_per_frame, count);
+		if (spent > budget_usec) {
+			overruns++;
+			max_overrun_usec = std::max(max_overrun_usec, spent - budget_usec);
+		}
+	}
+
+	if (!print_stats) return;
+
+	window += delta;
+	if (window >= 1.0) {
+		Godot::print("WaveSpawner: queue " + String::num_int64(get_queue_depth()) + " (max "
+				+ String::num_int64(max_depth) + "), " + String::num_int64(spawned) + " spawned ("
+				+ String::num_int64(instantiated) + " instantiated), "
+				+ String::num(spawned ? (double)spawn_usec / spawned : 0.0, 1) + " us each, max "
+				+ String::num_int64(max_per_frame) + "/frame, " + String::num_int64(overruns) + "/"
+				+ String::num_int64(busy_frames) + " frames over budget (worst +"
+				+ String::num_int64(max_overrun_usec) + " us)");
+		window -= 1.0;
+	}
+}
+
+// ------------------ QUEUE --------------------
+int WaveSpawner::queue_wave(int kind, PackedVector2Array positions) {
+	if (!source) {
+		ERR_FAIL_INDEX_V(kind, POOL_KIND_COUNT, -1);
+	}
+	return push_wave(kind, positions.ptr(), (int)positions.size(), -1);
+}
+
+int WaveSpawner::queue_tagged(int kind, Vector2 position, int tag) {
+	return push_wave(kind, &position, 1, tag);
+}
+
+int WaveSpawner::push_wave(int kind, const Vector2* positions, int count, int tag) {
+	int wave = next_wave++;
+	if (count == 0) {
+		call_deferred("emit_signal", "wave_spawned", wave);
+		return wave;
+	}
+
+	Rect2 view = view_rect();
+	for (int i = 0; i < count; i++) {
+		Request request = { kind, wave, tag, positions[i] };
+		if (view.has_point(request.position)) {
+			visible.push_back(request);
+		} else {
+			hidden.push_back(request);
+		}
+	}
+	wave_remaining[wave] = count;
+	max_depth = std::max(max_depth, get_queue_depth());
+	return wave;
+}
+
+int WaveSpawner::queue_spawn(int kind, Vector2 position) {
+	PackedVector2Array positions;
+	positions.push_back(position);
+	return queue_wave(kind, positions);
+}
+
+void WaveSpawner::clear_queue() {
+	visible.clear();
+	hidden.clear();
+
+	// Swap out first: a wave_spawned handler may queue the next wave
+	std::unordered_map<int, int> waiting;
+	waiting.swap(wave_remaining);
+	for (const std::pair<const int, int>& wave : waiting) {
+		emit_signal("wave_spawned", wave.first);
+	}
+}
+
+void WaveSpawner::cancel_wave(int wave) {
+	auto found = wave_remaining.find(wave);
+	if (found == wave_remaining.end()) return;
+	wave_remaining.erase(found);
+
+	auto other_wave = [wave](const Request& request) { return request.wave != wave; };
+	visible.erase(std::stable_partition(visible.begin(), visible.end(), other_wave), visible.end());
+	hidden.erase(std::stable_partition(hidden.begin(), hidden.end(), other_wave), hidden.end());
+
+	emit_signal("wave_spawned", wave);
+}
+
+// Global-space view of whichever Camera2D is current, with the margin
+Rect2 WaveSpawner::view_rect() const {
+	Viewport* viewport = get_viewport();
+	Rect2 view = viewport->get_visible_rect();
+	return viewport->get_canvas_transform().affine_inverse().xform(view).grow(on_screen_margin);
+}
+
+// The camera moves; requests it has reached jump ahead of the rest
+void WaveSpawner::promote() {
+	if (hidden.empty()) return;
+
+	Rect2 view = view_rect();
+	size_t kept = 0;
+	for (size_t i = 0; i < hidden.size(); i++) {
+		if (view.has_point(hidden[i].position)) {
+			visible.push_back(hidden[i]);
+		} else {
+			hidden[kept++] = hidden[i];
+		}
+	}
+	hidden.resize(kept);
+}
+
+int WaveSpawner::run(int64_t usec) {
+	Time* time = Time::get_singleton();
+	uint64_t start = time->get_ticks_usec();
+	promote();
+
+	int count = 0;
+	while (!visible.empty() || !hidden.empty()) {
+		int64_t spent = (int64_t)(time->get_ticks_usec() - start);
+		if (count > 0 && spent + (int64_t)expected_usec > usec) break;
+
+		std::deque<Request>& queue = visible.empty() ? hidden : visible;
+		Request request = queue.front();
+		queue.pop_front();
+
+		uint64_t spawn_start = time->get_ticks_usec();
+		bool produced = spawn(request);
+		uint64_t cost = time->get_ticks_usec() - spawn_start;
+
+		// A dropped request costs next to nothing; keep it out of the mean
+		if (produced) {
+			spawn_usec += cost;
+			expected_usec = spawned > 0 ? expected_usec * 0.9 + cost * 0.1 : (double)cost;
+			spawned++;
+			count++;
+		}
+		finish(request.wave);
+	}
+	return count;
+}
+
+bool WaveSpawner::spawn(const Request& request) {
+	Node* node = nullptr;
+	if (source) {
+		node = source(request.kind, request.tag, request.position);
+	} else if (pool) {
+		node = pool->spawn(request.kind, request.position);
+	}
+
+	if (node) {
+		activated++;
+	} else {
+		Ref<PackedScene> scene = pool && !source ? pool->get_scene(request.kind) : Ref<PackedScene>();
+		if (!instantiate_on_miss || scene.is_null()) {
+			dropped++;
+			return false;
+		}
+
+		// Placed before add_child, so its _ready already runs where it spawns
+		node = scene->instantiate();
+		ERR_FAIL_COND_V(!node, false);
+		if (Node2D* node_2d = Object::cast_to<Node2D>(node)) {
+			Node2D* parent_2d = Object::cast_to<Node2D>(spawn_parent);
+			node_2d->set_position(parent_2d ? parent_2d->to_local(request.position) : request.position);
+		}
+		spawn_parent->add_child(node);
+		instantiated++;
+	}
+
+	emit_signal("spawned", node);
+	return true;
+}
+
+void WaveSpawner::finish(int wave) {
+	auto found = wave_remaining.find(wave);
+	if (found == wave_remaining.end()) return;
+
+	if (--found->second == 0) {
+		wave_remaining.erase(found);
+		emit_signal("wave_spawned", wave);
+	}
+}
+
+Dictionary WaveSpawner::get_stats() const {
+	Dictionary stats;
+	stats["queue_depth"] = get_queue_depth();
+	stats["queue_on_screen"] = (int64_t)visible.size();
+	stats["max_queue_depth"] = max_depth;
+	stats["spawned"] = spawned;
+	stats["activated"] = activated;
+	stats["instantiated"] = instantiated;
+	stats["dropped"] = dropped;
+	stats["mean_spawn_usec"] = spawned ? (double)spawn_usec / spawned : 0.0;
+	stats["max_per_frame"] = max_per_frame;
+	stats["busy_frames"] = busy_frames;
+	stats["overruns"] = overruns;
+	stats["max_overrun_usec"] = max_overrun_usec;
+	return stats;
+}
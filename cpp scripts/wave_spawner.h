@@ -0,0 +1,130 @@
+#pragma once
+
+#ifndef WAVE_SPAWNER_H
+#define WAVE_SPAWNER_H
+
+#include <Godot.hpp>
+#include <Node2D.hpp>
+#include <PackedScene.hpp>
+#include <Viewport.hpp>
+#include <Time.hpp>
+
+#include "scene_pool.h"
+
+#include <deque>
+#include <functional>
+#include <unordered_map>
+
+namespace godot {
+
+    // ============================================================
+    // WAVE SPAWNER
+    // Survival waves without the spawn-frame hitch: queue_spawn() and
+    // queue_wave() only record requests, and _process works through
+    // them until budget_usec is used up, so a 40-enemy wave lands over a
+    // few frames instead of running 40 _ready()s in one.
+    // Each request is a ScenePool spawn (activation: _on_pool_spawn, no
+    // instancing). If the pool is out and instantiate_on_miss is set,
+    // the pool's scene is instantiated unpooled under spawn_parent_path
+    // instead, which is the expensive case the budget is there for.
+    // Requests inside the camera's view (plus on_screen_margin) go
+    // first; the rest keep their order. The first request of a frame
+    // always runs, so the queue drains even when one spawn costs more
+    // than the budget; after that a spawn only starts if the running
+    // mean spawn cost still fits. A frame that goes over anyway counts
+    // as an overrun.
+    // Instead of a ScenePool, C++ owners can set a SpawnSource and hand
+    // out their own instances (LevelStreamer queues a chunk's enemies and
+    // coins here); `kind` and `tag` then mean whatever the source says.
+    // Every wave gets exactly one "wave_spawned", including waves that
+    // clear_queue() or cancel_wave() cut short.
+    // ============================================================
+    typedef std::function<Node*(int kind, int tag, Vector2 position)> SpawnSource;
+
+    class WaveSpawner : public Node2D {
+        GODOT_CLASS(WaveSpawner, Node2D)
+
+    public:
+        WaveSpawner();
+        ~WaveSpawner();
+
+        static void _register_methods();
+
+        void _init() override;
+        void _ready() override;
+        void _process(double delta) override;
+
+        // ============================================================
+        // SETTINGS
+        // ============================================================
+        NodePath pool_path;             // empty: the "scene_pool" group
+        NodePath spawn_parent_path;     // unpooled instances go here
+        int budget_usec;
+        float on_screen_margin;
+        bool instantiate_on_miss;
+        bool print_stats;               // once a second
+
+        // ============================================================
+        // QUEUE
+        // ============================================================
+        // Returns the wave id; "wave_spawned" fires once all of it is out
+        int queue_wave(int kind, PackedVector2Array positions);
+        int queue_spawn(int kind, Vector2 position);
+        // Drops every queued request; waves still waiting report spawned
+        // now with whatever already came out
+        void clear_queue();
+        void cancel_wave(int wave);
+
+        void set_source(const SpawnSource& value) { source = value; }
+        // One request of its own wave; `tag` goes back to the source
+        int queue_tagged(int kind, Vector2 position, int tag);
+
+        // Spawn queued requests until `usec` is spent; returns how many
+        // produced a node (dropped ones still count towards their wave)
+        int run(int64_t usec);
+
+        int get_queue_depth() const { return (int)(visible.size() + hidden.size()); }
+        Dictionary get_stats() const;
+
+    private:
+        struct Request {
+            int kind;
+            int wave;
+            int tag;
+            Vector2 position;
+        };
+
+        ScenePool* pool;
+        SpawnSource source;
+        Node* spawn_parent;
+
+        std::deque<Request> visible;        // inside the view when last checked
+        std::deque<Request> hidden;
+        std::unordered_map<int, int> wave_remaining;
+        int next_wave;
+
+        // Stats
+        double expected_usec;               // running mean cost of one spawn
+        int64_t spawned;
+        int64_t activated;
+        int64_t instantiated;
+        int64_t dropped;                    // pool empty, nothing to instantiate
+        int64_t frames;
+        int64_t busy_frames;                // had anything queued
+        int64_t overruns;
+        int64_t max_overrun_usec;
+        int max_depth;
+        int max_per_frame;
+        uint64_t spawn_usec;
+        double window;
+
+        Rect2 view_rect() const;
+        int push_wave(int kind, const Vector2* positions, int count, int tag);
+        void promote();
+        bool spawn(const Request& request);     // false if nothing came out
+        void finish(int wave);
+    };
+
+} // namespace godot
+
+#endif
@@ -3,8 +3,19 @@ extends Node2D
 
 const SPEED = 45
 
+@export var max_health = 3
+
 var health
 var direction = 1
+var health_bar_id = -1
+# One HealthBarBatch per level draws every enemy bar; found on first spawn,
+# so it does not matter whether it or this enemy became ready first.
+# Levels without one fall back to the enemy's own "health bar".
+var health_bars: Node = null
+var update_id = -1
+# Slows this enemy down while it is off screen, if the level has one;
+# found on first spawn, like health_bars
+var update_scheduler: Node = null
 
 @onready var ray_cast_right: RayCast2D = $RayCastRight
 @onready var ray_cast_left: RayCast2D = $RayCastLeft
@@ -15,15 +26,64 @@ var direction = 1
 
 
 func _ready() -> void:
-	health_bar.init_health(health)
-
 	killzone.area_entered.connect(_on_killzone_area_entered)
 	attack_hitbox.area_shape_entered.connect(_on_attack_hitbox_area_shape_entered)
 
+	# A ScenePool instance waits parked until it is handed out
+	if not has_meta("pooled"):
+		_on_pool_spawn()
+
+
+# Reset everything a previous life changed
+func _on_pool_spawn() -> void:
+	health = max_health
+	direction = 1
+	animated_sprite.flip_h = false
+	if _find_health_bars():
+		health_bar.hide()
+		health_bar_id = health_bars.add_bar(self, health, Vector2(-47, -70))
+	else:
+		health_bar.init_health(health)
+	if _find_update_scheduler():
+		update_id = update_scheduler.add_entity(self)
+
+
+func _find_health_bars() -> Node:
+	if not health_bars:
+		health_bars = get_tree().get_first_node_in_group("health_bar_batch")
+	return health_bars
+
+
+func _find_update_scheduler() -> Node:
+	if not update_scheduler:
+		update_scheduler = get_tree().get_first_node_in_group("update_scheduler")
+	return update_scheduler
+
+
+func _on_pool_release() -> void:
+	if health_bars and health_bar_id >= 0:
+		health_bars.remove_bar(health_bar_id)
+	health_bar_id = -1
+	if update_scheduler and update_id >= 0:
+		update_scheduler.remove_entity(update_id)
+	update_id = -1
+
 
 
 # Called every frame. 'delta' is the elapsed time since the previous frame.
 func _process(delta):
+	_walk(delta)
+	
+	if direction != 0:
+		animated_sprite.play("walk")
+
+
+# Off screen: UpdateScheduler calls this every few frames with the time since the last call
+func _lod_process(delta):
+	_walk(delta)
+
+
+func _walk(delta):
 	if ray_cast_right.is_colliding():
 		direction = -1
 		animated_sprite.flip_h = true
@@ -32,9 +92,6 @@ func _process(delta):
 		animated_sprite.flip_h = false
 	position.x += direction * SPEED * delta 
 	
-	if direction != 0:
-		animated_sprite.play("walk")
-	
 
 
 
@@ -42,10 +99,19 @@ func _process(delta):
 func _on_attack_hitbox_area_shape_entered(area_rid: RID, area: Area2D, area_shape_index: int, local_shape_index: int) -> void:
 	health -= 1
 	health = max(health, 0)
-	health_bar.value = health
-	print ("Enemy took damage")  # update bar
+	if health_bars:
+		health_bars.set_bar_value(health_bar_id, health)
+	else:
+		health_bar.health = health
 
 	if health <= 0:
+		_die()
+
+
+func _die() -> void:
+	if has_meta("pooled"):
+		get_parent().release(self)
+	else:
 		queue_free()
 
 
@@ -14,6 +14,8 @@ const BUFFER_DURATION = 0.3
 # ============================================================
 @onready var facing_container: Node2D = $facing_container
 @onready var animated_sprite: AnimatedSprite2D = $facing_container/AnimatedSprite2D
+# Repacked frames; only used once SpriteRepacker has written the table
+@onready var packed_sprite: Node2D = $facing_container/PackedSprite
 
 # Hurtboxes
 @onready var hurtbox_standing_area: Hurtbox = $facing_container/hurtbox_standing
@@ -45,6 +47,10 @@ var health: int = max_health
 var current_attack = ""
 var is_attacking = false
 
+# Which animation and how long in it, counted in physics ticks; the
+# sprite only samples this, and "finished" is a counted frame
+var anim := AnimClock.new()
+
 # Crouch
 var is_crouching = false
 var crouch_state = "none"   # none / down / idle / up
@@ -79,7 +85,12 @@ const COMBOS = {
 # READY
 # ============================================================
 func _ready():
-	animated_sprite.animation_finished.connect(_on_animation_finished)
+	anim.bake(animated_sprite.sprite_frames)
+	animated_sprite.pause()
+	if packed_sprite.is_loaded():
+		animated_sprite.hide()
+	else:
+		packed_sprite.hide()
 
 	# Disable hitboxes by default
 	hitbox_punch_area.get_node("CollisionShape2D").disabled = true
@@ -89,11 +100,27 @@ func _ready():
 	counter_window_timer.one_shot = true
 	counter_window_timer.timeout.connect(func(): is_counter_window_active = false)
 
+# ============================================================
+# RENDER
+# ============================================================
+func _process(_delta: float) -> void:
+	if packed_sprite.visible:
+		anim.apply_packed(packed_sprite)
+	else:
+		anim.apply(animated_sprite)
+
 # ============================================================
 # MAIN PHYSICS PROCESS
 # ============================================================
 func _physics_process(delta: float) -> void:
 
+	# -------- ANIMATION CLOCK --------
+	anim.step()
+	if is_attacking and anim.is_finished():
+		_end_attack()
+	elif anim.just_finished():
+		_on_animation_finished()
+
 	# -------- STUN --------
 	if is_stunned and not is_knocked_down:
 		_handle_stun(delta)
@@ -146,7 +173,7 @@ func _handle_stun(delta):
 
 	if stun_timer <= 0:
 		is_stunned = false
-		animated_sprite.play("p1_idle")
+		anim.enter("p1_idle")
 
 func _handle_knockdown(delta):
 	
@@ -158,7 +185,7 @@ func _handle_knockdown(delta):
 
 	if knockdown_time <= 0:
 		is_knocked_down = false
-		animated_sprite.play("p1_knockdown_get_up")
+		anim.enter("p1_knockdown_get_up")
 
 # ============================================================
 # ATTACK STATE
@@ -186,7 +213,7 @@ func _handle_crouch(crouch_pressed):
 			return
 		
 		if crouch_state == "idle":
-			animated_sprite.play("p1_crouch_idle")
+			anim.enter("p1_crouch_idle")
 			velocity.x = 0
 
 	# Stop Crouch
@@ -203,7 +230,7 @@ func _start_crouch_down():
 	crouch_state = "down"
 	is_crouching = true
 	velocity.x = 0
-	animated_sprite.play("p1_crouch_down")
+	anim.enter("p1_crouch_down")
 	
 	hurtbox_standing_area.get_node("CollisionShape2D").disabled = true
 	hurtbox_crouching_area.get_node("CollisionShape2D").disabled = false
@@ -211,7 +238,7 @@ func _start_crouch_down():
 func _start_crouch_up():
 	
 	crouch_state = "up"
-	animated_sprite.play("p1_crouch_up")
+	anim.enter("p1_crouch_up")
 	
 	hurtbox_standing_area.get_node("CollisionShape2D").disabled = false
 	hurtbox_crouching_area.get_node("CollisionShape2D").disabled = true
@@ -316,7 +343,7 @@ func _handle_animation():
 	if is_on_floor():
 
 		if crouch_state == "idle":
-			animated_sprite.play("p1_crouch_idle")
+			anim.enter("p1_crouch_idle")
 			return
 
 		if crouch_state in ["up", "down"]:
@@ -325,53 +352,59 @@ func _handle_animation():
 		var direction := Input.get_axis("p1_walk_left", "p1_walk_right")
 
 		if direction == 0:
-			animated_sprite.play("p1_idle")
+			anim.enter("p1_idle")
 		else:
-			animated_sprite.play("p1_walk")
+			anim.enter("p1_walk")
 
 	else:
-		animated_sprite.play("p1_jump")
+		anim.enter("p1_jump")
 
 # ============================================================
 # ANIMATION FINISHED
 # ============================================================
 func _on_animation_finished():
 
-	if animated_sprite.animation == current_attack:
-		is_attacking = false
-		current_attack = ""
-
-		hitbox_punch_area.get_node("CollisionShape2D").disabled = true
-		hitbox_kick_area.get_node("CollisionShape2D").disabled = true
-
-		if is_crouching and not Input.is_action_pressed("p1_crouch"):
-			_start_crouch_up()
-		return
-
-	if animated_sprite.animation == "p1_crouch_down":
+	if anim.animation == "p1_crouch_down":
 		
 		crouch_state = "idle"
-		animated_sprite.play("p1_crouch_idle")
+		anim.enter("p1_crouch_idle")
 		return
 
-	if animated_sprite.animation == "p1_crouch_up":
+	if anim.animation == "p1_crouch_up":
 		
 		crouch_state = "none"
 		is_crouching = false
-		animated_sprite.play("p1_idle")
+		anim.enter("p1_idle")
 		return
 
-	if animated_sprite.animation == "getup":
+	if anim.animation == "getup":
 		
-		animated_sprite.play("p1_idle")
+		anim.enter("p1_idle")
 		return
 
-	if animated_sprite.animation == "p1_get_hit":
+	if anim.animation == "p1_get_hit":
 		
 		if not is_knocked_down:
-			animated_sprite.play("p1_idle")
+			anim.enter("p1_idle")
 		return
 
+# ============================================================
+# ATTACK END
+# ============================================================
+func _end_attack():
+	is_attacking = false
+	current_attack = ""
+
+	hitbox_punch_area.get_node("CollisionShape2D").disabled = true
+	hitbox_kick_area.get_node("CollisionShape2D").disabled = true
+
+	# A hit may have cut the attack short; the stun/knockdown owns the sprite then
+	if is_stunned or is_knocked_down:
+		return
+
+	if is_crouching and not Input.is_action_pressed("p1_crouch"):
+		_start_crouch_up()
+
 # ============================================================
 # ATTACK START
 # ============================================================
@@ -419,7 +452,7 @@ func _start_attack(type):
 	if "k" in type:
 		hitbox_kick_area.get_node("CollisionShape2D").disabled = false
 
-	animated_sprite.play(current_attack)
+	anim.restart(current_attack)
 
 # ============================================================
 # DAMAGE SYSTEM
@@ -458,7 +491,7 @@ func take_damage(amount: int, hit_position: Vector2):
 	if final_damage >= 25:
 		is_knocked_down = true
 		knockdown_time = knockdown_duration
-		animated_sprite.play("p1_knockdown")
+		anim.enter("p1_knockdown")
 		return
 
 	# -------- STUN / HIT ANIM --------
@@ -469,21 +502,21 @@ func take_damage(amount: int, hit_position: Vector2):
 
 		if play_get_hit:
 			if is_crouching:
-				animated_sprite.play("p1_get_hit_crouch")
+				anim.enter("p1_get_hit_crouch")
 			else:
-				animated_sprite.play("p1_get_hit")
+				anim.enter("p1_get_hit")
 
 
 	else:
 		if is_crouching:
-			animated_sprite.play("p1_block_crouch")
+			anim.enter("p1_block_crouch")
 		else:
-			animated_sprite.play("p1_block_standing")
+			anim.enter("p1_block_standing")
 
 
 	# -------- DEATH --------
 	if health <= 0:
-		animated_sprite.play("p1_defeat")
+		anim.enter("p1_defeat")
 		emit_signal("character_died", character_name)
 		die()
 
@@ -523,9 +556,9 @@ func _take_punch_hit(area: Area2D):
 	stun_timer = hitstun_duration
 	
 	if is_crouching:
-		animated_sprite.play("p1_get_hit_crouch")
+		anim.enter("p1_get_hit_crouch")
 	else:
-		animated_sprite.play("p1_get_hit")
+		anim.enter("p1_get_hit")
 
 
 func _take_kick_hit(area: Area2D):
@@ -536,7 +569,7 @@ func _take_kick_hit(area: Area2D):
 
 	velocity.y = -200
 	velocity.x = sign(global_position.x - area.global_position.x) * 1300
-	animated_sprite.play("p1_knockdown")
+	anim.enter("p1_knockdown")
 
 # ============================================================
 # INPUT BUFFER SYSTEM
@@ -584,12 +617,12 @@ func perform_combo(combo_name: String):
 
 	match combo_name:
 		"punch_punch_kick":
-			animated_sprite.play("combo_punch_punch_kick")
+			current_attack = "combo_punch_punch_kick"
 		"kick_punch":
-			animated_sprite.play("combo_kick_punch")
+			current_attack = "combo_kick_punch"
 
 	is_attacking = true
-	animated_sprite.animation_finished.connect(_on_animation_finished, CONNECT_ONE_SHOT)
+	anim.restart(current_attack)
 
 	hitbox_punch_area.get_node("CollisionShape2D").disabled = false
 	hitbox_kick_area.get_node("CollisionShape2D").disabled = false
@@ -604,19 +637,19 @@ func _handle_block():
 		if not is_blocking:
 			is_blocking = true
 
-			if is_crouching: animated_sprite.play("p1_block_crouch_start")
-			else: animated_sprite.play("p1_block_standing_start")
+			if is_crouching: anim.enter("p1_block_crouch_start")
+			else: anim.enter("p1_block_standing_start")
 
 		else:
-			if is_crouching: animated_sprite.play("p1_block_crouch_idle")
-			else: animated_sprite.play("p1_block_standing_idle")
+			if is_crouching: anim.enter("p1_block_crouch_idle")
+			else: anim.enter("p1_block_standing_idle")
 
 	else:
 		if is_blocking:
 			is_blocking = false
 
-			if is_crouching: animated_sprite.play("p1_block_crouch_release")
-			else: animated_sprite.play("p1_block_standing_release")
+			if is_crouching: anim.enter("p1_block_crouch_release")
+			else: anim.enter("p1_block_standing_release")
 	
 
 
@@ -626,4 +659,24 @@ func reset_stats():
 	is_attacking = false
 	is_blocking = false
 	velocity = Vector2.ZERO
+
+	# Everything a fresh scene load would give us, so rematch can skip the reload
+	current_attack = ""
+	is_crouching = false
+	crouch_state = "none"
+	stun_timer = 0.0
+	is_knocked_down = false
+	knockdown_time = 0.0
+	is_blocking_hit = false
+	is_counter_window_active = false
+	counter_window_timer.stop()
+	input_buffer.clear()
+	buffer_timer = 0.0
+
+	hitbox_punch_area.get_node("CollisionShape2D").disabled = true
+	hitbox_kick_area.get_node("CollisionShape2D").disabled = true
+	hurtbox_standing_area.get_node("CollisionShape2D").disabled = false
+	hurtbox_crouching_area.get_node("CollisionShape2D").disabled = true
+	anim.restart("p1_idle")
+
 	health_changed.emit(health, character_name)
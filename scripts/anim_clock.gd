@@ -0,0 +1,119 @@
+class_name AnimClock
+extends RefCounted
+
+# Sim-side animation state for the AnimatedSprite2D fighters.
+# The GDScript side of AnimTimeline + AnimState (cpp scripts/anim_timeline.h):
+# frame lengths are baked once into whole physics ticks with the same
+# rounding, the fighter steps the clock from _physics_process, and the
+# sprite only shows what sample() says. "Finished" is a counted frame,
+# never the sprite's animation_finished signal.
+
+var tick_rate: int = 60
+
+# animation name (StringName) -> cumulative end tick of each frame
+var _frame_ends: Dictionary = {}
+var _loops: Dictionary = {}
+# animation name (StringName) -> PackedSprite animation id
+var _packed_ids: Dictionary = {}
+
+var animation: StringName = &""
+var frame: int = 0      # physics ticks since entry
+
+
+func bake(frames: SpriteFrames, rate: int = Engine.physics_ticks_per_second) -> void:
+	tick_rate = rate
+	_frame_ends.clear()
+	_loops.clear()
+	_packed_ids.clear()
+
+	for name in frames.get_animation_names():
+		var anim_name := StringName(name)
+		# speed 0 is a paused animation: hold each frame one tick so it still samples
+		var speed := frames.get_animation_speed(anim_name)
+		var seconds_per_unit := 1.0 / speed if speed > 0.0 else 1.0 / tick_rate
+
+		var ends := PackedInt32Array()
+		var end := 0
+		for f in frames.get_frame_count(anim_name):
+			end += maxi(1, roundi(frames.get_frame_duration(anim_name, f) * seconds_per_unit * tick_rate))
+			ends.append(end)
+
+		_frame_ends[anim_name] = ends
+		_loops[anim_name] = frames.get_animation_loop(anim_name)
+
+
+# AnimatedSprite2D.play() semantics: re-entering the current animation keeps
+# counting, unless it already played through, which starts it over
+func enter(anim_name: StringName) -> void:
+	if anim_name == animation and not is_finished():
+		return
+	restart(anim_name)
+
+
+func restart(anim_name: StringName) -> void:
+	if not _frame_ends.has(anim_name):
+		push_error("AnimClock: no animation %s" % anim_name)
+	animation = anim_name
+	frame = 0
+
+
+func step() -> void:
+	frame += 1
+
+
+func get_length(anim_name: StringName) -> int:
+	var ends: PackedInt32Array = _frame_ends.get(anim_name, PackedInt32Array())
+	if ends.is_empty():
+		return 0
+	return ends[-1]
+
+
+# Non-looping and played through; a missing animation reads as finished
+func is_finished() -> bool:
+	if not _frame_ends.has(animation):
+		return true
+	return not _loops[animation] and frame >= get_length(animation)
+
+
+# True on exactly the tick the animation played through, like the old signal
+func just_finished() -> bool:
+	if not _frame_ends.has(animation) or _loops[animation]:
+		return false
+	return frame == get_length(animation)
+
+
+# Frame index to show; non-looping animations hold their last frame
+func sample() -> int:
+	var ends: PackedInt32Array = _frame_ends.get(animation, PackedInt32Array())
+	if ends.is_empty():
+		return 0
+
+	var t := frame
+	var length := ends[-1]
+	if t >= length:
+		if not _loops[animation]:
+			return ends.size() - 1
+		t %= length
+
+	return ends.bsearch(t, false)
+
+
+# Render side: show the sampled frame, the sprite's own clock stays paused
+func apply(sprite: AnimatedSprite2D) -> void:
+	if not _frame_ends.has(animation):
+		return
+	if sprite.animation != animation:
+		sprite.animation = animation
+	sprite.set_frame_and_progress(sample(), 0.0)
+
+
+# Same, for a PackedSprite (cpp scripts/packed_sprite.h) built from the same
+# SpriteFrames; it samples the frame itself with the same tick rounding
+func apply_packed(sprite: Node2D) -> void:
+	if not _frame_ends.has(animation):
+		return
+	if not _packed_ids.has(animation):
+		_packed_ids[animation] = sprite.find_animation(animation)
+	var id: int = _packed_ids[animation]
+	if id >= 0:
+		sprite.show_frame(id, frame)
@@ -1,10 +1,51 @@
 # the pickup coin script
 extends Area2D
 
-@onready var game_manager: Node = %"game manager"
+# Placed coins find it by unique name, pooled ones through its group
+@onready var game_manager: Node = get_node_or_null(^"%game manager")
 @onready var animation_player: AnimationPlayer = $AnimationPlayer
 
+var update_id = -1
+# Stops the spin while this coin is off screen, if the level has one;
+# found on first use, so it does not matter which became ready first
+var update_scheduler: Node = null
+
+
+func _ready() -> void:
+	if not game_manager:
+		game_manager = get_tree().get_first_node_in_group("game_manager")
+	if not has_meta("pooled") and _find_update_scheduler():
+		update_id = update_scheduler.add_entity(self)
+
 
 func _on_body_entered(body):
-	game_manager.add_point()
+	if game_manager:
+		game_manager.add_point()
 	animation_player.play("coin_pickup")
+
+
+# End of "coin_pickup"
+func _on_pickup_finished() -> void:
+	if has_meta("pooled"):
+		get_parent().release(self)
+	else:
+		queue_free()
+
+
+func _on_pool_spawn() -> void:
+	animation_player.play("RESET")
+	animation_player.advance(0)
+	if _find_update_scheduler():
+		update_id = update_scheduler.add_entity(self)
+
+
+func _find_update_scheduler() -> Node:
+	if not update_scheduler:
+		update_scheduler = get_tree().get_first_node_in_group("update_scheduler")
+	return update_scheduler
+
+
+func _on_pool_release() -> void:
+	if update_scheduler and update_id >= 0:
+		update_scheduler.remove_entity(update_id)
+	update_id = -1
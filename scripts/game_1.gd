@@ -24,6 +24,14 @@ const MAX_ROUNDS = 3
 
 @export var speed = 0.1
 
+@onready var camera_2d: Camera2D = $camera_controller/Camera2D
+
+# Rematch: state captured right after load, restored in place instead of reloading the scene
+var initial_snapshot := {}
+var match_generation := 0
+var last_restart_usec := 0
+var match_tweens: Array[Tween] = []
+
 
 # Called when the node enters the scene tree for the first time.
 func _ready() -> void:
@@ -39,12 +47,14 @@ func _ready() -> void:
 	player_1.character_died.connect(on_character_died)
 	player_2.character_died.connect(on_character_died)
 	
-	start_match()
-	
 	restart_button.pressed.connect(on_restart_button_pressed)
 	
 	victory_screen.visible = false
 
+	initial_snapshot = capture_snapshot()
+
+	start_match()
+
 
 # Called every frame. 'delta' is the elapsed time since the previous frame.
 func _process(delta: float) -> void:
@@ -70,6 +80,7 @@ func start_match():
 
 	# Use a Tween to animate players into position
 	var tween = create_tween()
+	match_tweens.append(tween)
 	tween.tween_property(player_1, "position:x", 1701.0, 1.0).from(1701.0) # Animate from off-screen
 	tween.tween_property(player_2, "position:x", 2127.0, 1.0).from(2127.0)
 
@@ -86,7 +97,11 @@ func start_fight():
 	current_state = State.FIGHT
 	match_state_msgs.text = "Fight!"
 	# Use a timer to hide the "Fight!" message after a second
-	get_tree().create_timer(1.0).timeout.connect(func(): match_state_msgs.visible = false)
+	var generation = match_generation
+	get_tree().create_timer(1.0).timeout.connect(func():
+		if generation == match_generation:
+			match_state_msgs.visible = false
+	)
 	round_timer.start()
 	
 
@@ -118,6 +133,9 @@ func end_round():
 
 
 func reset_round():
+	if current_state != State.ROUND_END:
+		return
+
 		# Reset player health, energy, position
 	player_1.reset_stats()
 	player_2.reset_stats()
@@ -137,6 +155,7 @@ func end_match():
 	restart_button.visible = true
 	
 	var tween = create_tween()
+	match_tweens.append(tween)
 	victory_screen.modulate = Color(1, 1, 1, 0)  # fade in from transparent
 	tween.tween_property(victory_screen, "modulate:a", 1.0, 0.8)
 
@@ -147,4 +166,83 @@ func end_match():
 
 
 func on_restart_button_pressed():
-	get_tree().reload_current_scene()
+	rematch()
+
+
+# ============================================================
+# REMATCH
+# ============================================================
+func capture_snapshot() -> Dictionary:
+	return {
+		"p1_position": player_1.position,
+		"p2_position": player_2.position,
+		"p1_facing": player_1.facing_container.scale,
+		"p2_facing": player_2.facing_container.scale,
+		"p1_bar": health_bar_player_1.value,
+		"p2_bar": health_bar_player_2.value,
+		"round_timer_text": round_timer_label.text,
+		"round_counter_text": round_counter_label.text,
+		"match_state_text": match_state_msgs.text,
+		"match_state_visible": match_state_msgs.visible,
+		"victory_visible": victory_screen.visible,
+		"victory_modulate": victory_screen.modulate,
+		"camera_position": camera_2d.position,
+		"camera_zoom": camera_2d.zoom,
+	}
+
+
+func hash_match_state() -> int:
+	var state := capture_snapshot()
+	state["current_state"] = current_state
+	state["rounds"] = [rounds_won_p1, rounds_won_p2]
+	state["round_timer_stopped"] = round_timer.is_stopped()
+	for player in [player_1, player_2]:
+		state[player.character_name] = [
+			player.health, player.velocity, player.is_attacking, player.is_crouching,
+			player.is_stunned, player.is_knocked_down, player.is_blocking,
+			player.is_counter_window_active, player.input_buffer.size(), player.visible,
+		]
+	return hash(state)
+
+
+func rematch():
+	var start_usec := Time.get_ticks_usec()
+	match_generation += 1
+
+	for tween in match_tweens:
+		if tween.is_valid():
+			tween.kill()
+	match_tweens.clear()
+
+	round_timer.stop()
+	current_state = State.IDLE
+	rounds_won_p1 = 0
+	rounds_won_p2 = 0
+
+	player_1.reset_stats()
+	player_2.reset_stats()
+	player_1.show()
+	player_2.show()
+
+	player_1.position = initial_snapshot["p1_position"]
+	player_2.position = initial_snapshot["p2_position"]
+	player_1.facing_container.scale = initial_snapshot["p1_facing"]
+	player_2.facing_container.scale = initial_snapshot["p2_facing"]
+	health_bar_player_1.value = initial_snapshot["p1_bar"]
+	health_bar_player_2.value = initial_snapshot["p2_bar"]
+	round_timer_label.text = initial_snapshot["round_timer_text"]
+	round_counter_label.text = initial_snapshot["round_counter_text"]
+	match_state_msgs.text = initial_snapshot["match_state_text"]
+	match_state_msgs.visible = initial_snapshot["match_state_visible"]
+	victory_screen.visible = initial_snapshot["victory_visible"]
+	victory_screen.modulate = initial_snapshot["victory_modulate"]
+	camera_2d.position = initial_snapshot["camera_position"]
+	camera_2d.zoom = initial_snapshot["camera_zoom"]
+
+	last_restart_usec = Time.get_ticks_usec() - start_usec
+
+	start_match()
+
+
+func get_last_restart_usec() -> int:
+	return last_restart_usec
@@ -5,6 +5,9 @@ extends Node
 
 var score = 0
 
+func _ready():
+	add_to_group("game_manager")
+
 func add_point():
 	score += 1
 	score_label.text = "Coins  " + str(score)
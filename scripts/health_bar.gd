@@ -7,11 +7,12 @@ var health = 0 : set = _set_health
 
 func _set_health (new_health):
 	var prev_health = health
+	health = new_health
 	
 	value = health
 	
-	if health <= 0:
-		queue_free()
+	# Hidden rather than freed so the next round can reuse it
+	visible = health > 0
 	
 	if health < prev_health:
 		timer.start()
@@ -20,6 +21,7 @@ func _set_health (new_health):
 
 func init_health (_health):
 	health = _health
+	visible = true
 	max_value = health
 	value = health
 	damage_bar.max_value = health
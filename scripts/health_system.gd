@@ -58,6 +58,13 @@ func set_temporary_immortality (time : float):
 	immortality = true
 	
 	immortality_timer.start()
+
+
+# Rematch: an expiry left over from the last match must not fire into the new one
+func cancel_temporary_immortality():
+	if immortality_timer != null:
+		immortality_timer.stop()
+	immortality = false
 	
 
 func set_health (value : int):
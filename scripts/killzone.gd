@@ -7,7 +7,7 @@ extends Area2D
 func _on_body_entered(body: Node2D) -> void:
 	print ("You Died !")
 	Engine.time_scale = 0.5
-	body.get_node("CollisionShape2D").queue_free()
+	body.get_node("CollisionShape2D").set_deferred("disabled", true)
 	timer.start()
 
 
@@ -0,0 +1,85 @@
+// Throughput of the AABB overlap kernel at every ISA this CPU runs.
+//
+//   aabb_bench [--targets 10000] [--queries 64] [--reps 200]
+//
+// --queries fighter-sized hitboxes against --targets enemy hurtboxes
+// scattered over a PvE level, all pairs, --reps times per ISA. Reports
+// pairs tested per second and checks every ISA finds the same pairs.
+
+#include "aabb_kernel.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace godot;
+
+typedef std::chrono::steady_clock Clock;
+
+int main(int argc, char** argv) {
+	int target_count = 10000;
+	int query_count = 64;
+	int reps = 200;
+
+	for (int i = 1; i + 1 < argc; i += 2) {
+		if (!strcmp(argv[i], "--targets")) target_count = atoi(argv[i + 1]);
+		else if (!strcmp(argv[i], "--queries")) query_count = atoi(argv[i + 1]);
+		else if (!strcmp(argv[i], "--reps")) reps = atoi(argv[i + 1]);
+	}
+
+	std::mt19937 rng(42);
+	RectBuffer targets(target_count);
+	RectBuffer queries(query_count);
+
+	// enemy.tscn "attack hitbox" capsule as a rect, hitbox_punch-sized queries
+	const float level_w = 64 * 1100.0f;
+	const float level_h = 2000.0f;
+	for (int i = 0; i < target_count; i++) {
+		float x = (float)(rng() % (int)level_w);
+		float y = (float)(rng() % (int)level_h);
+		targets.add(x - 15.0f, y - 50.0f, x + 33.0f, y + 64.0f);
+	}
+	for (int i = 0; i < query_count; i++) {
+		float x = (float)(rng() % (int)level_w);
+		float y = (float)(rng() % (int)level_h);
+		queries.add(x, y - 20.0f, x + 60.0f, y + 20.0f);
+	}
+
+	std::vector<HitPair> pairs;
+	std::vector<HitPair> reference;
+	pairs.reserve(4096);
+
+	const AabbIsa best = AabbKernel::get_best_isa();
+	printf("aabb: %d queries x %d targets, %d reps, best ISA %s\n", query_count, target_count, reps, AabbKernel::get_isa_name(best));
+
+	double scalar_rate = 0.0;
+	for (int isa = AABB_SCALAR; isa <= best; isa++) {
+		AabbKernel::set_isa((AabbIsa)isa);
+
+		size_t found = 0;
+		Clock::time_point start = Clock::now();
+		for (int r = 0; r < reps; r++) {
+			pairs.clear();
+			found += AabbKernel::overlap_all(queries, targets, pairs);
+		}
+		double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+		if (isa == AABB_SCALAR) reference = pairs;
+		bool same = pairs.size() == reference.size();
+		for (size_t p = 0; same && p < pairs.size(); p++) {
+			same = pairs[p].query == reference[p].query && pairs[p].target == reference[p].target;
+		}
+
+		double rate = (double)query_count * target_count * reps / seconds;
+		if (isa == AABB_SCALAR) scalar_rate = rate;
+		printf("  %-6s %8.1f M pairs/s  (%.2fx scalar)  %zu hits/rep  %s\n",
+				AabbKernel::get_isa_name((AabbIsa)isa), rate / 1e6, rate / scalar_rate, found / reps, same ? "ok" : "MISMATCH");
+		if (!same) return 1;
+	}
+
+	AabbKernel::set_isa(best);
+	return 0;
+}
@@ -0,0 +1,107 @@
+// Single-core throughput of CrowdSim.
+//
+//   crowd_bench [--enemies 10000] [--seconds 60] [--kills 20]
+//
+// Spawns --enemies patrolling enemies over a row of platforms, ticks them
+// at 60 Hz for --seconds of game time as fast as possible, killing and
+// respawning --kills enemies per tick, and reports tick cost against the
+// 16.67 ms frame budget.
+
+#include "crowd_sim.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace godot;
+
+typedef std::chrono::steady_clock Clock;
+
+static const float TICK = 1.0f / 60.0f;
+static const int PLATFORMS = 64;
+static const float PLATFORM_WIDTH = 900.0f;
+static const float PLATFORM_GAP = 200.0f;
+
+static double percentile(std::vector<double> values, double p) {
+	if (values.empty()) return 0.0;
+	size_t index = std::min(values.size() - 1, (size_t)(values.size() * p));
+	std::nth_element(values.begin(), values.begin() + index, values.end());
+	return values[index];
+}
+
+static int spawn_random(CrowdSim& crowd, std::mt19937& rng) {
+	int platform = (int)(rng() % PLATFORMS);
+	float left = platform * (PLATFORM_WIDTH + PLATFORM_GAP);
+	float right = left + PLATFORM_WIDTH;
+	float x = left + (float)(rng() % (int)PLATFORM_WIDTH);
+	return crowd.spawn(x, -61.0f, left, right, 3, (rng() & 1) ? 1.0f : -1.0f);
+}
+
+int main(int argc, char** argv) {
+	int enemy_count = 10000;
+	int seconds = 60;
+	int kills_per_tick = 20;
+
+	for (int i = 1; i + 1 < argc; i += 2) {
+		if (!strcmp(argv[i], "--enemies")) enemy_count = atoi(argv[i + 1]);
+		else if (!strcmp(argv[i], "--seconds")) seconds = atoi(argv[i + 1]);
+		else if (!strcmp(argv[i], "--kills")) kills_per_tick = atoi(argv[i + 1]);
+	}
+
+	std::mt19937 rng(42);
+	CrowdSim crowd(enemy_count);
+	std::vector<int> ids;
+	ids.reserve(enemy_count);
+
+	for (int i = 0; i < enemy_count; i++) {
+		ids.push_back(spawn_random(crowd, rng));
+	}
+
+	std::vector<int> killed;
+	killed.reserve(kills_per_tick);
+
+	int ticks = seconds * 60;
+	std::vector<double> tick_us;
+	tick_us.reserve(ticks);
+
+	Clock::time_point start = Clock::now();
+	for (int t = 0; t < ticks; t++) {
+		Clock::time_point tick_start = Clock::now();
+
+		// Each killed enemy leaves in this tick and is replaced straight away
+		killed.clear();
+		for (int k = 0; k < kills_per_tick; k++) {
+			int slot = (int)(rng() % ids.size());
+			if (crowd.damage_id(ids[slot], 3)) killed.push_back(slot);
+		}
+		crowd.tick(TICK);
+		for (int slot : killed) {
+			ids[slot] = spawn_random(crowd, rng);
+		}
+
+		tick_us.push_back(std::chrono::duration<double, std::micro>(Clock::now() - tick_start).count());
+	}
+	double total_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+	// Keep the result observable so the loop can't be dropped
+	double checksum = 0.0;
+	for (int i = 0; i < crowd.get_count(); i++) checksum += crowd.get_x()[i];
+
+	double mean = 0.0;
+	for (double us : tick_us) mean += us;
+	mean /= tick_us.size();
+
+	double p99 = percentile(tick_us, 0.99);
+	double worst = *std::max_element(tick_us.begin(), tick_us.end());
+
+	printf("crowd: %d enemies, %d ticks (%d s at 60 Hz) in %.1f ms\n", crowd.get_count(), ticks, seconds, total_ms);
+	printf("  tick mean %.2f us  p99 %.2f us  max %.2f us\n", mean, p99, worst);
+	printf("  %.2f ns per enemy per tick, %.3f%% of the 16.67 ms budget at p99\n", mean * 1000.0 / enemy_count, p99 / 16666.7 * 100.0);
+	printf("  checksum %.1f\n", checksum);
+
+	return p99 < 16666.7 ? 0 : 1;
+}
@@ -0,0 +1,50 @@
+// Headless multi-match host for bot leagues and netplay validation.
+//
+//   dedicated_server --matches 500 --workers 8 --seconds 60 [--fast] [--no-refill]
+
+#include "match_server.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+using namespace godot;
+
+int main(int argc, char** argv) {
+	MatchServerConfig config;
+	config.worker_count = (int)std::thread::hardware_concurrency();
+	config.match_count = 200;
+	double seconds = 30.0;
+
+	for (int i = 1; i < argc; i++) {
+		const char* arg = argv[i];
+		const char* value = i + 1 < argc ? argv[i + 1] : "0";
+
+		if (!strcmp(arg, "--matches")) { config.match_count = atoi(value); i++; }
+		else if (!strcmp(arg, "--workers")) { config.worker_count = atoi(value); i++; }
+		else if (!strcmp(arg, "--seconds")) { seconds = atof(value); i++; }
+		else if (!strcmp(arg, "--seed")) { config.seed = (uint32_t)strtoul(value, nullptr, 10); i++; }
+		else if (!strcmp(arg, "--fast")) { config.realtime = false; }
+		else if (!strcmp(arg, "--no-refill")) { config.refill = false; }
+		else {
+			fprintf(stderr, "unknown argument: %s\n", arg);
+			return 1;
+		}
+	}
+
+	MatchServer server(config);
+	server.run((uint64_t)(seconds * SIM_TICK_RATE));
+
+	MatchServerStats stats = server.get_stats();
+
+	printf("matches          %d on %d workers (%.1f per core)\n", config.match_count, config.worker_count, stats.matches_per_core);
+	printf("frames           %llu in %.2fs\n", (unsigned long long)stats.frames, stats.elapsed_sec);
+	printf("ticks            %llu (%llu stolen)\n", (unsigned long long)stats.ticks, (unsigned long long)stats.steals);
+	printf("completed        %llu (%.2f per core per sec)\n", (unsigned long long)stats.matches_completed, stats.completed_per_core_sec);
+	printf("deadline misses  %llu\n", (unsigned long long)stats.deadline_misses);
+	printf("tick time        p50 %.2fus  p99 %.2fus  max %.2fus\n", stats.p50_tick_us, stats.p99_tick_us, stats.max_tick_us);
+	printf("frame time       p99 %.3fms\n", stats.p99_frame_ms);
+
+	return 0;
+}
@@ -0,0 +1,149 @@
+// Load generator and throughput benchmark for MatchmakingQueue.
+//
+//   matchmaking_bench [--players 100000] [--arrivals 2000] [--seconds 60] [--host 200]
+//
+// 1. bulk:   fill the queue with --players at once and drain it
+// 2. steady: --arrivals players per second for --seconds, pairing at 10 Hz
+// 3. host:   feed the formed matches into a MatchServer with --host slots
+
+#include "match_server.h"
+#include "matchmaking.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace godot;
+
+typedef std::chrono::steady_clock Clock;
+
+static double elapsed_us(Clock::time_point from) {
+	return std::chrono::duration<double, std::micro>(Clock::now() - from).count();
+}
+
+static int random_rating(std::mt19937& rng) {
+	static std::normal_distribution<float> distribution(1500.0f, 350.0f);
+	int rating = (int)distribution(rng);
+	return std::min(std::max(rating, MatchmakingQueue::MIN_RATING), MatchmakingQueue::MAX_RATING);
+}
+
+static double percentile(std::vector<double> values, double p) {
+	if (values.empty()) return 0.0;
+	size_t index = std::min(values.size() - 1, (size_t)(values.size() * p));
+	std::nth_element(values.begin(), values.begin() + index, values.end());
+	return values[index];
+}
+
+int main(int argc, char** argv) {
+	int player_count = 100000;
+	int arrivals_per_sec = 2000;
+	int seconds = 60;
+	int host_slots = 200;
+
+	for (int i = 1; i + 1 < argc; i += 2) {
+		if (!strcmp(argv[i], "--players")) player_count = atoi(argv[i + 1]);
+		else if (!strcmp(argv[i], "--arrivals")) arrivals_per_sec = atoi(argv[i + 1]);
+		else if (!strcmp(argv[i], "--seconds")) seconds = atoi(argv[i + 1]);
+		else if (!strcmp(argv[i], "--host")) host_slots = atoi(argv[i + 1]);
+	}
+
+	std::mt19937 rng(1234);
+	std::vector<MatchDescriptor> formed;
+	formed.reserve(player_count);
+
+	// ------------------ BULK --------------------
+	{
+		MatchmakingQueue queue(player_count);
+
+		Clock::time_point begin = Clock::now();
+		for (int i = 0; i < player_count; i++) {
+			queue.enqueue((uint32_t)i, random_rating(rng), 0.0);
+		}
+		double enqueue_us = elapsed_us(begin);
+
+		std::vector<double> call_us;
+		double now = 0.0;
+		begin = Clock::now();
+		while (queue.size() > 1 && now < 30.0) {
+			Clock::time_point call = Clock::now();
+			int pairs = queue.form_pairs(now, formed, 1000);
+			call_us.push_back(elapsed_us(call));
+			if (pairs == 0) now += 0.1;
+		}
+		double drain_us = elapsed_us(begin);
+
+		printf("bulk      %d players, enqueue %.1f ns/player\n", player_count, enqueue_us * 1000.0 / player_count);
+		printf("          %zu pairs in %.2f ms (%.1f ns/pair), %zu left unpaired\n",
+				formed.size(), drain_us / 1000.0, formed.empty() ? 0.0 : drain_us * 1000.0 / formed.size(), queue.size());
+		printf("          form_pairs(1000) p50 %.1f us  p99 %.1f us\n", percentile(call_us, 0.5), percentile(call_us, 0.99));
+	}
+
+	// ------------------ STEADY STATE --------------------
+	{
+		MatchmakingQueue queue(player_count);
+		std::vector<MatchDescriptor> out;
+		std::vector<double> call_us;
+		std::vector<double> enqueued_at(player_count * 4, 0.0);
+
+		uint32_t next_player = 0;
+		size_t pairs = 0;
+		size_t max_depth = 0;
+		double wait_total = 0.0;
+		double gap_total = 0.0;
+
+		const int TICKS_PER_SEC = 10;
+		for (int tick = 0; tick < seconds * TICKS_PER_SEC; tick++) {
+			double now = double(tick) / TICKS_PER_SEC;
+
+			for (int i = 0; i < arrivals_per_sec / TICKS_PER_SEC && next_player < enqueued_at.size(); i++) {
+				if (queue.enqueue(next_player, random_rating(rng), now)) {
+					enqueued_at[next_player] = now;
+				}
+				next_player++;
+			}
+			max_depth = std::max(max_depth, queue.size());
+
+			out.clear();
+			Clock::time_point call = Clock::now();
+			queue.form_pairs(now, out, 1 << 30);
+			call_us.push_back(elapsed_us(call));
+
+			for (const MatchDescriptor& match : out) {
+				wait_total += (now - enqueued_at[match.player_ids[0]]) + (now - enqueued_at[match.player_ids[1]]);
+				gap_total += std::abs(match.ratings[0] - match.ratings[1]);
+			}
+			pairs += out.size();
+		}
+
+		printf("steady    %d arrivals/s for %ds, %zu pairs (%.0f pairs/s), max depth %zu\n",
+				arrivals_per_sec, seconds, pairs, double(pairs) / seconds, max_depth);
+		printf("          avg wait %.2f s, avg rating gap %.1f\n",
+				pairs ? wait_total / (pairs * 2) : 0.0, pairs ? gap_total / pairs : 0.0);
+		printf("          form_pairs tick p50 %.1f us  p99 %.1f us\n", percentile(call_us, 0.5), percentile(call_us, 0.99));
+	}
+
+	// ------------------ HOST --------------------
+	if (host_slots > 0) {
+		MatchServerConfig config;
+		config.match_count = host_slots;
+		config.worker_count = 1;
+		config.realtime = false;
+		config.refill = false;
+
+		MatchServer server(config);
+		for (size_t i = 0; i < formed.size() && i < (size_t)host_slots * 4; i++) {
+			server.submit(formed[i]);
+		}
+		server.run(SIM_TICK_RATE * 120);
+
+		MatchServerStats stats = server.get_stats();
+		printf("host      %d slots, %llu matches completed, %zu descriptors still pending\n",
+				host_slots, (unsigned long long)stats.matches_completed, server.get_pending_count());
+	}
+
+	return 0;
+}
@@ -0,0 +1,189 @@
+// Per-frame cost of ProjectilePool with thousands of live projectiles.
+//
+//   projectile_bench [--live 4000] [--seconds 30]
+//
+// Two fighters trade fireballs and thrown items until --live projectiles
+// are in the air, then keep the count steady for --seconds of 60 Hz
+// frames. Every frame is snapshotted as rollback netcode would, and
+// every 30 frames the last 7 are rolled back and re-simulated, checking
+// the state hash matches. Reports frame cost and heap allocations made
+// after warm-up (should be zero).
+
+#include "projectile_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+
+using namespace godot;
+
+typedef std::chrono::steady_clock Clock;
+
+static std::atomic<long long> allocations(0);
+
+void* operator new(size_t size) {
+	allocations++;
+	if (void* p = malloc(size ? size : 1)) return p;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+	free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+	free(p);
+}
+
+static const int LIFETIME = 120;
+static const int ROLLBACK_FRAMES = 7;
+static const int SNAPSHOT_RING = 8;
+
+static const float ARENA_MIN_X = -600.0f;
+static const float ARENA_MAX_X = 600.0f;
+static const float FLOOR_Y = 0.0f;
+
+static uint32_t xorshift(uint32_t& state) {
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+
+static void fire_volley(ProjectilePool& pool, uint32_t& rng, int shots) {
+	for (int s = 0; s < shots; s++) {
+		int owner = (int)(xorshift(rng) & 1);
+		float from_x = owner == 0 ? -300.0f : 300.0f;
+		float dir = owner == 0 ? 1.0f : -1.0f;
+		float height = -40.0f - (float)(xorshift(rng) % 80);
+
+		if (xorshift(rng) & 3) {
+			pool.fire(PROJECTILE_FIREBALL, owner, from_x, height, dir * (120.0f + xorshift(rng) % 200), 0.0f, 12.0f, 10.0f, 10, LIFETIME);
+		} else {
+			pool.fire(PROJECTILE_THROWN, owner, from_x, height, dir * 250.0f, -900.0f, 8.0f, 8.0f, 15, LIFETIME);
+		}
+	}
+}
+
+static void set_hurtboxes(RectBuffer& boxes, uint32_t frame) {
+	// Both fighters pace back and forth, standing and crouching hurtboxes
+	float sway = (float)((int)(frame % 240) - 120);
+	boxes.clear();
+	boxes.add(-320.0f + sway, -120.0f, -260.0f + sway, FLOOR_Y);
+	boxes.add(-320.0f + sway, -70.0f, -260.0f + sway, FLOOR_Y);
+	boxes.add(260.0f - sway, -120.0f, 320.0f - sway, FLOOR_Y);
+	boxes.add(260.0f - sway, -70.0f, 320.0f - sway, FLOOR_Y);
+}
+
+static const int32_t HURTBOX_OWNERS[4] = { 0, 0, 1, 1 };
+
+int main(int argc, char** argv) {
+	int live = 4000;
+	int seconds = 30;
+
+	for (int i = 1; i + 1 < argc; i += 2) {
+		if (!strcmp(argv[i], "--live")) live = atoi(argv[i + 1]);
+		else if (!strcmp(argv[i], "--seconds")) seconds = atoi(argv[i + 1]);
+	}
+
+	ProjectilePool pool(live * 2);
+	pool.set_bounds(ARENA_MIN_X, -2000.0f, ARENA_MAX_X, FLOOR_Y + 1.0f);
+
+	RectBuffer hurtboxes(8);
+	std::vector<ProjectileHit> hits;
+	hits.reserve(pool.get_capacity());
+
+	ProjectileSnapshot ring[SNAPSHOT_RING];
+	uint32_t rng_ring[SNAPSHOT_RING];
+	uint32_t rng = 0x9E3779B9u;
+
+	// One frame of game: top up to the target count, then step
+	auto simulate = [&](uint32_t frame) {
+		int missing = live - pool.get_count();
+		fire_volley(pool, rng, std::max(0, std::min(missing, live / 20 + 1)));
+		set_hurtboxes(hurtboxes, frame);
+		hits.clear();
+		pool.step(hurtboxes, HURTBOX_OWNERS, hits);
+	};
+
+	// Warm-up: fill the pool and size every buffer
+	for (int f = 0; f < LIFETIME * 2; f++) {
+		pool.save(ring[f % SNAPSHOT_RING]);
+		rng_ring[f % SNAPSHOT_RING] = rng;
+		simulate(pool.get_frame());
+	}
+
+	int frames = seconds * 60;
+	std::vector<double> frame_us;
+	frame_us.reserve(frames);
+	long long allocations_before = allocations.load();
+
+	long long total_hits = 0;
+	int rollbacks = 0;
+	int desyncs = 0;
+	long long live_total = 0;
+
+	for (int f = 0; f < frames; f++) {
+		Clock::time_point start = Clock::now();
+
+		uint32_t frame = pool.get_frame();
+		pool.save(ring[frame % SNAPSHOT_RING]);
+		rng_ring[frame % SNAPSHOT_RING] = rng;
+		simulate(frame);
+		total_hits += (long long)hits.size();
+
+		if (f % 30 == 29) {
+			// Late input: rewind ROLLBACK_FRAMES and play them again
+			uint64_t expected = pool.hash(14695981039346656037ull);
+			uint32_t now = pool.get_frame();
+			uint32_t from = now - ROLLBACK_FRAMES;
+			pool.restore(ring[from % SNAPSHOT_RING]);
+			rng = rng_ring[from % SNAPSHOT_RING];
+			while (pool.get_frame() < now) {
+				uint32_t replay = pool.get_frame();
+				pool.save(ring[replay % SNAPSHOT_RING]);
+				rng_ring[replay % SNAPSHOT_RING] = rng;
+				simulate(replay);
+			}
+			rollbacks++;
+			desyncs += pool.hash(14695981039346656037ull) != expected;
+		}
+
+		frame_us.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+		live_total += pool.get_count();
+	}
+
+	long long allocations_after = allocations.load();
+
+	double mean = 0.0;
+	for (double us : frame_us) mean += us;
+	mean /= frame_us.size();
+
+	std::vector<double> sorted = frame_us;
+	std::sort(sorted.begin(), sorted.end());
+	double p50 = sorted[sorted.size() / 2];
+	double p99 = sorted[std::min(sorted.size() - 1, (size_t)(sorted.size() * 0.99))];
+
+	// Constant cost: both halves of the run should match
+	double first_half = 0.0;
+	double second_half = 0.0;
+	int half = frames / 2;
+	for (int f = 0; f < frames; f++) {
+		(f < half ? first_half : second_half) += frame_us[f];
+	}
+
+	printf("projectiles: %.0f live on average, capacity %d, %d frames, %d rollbacks of %d frames\n",
+			(double)live_total / frames, pool.get_capacity(), frames, rollbacks, ROLLBACK_FRAMES);
+	printf("  frame mean %.2f us  p50 %.2f us  p99 %.2f us\n", mean, p50, p99);
+	printf("  first half %.2f us/frame, second half %.2f us/frame\n", first_half / half, second_half / (frames - half));
+	printf("  %.1f ns per projectile per frame\n", p50 * 1000.0 / std::max(1.0, (double)live_total / frames));
+	printf("  %lld hits, %d dropped shots, %d desyncs\n", total_hits, pool.get_dropped_count(), desyncs);
+	printf("  heap allocations after warm-up: %lld\n", allocations_after - allocations_before);
+
+	return (desyncs == 0 && allocations_after == allocations_before) ? 0 : 1;
+}
@@ -0,0 +1,128 @@
+// Cost of SpatialHash from a 1v1 match up to a 10k PvE crowd.
+//
+//   spatial_bench [--ticks 600] [--cell 64]
+//
+// For each scale, spawns fighter-sized bodies with hurtboxes, a share of
+// them swinging hitboxes, a scatter of coins and a level-wide killzone,
+// moves everything every tick, and reports update() cost, the cost of
+// one box query per entity (ns/query) and the events produced.
+
+#include "spatial_hash.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace godot;
+
+typedef std::chrono::steady_clock Clock;
+
+static const int SCALES[] = { 2, 100, 1000, 10000 };
+
+// Matches the fighter scenes: ~60x120 body, hurtbox inset, punch reach ~50 px
+static const float BODY_W = 60.0f;
+static const float BODY_H = 120.0f;
+static const float REACH = 50.0f;
+
+struct Entity {
+	float x, y, vx;
+	int body, hurtbox, hitbox;
+};
+
+static double elapsed_ns(Clock::time_point since) {
+	return std::chrono::duration<double, std::nano>(Clock::now() - since).count();
+}
+
+static void run(int entity_count, int ticks, float cell) {
+	std::mt19937 rng(42);
+	SpatialHash hash(cell);
+
+	// Spread so density stays about the same as the arena at every scale
+	float world_w = std::max(1200.0f, std::sqrt((float)entity_count) * 400.0f);
+	float world_h = world_w * 0.5f;
+
+	std::vector<Entity> entities(entity_count);
+	for (int i = 0; i < entity_count; i++) {
+		Entity& e = entities[i];
+		e.x = (float)(rng() % (int)world_w);
+		e.y = (float)(rng() % (int)world_h);
+		e.vx = (rng() & 1) ? 2.0f : -2.0f;
+		e.body = hash.add(VOLUME_BODY, i, e.x, e.y, e.x + BODY_W, e.y + BODY_H);
+		e.hurtbox = hash.add(VOLUME_HURTBOX, i, e.x + 5, e.y + 5, e.x + BODY_W - 5, e.y + BODY_H);
+		e.hitbox = hash.add(VOLUME_HITBOX, i, e.x + BODY_W, e.y + 30, e.x + BODY_W + REACH, e.y + 60);
+	}
+
+	int coins = std::max(1, entity_count / 4);
+	for (int c = 0; c < coins; c++) {
+		float x = (float)(rng() % (int)world_w);
+		float y = (float)(rng() % (int)world_h);
+		hash.add(VOLUME_PICKUP, SpatialHash::NO_OWNER, x, y, x + 16, y + 16);
+	}
+	hash.add(VOLUME_KILLZONE, SpatialHash::NO_OWNER, -1e6f, world_h + 200.0f, 1e6f, world_h + 400.0f);
+
+	double update_ns = 0.0;
+	double query_ns = 0.0;
+	long long queries = 0;
+	long long found = 0;
+	long long events = 0;
+	long long candidates = 0;
+	std::vector<int> hits;
+	hits.reserve(256);
+
+	for (int t = 0; t < ticks; t++) {
+		for (int i = 0; i < entity_count; i++) {
+			Entity& e = entities[i];
+			e.x += e.vx;
+			if (e.x < 0.0f || e.x > world_w) e.vx = -e.vx;
+
+			hash.move(e.body, e.x, e.y, e.x + BODY_W, e.y + BODY_H);
+			hash.move(e.hurtbox, e.x + 5, e.y + 5, e.x + BODY_W - 5, e.y + BODY_H);
+			hash.move(e.hitbox, e.x + BODY_W, e.y + 30, e.x + BODY_W + REACH, e.y + 60);
+			// A quarter of the crowd is mid-swing on any tick
+			hash.set_enabled(e.hitbox, ((i + t / 8) & 3) == 0);
+		}
+
+		Clock::time_point start = Clock::now();
+		hash.update();
+		update_ns += elapsed_ns(start);
+		events += (long long)hash.get_events().size();
+		candidates += hash.get_stats().candidates;
+
+		start = Clock::now();
+		for (int i = 0; i < entity_count; i++) {
+			const Entity& e = entities[i];
+			hits.clear();
+			found += hash.query(e.x - REACH, e.y, e.x + BODY_W + REACH, e.y + BODY_H, 1u << VOLUME_HURTBOX, hits);
+		}
+		query_ns += elapsed_ns(start);
+		queries += entity_count;
+	}
+
+	const SpatialHashStats& stats = hash.get_stats();
+	printf("%6d entities (%d volumes, %d cell entries)\n", entity_count, stats.volumes, stats.cell_entries);
+	printf("  update %.2f us/tick  (%.1f ns/volume, %lld candidates/tick)\n",
+			update_ns / ticks / 1000.0, update_ns / ticks / stats.volumes, candidates / ticks);
+	printf("  query  %.1f ns/query (%.2f hurtboxes/query)\n", query_ns / queries, (double)found / queries);
+	printf("  events %.1f/tick, %d live pairs\n", (double)events / ticks, stats.pairs);
+}
+
+int main(int argc, char** argv) {
+	int ticks = 600;
+	float cell = 64.0f;
+
+	for (int i = 1; i + 1 < argc; i += 2) {
+		if (!strcmp(argv[i], "--ticks")) ticks = atoi(argv[i + 1]);
+		else if (!strcmp(argv[i], "--cell")) cell = (float)atof(argv[i + 1]);
+	}
+
+	for (int count : SCALES) {
+		run(count, ticks, cell);
+	}
+
+	return 0;
+}